@@ -13,17 +13,33 @@
 #include <iostream>
 #include <stdexcept>
 #include <cstring>
+#include <cstdlib>
 #include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
 #include <getopt.h>
+#include <unistd.h>
+#include <sys/epoll.h>
 #include <jsoncpp/json/json.h>
 
 /*--------------------------------------------------/
 /                   Local Imports                   /
 /--------------------------------------------------*/
-#include "RSXA.h"
+#include "RSXA.hpp"
 #include "NMT_log.h"
 #include "NMT_sock.hpp"
+#include "NMT_spsc.hpp"
+#include "NMT_uring.hpp"
 #include "RMCT_lib.hpp"
+#include "RMCT_proto.hpp"
+#include "RMCT_rt.hpp"
+#include "RMCT_trace.hpp"
+#include "RMCT_watchdog.hpp"
 
 /*--------------------------------------------------/
 /                    Macros                         /
@@ -37,9 +53,27 @@
  *  Quantity of Hardware RMCT directly controls*/
 const unsigned int SOCK_TIMEOUT = 600;
 
-/** @var NO_OF_HW
- *  Quantity of Hardware RMCT directly controls*/
-const unsigned int NO_OF_HW = 4;
+/** @var RMCT_TELEMETRY_PERIOD
+ *  Time (sec) between status telemetry messages */
+const unsigned int RMCT_TELEMETRY_PERIOD = 1;
+
+/** @var RMCT_RX_BATCH
+ *  Max messages drained from the socket per read */
+const unsigned int RMCT_RX_BATCH = 8;
+
+/** @var RMCT_COALESCE_MAX
+ *  Max queued commands merged into one hardware write */
+const unsigned int RMCT_COALESCE_MAX = 64;
+
+/** @var RMCT_CMD_QUEUE_DEPTH
+ *  Validated commands the network thread may get ahead of the
+ *  actuation thread by */
+const unsigned int RMCT_CMD_QUEUE_DEPTH = 64;
+
+/** @var RMCT_JSON_ACK
+ *  Serialized JSON acks, indexed by NMT_result */
+static const char *const RMCT_JSON_ACK[] = {"{\"type\":\"ack\",\"result\":0}",
+                                             "{\"type\":\"ack\",\"result\":1}"};
 
 /*--------------------------------------------------/
 /                Structs/Classes/Enums              /
@@ -69,13 +103,293 @@ typedef struct RMDR_hw_settings
     RSXA_procs rmct_task_config;
 } RMCT_hw_settings;
 
+/** @struct RMCT_config
+ *  One version of the settings, as published to the actuation thread.
+ *  A reloaded version owns the RSXA its hw entries point into. */
+typedef struct RMCT_config
+{
+    /** @var generation
+     *  Version number (0 for the settings RMCT started with) */
+    uint64_t generation = 0;
+
+    /** @var rsxa
+     *  Settings the hw entries were taken from (empty for generation 0) */
+    RSXA_reader rsxa;
+
+    /** @var hw
+     *  Extracted settings */
+    RMCT_hw_settings hw = {};
+
+    RMCT_config() = default;
+    RMCT_config(const RMCT_config &) = delete;
+    RMCT_config &operator=(const RMCT_config &) = delete;
+} RMCT_config;
+
+/** @struct RMCT_command
+ *  Validated command handed from the network thread to the actuation thread */
+typedef struct RMCT_command
+{
+    /** @var msg
+     *  Decoded command */
+    RMCT_proto_msg msg;
+
+    /** @var stamps
+     *  Time the command reached each stage (zero if it skipped it) */
+    struct timespec stamps[MAX_RMCT_TRACE_STAGES];
+} RMCT_command;
+
+/** @var RMCT_command_queue
+ *  Lock-free queue between the network and actuation threads */
+typedef NMT_spsc_queue<RMCT_command, RMCT_CMD_QUEUE_DEPTH> RMCT_command_queue;
+
+/** @struct RMCT_pending_ack
+ *  Ack owed for a command read in the current drain */
+typedef struct RMCT_pending_ack
+{
+    /** @var binary
+     *  Answer in the binary protocol */
+    bool binary;
+
+    /** @var batched
+     *  The client takes RMCT_PROTO_ACK_BATCH */
+    bool batched;
+
+    /** @var client
+     *  Client ID of the command */
+    uint8_t client;
+
+    /** @var seq
+     *  Sequence number of the command */
+    uint32_t seq;
+
+    /** @var queued
+     *  Actions were validated and go to the actuation thread */
+    bool queued;
+
+    /** @var command
+     *  Reserved queue slot of a queued command (NULL otherwise) */
+    RMCT_command *command;
+
+    /** @var result
+     *  Result of decoding and validating the command */
+    NMT_result result;
+
+    /** @var sent
+     *  Already carried by an ack datagram */
+    bool sent;
+
+    /** @var report
+     *  The command asked for the latency report */
+    bool report;
+
+    /** @var stamps
+     *  Time the command reached each stage (zero if it skipped it) */
+    struct timespec stamps[MAX_RMCT_TRACE_STAGES];
+} RMCT_pending_ack;
+
+/** @struct RMCT_options
+ *  Command line settings of RMCT */
+typedef struct RMCT_options
+{
+    /** @var verbosity
+     *  Log DEBUG messages */
+    bool verbosity = false;
+
+    /** @var cmd_deadline
+     *  Time (ms) a command stays fresh before the motors are stopped (0 disables) */
+    unsigned int cmd_deadline = DEFAULT_CMD_DEADLINE;
+
+    /** @var use_uring
+     *  Move multicast datagrams through io_uring */
+    bool use_uring = true;
+
+    /** @var rt_rate
+     *  Control loop rate in Hz (0 to actuate on each command) */
+    unsigned int rt_rate = 0;
+
+    /** @var rt_cpu
+     *  CPU of the control loop (< 0 for the last one) */
+    int rt_cpu = -1;
+} RMCT_options;
+
+/** @class RmctRuntime
+ *  Owns everything RMCT runs on: the controller, the transports, the
+ *  command queue, the event loops and the actuation thread. Members are
+ *  built in declaration order and destroyed in reverse, so the thread
+ *  and event loops always go before the transports and controller
+ *  they use. The registered handlers hold its address, so it is
+ *  neither copied nor moved. */
+class RmctRuntime
+{
+    public:
+        /* Constructor */
+        RmctRuntime(const RMCT_hw_settings &hw_settings, const RMCT_options &options);
+        RmctRuntime(const RmctRuntime &) = delete;
+        RmctRuntime &operator=(const RmctRuntime &) = delete;
+
+        /* Destructor */
+        ~RmctRuntime();
+
+        /* Prototypes */
+        NMT_result run();
+
+        /* Getters */
+        NMT_result get_result() const {return result;}
+        bool is_uring() const {return (uring && uring->NMT_is_uring());}
+
+    private:
+        /** @var options
+         *  Command line settings */
+        RMCT_options options;
+
+        /** @var result
+         *  Varible to set the overall state of the object */
+        NMT_result result = OK;
+
+        /** @var rmct_obj
+         *  Motor controller (only used from the actuation thread) */
+        std::unique_ptr<RobotMotorController> rmct_obj;
+
+        /** @var client_sock
+         *  Transport commands arrive on */
+        std::unique_ptr<NMT_transport> client_sock;
+
+        /** @var server_sock
+         *  Transport acks and telemetry leave on */
+        std::unique_ptr<NMT_transport> server_sock;
+
+        /** @var uring
+         *  io_uring over both multicast sockets (NULL if not used) */
+        std::unique_ptr<NMT_uring_transport> uring;
+
+        /** @var cmd_transport
+         *  Commands are read from here */
+        NMT_transport *cmd_transport = NULL;
+
+        /** @var ack_transport
+         *  Acknowledgements and telemetry are sent here (network thread only) */
+        NMT_transport *ack_transport = NULL;
+
+        /** @var cmd_queue
+         *  Validated commands from the network to the actuation thread */
+        RMCT_command_queue cmd_queue;
+
+        /** @var configs
+         *  Published settings, oldest first (network thread only). A
+         *  version older than applied_generation is no longer read by
+         *  the actuation thread and is freed on the next reload. */
+        std::deque<std::unique_ptr<RMCT_config>> configs;
+
+        /** @var config
+         *  Newest settings, picked up by the actuation thread */
+        std::atomic<const RMCT_config *> config{NULL};
+
+        /** @var applied_generation
+         *  Generation the actuation thread runs the devices with */
+        std::atomic<uint64_t> applied_generation{0};
+
+        /** @var active_config
+         *  Settings the devices run with (actuation thread only) */
+        const RMCT_config *active_config = NULL;
+
+        /** @var config_watch
+         *  inotify fd on RSXA.json (-1 if not watched) */
+        int config_watch = -1;
+
+        /** @var trace
+         *  Command latency per stage (guarded by trace_lock) */
+        RMCT_trace trace;
+        std::mutex trace_lock;
+
+        /** @var trace_report
+         *  Copy of trace the latency report is built from, so the
+         *  control loop never waits on the JSON or the send */
+        RMCT_trace trace_report;
+
+        /* Counters kept by the actuation thread */
+        std::atomic<unsigned long> coalesced{0};
+        std::atomic<unsigned long> actuation_failures{0};
+
+        /** @var stop_result
+         *  Result of the last watchdog emergency stop */
+        std::atomic<NMT_result> stop_result{OK};
+
+        /** @var watchdog
+         *  Stops the motors if commands stop arriving (checked from its
+         *  own thread, so a stuck I2C write cannot hold it up, and
+         *  reported from the network thread) */
+        RMCT_watchdog watchdog;
+
+        /** @var seq_filter
+         *  Drops duplicate and stale commands */
+        RMCT_seq_filter seq_filter;
+
+        /** @var overflow
+         *  Decodes a command while the queue is full */
+        RMCT_command overflow;
+
+        /* Network thread state */
+        Json::Value telemetry;
+        unsigned int rx_total = 0;
+        unsigned long ack_datagrams = 0;
+        std::chrono::steady_clock::time_point last_rx;
+
+        /* Network thread buffers (allocated once) */
+        std::vector<char> rx_pool;
+        std::vector<char> ack_pool;
+        NMT_sock_msg rx_msgs[RMCT_RX_BATCH];
+        NMT_sock_msg tx_msgs[RMCT_COALESCE_MAX];
+        RMCT_proto_ack batch[RMCT_PROTO_MAX_ACTIONS];
+        RMCT_pending_ack pending[RMCT_COALESCE_MAX];
+
+        /* Actuation thread buffers */
+        struct timespec act_stamps[RMCT_COALESCE_MAX][MAX_RMCT_TRACE_STAGES];
+        bool act_staged[RMCT_COALESCE_MAX];
+
+        /** @var reactor
+         *  Network thread event loop */
+        NMT_reactor reactor;
+
+        /** @var act_reactor
+         *  Actuation thread event loop (unused with rt_loop) */
+        NMT_reactor act_reactor;
+
+        /* Events between the threads */
+        int queue_event   = -1;
+        int expired_event = -1;
+        int config_event  = -1;
+
+        /** @var rt_loop
+         *  Real-time control loop (NULL to actuate on each command) */
+        std::unique_ptr<RMCT_rt_loop> rt_loop;
+
+        /** @var actuation
+         *  Actuation thread */
+        std::thread actuation;
+
+        /* Prototypes */
+        NMT_result setup();
+        void on_commands();
+        void on_telemetry();
+        void on_config_changed();
+        void apply_config();
+        unsigned int actuate();
+        void actuation_main();
+        void rt_tick();
+        void stop_actuation();
+};
+
 /*--------------------------------------------------/
 /                  Prototypes                       /
 /--------------------------------------------------*/
-static bool rmct_validate_robot_action(Json::Value mc);
 static void rmct_control_print_usage(int es);
 static NMT_result rmct_get_robot_settings(RSXA &hw_settings, RMCT_hw_settings &rmct_hw_settings);
-static void rmct_main_loop(NMT_sock_multicast server_sock, NMT_sock_multicast client_sock, RobotMotorController rmct_obj);
+static void rmct_write_latency(NMT_transport &ack_transport, const RMCT_trace &trace);
+static void rmct_watchdog_expired(NMT_transport &ack_transport, const RMCT_watchdog &watchdog,
+                                  NMT_result stop_result);
+static bool rmct_decode_message(const NMT_sock_msg &rx_msg, RMCT_seq_filter &seq_filter, RMCT_proto_msg &msg,
+                                bool &terminate_proc, RMCT_pending_ack &pending);
+static NMT_result rmct_stage_actions(const RMCT_proto_msg &msg, RobotMotorController &rmct_obj);
 
 /*--------------------------------------------------/
 /           Entry Point for RMCT Process            /
@@ -91,20 +405,39 @@ int main(int argc, char *argv[])
     /** Initialize Varibles */
     int opt;
     RMCT_hw_settings rmct_hw_settings = {0};
-    RSXA hw_settings                  = {0};
+    RSXA_reader hw_settings;
     NMT_result result                 = OK;
-    bool verbosity                    = false;
+    RMCT_options options;
 
     cout << "Starting Robot Motor Controller ......" << endl;
 
     /* 1. Parse Arguments */
-    while ((opt = getopt(argc, argv, ":hv")) != -1)
+    while ((opt = getopt(argc, argv, ":hvnw:r:c:")) != -1)
     {
         switch(opt)
         {
+            case 'w':
+                options.cmd_deadline = (unsigned int)atoi(optarg);
+                if (options.cmd_deadline > 0)
+                    cout << "Command deadline " << options.cmd_deadline << "ms ..........." << endl;
+                else
+                    cout << "Command deadline disabled ..........." << endl;
+                break;
+            case 'r':
+                options.rt_rate = (unsigned int)atoi(optarg);
+                cout << "Real-time control loop at " << options.rt_rate << "Hz ......" << endl;
+                break;
+            case 'c':
+                options.rt_cpu = atoi(optarg);
+                cout << "Control loop pinned to CPU " << options.rt_cpu << " ......." << endl;
+                break;
+            case 'n':
+                cout << "Using the sockets directly .........." << endl;
+                options.use_uring = false;
+                break;
             case 'v':
                 cout << "Run in verbose mode ................." << endl;
-                verbosity = true;
+                options.verbosity = true;
                 break;
             case 'h':
                 cout << "Help Menu" << endl;
@@ -117,36 +450,33 @@ int main(int argc, char *argv[])
     }
 
     /* 2. Get Robot Settings */
-    result = RSXA_init(&hw_settings);
+    result = hw_settings.load();
 
     /* 3. Validate and Extract Settings Needed */
     if (result == OK)
-        result = rmct_get_robot_settings(hw_settings, rmct_hw_settings);
+        result = rmct_get_robot_settings(hw_settings.settings(), rmct_hw_settings);
 
     /* 4. Initialize All Hardware */
     if (result == OK)
     {
         /* Initialize the logger */
-        cout << "Initializing the Logger " << hw_settings.log_dir << ".........." << endl;
-        NMT_log_init((char *)hw_settings.log_dir, verbosity);
-
-        /* Initialize Robot Motor Controller */
-        RobotMotorController rmct_obj(rmct_hw_settings.pca9685_hw_config,
-                                      rmct_hw_settings.cam_motor_hw_config,
-                                      rmct_hw_settings.left_motor_hw_config,
-                                      rmct_hw_settings.right_motor_hw_config);
+        const char *log_dir = hw_settings.str(hw_settings.settings().log_dir);
 
-        /** Free RSXA Memory (Everything is initialized) */
-        if (result == OK) {RSXA_free_mem(&hw_settings);}
+        cout << "Initializing the Logger " << log_dir << ".........." << endl;
+        NMT_log_init((char *)log_dir, options.verbosity);
 
-        /* Initialize Sockets */
-        RSXA_procs sock_config = rmct_hw_settings.rmct_task_config;
-        NMT_sock_multicast client_sock(sock_config.server_p, sock_config.server_ip, SOCK_CLIENT, SOCK_TIMEOUT);
-        NMT_sock_multicast server_sock(sock_config.client_p, sock_config.client_ip, SOCK_SERVER);
+        /* Initialize the hardware and the transports named in RSXA.json */
+        RmctRuntime runtime(rmct_hw_settings, options);
+        result = runtime.get_result();
 
         /* 5. Start the Program */
-        cout << "RMCT Executed .............. " << endl;
-        rmct_main_loop(server_sock, client_sock, rmct_obj);
+        if (result == OK)
+        {
+            cout << "RMCT Executed over " << RSXA_str_get(rmct_hw_settings.rmct_task_config.strings,
+                                                          rmct_hw_settings.rmct_task_config.transport)
+                 << " io_uring=" << btoa(runtime.is_uring()) << " .............. " << endl;
+            result = runtime.run();
+        }
     }
 
     /* Exit the program */
@@ -155,100 +485,767 @@ int main(int argc, char *argv[])
     return result;
 }
 
-static void rmct_main_loop(NMT_sock_multicast server_sock, NMT_sock_multicast client_sock,
-                           RobotMotorController rmct_obj)
+RmctRuntime::RmctRuntime(const RMCT_hw_settings &hw_settings, const RMCT_options &options) :
+    options(options),
+    watchdog(std::chrono::milliseconds(options.cmd_deadline), [this]() {
+        this->stop_result = this->rmct_obj->emergency_stop();
+        this->reactor.NMT_notify(this->expired_event);
+    }),
+    last_rx(std::chrono::steady_clock::now()),
+    rx_pool(RMCT_RX_BATCH * NMT_SOCK_MAX_MSG),
+    ack_pool(RMCT_COALESCE_MAX * RMCT_PROTO_MAX_MSG)
 {
     /*!
-     *  @brief     Main Loop for RMCT
-     *  param[in]  server_sock
-     *  param[in]  client_sock
-     *  param[in]  rmct_obj
+     *  @brief     Constructor for RmctRuntime - Initialize the hardware
+     *             and open the transports named in RSXA.json
+     *  @param[in] hw_settings
+     *  @param[in] options
+     *  @return    void
+     */
+
+    /* The settings the hardware starts with are generation 0 */
+    this->configs.emplace_back(new RMCT_config());
+    this->configs.back()->hw = hw_settings;
+    this->active_config      = this->configs.back().get();
+    this->config             = this->active_config;
+
+    /* Initialize Robot Motor Controller */
+    this->rmct_obj.reset(new RobotMotorController(hw_settings.pca9685_hw_config,
+                                                  hw_settings.cam_motor_hw_config,
+                                                  hw_settings.left_motor_hw_config,
+                                                  hw_settings.right_motor_hw_config));
+
+    /* Report how long each device took to come up */
+    const RMCT_init_graph &hw_init = this->rmct_obj->hw_init();
+    for (const RMCT_init_report &device : hw_init.report())
+        cout << "Initialized " << device.name << " in " << device.init_ms << "ms (up at " << device.ready_ms << "ms)" << endl;
+    cout << "Hardware up in " << hw_init.elapsed_ms() << "ms ......" << endl;
+
+    /* Initialize the transports */
+    const RSXA_procs &sock_config = hw_settings.rmct_task_config;
+    const char *transport         = RSXA_str_get(sock_config.strings, sock_config.transport);
+    this->client_sock = NMT_sock_open(transport, sock_config.server_p,
+                                      RSXA_str_get(sock_config.strings, sock_config.server_ip), SOCK_CLIENT, SOCK_TIMEOUT);
+    this->server_sock = NMT_sock_open(transport, sock_config.client_p,
+                                      RSXA_str_get(sock_config.strings, sock_config.client_ip), SOCK_SERVER);
+
+    if ((!this->client_sock) || (!this->server_sock) ||
+        (this->client_sock->NMT_get_result() != OK) || (this->server_sock->NMT_get_result() != OK))
+    {
+        cout << "ERROR, Failed to open the " << transport << " transport" << endl;
+        this->result = NOK;
+    }
+
+    /* Multicast commands and acks go through io_uring (falls back to the sockets) */
+    if (this->result == OK)
+    {
+        NMT_sock_multicast *udp_client = dynamic_cast<NMT_sock_multicast *>(this->client_sock.get());
+        NMT_sock_multicast *udp_server = dynamic_cast<NMT_sock_multicast *>(this->server_sock.get());
+
+        if ((this->options.use_uring) && (udp_client) && (udp_server))
+            this->uring.reset(new NMT_uring_transport(*udp_client, *udp_server));
+
+        this->cmd_transport = (this->uring ? this->uring.get() : this->client_sock.get());
+        this->ack_transport = (this->uring ? this->uring.get() : this->server_sock.get());
+    }
+
+    if ((this->reactor.NMT_get_result() != OK) || (this->act_reactor.NMT_get_result() != OK))
+        this->result = NOK;
+
+    /* Real-time mode - Every tick writes the latest queued state in one
+     * batch and steps the drive ramp */
+    if (this->options.rt_rate > 0)
+    {
+        this->rt_loop.reset(new RMCT_rt_loop(this->options.rt_rate, this->options.rt_cpu, DEFAULT_RT_PRIORITY,
+                                             [this]() {this->rt_tick();}));
+    }
+
+    for (unsigned int i = 0; i < RMCT_RX_BATCH; i++)
+        this->rx_msgs[i] = {&this->rx_pool[i * NMT_SOCK_MAX_MSG], NMT_SOCK_MAX_MSG, 0, false};
+
+    this->telemetry["type"]  = "telemetry";
+    this->telemetry["event"] = "status";
+}
+
+RmctRuntime::~RmctRuntime()
+{
+    /*!
+     *  @brief     Destructor - run() joins the actuation thread, this
+     *             only covers leaving before it returned
+     *  @return    void
+     */
+
+    this->stop_actuation();
+
+    /* Its callback uses the reactor and rmct_obj, which go first */
+    this->watchdog.stop();
+
+    if (this->config_watch >= 0) {close(this->config_watch);}
+}
+
+NMT_result RmctRuntime::run()
+{
+    /*!
+     *  @brief     Main Loop for RMCT. The network thread (the caller)
+     *             receives, validates and acks commands, then hands them
+     *             through a lock-free queue to the actuation thread, which
+     *             owns rmct_obj (hardware writes and drive ramp ticks). A
+     *             slow I2C write never delays the next receive, nor the
+     *             watchdog thread. Only the network thread sends on
+     *             ack_transport.
+     *             With rt_rate the actuation thread runs a real-time
+     *             fixed rate loop instead of reacting to each command.
+     *  @return    NMT_result
+     */
+
+    if (this->result == OK)
+        this->result = this->setup();
+
+    if (this->result == OK)
+        this->result = this->watchdog.start();
+
+    if (this->result == OK)
+    {
+        this->actuation = std::thread(&RmctRuntime::actuation_main, this);
+        this->reactor.NMT_run();
+        this->stop_actuation();
+        this->watchdog.stop();
+    }
+    else
+    {
+        NMT_log_write(ERROR, (char *)"Failed to set up the RMCT main loop");
+    }
+
+    return this->result;
+}
+
+NMT_result RmctRuntime::setup()
+{
+    /*!
+     *  @brief     Register the handlers of both threads
      *  @return    NMT_result
      */
 
+    /* Commands - Validated and acked on receipt, the actions are queued for
+     * the actuation thread */
+    NMT_result result = this->reactor.NMT_add_fd(this->cmd_transport->NMT_get_fd(), EPOLLIN, [this](uint64_t) {
+        this->on_commands();
+    });
+
+    /* Watchdog expiry report */
+    if ((result == OK) &&
+        ((this->expired_event = this->reactor.NMT_add_event([this](uint64_t) {
+            rmct_watchdog_expired(*this->ack_transport, this->watchdog, this->stop_result);
+        })) < 0))
+    {
+        result = NOK;
+    }
+
+    /* Telemetry - Also exits once the client has been silent for SOCK_TIMEOUT */
+    if ((result == OK) &&
+        (this->reactor.NMT_add_timer(std::chrono::seconds(RMCT_TELEMETRY_PERIOD), [this](uint64_t) {
+            this->on_telemetry();
+        }) < 0))
+    {
+        result = NOK;
+    }
+
+    /* Edits of RSXA.json - Without the watch they need a restart */
+    if (result == OK)
+    {
+        this->config_watch = RSXA_watch(RS_SETTINGS_PATH);
+
+        if (this->config_watch < 0)
+            NMT_log_write(WARNING, (char *)"Not watching %s, edits need a restart", RS_SETTINGS_PATH);
+        else
+            result = this->reactor.NMT_add_fd(this->config_watch, EPOLLIN, [this](uint64_t) {
+                this->on_config_changed();
+            });
+    }
+
+    /* The control loop does the rest from its ticks */
+    if (this->rt_loop)
+        return result;
+
+    /* Reloaded settings */
+    if ((result == OK) &&
+        ((this->config_event = this->act_reactor.NMT_add_event([this](uint64_t) {
+            this->apply_config();
+        })) < 0))
+    {
+        result = NOK;
+    }
+
+    /* Queued commands */
+    if ((result == OK) &&
+        ((this->queue_event = this->act_reactor.NMT_add_event([this](uint64_t) {
+            while (this->actuate() == RMCT_COALESCE_MAX) {}
+        })) < 0))
+    {
+        result = NOK;
+    }
+
+    /* Drive motor ramp */
+    if ((result == OK) &&
+        (this->act_reactor.NMT_add_timer(std::chrono::microseconds((long)(1000000 / DEFAULT_RAMP_TICK_RATE)), [this](uint64_t) {
+            if (this->rmct_obj->drive_ramp_tick() != OK)
+                NMT_log_write(ERROR, (char *)"Ramp tick failed to update PWM");
+        }) < 0))
+    {
+        result = NOK;
+    }
+
+    return result;
+}
+
+void RmctRuntime::on_commands()
+{
+    /*!
+     *  @brief     Network thread - Drain the command backlog (up to
+     *             RMCT_COALESCE_MAX), ack it and queue the actions
+     *  @return    void
+     */
+
     /* Initialize Varibles */
-    NMT_result result = OK;
-    Json::Value  mc;
-    Json::Value  ack;
-    Json::Reader reader;
-    char *rx_message;
-    bool terminate_proc = false;
-    ack["type"] = "ack";
+    unsigned int rx_count      = 0;
+    unsigned int pending_count = 0;
+    unsigned int queued        = 0;
+    unsigned int tx_count      = 0;
+    bool terminate_proc        = false;
+    bool report                = false;
+    struct timespec read_time, ack_send;
 
-    /* Main Program Loop */
-    while ((result == OK) && (!terminate_proc))
+    while ((pending_count < RMCT_COALESCE_MAX) && (!terminate_proc))
     {
-        /* Listen on the socket */
-        result = client_sock.NMT_read_socket(&rx_message); 
+        unsigned int max_msgs = RMCT_COALESCE_MAX - pending_count;
+        if (max_msgs > RMCT_RX_BATCH) {max_msgs = RMCT_RX_BATCH;}
 
-        if (result == OK)
+        if ((this->cmd_transport->NMT_read_batch(this->rx_msgs, max_msgs, &rx_count, false) != OK) || (rx_count == 0))
+            break;
+        RMCT_trace::stamp(read_time);
+
+        this->last_rx   = std::chrono::steady_clock::now();
+        this->rx_total += rx_count;
+
+        for (unsigned int i = 0; ((i < rx_count) && (!terminate_proc)); i++)
         {
-            /* Parse the message as JSON Object */
-            reader.parse(rx_message, mc);
+            RMCT_pending_ack &ack = this->pending[pending_count];
+            RMCT_command *command = this->cmd_queue.NMT_reserve(queued);
+            if (!command) {command = &this->overflow;}
+
+            ack.stamps[RMCT_STAGE_KERNEL] = this->rx_msgs[i].rx_time;
+            ack.stamps[RMCT_STAGE_RECV]   = read_time;
+
+            if (!rmct_decode_message(this->rx_msgs[i], this->seq_filter, command->msg, terminate_proc, ack))
+                continue;
 
-            for (Json::Value::ArrayIndex i = 0; i != mc.size() && result == OK; i++)
+            /* Only a new, valid command counts as fresh - Duplicates, stale or
+             * broken messages and hellos do not keep the deadman alive */
+            if ((ack.result == OK) && (command->msg.type != RMCT_PROTO_HELLO))
+                this->watchdog.feed();
+
+            /* The actuation thread is RMCT_CMD_QUEUE_DEPTH commands behind */
+            if ((ack.queued) && (command == &this->overflow))
             {
-                if (rmct_validate_robot_action(mc[i]))
-                {
-                    if (mc[i]["type"].asString() == "hw_action")
-                    {
-                        /* Process Request */
-                        result = rmct_obj.process_motor_action(mc[i]["motor"].asString(),
-                                                               mc[i]["direction"].asString(),
-                                                               mc[i]["angle"].asDouble(), 
-                                                               mc[i]["speed"].asInt());
-                    }
-                    else if (mc[i]["type"].asString() == "proc_action")
-                    {
-                        /* Process proc_action */
-                        if (mc[i]["action"].asString() == "exit") {terminate_proc = true;}
-                        result = OK;
-                    }
-                }
-                else
+                NMT_log_write(ERROR, (char *)"Command queue full client=%u seq=%u", ack.client, ack.seq);
+                ack.queued = false;
+                ack.result = NOK;
+            }
+
+            ack.command = (ack.queued ? command : NULL);
+            queued     += ack.queued;
+            pending_count++;
+        }
+
+        /* Drained */
+        if (rx_count < max_msgs)
+            break;
+    }
+
+    for (unsigned int i = 0; i < pending_count; i++)
+    {
+        this->pending[i].sent = false;
+        report |= this->pending[i].report;
+    }
+
+    /* Each command is answered in the protocol it was sent in. Binary clients
+     * that take batches get one datagram per client for the whole backlog */
+    for (unsigned int i = 0; i < pending_count; i++)
+    {
+        RMCT_pending_ack &ack = this->pending[i];
+        char *ack_buffer      = &this->ack_pool[tx_count * RMCT_PROTO_MAX_MSG];
+        size_t ack_length     = 0;
+
+        if (ack.sent)
+            continue;
+
+        if (!ack.binary)
+        {
+            ack_length = strlen(RMCT_JSON_ACK[ack.result]);
+            memcpy(ack_buffer, RMCT_JSON_ACK[ack.result], ack_length);
+        }
+        else if (!ack.batched)
+        {
+            ack_length = RMCT_proto_encode_ack(ack.client, ack.seq, ack.result, ack_buffer, RMCT_PROTO_MAX_MSG);
+        }
+        else
+        {
+            unsigned int batch_count = 0;
+
+            for (unsigned int j = i; ((j < pending_count) && (batch_count < RMCT_PROTO_MAX_ACTIONS)); j++)
+            {
+                RMCT_pending_ack &other = this->pending[j];
+
+                if ((!other.sent) && (other.batched) && (other.client == ack.client))
                 {
-                    result = NOK;
-                    NMT_log_write(ERROR, (char *)"Invalid Message Recieved");
+                    this->batch[batch_count++] = {other.seq, other.result};
+                    other.sent                 = true;
                 }
             }
 
-            /* Free rx_message */
-            free(rx_message);
+            ack_length = RMCT_proto_encode_ack_batch(ack.client, this->batch, batch_count,
+                                                     ack_buffer, RMCT_PROTO_MAX_MSG);
+        }
+
+        ack.sent                  = true;
+        this->tx_msgs[tx_count++] = {ack_buffer, ack_length, ack_length, false};
+    }
+
+    /* Send the Acknowledgements */
+    this->ack_datagrams += tx_count;
+    if (((tx_count > 0) && (this->ack_transport->NMT_write_batch(this->tx_msgs, tx_count) != OK)) || (terminate_proc))
+        this->reactor.NMT_stop();
 
-            /* Send Acknowledgement */
-            ack["result"] = result;
-            result = server_sock.NMT_write_socket((char *)(ack.toStyledString()).c_str());
+    /* Commands that stop here are traced now, the queued ones once written */
+    RMCT_trace::stamp(ack_send);
+    {
+        std::lock_guard<std::mutex> lock(this->trace_lock);
+        for (unsigned int i = 0; i < pending_count; i++)
+        {
+            RMCT_pending_ack &ack = this->pending[i];
+
+            ack.stamps[RMCT_STAGE_ACK_SEND] = ack_send;
+            if (ack.command)
+                memcpy(ack.command->stamps, ack.stamps, sizeof(ack.stamps));
+            else
+                this->trace.record(ack.stamps);
         }
+
+        if (report)
+            this->trace_report = this->trace;
+    }
+
+    if (report)
+        rmct_write_latency(*this->ack_transport, this->trace_report);
+
+    /* Hand the actions over (the control loop picks them up on its next tick) */
+    if (queued > 0)
+    {
+        this->cmd_queue.NMT_publish(queued);
+        if (!this->rt_loop) {this->act_reactor.NMT_notify(this->queue_event);}
+    }
+}
+
+void RmctRuntime::on_telemetry()
+{
+    /*!
+     *  @brief     Network thread - Send the status telemetry and stop
+     *             once the client has been silent for SOCK_TIMEOUT
+     *  @return    void
+     */
+
+    this->telemetry["rx_messages"]        = this->rx_total;
+    this->telemetry["coalesced"]          = (Json::UInt64)this->coalesced;
+    this->telemetry["actuation_failures"] = (Json::UInt64)this->actuation_failures;
+    this->telemetry["ack_datagrams"]      = (Json::UInt64)this->ack_datagrams;
+    this->telemetry["dropped_duplicate"]  = (Json::UInt64)this->seq_filter.duplicates();
+    this->telemetry["dropped_stale"]      = (Json::UInt64)this->seq_filter.stale();
+    this->telemetry["watchdog_expiries"]  = this->watchdog.expiries();
+    this->telemetry["config_generation"]  = (Json::UInt64)this->applied_generation;
+
+    if (this->rt_loop)
+    {
+        RMCT_latency_histogram jitter;
+        uint64_t overruns = 0;
+
+        this->rt_loop->stats(jitter, overruns);
+        this->telemetry["rt_ticks"]         = (Json::UInt64)this->rt_loop->ticks();
+        this->telemetry["rt_overruns"]      = (Json::UInt64)overruns;
+        this->telemetry["rt_jitter_p99_ns"] = (Json::UInt64)jitter.percentile(99);
+        this->telemetry["rt_jitter_max_ns"] = (Json::UInt64)jitter.max();
+    }
+    this->ack_transport->NMT_write_message(this->telemetry.toStyledString().c_str());
+
+    if (std::chrono::steady_clock::now() - this->last_rx > std::chrono::seconds(SOCK_TIMEOUT))
+    {
+        NMT_log_write(WARNING, (char *)"No Message recived for %us", SOCK_TIMEOUT);
+        this->reactor.NMT_stop();
+    }
+}
+
+void RmctRuntime::on_config_changed()
+{
+    /*!
+     *  @brief     Network thread - Reload RSXA.json once it was edited
+     *             and publish it if a device RMCT drives changed. The
+     *             actuation thread swaps to it on its own, so a reload
+     *             never holds up the control loop. Settings that only
+     *             apply at startup are reported, not applied.
+     *  @return    void
+     */
+
+    /* Initialize Varibles */
+    std::unique_ptr<RMCT_config> next;
+    const RMCT_hw_settings &latest = this->configs.back()->hw;
+    uint64_t generation            = this->configs.back()->generation + 1;
+
+    if (!RSXA_watch_changed(this->config_watch, RS_SETTINGS_PATH))
+        return;
+    next.reset(new RMCT_config());
+
+    /* A half written or invalid file leaves the running settings alone */
+    if ((next->rsxa.load() != OK) || (rmct_get_robot_settings(next->rsxa.settings(), next->hw) != OK))
+    {
+        NMT_log_write(ERROR, (char *)"Ignoring %s, it is not valid", RS_SETTINGS_PATH);
+        return;
+    }
+
+    if ((RSXA_diff_proc(&latest.rmct_task_config, &next->hw.rmct_task_config)) ||
+        (RSXA_diff_hw(&latest.pca9685_hw_config, &next->hw.pca9685_hw_config) != RSXA_HW_SAME))
+    {
+        NMT_log_write(WARNING, (char *)"%s and %s settings change on a restart", MY_NAME, PCA9685_HW_NAME);
+    }
+
+    if ((RSXA_diff_hw(&latest.cam_motor_hw_config, &next->hw.cam_motor_hw_config) == RSXA_HW_SAME) &&
+        (RSXA_diff_hw(&latest.left_motor_hw_config, &next->hw.left_motor_hw_config) == RSXA_HW_SAME) &&
+        (RSXA_diff_hw(&latest.right_motor_hw_config, &next->hw.right_motor_hw_config) == RSXA_HW_SAME))
+    {
+        NMT_log_write(DEBUG, (char *)"No device settings changed");
+        return;
     }
-    return;
+
+    /* Free the versions the actuation thread has moved past (never the newest) */
+    while (this->configs.front()->generation < this->applied_generation.load(std::memory_order_acquire))
+        this->configs.pop_front();
+
+    next->generation = generation;
+    this->configs.push_back(std::move(next));
+    this->config.store(this->configs.back().get(), std::memory_order_release);
+
+    NMT_log_write(DEBUG, (char *)"Published settings generation=%llu", (unsigned long long)generation);
+    if (!this->rt_loop) {this->act_reactor.NMT_notify(this->config_event);}
+}
+
+void RmctRuntime::apply_config()
+{
+    /*!
+     *  @brief     Actuation thread - Swap to the newest published
+     *             settings. Only the devices that differ from the ones
+     *             running are reconfigured, nothing is initialized again.
+     *  @return    void
+     */
+
+    const RMCT_config *next         = this->config.load(std::memory_order_acquire);
+    const RMCT_hw_settings &running = this->active_config->hw;
+
+    if (next == this->active_config)
+        return;
+
+    const RSXA_hw *cam_motor   = &next->hw.cam_motor_hw_config;
+    const RSXA_hw *left_motor  = &next->hw.left_motor_hw_config;
+    const RSXA_hw *right_motor = &next->hw.right_motor_hw_config;
+
+    if (RSXA_diff_hw(&running.cam_motor_hw_config, cam_motor) == RSXA_HW_SAME) {cam_motor = NULL;}
+    if (RSXA_diff_hw(&running.left_motor_hw_config, left_motor) == RSXA_HW_SAME) {left_motor = NULL;}
+    if (RSXA_diff_hw(&running.right_motor_hw_config, right_motor) == RSXA_HW_SAME) {right_motor = NULL;}
+
+    if (this->rmct_obj->reconfigure(cam_motor, left_motor, right_motor) != OK)
+        NMT_log_write(ERROR, (char *)"Settings generation=%llu not fully applied", (unsigned long long)next->generation);
+
+    /* The previous version is not read from here on */
+    this->active_config = next;
+    this->applied_generation.store(next->generation, std::memory_order_release);
 }
-static bool rmct_validate_robot_action(Json::Value mc)
+
+unsigned int RmctRuntime::actuate()
 {
     /*!
-     *  @brief      Verify that the command sent is in the
-     *              expected format.
-     *  @return     True/False
+     *  @brief     Actuation thread - Stage the queued backlog (up to
+     *             RMCT_COALESCE_MAX) into one batch, so each motor is
+     *             written once with its newest command
+     *  @return    Number of commands taken off the queue
      */
 
-    NMT_log_write(DEBUG, (char *)">");
-    bool valid = false;
+    /* Initialize Varibles */
+    unsigned int count  = 0;
+    unsigned int staged = 0;
+    RMCT_command *command;
+    struct timespec i2c_issue, i2c_complete;
+
+    /* Idle tick - Nothing to write */
+    if (this->cmd_queue.NMT_front() == NULL)
+        return count;
+
+    this->rmct_obj->begin_batch();
+
+    while ((count < RMCT_COALESCE_MAX) && ((command = this->cmd_queue.NMT_front()) != NULL))
+    {
+        this->act_staged[count] = (rmct_stage_actions(command->msg, *this->rmct_obj) == OK);
+        memcpy(this->act_stamps[count], command->stamps, sizeof(command->stamps));
+        RMCT_trace::stamp(this->act_stamps[count][RMCT_STAGE_DISPATCH]);
+
+        if (this->act_staged[count])
+            staged++;
+        else
+            this->actuation_failures++;
+
+        this->cmd_queue.NMT_pop();
+        count++;
+    }
+
+    /* One hardware write for everything staged */
+    RMCT_trace::stamp(i2c_issue);
+    if (this->rmct_obj->commit() != OK) {this->actuation_failures += staged;}
+    RMCT_trace::stamp(i2c_complete);
+    if (staged > 1) {this->coalesced += staged - 1;}
 
-    if (mc["type"].isString())
+    std::lock_guard<std::mutex> lock(this->trace_lock);
+    for (unsigned int i = 0; i < count; i++)
     {
-        if (mc["type"].asString() == "hw_action")
+        if (this->act_staged[i])
         {
-            valid = mc["motor"].isString() && mc["direction"].isString() && 
-                    mc["angle"].isNumeric() && mc["speed"].isNumeric();
+            this->act_stamps[i][RMCT_STAGE_I2C_ISSUE]    = i2c_issue;
+            this->act_stamps[i][RMCT_STAGE_I2C_COMPLETE] = i2c_complete;
         }
-        else if (mc["type"].asString() == "proc_action")
+        this->trace.record(this->act_stamps[i]);
+    }
+
+    return count;
+}
+
+void RmctRuntime::actuation_main()
+{
+    /*!
+     *  @brief     Actuation thread - Whatever is still queued once the
+     *             loop stops is written before the thread exits
+     *  @return    void
+     */
+
+    if (this->rt_loop)
+        this->rt_loop->run();
+    else
+        this->act_reactor.NMT_run();
+
+    while (this->actuate() > 0) {}
+}
+
+void RmctRuntime::rt_tick()
+{
+    /*!
+     *  @brief     Control loop tick - Apply reloaded settings, write the
+     *             latest queued state and step the drive ramp
+     *  @return    void
+     */
+
+    this->apply_config();
+    this->actuate();
+
+    if (this->rmct_obj->drive_ramp_tick() != OK)
+        NMT_log_write(ERROR, (char *)"Ramp tick failed to update PWM");
+}
+
+void RmctRuntime::stop_actuation()
+{
+    /*!
+     *  @brief     Stop the actuation thread and wait for it to exit
+     *  @return    void
+     */
+
+    if (!this->actuation.joinable())
+        return;
+
+    if (this->rt_loop) {this->rt_loop->stop();}
+    this->act_reactor.NMT_stop();
+    this->actuation.join();
+}
+
+static bool rmct_decode_message(const NMT_sock_msg &rx_msg, RMCT_seq_filter &seq_filter, RMCT_proto_msg &msg,
+                                bool &terminate_proc, RMCT_pending_ack &pending)
+{
+    /*!
+     *  @brief      Decode one command (binary or JSON) and validate its
+     *              actions without touching the hardware. A binary hello
+     *              is acked with RMCT_PROTO_VERSION and restarts the
+     *              client's sequence numbers. A hello from client 0 is
+     *              acked with the client ID RMCT assigned it.
+     *  param[in]   rx_msg
+     *  param[in]   seq_filter
+     *  param[out]  msg (Decoded command)
+     *  param[out]  terminate_proc
+     *  param[out]  pending (Ack owed for the command)
+     *  @return     False if the command was a duplicate or stale (not acked)
+     */
+
+    /* Initialize Varibles */
+    NMT_result result = (rx_msg.truncated ? NOK : OK);
+
+    msg.client      = 0;
+    msg.seq         = 0;
+    msg.count       = 0;
+    pending.binary  = RMCT_proto_is_binary(rx_msg.buffer, rx_msg.length);
+    pending.queued  = false;
+    pending.command = NULL;
+    pending.report  = false;
+    pending.stamps[RMCT_STAGE_ACK_SEND]     = {0, 0};
+    pending.stamps[RMCT_STAGE_DISPATCH]     = {0, 0};
+    pending.stamps[RMCT_STAGE_I2C_ISSUE]    = {0, 0};
+    pending.stamps[RMCT_STAGE_I2C_COMPLETE] = {0, 0};
+
+    /* Parse straight into the action array (no DOM, no allocation) */
+    if (result == OK)
+    {
+        if (pending.binary)
+            result = RMCT_proto_decode(rx_msg.buffer, rx_msg.length, msg);
+        else
+            result = RMCT_proto_parse_json(rx_msg.buffer, rx_msg.length, msg);
+    }
+    RMCT_trace::stamp(pending.stamps[RMCT_STAGE_PARSE]);
+
+    pending.client  = msg.client;
+    pending.seq     = msg.seq;
+    pending.batched = ((pending.binary) && (result == OK) && (msg.type != RMCT_PROTO_HELLO) &&
+                       (msg.version >= RMCT_PROTO_ACK_BATCH_VERSION));
+
+    if ((result == OK) && (msg.type == RMCT_PROTO_HELLO))
+    {
+        /* Client 0 gets an ID of its own, so two clients never share a sequence */
+        if (msg.client == 0)
+            pending.client = seq_filter.assign(msg.seq);
+        else
+            seq_filter.reset(msg.client, msg.seq);
+
+        NMT_log_write(DEBUG, (char *)"Binary protocol hello client=%u version=%u", pending.client, msg.version);
+    }
+    else if ((result == OK) && (msg.type != RMCT_PROTO_ACTIONS) && (msg.type != RMCT_PROTO_EXIT) &&
+             (msg.type != RMCT_PROTO_LATENCY))
+    {
+        NMT_log_write(ERROR, (char *)"Unexpected binary message type=%u", msg.type);
+        result = NOK;
+    }
+    else if (result == OK)
+    {
+        /* UDP may duplicate or reorder - Only the newest command per client counts */
+        if (seq_filter.check(msg.client, msg.seq) != RMCT_SEQ_NEW)
         {
-            valid = mc["action"].isString();
+            NMT_log_write(DEBUG, (char *)"Dropped client=%u seq=%u", msg.client, msg.seq);
+            return false;
         }
+
+        /* The ack reports the validation, hardware failures show up in the telemetry */
+        for (unsigned int i = 0; (i < msg.count) && (result == OK); i++)
+            result = RMCT_check_motor_action(msg.actions[i]);
+
+        if (result != OK)
+            NMT_log_write(ERROR, (char *)"Invalid action client=%u seq=%u", msg.client, msg.seq);
+
+        pending.queued = ((result == OK) && (msg.count > 0));
+        pending.report = (msg.type == RMCT_PROTO_LATENCY);
+
+        if (msg.type == RMCT_PROTO_EXIT)
+            terminate_proc = true;
+    }
+
+    pending.result = result;
+    return true;
+}
+
+static NMT_result rmct_stage_actions(const RMCT_proto_msg &msg, RobotMotorController &rmct_obj)
+{
+    /*!
+     *  @brief      Stage the actions of a validated command in the open
+     *              batch. A rejected command drops only its own actions.
+     *  param[in]   msg
+     *  param[in]   rmct_obj
+     *  @return     NMT_result
+     */
+
+    NMT_result result = OK;
+
+    rmct_obj.mark_batch();
+
+    for (unsigned int i = 0; (i < msg.count) && (result == OK); i++)
+        result = rmct_obj.process_motor_action(msg.actions[i]);
+
+    if (result != OK)
+    {
+        NMT_log_write(ERROR, (char *)"Actuation failed client=%u seq=%u", msg.client, msg.seq);
+        rmct_obj.rollback_batch();
+    }
+
+    return result;
+}
+
+static void rmct_write_latency(NMT_transport &ack_transport, const RMCT_trace &trace)
+{
+    /*!
+     *  @brief      Send the latency histograms as telemetry. Answers
+     *              the latency proc_action, so it is not on the hot path.
+     *  param[in]   ack_transport
+     *  param[in]   trace
+     *  @return     void
+     */
+
+    /* Initialize Varibles */
+    Json::Value report;
+    report["type"]  = "telemetry";
+    report["event"] = "latency";
+
+    for (int i = RMCT_STAGE_RECV; i <= MAX_RMCT_TRACE_STAGES; i++)
+    {
+        const RMCT_latency_histogram &histogram = ((i < MAX_RMCT_TRACE_STAGES) ?
+                                                   trace.stage((RMCT_TRACE_STAGES)i) : trace.total());
+        const char *name = ((i < MAX_RMCT_TRACE_STAGES) ? RMCT_TRACE_STAGE_TO_STR[i] : "total");
+        Json::Value &stage = report["stages"][name];
+        unsigned int used = RMCT_TRACE_BUCKETS;
+
+        stage["count"]   = (Json::UInt64)histogram.count();
+        stage["mean_ns"] = (Json::UInt64)histogram.mean();
+        stage["p50_ns"]  = (Json::UInt64)histogram.percentile(50);
+        stage["p99_ns"]  = (Json::UInt64)histogram.percentile(99);
+        stage["max_ns"]  = (Json::UInt64)histogram.max();
+
+        /* Bucket i counts latencies below 2^i ns - Trailing empty ones are left out */
+        while ((used > 0) && (histogram.bucket(used - 1) == 0)) {used--;}
+        stage["buckets"] = Json::Value(Json::arrayValue);
+        for (unsigned int b = 0; b < used; b++)
+            stage["buckets"].append((Json::UInt64)histogram.bucket(b));
     }
-        
-    /* Check and Exit the Function */
-    NMT_log_write (DEBUG, (char *)"< valid=%s", btoa(valid));
-    return valid;
+
+    ack_transport.NMT_write_message(report.toStyledString().c_str());
+}
+
+static void rmct_watchdog_expired(NMT_transport &ack_transport, const RMCT_watchdog &watchdog,
+                                  NMT_result stop_result)
+{
+    /*!
+     *  @brief      Called from the network thread once the actuation
+     *              thread stopped all motors because no command arrived
+     *              within the deadline. Reports it.
+     *  param[in]   ack_transport
+     *  param[in]   watchdog
+     *  param[in]   stop_result (Result of the emergency stop)
+     *  @return     void
+     */
+
+    Json::Value telemetry;
+
+    telemetry["type"]        = "telemetry";
+    telemetry["event"]       = "watchdog_expired";
+    telemetry["deadline_ms"] = (Json::UInt)watchdog.get_deadline().count();
+    telemetry["expiries"]    = watchdog.expiries();
+    telemetry["result"]      = stop_result;
+
+    ack_transport.NMT_write_message(telemetry.toStyledString().c_str());
 }
 
 static NMT_result rmct_get_robot_settings(RSXA &hw_settings, RMCT_hw_settings &rmct_hw_settings)
@@ -264,53 +1261,28 @@ static NMT_result rmct_get_robot_settings(RSXA &hw_settings, RMCT_hw_settings &r
    
     /** Initialize Varibles */
     NMT_result result = OK;
-    int mc = 0;
 
     /** Main Operation */
-    if (result == OK)
-    {
-        for (int i = 0; i < hw_settings.array_len_hw; i++)
-        {
-            if (strcmp(hw_settings.hw[i].hw_name, PCA9685_HW_NAME) == 0)
-            {
-                memcpy(&(rmct_hw_settings.pca9685_hw_config), &(hw_settings.hw[i]), sizeof(hw_settings.hw[i]));
-                mc++;
-            }
-            else if (strcmp(hw_settings.hw[i].hw_name, LEFT_DRV_MTR.c_str()) == 0)
-            {
-                memcpy(&(rmct_hw_settings.left_motor_hw_config), &(hw_settings.hw[i]), sizeof(hw_settings.hw[i]));
-                mc++;
-            }
-            else if (strcmp(hw_settings.hw[i].hw_name, RIGHT_DRV_MTR.c_str()) == 0)
-            {
-                memcpy(&(rmct_hw_settings.right_motor_hw_config), &(hw_settings.hw[i]), sizeof(hw_settings.hw[i]));
-                mc++;
-            }
-            else if (strcmp(hw_settings.hw[i].hw_name, LD27MG_HW_NAME) == 0)
-            {
-                memcpy(&(rmct_hw_settings.cam_motor_hw_config), &(hw_settings.hw[i]), sizeof(hw_settings.hw[i]));
-                mc++;
-            }
-
-            if (mc == NO_OF_HW) {break;}
-        }
+    const RSXA_hw *pca9685_hw     = RSXA_find_hw(&hw_settings, PCA9685_HW_NAME);
+    const RSXA_hw *left_motor_hw  = RSXA_find_hw(&hw_settings, LEFT_DRV_MTR.c_str());
+    const RSXA_hw *right_motor_hw = RSXA_find_hw(&hw_settings, RIGHT_DRV_MTR.c_str());
+    const RSXA_hw *cam_motor_hw   = RSXA_find_hw(&hw_settings, LD27MG_HW_NAME);
+    const RSXA_procs *rmct_task   = RSXA_find_proc(&hw_settings, MY_NAME);
 
-        for (int i = 0; i < hw_settings.array_len_procs; i++)
-        {
-            if (strcmp(hw_settings.procs[i].proc_name, MY_NAME) == 0)
-            {
-                memcpy(&(rmct_hw_settings.rmct_task_config), &(hw_settings.procs[i]), sizeof(hw_settings.procs[i]));
-                mc++;
-                break;
-            }
-        }
-
-        /** Verify we found all the settings needed */
-        if (mc != NO_OF_HW + 1)
-        {
-            cout << "ERROR, Missing Configuration data in RSXA.json file" << endl;
-            result = NOK;
-        }
+    /** Verify we found all the settings needed */
+    if ((pca9685_hw == NULL) || (left_motor_hw == NULL) || (right_motor_hw == NULL) ||
+        (cam_motor_hw == NULL) || (rmct_task == NULL))
+    {
+        cout << "ERROR, Missing Configuration data in RSXA.json file" << endl;
+        result = NOK;
+    }
+    else
+    {
+        rmct_hw_settings.pca9685_hw_config     = *pca9685_hw;
+        rmct_hw_settings.left_motor_hw_config  = *left_motor_hw;
+        rmct_hw_settings.right_motor_hw_config = *right_motor_hw;
+        rmct_hw_settings.cam_motor_hw_config   = *cam_motor_hw;
+        rmct_hw_settings.rmct_task_config      = *rmct_task;
     }
 
     /* Exit the function */
@@ -326,6 +1298,7 @@ static void rmct_control_print_usage(int es)
      *  @return   status
      */
 
-    cout << "-v verbosity || -h/help menu" << endl;
+    cout << "-v verbosity || -w <ms> command deadline (0 is off) || -n no io_uring || -r <Hz> real-time control loop "
+         << "|| -c <cpu> control loop CPU || -h/help menu" << endl;
     exit(es);
 }
@@ -0,0 +1,62 @@
+/*rsxa-compile.c:  Validate RSXA.json once and write the binary image
+                   RSXA_init maps instead of parsing the JSON
+
+__author__       = "Nitin Mohan
+__copyright__    = "Copy Right 2020. NM Technologies" */
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "NMT_stdlib.h"
+#include "RSXA.h"
+
+static void print_usage(int es);
+
+int main(int argc, char *argv[])
+{
+    //Initialize Variables
+    int opt;
+    const char *json_path  = RS_SETTINGS_PATH;
+    const char *image_path = RS_IMAGE_PATH;
+    NMT_result result      = OK;
+
+    //Parse input arguments and take appropriate action
+    while ((opt = getopt(argc, argv, "hi:o:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'i':
+                json_path = optarg;
+                break;
+            case 'o':
+                image_path = optarg;
+                break;
+            case 'h':
+                printf("Help Menu\n");
+                print_usage(0);
+                break;
+            case '?':
+                printf("Unknown Argument Provided\n");
+                print_usage(1);
+                break;
+        }
+    }
+
+    result = RSXA_compile(json_path, image_path);
+    printf("Compiled: %s -> %s and the result=%s\n", json_path, image_path, result_e2s[result]);
+
+    return (result == OK ? 0 : 1);
+}
+
+static void print_usage(int es)
+{
+    printf("JSON settings -i <RSXA.json> || image -o <RSXA.bin> || help -h\n");
+    exit(es);
+}
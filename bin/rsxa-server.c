@@ -0,0 +1,108 @@
+/*rsxa-server.c:   Publish RSXA.json in shared memory and republish it
+                   on every edit, so RSXA_init copies the settings
+                   instead of opening and parsing files
+
+__author__       = "Nitin Mohan
+__copyright__    = "Copy Right 2020. NM Technologies" */
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <signal.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "NMT_stdlib.h"
+#include "RSXA.h"
+
+static volatile sig_atomic_t running = 1;
+
+static void print_usage(int es);
+static void stop_server(int signum);
+
+int main(int argc, char *argv[])
+{
+    //Initialize Variables
+    //Readers check the segment against RS_SETTINGS_PATH, so only that file is published
+    int opt;
+    const char *json_path = RS_SETTINGS_PATH;
+    const char *shm_name  = RS_SHM_NAME;
+    NMT_result result     = OK;
+    struct sigaction sa   = {0};
+    struct pollfd pfd;
+
+    //Parse input arguments and take appropriate action
+    while ((opt = getopt(argc, argv, "hs:")) != -1)
+    {
+        switch (opt)
+        {
+            case 's':
+                shm_name = optarg;
+                break;
+            case 'h':
+                printf("Help Menu\n");
+                print_usage(0);
+                break;
+            case '?':
+                printf("Unknown Argument Provided\n");
+                print_usage(1);
+                break;
+        }
+    }
+
+    //No SA_RESTART - A signal wakes up poll
+    sa.sa_handler = stop_server;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    //Watch before publishing so an edit in between is not missed
+    pfd.fd     = RSXA_watch(json_path);
+    pfd.events = POLLIN;
+
+    if (pfd.fd < 0)
+    {
+        printf("Unable to watch %s\n", json_path);
+        return 1;
+    }
+
+    result = RSXA_publish(json_path, shm_name);
+    printf("Published: %s -> %s generation=%llu and the result=%s\n", json_path, shm_name,
+           (unsigned long long)RSXA_shm_generation(shm_name), result_e2s[result]);
+
+    //An invalid edit keeps the last good settings published
+    while (running)
+    {
+        if ((poll(&pfd, 1, -1) > 0) && (RSXA_watch_changed(pfd.fd, json_path)))
+        {
+            result = RSXA_publish(json_path, shm_name);
+            printf("Published: %s -> %s generation=%llu and the result=%s\n", json_path, shm_name,
+                   (unsigned long long)RSXA_shm_generation(shm_name), result_e2s[result]);
+        }
+    }
+
+    //Readers fall back to the image or the JSON
+    close(pfd.fd);
+    shm_unlink(shm_name);
+    printf("Unpublished: %s\n", shm_name);
+
+    return 0;
+}
+
+static void stop_server(int signum)
+{
+    (void)signum;
+    running = 0;
+}
+
+static void print_usage(int es)
+{
+    printf("shared memory -s <name> || help -h\n");
+    exit(es);
+}
@@ -14,6 +14,9 @@
 /                   System Imports                  /
 /--------------------------------------------------*/
 #include <map>
+#include <mutex>
+#include <vector>
+#include <chrono>
 
 /*--------------------------------------------------/
 /                   Local Imports                   /
@@ -28,6 +31,22 @@
  *  Default motor speed the robot moves at */
 const double DEFAULT_SPEED = 50;
 
+/** @var DEFAULT_SLEW_RATE
+ *  Default rate (duty %/sec) the drive motors ramp at */
+const double DEFAULT_SLEW_RATE = 200;
+
+/** @var DEFAULT_DEAD_TIME
+ *  Default time (ms) both outputs are held off before reversing */
+const double DEFAULT_DEAD_TIME = 500;
+
+/** @var DEFAULT_RAMP_TICK_RATE
+ *  Default rate (Hz) of the shared ramp tick */
+const double DEFAULT_RAMP_TICK_RATE = 50;
+
+/** @var L9110_MAX_UPDATES
+ *  Max PWM channel updates one motor produces per ramp step */
+const unsigned int L9110_MAX_UPDATES = 2;
+
 /** @enum directions
  *  Possible directions the Robot can move */
 typedef enum {FORWARD, REVERSE, STOP} L9110_DIRECTIONS;
@@ -36,6 +55,23 @@ typedef enum {FORWARD, REVERSE, STOP} L9110_DIRECTIONS;
  *  Facility to convert direction enum to string */
 const std::string L9110_DIR_TO_STR[] = {"FORWARD", "REVERSE", "STOP"};
 
+/** @struct L9110_ramp_settings
+ *  Acceleration limits applied while ramping a motor */
+typedef struct L9110_ramp_settings
+{
+    /** @var slew_rate
+     *  Max change in duty cycle (%/sec) */
+    double slew_rate;
+
+    /** @var dead_time
+     *  Time (ms) both outputs stay off on a direction reversal */
+    double dead_time;
+} L9110_ramp_settings;
+
+/** @var L9110_DEFAULT_RAMP
+ *  Default ramp settings */
+const L9110_ramp_settings L9110_DEFAULT_RAMP = {DEFAULT_SLEW_RATE, DEFAULT_DEAD_TIME};
+
 /** @class L9110 
  *  Driver Object */
 class L9110
@@ -46,19 +82,73 @@ class L9110
         std::string hw_name;
 
         /* Constructor */ 
-        L9110(RSXA_hw hw_config);
+        L9110(RSXA_hw hw_config, L9110_ramp_settings ramp_settings = L9110_DEFAULT_RAMP, bool init_hw = true);
 
         /* Destructor */
         ~L9110() {}
 
         /* Prototypes */
+        NMT_result L9110_init();
         NMT_result L9110_move_motor(L9110_DIRECTIONS direction, int speed=DEFAULT_SPEED);
+        NMT_result L9110_ramp_motor(L9110_DIRECTIONS direction, int speed=DEFAULT_SPEED);
+        unsigned int L9110_ramp_step(double elapsed_ms, PCA9685_pwm_update *updates);
+        void L9110_ramp_ack();
+        void L9110_halt();
+        NMT_result L9110_reconfigure(RSXA_hw hw_config);
 
     private:
         /** @var sim_mode
          *  Simulation Mode of the Hardware */
         bool sim_mode;
 
+        /** @var ramp
+         *  Acceleration limits for this motor */
+        L9110_ramp_settings ramp;
+
+        /** @var ramp_lock
+         *  Guards the ramp state between the caller and the ramp tick */
+        std::mutex ramp_lock;
+
+        /** @var drive_dir
+         *  Direction the H-Bridge is currently driven in */
+        L9110_DIRECTIONS drive_dir = STOP;
+
+        /** @var drive_duty
+         *  Duty cycle currently applied to the active output */
+        double drive_duty = 0;
+
+        /** @var target_dir
+         *  Direction the motor is ramping towards */
+        L9110_DIRECTIONS target_dir = STOP;
+
+        /** @var target_duty
+         *  Duty cycle the motor is ramping towards */
+        double target_duty = 0;
+
+        /** @var coast_dir
+         *  Direction the motor was last driven in before coming to rest */
+        L9110_DIRECTIONS coast_dir = STOP;
+
+        /** @var dead_time_left
+         *  Remaining dead time (ms) before a reversal may start */
+        double dead_time_left = 0;
+
+        /** @var out_forward
+         *  Duty cycle last written to the forward channel */
+        double out_forward = 0;
+
+        /** @var out_reverse
+         *  Duty cycle last written to the reverse channel */
+        double out_reverse = 0;
+
+        /** @var step_forward
+         *  Forward duty cycle of the last step, written on L9110_ramp_ack */
+        double step_forward = 0;
+
+        /** @var step_reverse
+         *  Reverse duty cycle of the last step, written on L9110_ramp_ack */
+        double step_reverse = 0;
+
         /** @var forward
          *  Pin Mapping for forward PWM Channel */
         PCA9685_PWM_CHANNEL  forward;
@@ -67,4 +157,64 @@ class L9110
          *  Pin Mapping for reverse PWM CHannel */
         PCA9685_PWM_CHANNEL  reverse;
 };
+
+/** @struct L9110_ramp_target
+ *  New ramp target for one motor, applied by L9110_ramp_scheduler::commit */
+typedef struct L9110_ramp_target
+{
+    /** @var motor
+     *  Motor to ramp */
+    L9110 *motor;
+
+    /** @var direction
+     *  Direction to ramp towards */
+    L9110_DIRECTIONS direction;
+
+    /** @var speed
+     *  Speed to ramp towards */
+    int speed;
+} L9110_ramp_target;
+
+/** @class L9110_ramp_scheduler
+ *  Steps every attached motor from one shared fixed-rate tick and
+ *  collects the resulting channel changes into one batch for the
+ *  caller to write */
+class L9110_ramp_scheduler
+{
+    public:
+        /* Constructor */
+        L9110_ramp_scheduler(double tick_rate = DEFAULT_RAMP_TICK_RATE);
+
+        /* Prototypes */
+        void attach_motor(L9110 *motor);
+        NMT_result tick(PCA9685_pwm_update *updates, unsigned int *update_count);
+        NMT_result commit(const L9110_ramp_target *targets, unsigned int target_count,
+                          PCA9685_pwm_update *updates, unsigned int *update_count);
+        void ack();
+        void halt();
+
+    private:
+        /** @var tick_period
+         *  Time between ramp ticks */
+        std::chrono::microseconds tick_period;
+
+        /** @var last_step
+         *  Time the motors were last stepped */
+        std::chrono::steady_clock::time_point last_step;
+
+        /** @var stepped
+         *  True once the motors have been stepped at least once */
+        bool stepped = false;
+
+        /** @var motors
+         *  Motors stepped on every tick */
+        std::vector<L9110 *> motors;
+
+        /** @var lock
+         *  Serializes ticks with attach_motor */
+        std::mutex lock;
+
+        /* Prototypes */
+        unsigned int collect_steps(PCA9685_pwm_update *updates);
+};
 #endif
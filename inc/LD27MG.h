@@ -49,8 +49,12 @@
 
         NMT_result LD27MG_get_current_position(LD27MG_MOTORS motor, double *angle);
 
+        unsigned int LD27MG_stage_move(LD27MG_MOTORS motor, double angle, PCA9685_pwm_update *update);
+
         NMT_result LD27MG_init(RSXA_hw hw_config);
 
+        NMT_result LD27MG_reconfigure(RSXA_hw hw_config);
+
 #ifdef __cplusplus
     }
 #endif
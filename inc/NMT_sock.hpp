@@ -13,6 +13,17 @@
 /                   System Imports                  /
 /--------------------------------------------------*/
 #include <arpa/inet.h>
+#include <sys/types.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
 
 /*--------------------------------------------------/
 /                   Local Imports                   /
@@ -22,12 +33,106 @@
 
 typedef enum sock_mode {SOCK_CLIENT, SOCK_SERVER}sock_mode;
 
-class NMT_sock_multicast
+/** @var NMT_SOCK_MAX_MSG
+ *  Default receive buffer size */
+const unsigned int NMT_SOCK_MAX_MSG = 10240;
+
+/** @var NMT_SOCK_MAX_BATCH
+ *  Max datagrams moved per recvmmsg/sendmmsg call */
+const unsigned int NMT_SOCK_MAX_BATCH = 32;
+
+/** @var NMT_SOCK_LOCAL_DIR
+ *  Directory for the AF_UNIX endpoints and shared memory doorbells */
+#define NMT_SOCK_LOCAL_DIR "/tmp"
+
+/** @var NMT_SHM_SLOTS
+ *  Messages a shared memory ring holds (power of 2) */
+const unsigned int NMT_SHM_SLOTS = 32;
+
+/** @enum NMT_transport_type
+ *  Transports selectable per proc (RSXA procs "transport") */
+typedef enum {NMT_TRANSPORT_UDP, NMT_TRANSPORT_UNIX, NMT_TRANSPORT_SHM, MAX_NMT_TRANSPORTS} NMT_transport_type;
+
+/** @var NMT_TRANSPORT_TO_STR
+ *  Name of each transport in RSXA.json */
+const char *const NMT_TRANSPORT_TO_STR[MAX_NMT_TRANSPORTS] = {"udp", "unix", "shm"};
+
+/** @struct NMT_sock_msg
+ *  One datagram slot for the batch read/write calls. The buffer is
+ *  owned by the caller and can be reused across calls. */
+typedef struct NMT_sock_msg
+{
+    /** @var buffer
+     *  Message data (nul terminated after a read) */
+    char *buffer;
+
+    /** @var capacity
+     *  Size of buffer (one byte is kept for the terminator on reads) */
+    size_t capacity;
+
+    /** @var length
+     *  Bytes in the message */
+    size_t length;
+
+    /** @var truncated
+     *  Set on a read when the datagram did not fit in the buffer */
+    bool truncated;
+
+    /** @var rx_time
+     *  Set on a read to when the message arrived (CLOCK_REALTIME). Sockets
+     *  report the kernel receive time (SO_TIMESTAMPNS), shared memory the
+     *  time it was queued and io_uring the time the completion was reaped */
+    struct timespec rx_time = {0, 0};
+} NMT_sock_msg;
+
+/** @class NMT_transport
+ *  Datagram transport used by the processes. NMT_get_fd() is the fd to
+ *  wait on (e.g. with NMT_reactor) before a non-blocking read. A
+ *  transport owns its fds, so it is never copied. */
+class NMT_transport
+{
+    public:
+        /* Constructor */
+        NMT_transport() = default;
+        NMT_transport(const NMT_transport &) = delete;
+        NMT_transport &operator=(const NMT_transport &) = delete;
+
+        /* Destructor */
+        virtual ~NMT_transport() {}
+
+        /* Functions to move several datagrams per call */
+        virtual NMT_result NMT_read_batch(NMT_sock_msg *msgs, unsigned int max_msgs, unsigned int *count,
+                                          bool wait = true) = 0;
+        virtual NMT_result NMT_write_batch(const NMT_sock_msg *msgs, unsigned int count) = 0;
+
+        /* Function to send one nul terminated message */
+        NMT_result NMT_write_message(const char *message)
+        {
+            NMT_sock_msg msg = {(char *)message, strlen(message), strlen(message), false};
+            return NMT_write_batch(&msg, 1);
+        }
+
+        /* Getter function to return the fd that becomes readable with data */
+        virtual int NMT_get_fd() = 0;
+
+        /* Getter function to return the result */
+        virtual NMT_result NMT_get_result() = 0;
+};
+
+/** @class NMT_sock_multicast
+ *  UDP multicast transport. Owns its socket (closed on destruction);
+ *  it can be moved but not copied. */
+class NMT_sock_multicast : public NMT_transport
 {
     public:
         /* Constructor */
         NMT_sock_multicast(unsigned int port, std::string multicast_ip,
                            sock_mode socket_mode, unsigned int socket_timeout = 60);
+        NMT_sock_multicast(NMT_sock_multicast &&other) noexcept;
+        NMT_sock_multicast &operator=(NMT_sock_multicast &&other) noexcept;
+
+        /* Destructor */
+        ~NMT_sock_multicast();
 
         /* Function to send message over the socket */
         NMT_result NMT_write_socket(char *message);
@@ -35,8 +140,37 @@ class NMT_sock_multicast
         /* Function to read message on the socket */
         NMT_result NMT_read_socket(char **message);
 
+        /* Function to read message straight into a caller-owned buffer */
+        NMT_result NMT_read_socket(NMT_sock_msg *msg);
+
+        /* Functions to move several datagrams per syscall */
+        NMT_result NMT_read_socket_batch(NMT_sock_msg *msgs, unsigned int max_msgs, unsigned int *count,
+                                         bool wait = true);
+        NMT_result NMT_write_socket_batch(const NMT_sock_msg *msgs, unsigned int count);
+
+        /* NMT_transport */
+        NMT_result NMT_read_batch(NMT_sock_msg *msgs, unsigned int max_msgs, unsigned int *count,
+                                  bool wait = true) override
+        {
+            return NMT_read_socket_batch(msgs, max_msgs, count, wait);
+        }
+
+        NMT_result NMT_write_batch(const NMT_sock_msg *msgs, unsigned int count) override
+        {
+            return NMT_write_socket_batch(msgs, count);
+        }
+
         /* Getter function to return the result */
-        NMT_result NMT_get_result() {return this->result;}
+        NMT_result NMT_get_result() override {return this->result;}
+
+        /* Getter function to return the socket (e.g. for NMT_reactor) */
+        int NMT_get_fd() override {return this->sock;}
+
+        /* Getter function to return the read timeout (sec) */
+        unsigned int NMT_get_timeout() {return this->socket_timeout;}
+
+        /* Getter function to return the address datagrams are sent to */
+        const struct sockaddr_in *NMT_get_address() {return &(this->my_address);}
 
     private:
         /** @var result
@@ -53,7 +187,7 @@ class NMT_sock_multicast
 
         /** @var sock
          *  Socket object */
-        int sock; 
+        int sock = -1;
 
         /** @var socket_timeout
          *  Time out for Client */
@@ -75,5 +209,204 @@ class NMT_sock_multicast
 
 };
 
+/** @class NMT_sock_unix
+ *  Same host transport over an AF_UNIX SOCK_SEQPACKET socket named after
+ *  the port. SOCK_CLIENT listens and reads from every peer that connects
+ *  (NMT_get_fd() is an epoll fd over all of them), SOCK_SERVER connects
+ *  on the first write and again after the reader goes away. */
+class NMT_sock_unix : public NMT_transport
+{
+    public:
+        /* Constructor */
+        NMT_sock_unix(unsigned int port, sock_mode socket_mode, unsigned int socket_timeout = 60);
+
+        /* Destructor */
+        ~NMT_sock_unix();
+
+        /* Not copyable - Owns the fds */
+        NMT_sock_unix(const NMT_sock_unix &) = delete;
+        NMT_sock_unix &operator=(const NMT_sock_unix &) = delete;
+
+        /* NMT_transport */
+        NMT_result NMT_read_batch(NMT_sock_msg *msgs, unsigned int max_msgs, unsigned int *count,
+                                  bool wait = true) override;
+        NMT_result NMT_write_batch(const NMT_sock_msg *msgs, unsigned int count) override;
+        int NMT_get_fd() override {return (this->mode == SOCK_CLIENT ? this->epoll_fd : this->sock);}
+        NMT_result NMT_get_result() override {return this->result;}
+
+    private:
+        /** @var result
+         *  Varible to set the overall state of the object */
+        NMT_result result = OK;
+
+        /** @var mode
+         *  Mode of socket */
+        sock_mode mode;
+
+        /** @var socket_timeout
+         *  Time out for Client */
+        unsigned int socket_timeout;
+
+        /** @var path
+         *  Socket path */
+        std::string path;
+
+        /** @var path_ino
+         *  Inode of the socket this reader bound */
+        ino_t path_ino = 0;
+
+        /** @var sock
+         *  Listening (client) or connected (server) socket */
+        int sock = -1;
+
+        /** @var epoll_fd
+         *  Listening socket and the connected peers (client) */
+        int epoll_fd = -1;
+
+        /** @var peers
+         *  Connected writers (client) */
+        std::vector<int> peers;
+
+        /* Prototypes */
+        NMT_result NMT_connect();
+        void NMT_accept();
+        void NMT_drop_peer(int peer);
+};
+
+/** @class NMT_sock_shm
+ *  Same host transport over a lock-free single producer/single consumer
+ *  ring in POSIX shared memory named after the port. SOCK_SERVER is the
+ *  producer, SOCK_CLIENT the consumer. A FIFO doorbell is only rung when
+ *  the consumer is idle, so a busy stream moves without syscalls and the
+ *  consumer can still sleep in NMT_reactor on NMT_get_fd(). */
+class NMT_sock_shm : public NMT_transport
+{
+    public:
+        /* Constructor */
+        NMT_sock_shm(unsigned int port, sock_mode socket_mode, unsigned int socket_timeout = 60);
+
+        /* Destructor */
+        ~NMT_sock_shm();
+
+        /* Not copyable - Owns the mapping */
+        NMT_sock_shm(const NMT_sock_shm &) = delete;
+        NMT_sock_shm &operator=(const NMT_sock_shm &) = delete;
+
+        /* NMT_transport */
+        NMT_result NMT_read_batch(NMT_sock_msg *msgs, unsigned int max_msgs, unsigned int *count,
+                                  bool wait = true) override;
+        NMT_result NMT_write_batch(const NMT_sock_msg *msgs, unsigned int count) override;
+        int NMT_get_fd() override {return this->bell_fd;}
+        NMT_result NMT_get_result() override {return this->result;}
+
+    private:
+        /** @var result
+         *  Varible to set the overall state of the object */
+        NMT_result result = OK;
+
+        /** @var mode
+         *  Mode of socket */
+        sock_mode mode;
+
+        /** @var socket_timeout
+         *  Time out for Client */
+        unsigned int socket_timeout;
+
+        /** @var bell_path
+         *  Doorbell FIFO */
+        std::string bell_path;
+
+        /** @var ring
+         *  Mapped ring (NMT_shm_ring in NMT_sock.cpp) */
+        void *ring = NULL;
+
+        /** @var ring_size
+         *  Size of the mapping */
+        size_t ring_size = 0;
+
+        /** @var bell_fd
+         *  Doorbell read end (consumer) or write end (producer) */
+        int bell_fd = -1;
+
+        /** @var bell_keep_fd
+         *  Consumer held write end - Keeps the FIFO from reporting hang up */
+        int bell_keep_fd = -1;
+
+        /* Prototypes */
+        bool NMT_ring_bell(int fd);
+        void NMT_drain_bell();
+};
+
+/* Function to open the transport a proc asked for in RSXA.json */
+std::unique_ptr<NMT_transport> NMT_sock_open(const char *transport, unsigned int port, std::string ip,
+                                             sock_mode socket_mode, unsigned int socket_timeout = 60);
+
+/** @typedef NMT_reactor_handler
+ *  Called with the epoll events (for fds) or the count (for timers/events) */
+typedef std::function<void(uint64_t)> NMT_reactor_handler;
+
+/** @class NMT_reactor
+ *  Single threaded epoll event loop. File descriptors, periodic timers
+ *  (timerfd) and wakeup events (eventfd) are dispatched from run(). */
+class NMT_reactor
+{
+    public:
+        /* Constructor */
+        NMT_reactor();
+        NMT_reactor(const NMT_reactor &) = delete;
+        NMT_reactor &operator=(const NMT_reactor &) = delete;
+
+        /* Destructor */
+        ~NMT_reactor();
+
+        /* Registration */
+        NMT_result NMT_add_fd(int fd, uint32_t events, NMT_reactor_handler handler);
+        int        NMT_add_timer(std::chrono::microseconds period, NMT_reactor_handler handler);
+        int        NMT_add_event(NMT_reactor_handler handler);
+        NMT_result NMT_notify(int event_fd);
+
+        /* Event loop */
+        NMT_result NMT_run_once(int timeout_ms);
+        NMT_result NMT_run();
+        void       NMT_stop();
+
+        /* Getter function to return the result */
+        NMT_result NMT_get_result() {return this->result;}
+
+    private:
+        /** @struct reactor_entry
+         *  A registered fd and its handler */
+        typedef struct reactor_entry
+        {
+            int fd;
+            bool owned;
+            bool counter;
+            NMT_reactor_handler handler;
+        } reactor_entry;
+
+        /** @var result
+         *  Varible to set the overall state of the object */
+        NMT_result result = OK;
+
+        /** @var epoll_fd
+         *  epoll instance */
+        int epoll_fd;
+
+        /** @var stop_fd
+         *  eventfd used to stop run() from any thread */
+        int stop_fd;
+
+        /** @var running
+         *  True while run() loops */
+        bool running = false;
+
+        /** @var entries
+         *  Registered fds (index is the epoll data). A deque so a handler
+         *  that registers more fds is not moved while it runs */
+        std::deque<reactor_entry> entries;
+
+        /* Prototypes */
+        NMT_result NMT_register(int fd, uint32_t events, bool owned, bool counter, NMT_reactor_handler handler);
+};
 
 #endif
@@ -0,0 +1,139 @@
+/**
+ *  @file      NMT_spsc.hpp
+ *  @brief     Lock-free single producer/single consumer queue
+ *  @details   Bounded queue for handing work between two threads
+ *             without locks or allocation
+ *  @author    Nitin Mohan
+ *  @date      April 22, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+#ifndef DEF_NMT_spsc
+#define DEF_NMT_spsc
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+/*--------------------------------------------------/
+/                   Classes                         /
+/--------------------------------------------------*/
+/** @class NMT_spsc_queue
+ *  Ring of Depth (power of 2) items. Only one thread may produce
+ *  (NMT_reserve/NMT_publish/NMT_push) and only one may consume
+ *  (NMT_front/NMT_pop). Items are built in place: the producer fills
+ *  reserved slots and publishes them together, the consumer reads the
+ *  front slot and pops it when done with it. */
+template <class T, unsigned int Depth>
+class NMT_spsc_queue
+{
+    static_assert((Depth > 0) && ((Depth & (Depth - 1)) == 0), "Depth must be a power of 2");
+
+    public:
+        /* Producer */
+        T *NMT_reserve(unsigned int offset)
+        {
+            /*!
+             *  @brief     Slot offset places past the last published one
+             *  @param[in] offset
+             *  @return    Slot to fill, or NULL if the queue is too full
+             */
+
+            uint64_t tail = this->tail.load(std::memory_order_relaxed);
+
+            if (tail + offset - this->head_cache >= Depth)
+            {
+                this->head_cache = this->head.load(std::memory_order_acquire);
+                if (tail + offset - this->head_cache >= Depth)
+                    return NULL;
+            }
+
+            return &(this->slots[(tail + offset) & (Depth - 1)]);
+        }
+
+        void NMT_publish(unsigned int count)
+        {
+            /*!
+             *  @brief     Hand the first count reserved slots to the consumer
+             *  @param[in] count
+             *  @return    void
+             */
+
+            this->tail.store(this->tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+        }
+
+        bool NMT_push(const T &item)
+        {
+            /*!
+             *  @brief     Copy one item in and publish it
+             *  @param[in] item
+             *  @return    False if the queue is full
+             */
+
+            T *slot = NMT_reserve(0);
+            if (!slot)
+                return false;
+
+            *slot = item;
+            NMT_publish(1);
+            return true;
+        }
+
+        /* Consumer */
+        T *NMT_front()
+        {
+            /*!
+             *  @brief     Oldest published item
+             *  @return    Item, or NULL if the queue is empty
+             */
+
+            uint64_t head = this->head.load(std::memory_order_relaxed);
+
+            if (head == this->tail_cache)
+            {
+                this->tail_cache = this->tail.load(std::memory_order_acquire);
+                if (head == this->tail_cache)
+                    return NULL;
+            }
+
+            return &(this->slots[head & (Depth - 1)]);
+        }
+
+        void NMT_pop()
+        {
+            /*!
+             *  @brief     Give the front slot back to the producer
+             *  @return    void
+             */
+
+            this->head.store(this->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /* Getters */
+        static constexpr unsigned int NMT_depth() {return Depth;}
+
+    private:
+        /** @var slots
+         *  Items */
+        T slots[Depth];
+
+        /** @var head
+         *  Next item to consume (only written by the consumer) */
+        alignas(64) std::atomic<uint64_t> head{0};
+
+        /** @var tail_cache
+         *  Consumer's last view of tail */
+        uint64_t tail_cache = 0;
+
+        /** @var tail
+         *  Next slot to publish (only written by the producer) */
+        alignas(64) std::atomic<uint64_t> tail{0};
+
+        /** @var head_cache
+         *  Producer's last view of head */
+        uint64_t head_cache = 0;
+};
+
+#endif
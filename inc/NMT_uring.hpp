@@ -0,0 +1,176 @@
+/**
+ *  @file      NMT_uring.hpp
+ *  @brief     Header file for NMT_uring.cpp
+ *  @details   io_uring backed NMT_transport for NMT_sock_multicast
+ *  @author    Nitin Mohan
+ *  @date      April 19, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+#ifndef DEF_NMT_uring
+#define DEF_NMT_uring
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "NMT_stdlib.h"
+#include "NMT_sock.hpp"
+
+/* Kernel ABI types (linux/io_uring.h) */
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+/*--------------------------------------------------/
+/                   Constants                       /
+/--------------------------------------------------*/
+/** @var NMT_URING_RX_BUFFERS
+ *  Receive buffers registered with the kernel (power of 2) */
+const unsigned int NMT_URING_RX_BUFFERS = 16;
+
+/** @var NMT_URING_TX_SLOTS
+ *  Datagrams that can be in flight on the send side */
+const unsigned int NMT_URING_TX_SLOTS = 16;
+
+/** @var NMT_URING_SQ_IDLE
+ *  Time (ms) the kernel SQ thread spins before it sleeps */
+const unsigned int NMT_URING_SQ_IDLE = 2000;
+
+/*--------------------------------------------------/
+/                   Classes                         /
+/--------------------------------------------------*/
+/** @class NMT_uring_transport
+ *  Reads datagrams from rx_sock with a multishot receive into buffers
+ *  registered once with the kernel, and sends on tx_sock from a fixed
+ *  pool of send slots. With the SQ thread running, steady state reads
+ *  and writes make no syscalls. When io_uring is not available (old
+ *  kernel, seccomp, built with NMT_NO_URING) every call falls back to
+ *  the sockets themselves - see NMT_is_uring(). */
+class NMT_uring_transport : public NMT_transport
+{
+    public:
+        /* Constructors */
+        NMT_uring_transport(NMT_sock_multicast &sock, bool sq_poll = true);
+        NMT_uring_transport(NMT_sock_multicast &rx_sock, NMT_sock_multicast &tx_sock, bool sq_poll = true);
+
+        /* Destructor */
+        ~NMT_uring_transport();
+
+        /* Not copyable - The kernel holds pointers into this object */
+        NMT_uring_transport(const NMT_uring_transport &) = delete;
+        NMT_uring_transport &operator=(const NMT_uring_transport &) = delete;
+
+        /* NMT_transport */
+        NMT_result NMT_read_batch(NMT_sock_msg *msgs, unsigned int max_msgs, unsigned int *count,
+                                  bool wait = true) override;
+        NMT_result NMT_write_batch(const NMT_sock_msg *msgs, unsigned int count) override;
+        int NMT_get_fd() override;
+        NMT_result NMT_get_result() override
+        {
+            return (((this->rx_sock.NMT_get_result() == OK) && (this->tx_sock.NMT_get_result() == OK)) ? OK : NOK);
+        }
+
+        /* Getters */
+        bool NMT_is_uring() {return this->ring_fd >= 0;}
+        bool NMT_is_sq_poll() {return this->sq_poll;}
+
+    private:
+        /** @struct uring_rx_done
+         *  Completed receive waiting to be copied out */
+        typedef struct uring_rx_done
+        {
+            uint16_t bid;
+            uint32_t length;
+            struct timespec rx_time;
+        } uring_rx_done;
+
+        /** @struct uring_tx_slot
+         *  Send slot - The kernel reads hdr/iov/data until completion */
+        typedef struct uring_tx_slot
+        {
+            struct msghdr hdr;
+            struct iovec iov;
+            bool busy;
+        } uring_tx_slot;
+
+        /** @var rx_sock
+         *  Socket datagrams are received on */
+        NMT_sock_multicast &rx_sock;
+
+        /** @var tx_sock
+         *  Socket datagrams are sent on */
+        NMT_sock_multicast &tx_sock;
+
+        /** @var ring_fd
+         *  io_uring instance (-1 in fallback mode) */
+        int ring_fd = -1;
+
+        /** @var event_fd
+         *  eventfd the kernel signals on every completion */
+        int event_fd = -1;
+
+        /** @var sq_poll
+         *  True when a kernel thread polls the submission queue */
+        bool sq_poll = false;
+
+        /* Submission queue (mapped from the kernel) */
+        void *sq_ring = NULL;
+        size_t sq_ring_size = 0;
+        unsigned int *sq_head = NULL;
+        unsigned int *sq_tail = NULL;
+        unsigned int *sq_flags = NULL;
+        unsigned int *sq_array = NULL;
+        unsigned int sq_mask = 0;
+        unsigned int sq_entries = 0;
+        unsigned int sq_pending = 0;
+        struct io_uring_sqe *sqes = NULL;
+        size_t sqes_size = 0;
+
+        /* Completion queue (mapped from the kernel) */
+        void *cq_ring = NULL;
+        size_t cq_ring_size = 0;
+        unsigned int *cq_head = NULL;
+        unsigned int *cq_tail = NULL;
+        unsigned int cq_mask = 0;
+        struct io_uring_cqe *cqes = NULL;
+
+        /* Provided receive buffers */
+        struct io_uring_buf_ring *buf_ring = NULL;
+        size_t buf_ring_size = 0;
+        uint16_t buf_tail = 0;
+        std::vector<char> rx_pool;
+        bool rx_armed = false;
+        bool rx_failed = false;
+
+        /** @var rx_done
+         *  Receives reaped from the CQ, in arrival order */
+        std::vector<uring_rx_done> rx_done;
+        unsigned int rx_done_head = 0;
+        unsigned int rx_done_count = 0;
+
+        /* Send slots */
+        std::vector<uring_tx_slot> tx_slots;
+        std::vector<char> tx_pool;
+        unsigned int tx_next = 0;
+
+        /* Prototypes */
+        NMT_result NMT_uring_setup(bool sq_poll);
+        void NMT_uring_teardown();
+        struct io_uring_sqe *NMT_uring_get_sqe();
+        NMT_result NMT_uring_submit();
+        NMT_result NMT_uring_arm_recv();
+        void NMT_uring_recycle(uint16_t bid);
+        void NMT_uring_reap();
+        NMT_result NMT_uring_wait_tx();
+};
+
+#endif
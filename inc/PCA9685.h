@@ -76,6 +76,24 @@
 
     }PCA9685_settings;
 
+    /** @typedef PCA9685_pwm_update
+     *  A single channel update for PCA9685_setPWM_batch */
+    typedef struct PCA9685_pwm_update
+    {
+        /**@var channel
+         * PWM Channel to update */
+        PCA9685_PWM_CHANNEL channel;
+
+        /**@var duty_cycle
+         * Duty cycle (%) to apply to the channel */
+        double duty_cycle;
+
+        /**@var delay_time
+         * Delay (%) before the channel turns on */
+        double delay_time;
+
+    }PCA9685_pwm_update;
+
     //------------------Prototypes----------------------//
     extern NMT_result PCA9685_init(PCA9685_settings settings);
 
@@ -84,6 +102,11 @@
     extern NMT_result PCA9685_setPWM(double duty_cycle, double delay_time,
                                      PCA9685_PWM_CHANNEL channel);
 
+    extern NMT_result PCA9685_setPWM_batch(const PCA9685_pwm_update *updates,
+                                           unsigned int count);
+
+    extern NMT_result PCA9685_stop_all(void);
+
     extern NMT_result PCA9685_getPWM(double *duty_cycle,
                                      PCA9685_PWM_CHANNEL channel);
 
@@ -91,6 +114,9 @@
 
     extern float PCA9685_get_curret_freq();
 
+    /* I2C block write on the wiringPi fd (kept apart so tests can stub the bus) */
+    extern int PCA9685_i2c_write_block(int fd, const unsigned char *block, int block_len);
+
 #ifdef __cplusplus
 }
 #endif
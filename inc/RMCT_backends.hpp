@@ -0,0 +1,332 @@
+/**
+ *  @file      RMCT_backends.hpp
+ *  @brief     Hardware backends for RMCT_lib.hpp
+ *  @details   Compile-time PWM, servo and drive policies used to
+ *             instantiate RobotMotorControllerT. Every policy exposes
+ *             the same non-virtual interface so calls inline into the
+ *             controller. Constructors add the hardware bring-up to an
+ *             RMCT_init_graph, which the controller runs.
+ *  @author    Nitin Mohan
+ *  @date      April 05, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+#ifndef _RMCT_backends_
+#define _RMCT_backends_
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <stdexcept>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "RSXA.h"
+#include "PCA9685.h"
+#include "LD27MG.h"
+#include "L9110.hpp"
+#include "RMCT_init.hpp"
+
+/*--------------------------------------------------/
+/                   Constants                       /
+/--------------------------------------------------*/
+/** @var RMCT_PWM_FREQ
+ *  PWM Frequency for PCA9685 Driver */
+const float RMCT_PWM_FREQ = 50.00;
+
+/** @var SERVO_HOME_ANGLE
+ *  Angle the servos start at */
+const double SERVO_HOME_ANGLE = 90.00;
+
+/** @var PWM_CHANNELS
+ *  Number of PWM Channels */
+const unsigned int PWM_CHANNELS = 16;
+
+/** @enum DRV_MOTORS
+ *  Drive Motors */
+typedef enum {DRV_MTR_LEFT, DRV_MTR_RIGHT, MAX_DRV_MTRS} DRV_MOTORS;
+
+/** @var SERVO_MOTORS
+ *  Number of camera servos */
+const unsigned int SERVO_MOTORS = 2;
+
+/** @var RMCT_MAX_UPDATES
+ *  Most channel updates one write of the controller can hold */
+const unsigned int RMCT_MAX_UPDATES = SERVO_MOTORS + (MAX_DRV_MTRS * L9110_MAX_UPDATES);
+
+/** @struct RMCT_drive_target
+ *  Drive motor target staged in a batch */
+typedef struct RMCT_drive_target
+{
+    /** @var motor
+     *  Drive motor */
+    DRV_MOTORS motor;
+
+    /** @var direction
+     *  Direction to ramp towards */
+    L9110_DIRECTIONS direction;
+
+    /** @var speed
+     *  Speed to ramp towards */
+    int speed;
+} RMCT_drive_target;
+
+/*--------------------------------------------------/
+/                   PWM Backends                    /
+/--------------------------------------------------*/
+/** @class PCA9685_pwm_backend
+ *  PWM Backend for the PCA9685 Driver */
+class PCA9685_pwm_backend
+{
+    public:
+        /* Constructor - The PCA9685 Driver comes up first */
+        PCA9685_pwm_backend(RSXA_hw hw_config, RMCT_init_graph &init_graph)
+        {
+            PCA9685_settings pwm_settings = {RMCT_PWM_FREQ, hw_config.hw_sim_mode};
+            init_graph.add(PCA9685_HW_NAME, [pwm_settings]() {return PCA9685_init(pwm_settings);});
+        }
+
+        NMT_result set_pwm_batch(const PCA9685_pwm_update *updates, unsigned int count)
+        {
+            return PCA9685_setPWM_batch(updates, count);
+        }
+
+        NMT_result stop_all()
+        {
+            return PCA9685_stop_all();
+        }
+};
+
+/** @class Sim_pwm_backend
+ *  PWM Backend that keeps the channel duty cycles in memory */
+class Sim_pwm_backend
+{
+    public:
+        /* Constructor */
+        Sim_pwm_backend(RSXA_hw, RMCT_init_graph &) {}
+
+        NMT_result set_pwm_batch(const PCA9685_pwm_update *updates, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; i++)
+                duty_cycle[updates[i].channel] = updates[i].duty_cycle;
+            return OK;
+        }
+
+        NMT_result stop_all()
+        {
+            for (unsigned int i = 0; i < PWM_CHANNELS; i++)
+                duty_cycle[i] = 0;
+            return OK;
+        }
+
+        /** @var duty_cycle
+         *  Last duty cycle written per channel */
+        double duty_cycle[PWM_CHANNELS] = {0};
+};
+
+/*--------------------------------------------------/
+/                   Servo Policies                  /
+/--------------------------------------------------*/
+/** @class LD27MG_servo_policy
+ *  Servo Policy for the LD27MG Camera Motors */
+class LD27MG_servo_policy
+{
+    public:
+        /* Constructor - The LD27MG Motors come up once the PCA9685 is */
+        LD27MG_servo_policy(RSXA_hw hw_config, RMCT_init_graph &init_graph)
+        {
+            init_graph.add(LD27MG_HW_NAME, [hw_config]() {return LD27MG_init(hw_config);}, {PCA9685_HW_NAME});
+        }
+
+        NMT_result move_motor(LD27MG_MOTORS motor, double angle)
+        {
+            return LD27MG_move_motor(motor, angle);
+        }
+
+        NMT_result get_position(LD27MG_MOTORS motor, double *angle)
+        {
+            return LD27MG_get_current_position(motor, angle);
+        }
+
+        unsigned int stage_move(LD27MG_MOTORS motor, double angle, PCA9685_pwm_update *update)
+        {
+            return LD27MG_stage_move(motor, angle, update);
+        }
+
+        NMT_result reconfigure(RSXA_hw hw_config)
+        {
+            return LD27MG_reconfigure(hw_config);
+        }
+};
+
+/** @class Sim_servo_policy
+ *  Servo Policy that keeps the servo angles in memory. Staged moves
+ *  produce the channel update the LD27MG would get, so a batch still
+ *  reaches the PWM backend. */
+class Sim_servo_policy
+{
+    public:
+        /* Constructor - Servos sit on the pins named after them */
+        Sim_servo_policy(RSXA_hw hw_config, RMCT_init_graph &)
+        {
+            for (unsigned int i = 0; i < SERVO_MOTORS; i++)
+            {
+                const RSXA_pins *pin = RSXA_find_pin(&hw_config, LD27MG_m2s[i]);
+                channel[i] = (pin != NULL ? (PCA9685_PWM_CHANNEL)pin->pin_no : (PCA9685_PWM_CHANNEL)i);
+            }
+        }
+
+        NMT_result move_motor(LD27MG_MOTORS motor, double angle)
+        {
+            this->angle[motor] = (angle > 180.00 ? 180.00 : (angle < 0.00 ? 0.00 : angle));
+            return OK;
+        }
+
+        NMT_result get_position(LD27MG_MOTORS motor, double *angle)
+        {
+            *angle = this->angle[motor];
+            return OK;
+        }
+
+        unsigned int stage_move(LD27MG_MOTORS motor, double angle, PCA9685_pwm_update *update)
+        {
+            move_motor(motor, angle);
+
+            /* Same pulse width as the LD27MG (0.5ms + angle/135) */
+            update->channel    = channel[motor];
+            update->duty_cycle = (0.5 + (this->angle[motor] / 135.00)) * RMCT_PWM_FREQ / 10.00;
+            update->delay_time = 0;
+            return 1;
+        }
+
+        NMT_result reconfigure(RSXA_hw) {return OK;}
+
+        /** @var angle
+         *  Current angle per servo */
+        double angle[SERVO_MOTORS] = {SERVO_HOME_ANGLE, SERVO_HOME_ANGLE};
+
+        /** @var channel
+         *  PWM channel per servo */
+        PCA9685_PWM_CHANNEL channel[SERVO_MOTORS];
+};
+
+/*--------------------------------------------------/
+/                   Drive Policies                  /
+/--------------------------------------------------*/
+/** @class L9110_drive_policy
+ *  Drive Policy for the L9110 H-Bridge Motors. The motors are held
+ *  by value and ramp off one shared scheduler. Ticks and commits hand
+ *  the channel updates back for the controller to write. */
+class L9110_drive_policy
+{
+    public:
+        /* Constructor - Both Drive Motors come up once the PCA9685 is */
+        L9110_drive_policy(RSXA_hw left_hw_config, RSXA_hw right_hw_config, RMCT_init_graph &init_graph) :
+            left(left_hw_config, L9110_DEFAULT_RAMP, false), right(right_hw_config, L9110_DEFAULT_RAMP, false)
+        {
+            scheduler.attach_motor(&left);
+            scheduler.attach_motor(&right);
+
+            init_graph.add(left.hw_name, [this]() {return left.L9110_init();}, {PCA9685_HW_NAME});
+            init_graph.add(right.hw_name, [this]() {return right.L9110_init();}, {PCA9685_HW_NAME});
+        }
+
+        NMT_result ramp_motor(DRV_MOTORS motor, L9110_DIRECTIONS direction, int speed)
+        {
+            return (motor == DRV_MTR_LEFT ? left : right).L9110_ramp_motor(direction, speed);
+        }
+
+        NMT_result tick(PCA9685_pwm_update *updates, unsigned int *update_count)
+        {
+            return scheduler.tick(updates, update_count);
+        }
+
+        /* The last tick/commit was written */
+        void ack() {scheduler.ack();}
+
+        /* Drops the ramps, under the tick lock */
+        void halt() {scheduler.halt();}
+
+        NMT_result reconfigure(DRV_MOTORS motor, RSXA_hw hw_config)
+        {
+            return (motor == DRV_MTR_LEFT ? left : right).L9110_reconfigure(hw_config);
+        }
+
+        NMT_result commit(const RMCT_drive_target *targets, unsigned int target_count,
+                          PCA9685_pwm_update *updates, unsigned int *update_count)
+        {
+            L9110_ramp_target ramp_targets[MAX_DRV_MTRS];
+            unsigned int count = (target_count < (unsigned int)MAX_DRV_MTRS ? target_count : (unsigned int)MAX_DRV_MTRS);
+
+            for (unsigned int i = 0; i < count; i++)
+            {
+                ramp_targets[i].motor     = (targets[i].motor == DRV_MTR_LEFT ? &left : &right);
+                ramp_targets[i].direction = targets[i].direction;
+                ramp_targets[i].speed     = targets[i].speed;
+            }
+
+            return scheduler.commit(ramp_targets, count, updates, update_count);
+        }
+
+    private:
+        /** @var left
+         *  Left Drive Motor */
+        L9110 left;
+
+        /** @var right
+         *  Right Drive Motor */
+        L9110 right;
+
+        /** @var scheduler
+         *  Shared ramp tick */
+        L9110_ramp_scheduler scheduler;
+};
+
+/** @class Sim_drive_policy
+ *  Drive Policy that keeps the commanded direction/speed in memory */
+class Sim_drive_policy
+{
+    public:
+        /* Constructor */
+        Sim_drive_policy(RSXA_hw, RSXA_hw, RMCT_init_graph &) {}
+
+        NMT_result ramp_motor(DRV_MOTORS motor, L9110_DIRECTIONS direction, int speed)
+        {
+            this->direction[motor] = direction;
+            this->speed[motor] = (direction == STOP ? 0 : speed);
+            return OK;
+        }
+
+        NMT_result tick(PCA9685_pwm_update *, unsigned int *update_count)
+        {
+            *update_count = 0;
+            return OK;
+        }
+
+        void ack() {}
+
+        void halt()
+        {
+            for (unsigned int i = 0; i < MAX_DRV_MTRS; i++)
+                ramp_motor((DRV_MOTORS)i, STOP, 0);
+        }
+
+        NMT_result reconfigure(DRV_MOTORS, RSXA_hw) {return OK;}
+
+        NMT_result commit(const RMCT_drive_target *targets, unsigned int target_count,
+                          PCA9685_pwm_update *, unsigned int *update_count)
+        {
+            for (unsigned int i = 0; i < target_count; i++)
+                ramp_motor(targets[i].motor, targets[i].direction, targets[i].speed);
+            *update_count = 0;
+            return OK;
+        }
+
+        /** @var direction
+         *  Commanded direction per motor */
+        L9110_DIRECTIONS direction[MAX_DRV_MTRS] = {STOP, STOP};
+
+        /** @var speed
+         *  Commanded speed per motor */
+        int speed[MAX_DRV_MTRS] = {0, 0};
+};
+#endif
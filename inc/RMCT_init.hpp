@@ -0,0 +1,156 @@
+/**
+ *  @file      RMCT_init.hpp
+ *  @brief     Header File for RMCT_init.cpp
+ *  @details   Dependency-aware hardware bring-up for the Robot Motor
+ *             Controller
+ *  @author    Nitin Mohan
+ *  @date      May 31, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+#ifndef _RMCT_init_
+#define _RMCT_init_
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <functional>
+#include <initializer_list>
+#include <condition_variable>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "NMT_stdlib.h"
+
+/*--------------------------------------------------/
+/                   Constants                       /
+/--------------------------------------------------*/
+/** @var RMCT_INIT_WORKERS
+ *  Default number of threads devices are brought up on */
+const unsigned int RMCT_INIT_WORKERS = 4;
+
+/*--------------------------------------------------/
+/                   Structs/Classes                 /
+/--------------------------------------------------*/
+/** @typedef RMCT_init_fn
+ *  Brings one device up (an exception counts as NOK) */
+typedef std::function<NMT_result()> RMCT_init_fn;
+
+/** @struct RMCT_init_report
+ *  How one device came up */
+typedef struct RMCT_init_report
+{
+    /** @var name
+     *  Device name */
+    std::string name;
+
+    /** @var result
+     *  NOK if it failed or a device it needs failed */
+    NMT_result result;
+
+    /** @var ran
+     *  False if it was skipped because a device it needs failed */
+    bool ran;
+
+    /** @var init_ms
+     *  Time its init function took */
+    double init_ms;
+
+    /** @var ready_ms
+     *  Time from the start of run() until it was up */
+    double ready_ms;
+} RMCT_init_report;
+
+/** @class RMCT_init_graph
+ *  Devices and the devices each one needs. run() brings up every device
+ *  whose dependencies are up on a pool of threads, so the bring-up takes
+ *  as long as the slowest chain rather than the sum of the devices.
+ *  Dependencies must be added first, which keeps the graph acyclic. */
+class RMCT_init_graph
+{
+    public:
+        /* Constructor */
+        RMCT_init_graph() = default;
+
+        /* Holds the state of a run - Never copied */
+        RMCT_init_graph(const RMCT_init_graph &) = delete;
+        RMCT_init_graph &operator=(const RMCT_init_graph &) = delete;
+
+        /* Prototypes */
+        NMT_result add(const std::string &name, RMCT_init_fn init,
+                       std::initializer_list<std::string> after = {});
+        NMT_result run(unsigned int workers = RMCT_INIT_WORKERS);
+
+        /* Getters */
+        const std::vector<RMCT_init_report> &report() const {return reports;}
+        double elapsed_ms() const {return total_ms;}
+
+    private:
+        /** @struct RMCT_init_node
+         *  One device of the graph */
+        typedef struct RMCT_init_node
+        {
+            /** @var init
+             *  Brings the device up */
+            RMCT_init_fn init;
+
+            /** @var children
+             *  Devices that need this one */
+            std::vector<size_t> children;
+
+            /** @var deps
+             *  Number of devices this one needs */
+            unsigned int deps;
+
+            /** @var pending
+             *  Devices this one still waits for (during a run) */
+            unsigned int pending;
+
+            /** @var blocked
+             *  A device this one needs failed (during a run) */
+            bool blocked;
+        } RMCT_init_node;
+
+        /** @var nodes
+         *  Devices in the order they were added */
+        std::vector<RMCT_init_node> nodes;
+
+        /** @var reports
+         *  One per device, in the order they were added */
+        std::vector<RMCT_init_report> reports;
+
+        /** @var valid
+         *  False once a device was added with a bad name or dependency */
+        bool valid = true;
+
+        /** @var total_ms
+         *  Time the last run took */
+        double total_ms = 0;
+
+        /** @var lock
+         *  Guards the run state below, the nodes and the reports */
+        std::mutex lock;
+
+        /** @var wake
+         *  Signalled when a device is ready or every device settled */
+        std::condition_variable wake;
+
+        /** @var ready
+         *  Devices whose dependencies are all up */
+        std::deque<size_t> ready;
+
+        /** @var settled
+         *  Number of devices that are up, failed or skipped */
+        size_t settled = 0;
+
+        /* Prototypes */
+        void work(std::chrono::steady_clock::time_point start);
+        void settle(size_t id, NMT_result result);
+};
+#endif
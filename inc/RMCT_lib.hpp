@@ -12,12 +12,16 @@
 /                   System Imports                  /
 /--------------------------------------------------*/
 #include <string>
+#include <cstring>
+#include <cstdint>
+#include <mutex>
 
 /*--------------------------------------------------/
 /                   Local Imports                   /
 /--------------------------------------------------*/
 #include "LD27MG.h"
 #include "L9110.hpp"
+#include "RMCT_backends.hpp"
 
 /*--------------------------------------------------/
 /                   Global Varibles                 /
@@ -51,50 +55,788 @@ extern const std::string DIRECTION_TO_STR[MAX_DIRECTIONS] = {"UP",
                                                              "RIGHT", 
                                                              "CUSTOM"};
 
-/** @class RobotMotorController
- *  Object which controls all Peripherals */
-class RobotMotorController
+/** @enum RMCT_MOTORS
+ *  Motors an action can address */
+typedef enum {RMCT_CAMERA,
+              RMCT_CAM_HRZN_MTR,
+              RMCT_CAM_VERT_MTR,
+              RMCT_LEFT_DRV_MTR,
+              RMCT_RIGHT_DRV_MTR,
+              MAX_RMCT_MOTORS} RMCT_MOTORS;
+
+/**@var RMCT_MOTOR_TO_STR
+ * Used to convert RMCT_MOTORS to string */
+constexpr const char *RMCT_MOTOR_TO_STR[MAX_RMCT_MOTORS] = {"CAMERA",
+                                                            "CAM_HRZN_MTR",
+                                                            "CAM_VERT_MTR",
+                                                            "LEFT_DRV_MTR",
+                                                            "RIGHT_DRV_MTR"};
+
+/** @enum RMCT_DIRECTIONS
+ *  Directions an action can request. Camera and drive directions
+ *  keep the order of CAMERA_MOTOR_DIRECTIONS and L9110_DIRECTIONS */
+typedef enum {RMCT_UP,
+              RMCT_DOWN,
+              RMCT_LEFT,
+              RMCT_RIGHT,
+              RMCT_FORWARD,
+              RMCT_REVERSE,
+              RMCT_STOP,
+              RMCT_NO_DIRECTION} RMCT_DIRECTIONS;
+
+/**@var RMCT_DIRECTION_TO_STR
+ * Used to convert RMCT_DIRECTIONS to string */
+constexpr const char *RMCT_DIRECTION_TO_STR[RMCT_NO_DIRECTION + 1] = {"UP",
+                                                                      "DOWN",
+                                                                      "LEFT",
+                                                                      "RIGHT",
+                                                                      "FORWARD",
+                                                                      "REVERSE",
+                                                                      "STOP",
+                                                                      ""};
+
+static_assert((RMCT_DOWN - RMCT_UP == DOWN) && (RMCT_RIGHT - RMCT_UP == RIGHT),
+              "RMCT camera directions must follow CAMERA_MOTOR_DIRECTIONS");
+static_assert((RMCT_REVERSE - RMCT_FORWARD == REVERSE) && (RMCT_STOP - RMCT_FORWARD == STOP),
+              "RMCT drive directions must follow L9110_DIRECTIONS");
+
+/** @struct MotorAction
+ *  A decoded hw_action */
+typedef struct MotorAction
+{
+    /** @var motor
+     *  Motor to move */
+    RMCT_MOTORS motor;
+
+    /** @var direction
+     *  Direction to move in (RMCT_NO_DIRECTION if not given) */
+    RMCT_DIRECTIONS direction;
+
+    /** @var angle
+     *  Absolute angle for the camera servos */
+    double angle;
+
+    /** @var speed
+     *  Drive speed (< 0 for the default) */
+    int speed;
+} MotorAction;
+
+/*--------------------------------------------------/
+/                   String Resolvers                /
+/--------------------------------------------------*/
+constexpr uint32_t RMCT_hash(const char *str, size_t len)
+{
+    /*!
+     *  @brief     FNV-1a hash, usable in case labels
+     *  @param[in] str
+     *  @param[in] len
+     *  @return    hash
+     */
+
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template <size_t N>
+constexpr uint32_t RMCT_hash(const char (&str)[N])
+{
+    return RMCT_hash(str, N - 1);
+}
+
+inline bool RMCT_name_equals(const char *name, const char *str, size_t len)
+{
+    return (strlen(name) == len) && (memcmp(name, str, len) == 0);
+}
+
+inline RMCT_MOTORS RMCT_motor_s2e(const char *str, size_t len)
+{
+    /*!
+     *  @brief     Resolve a motor name. The switch is built from the
+     *             name hashes at compile time (a collision between two
+     *             names fails the build) and one compare confirms the hit.
+     *  @param[in] str
+     *  @param[in] len
+     *  @return    RMCT_MOTORS (MAX_RMCT_MOTORS if unknown)
+     */
+
+    RMCT_MOTORS motor = MAX_RMCT_MOTORS;
+
+    switch (RMCT_hash(str, len))
+    {
+        case RMCT_hash("CAMERA"):        motor = RMCT_CAMERA;        break;
+        case RMCT_hash("CAM_HRZN_MTR"):  motor = RMCT_CAM_HRZN_MTR;  break;
+        case RMCT_hash("CAM_VERT_MTR"):  motor = RMCT_CAM_VERT_MTR;  break;
+        case RMCT_hash("LEFT_DRV_MTR"):  motor = RMCT_LEFT_DRV_MTR;  break;
+        case RMCT_hash("RIGHT_DRV_MTR"): motor = RMCT_RIGHT_DRV_MTR; break;
+    }
+
+    if ((motor != MAX_RMCT_MOTORS) && (!RMCT_name_equals(RMCT_MOTOR_TO_STR[motor], str, len)))
+        motor = MAX_RMCT_MOTORS;
+
+    return motor;
+}
+
+inline RMCT_DIRECTIONS RMCT_direction_s2e(const char *str, size_t len)
+{
+    /*!
+     *  @brief     Resolve a direction name (see RMCT_motor_s2e)
+     *  @param[in] str
+     *  @param[in] len
+     *  @return    RMCT_DIRECTIONS (RMCT_NO_DIRECTION if unknown)
+     */
+
+    RMCT_DIRECTIONS direction = RMCT_NO_DIRECTION;
+
+    switch (RMCT_hash(str, len))
+    {
+        case RMCT_hash("UP"):      direction = RMCT_UP;      break;
+        case RMCT_hash("DOWN"):    direction = RMCT_DOWN;    break;
+        case RMCT_hash("LEFT"):    direction = RMCT_LEFT;    break;
+        case RMCT_hash("RIGHT"):   direction = RMCT_RIGHT;   break;
+        case RMCT_hash("FORWARD"): direction = RMCT_FORWARD; break;
+        case RMCT_hash("REVERSE"): direction = RMCT_REVERSE; break;
+        case RMCT_hash("STOP"):    direction = RMCT_STOP;    break;
+    }
+
+    if (!RMCT_name_equals(RMCT_DIRECTION_TO_STR[direction], str, len))
+        direction = RMCT_NO_DIRECTION;
+
+    return direction;
+}
+
+inline NMT_result RMCT_parse_motor_action(const char *motor, size_t motor_len,
+                                          const char *direction, size_t direction_len,
+                                          double angle, int speed, MotorAction &action)
+{
+    /*!
+     *  @brief      Build a MotorAction from its string fields
+     *  @param[in]  motor
+     *  @param[in]  motor_len
+     *  @param[in]  direction
+     *  @param[in]  direction_len
+     *  @param[in]  angle
+     *  @param[in]  speed
+     *  @param[out] action
+     *  @return     NMT_result (NOK if the motor is unknown)
+     */
+
+    action.motor     = RMCT_motor_s2e(motor, motor_len);
+    action.direction = RMCT_direction_s2e(direction, direction_len);
+    action.angle     = angle;
+    action.speed     = speed;
+
+    return (action.motor == MAX_RMCT_MOTORS ? NOK : OK);
+}
+
+inline NMT_result RMCT_check_motor_action(const MotorAction &action)
+{
+    /*!
+     *  @brief     Check an action can be processed without touching the
+     *             hardware - The camera steps UP/DOWN/LEFT/RIGHT, the
+     *             drive motors FORWARD/REVERSE/STOP
+     *  @param[in] action
+     *  @return    NMT_result
+     */
+
+    switch (action.motor)
+    {
+        case RMCT_CAMERA:
+            return (action.direction <= RMCT_RIGHT ? OK : NOK);
+        case RMCT_CAM_HRZN_MTR:
+        case RMCT_CAM_VERT_MTR:
+            return OK;
+        case RMCT_LEFT_DRV_MTR:
+        case RMCT_RIGHT_DRV_MTR:
+            return (((action.direction >= RMCT_FORWARD) && (action.direction <= RMCT_STOP)) ? OK : NOK);
+        default:
+            return NOK;
+    }
+}
+
+/** @class RobotMotorControllerT
+ *  Object which controls all Peripherals. The PWM, servo and drive
+ *  backends are template policies (see RMCT_backends.hpp) so the
+ *  hardware calls resolve at compile time. */
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+class RobotMotorControllerT
 {
     public:
-        /* Constructor for RobotMotorController */
-        RobotMotorController(RSXA_hw pca9685_hw_config, 
-                             RSXA_hw cam_motor_hw_config,
-                             RSXA_hw left_motor_hw_config, 
-                             RSXA_hw right_motor_hw_config);
+        /* Constructor for RobotMotorControllerT */
+        RobotMotorControllerT(RSXA_hw pca9685_hw_config, 
+                              RSXA_hw cam_motor_hw_config,
+                              RSXA_hw left_motor_hw_config, 
+                              RSXA_hw right_motor_hw_config);
 
-        ~RobotMotorController() {};
+        /* The drive ramp keeps pointers into the backends - Never copied
+         * or moved (hold it in a std::unique_ptr to pass it around) */
+        RobotMotorControllerT(const RobotMotorControllerT &) = delete;
+        RobotMotorControllerT &operator=(const RobotMotorControllerT &) = delete;
+
+        ~RobotMotorControllerT() {};
 
 
         /* Prototypes */
-        NMT_result process_motor_action(std::string motor, std::string direction, double angle, int speed);
+        NMT_result process_motor_action(const MotorAction &action);
+        NMT_result process_motor_action(const std::string &motor, const std::string &direction, 
+                                        double angle, int speed);
+        NMT_result drive_ramp_tick();
+        void       begin_batch();
+        NMT_result commit();
+        void       abort_batch();
+        void       mark_batch();
+        void       rollback_batch();
+        NMT_result emergency_stop();
+        NMT_result reconfigure(const RSXA_hw *cam_motor_hw_config,
+                               const RSXA_hw *left_motor_hw_config,
+                               const RSXA_hw *right_motor_hw_config);
+
+        /* How each device came up */
+        const RMCT_init_graph &hw_init() const {return init_graph;}
+
+        /* Backend Access */
+        PwmBackend  &pwm_backend()  {return pwm;}
+        ServoPolicy &servo_policy() {return servo;}
+        DrivePolicy &drive_policy() {return drive;}
 
    private:
         /** @var motor_sensitivity 
          * The default amount the motor should when direction is provided */
-        static const int camera_motor_sensitivity = 10.00;
+        static constexpr double camera_motor_sensitivity = 10.00;
         
         /** @var default_drive_motor_speed 
          *  Default Speed the Drive Motors move */
-        static const int default_drive_motor_speed = 50.00;
+        static const int default_drive_motor_speed = 50;
+
+        /** @var init_graph
+         *  Hardware bring-up the backends add themselves to */
+        RMCT_init_graph init_graph;
+
+        /** @var pwm
+         *  PWM Backend (Initialized first) */
+        PwmBackend pwm;
+
+        /** @var servo
+         *  Camera Servo Backend */
+        ServoPolicy servo;
+
+        /** @var drive
+         *  Drive Motor Backend */
+        DrivePolicy drive;
+
+        /** @var output_lock
+         *  Serializes the PWM writes with emergency_stop() */
+        std::mutex output_lock;
+
+        /** @var batching
+         *  True between begin_batch() and commit()/abort_batch() */
+        bool batching = false;
+
+        /** @var servo_staged
+         *  Servos with an angle staged in the current batch */
+        bool servo_staged[SERVO_MOTORS] = {false};
+
+        /** @var staged_angle
+         *  Staged angle per servo */
+        double staged_angle[SERVO_MOTORS];
+
+        /** @var drive_staged
+         *  Drive motors with a target staged in the current batch */
+        bool drive_staged[MAX_DRV_MTRS] = {false};
+
+        /** @var staged_drive
+         *  Staged target per drive motor */
+        RMCT_drive_target staged_drive[MAX_DRV_MTRS];
+
+        /** @struct batch_state
+         *  Everything staged in the open batch */
+        typedef struct batch_state
+        {
+            bool servo_staged[SERVO_MOTORS];
+            double staged_angle[SERVO_MOTORS];
+            bool drive_staged[MAX_DRV_MTRS];
+            RMCT_drive_target staged_drive[MAX_DRV_MTRS];
+        } batch_state;
+
+        /** @var batch_mark
+         *  Staged state saved by mark_batch() */
+        batch_state batch_mark;
+
+        /** @typedef action_handler
+         *  Handler for the actions of one motor */
+        typedef NMT_result (RobotMotorControllerT::*action_handler)(const MotorAction &action);
+
+        /** @var action_table
+         *  Handlers indexed by RMCT_MOTORS */
+        static const action_handler action_table[MAX_RMCT_MOTORS];
 
         /* Prototypes */
+        NMT_result camera_action(const MotorAction &action);
+        NMT_result servo_action(const MotorAction &action);
+        NMT_result drive_action(const MotorAction &action);
+        NMT_result get_servo_angle(LD27MG_MOTORS motor, double *angle);
+        NMT_result set_servo_angle(LD27MG_MOTORS motor, double angle);
         NMT_result move_camera_motor(CAMERA_MOTOR_DIRECTIONS direction, 
                                             LD27MG_MOTORS camera_motor = CAM_HRZN_MTR, 
                                             double angle_to_move = 0.00, 
                                             double default_angle = camera_motor_sensitivity);
+};
+
+/** @typedef RobotMotorController
+ *  Controller on the real hardware drivers */
+typedef RobotMotorControllerT<PCA9685_pwm_backend, 
+                              LD27MG_servo_policy,
+                              L9110_drive_policy> RobotMotorController;
+
+/** @typedef SimRobotMotorController
+ *  Controller with every backend simulated in memory */
+typedef RobotMotorControllerT<Sim_pwm_backend,
+                              Sim_servo_policy,
+                              Sim_drive_policy> SimRobotMotorController;
+
+/* The hardware instantiations are compiled once in RMCT_lib.cpp */
+extern template class RobotMotorControllerT<PCA9685_pwm_backend, LD27MG_servo_policy, L9110_drive_policy>;
+extern template class RobotMotorControllerT<Sim_pwm_backend, Sim_servo_policy, Sim_drive_policy>;
+
+/*--------------------------------------------------/
+/             Template Implementation               /
+/--------------------------------------------------*/
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::RobotMotorControllerT(RSXA_hw pca9685_hw_config, 
+                                                                                   RSXA_hw cam_motor_hw_config,
+                                                                                   RSXA_hw left_motor_hw_config, 
+                                                                                   RSXA_hw right_motor_hw_config)
+try : pwm(pca9685_hw_config, init_graph),
+      servo(cam_motor_hw_config, init_graph),
+      drive(left_motor_hw_config, right_motor_hw_config, init_graph)
+{
+    /*!
+     *  @brief     Constructor Implementation for RobotMotorControllerT.
+     *             The backends add their hardware to the init graph in
+     *             member order. The PWM Driver comes up first, then the
+     *             Camera and Drive Motors come up side by side.
+     *  @param[in] pca9685_hw_config
+     *  @param[in] cam_motor_hw_config
+     *  @param[in] left_motor_hw_config
+     *  @param[in] right_motor_hw_config
+     *  @return    void 
+     */
+
+    if (this->init_graph.run() != OK)
+        throw std::runtime_error("ERROR, Hardware Bring-up Failed!");
+}
+catch (std::exception &e)
+{
+    NMT_log_write(ERROR, (char *)"%s", e.what());
+    throw std::runtime_error("ERROR, Robot Motor Hardware Initiization Failed!");
+}
+
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+const typename RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::action_handler
+RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::action_table[MAX_RMCT_MOTORS] = 
+{
+    &RobotMotorControllerT::camera_action,  /* RMCT_CAMERA        */
+    &RobotMotorControllerT::servo_action,   /* RMCT_CAM_HRZN_MTR  */
+    &RobotMotorControllerT::servo_action,   /* RMCT_CAM_VERT_MTR  */
+    &RobotMotorControllerT::drive_action,   /* RMCT_LEFT_DRV_MTR  */
+    &RobotMotorControllerT::drive_action    /* RMCT_RIGHT_DRV_MTR */
+};
+
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+NMT_result RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::process_motor_action(const MotorAction &action)
+{
+    /*!
+     *  @brief     Process motor action and send request to
+     *             execute it. 
+     *  @param[in] action
+     *  @return    NMT_result
+     */
+
+    /* Initialize Varibles */
+    NMT_result result = NOK;
+
+    /* Runs for every action on the actuation path - Not logged */
+    if (action.motor < MAX_RMCT_MOTORS)
+        result = (this->*action_table[action.motor])(action);
+
+    return result;
+}
+
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+NMT_result RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::process_motor_action(const std::string &motor, 
+                                                                                             const std::string &direction, 
+                                                                                             double angle, int speed)
+{
+    /*!
+     *  @brief     Resolve the motor/direction names and process the action
+     *  @param[in] motor
+     *  @param[in] direction
+     *  @param[in] angle
+     *  @param[in] speed
+     *  @return    NMT_result
+     */
+
+    MotorAction action;
+    NMT_result result = RMCT_parse_motor_action(motor.c_str(), motor.size(), 
+                                                direction.c_str(), direction.size(),
+                                                angle, speed, action);
+
+    if (result == OK)
+        result = process_motor_action(action);
+    else
+        NMT_log_write(ERROR, (char *)"Unknown motor=%s", motor.c_str());
+
+    return result;
+}
+
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+NMT_result RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::camera_action(const MotorAction &action)
+{
+    /*!
+     *  @brief     Step the camera one notch UP/DOWN/LEFT/RIGHT
+     *  @param[in] action
+     *  @return    NMT_result
+     */
+
+    if (action.direction > RMCT_RIGHT)
+        return NOK;
+
+    return move_camera_motor((CAMERA_MOTOR_DIRECTIONS)(action.direction - RMCT_UP));
+}
+
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+NMT_result RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::servo_action(const MotorAction &action)
+{
+    /*!
+     *  @brief     Move a camera servo to an absolute angle (direction is ignored)
+     *  @param[in] action
+     *  @return    NMT_result
+     */
+
+    LD27MG_MOTORS camera_motor = (action.motor == RMCT_CAM_HRZN_MTR ? CAM_HRZN_MTR : CAM_VERT_MTR);
+    return move_camera_motor(CUSTOM, camera_motor, action.angle);
+}
+
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+NMT_result RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::drive_action(const MotorAction &action)
+{
+    /*!
+     *  @brief     Ramp a drive motor FORWARD/REVERSE/STOP
+     *  @param[in] action
+     *  @return    NMT_result
+     */
+
+    if ((action.direction < RMCT_FORWARD) || (action.direction > RMCT_STOP))
+        return NOK;
+
+    DRV_MOTORS motor = (action.motor == RMCT_LEFT_DRV_MTR ? DRV_MTR_LEFT : DRV_MTR_RIGHT);
+    L9110_DIRECTIONS direction = (L9110_DIRECTIONS)(action.direction - RMCT_FORWARD);
+    int speed = (action.speed < 0 ? default_drive_motor_speed : action.speed);
+
+    if (!batching)
+        return drive.ramp_motor(motor, direction, speed);
+
+    /* A later action for the same motor replaces the staged one */
+    staged_drive[motor] = {motor, direction, speed};
+    drive_staged[motor] = true;
+    return OK;
+}
+
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+void RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::begin_batch()
+{
+    /*!
+     *  @brief     Start collecting actions. Until commit() nothing is
+     *             written; each motor only keeps its final staged state.
+     *  @return    void
+     */
+
+    batching = true;
+    for (unsigned int i = 0; i < SERVO_MOTORS; i++) {servo_staged[i] = false;}
+    for (unsigned int i = 0; i < MAX_DRV_MTRS; i++) {drive_staged[i] = false;}
+}
+
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+void RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::abort_batch()
+{
+    /*!
+     *  @brief     Drop everything staged since begin_batch()
+     *  @return    void
+     */
+
+    NMT_log_write(DEBUG, (char *)"> batch dropped");
+    begin_batch();
+    batching = false;
+}
+
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+void RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::mark_batch()
+{
+    /*!
+     *  @brief     Save what is staged so far. Lets several commands
+     *             share one batch while a rejected command only drops
+     *             its own actions (see rollback_batch()).
+     *  @return    void
+     */
+
+    memcpy(batch_mark.servo_staged, servo_staged, sizeof(servo_staged));
+    memcpy(batch_mark.staged_angle, staged_angle, sizeof(staged_angle));
+    memcpy(batch_mark.drive_staged, drive_staged, sizeof(drive_staged));
+    memcpy(batch_mark.staged_drive, staged_drive, sizeof(staged_drive));
+}
+
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+void RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::rollback_batch()
+{
+    /*!
+     *  @brief     Drop everything staged since the last mark_batch()
+     *  @return    void
+     */
+
+    memcpy(servo_staged, batch_mark.servo_staged, sizeof(servo_staged));
+    memcpy(staged_angle, batch_mark.staged_angle, sizeof(staged_angle));
+    memcpy(drive_staged, batch_mark.drive_staged, sizeof(drive_staged));
+    memcpy(staged_drive, batch_mark.staged_drive, sizeof(staged_drive));
+}
+
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+NMT_result RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::commit()
+{
+    /*!
+     *  @brief     Apply the staged batch. The servo channel updates and
+     *             the first ramp step of the drive motors go out as a
+     *             single PWM batch write.
+     *  @return    NMT_result
+     */
+
+    /* Initialize Variables */
+    NMT_result result = OK;
+    PCA9685_pwm_update updates[RMCT_MAX_UPDATES];
+    RMCT_drive_target  drive_targets[MAX_DRV_MTRS];
+    unsigned int servo_count = 0;
+    unsigned int drive_count = 0;
+    unsigned int step_count  = 0;
+
+    if (!batching)
+        return result;
+
+    for (unsigned int i = 0; i < SERVO_MOTORS; i++)
+    {
+        if (servo_staged[i])
+            servo_count += servo.stage_move((LD27MG_MOTORS)i, staged_angle[i], &updates[servo_count]);
+    }
+
+    for (unsigned int i = 0; i < MAX_DRV_MTRS; i++)
+    {
+        if (drive_staged[i])
+            drive_targets[drive_count++] = staged_drive[i];
+    }
+
+    if ((servo_count > 0) || (drive_count > 0))
+    {
+        std::lock_guard<std::mutex> guard(output_lock);
+
+        result = drive.commit(drive_targets, drive_count, &updates[servo_count], &step_count);
+        if ((result == OK) && (servo_count + step_count > 0))
+            result = pwm.set_pwm_batch(updates, servo_count + step_count);
+        if (result == OK)
+            drive.ack();
+    }
+
+    batching = false;
 
-        virtual L9110* Create_drv_motor(RSXA_hw hw_settings)
+    return result;
+}
+
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+NMT_result RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::drive_ramp_tick()
+{
+    /*!
+     *  @brief     Step the drive ramps once and write the changes as one
+     *             PWM batch. The ramps only count the changes as applied
+     *             once the write succeeds, so a failed one is re-sent.
+     *  @return    NMT_result
+     */
+
+    /* Initialize Variables */
+    PCA9685_pwm_update updates[RMCT_MAX_UPDATES];
+    unsigned int count = 0;
+    std::lock_guard<std::mutex> guard(output_lock);
+
+    NMT_result result = drive.tick(updates, &count);
+    if ((result == OK) && (count > 0))
+        result = pwm.set_pwm_batch(updates, count);
+    if (result == OK)
+        drive.ack();
+
+    return result;
+}
+
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+NMT_result RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::emergency_stop()
+{
+    /*!
+     *  @brief     Stop all motors now. Safe to call from another thread
+     *             (e.g. a watchdog) while actions are being processed.
+     *             The ramps are dropped and every channel is forced off
+     *             under the output lock, so no tick drives them again.
+     *  @return    NMT_result
+     */
+
+    NMT_log_write(DEBUG, (char *)">");
+
+    std::lock_guard<std::mutex> guard(output_lock);
+
+    drive.halt();
+    NMT_result result = pwm.stop_all();
+
+    NMT_log_write(DEBUG, (char *)"< result=%s", result_e2s[result]);
+    return result;
+}
+
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+NMT_result RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::reconfigure(const RSXA_hw *cam_motor_hw_config,
+                                                                                  const RSXA_hw *left_motor_hw_config,
+                                                                                  const RSXA_hw *right_motor_hw_config)
+{
+    /*!
+     *  @brief     Apply new settings to running devices without
+     *             initializing them again. Call it outside a batch,
+     *             from the thread processing the actions.
+     *  @param[in] cam_motor_hw_config (NULL to leave unchanged)
+     *  @param[in] left_motor_hw_config (NULL to leave unchanged)
+     *  @param[in] right_motor_hw_config (NULL to leave unchanged)
+     *  @return    NMT_result (NOK if any device failed, the others are still applied)
+     */
+
+    NMT_log_write(DEBUG, (char *)"> cam=%s left=%s right=%s", btoa(cam_motor_hw_config != NULL),
+                  btoa(left_motor_hw_config != NULL), btoa(right_motor_hw_config != NULL));
+
+    NMT_result result = OK;
+
+    if ((cam_motor_hw_config != NULL) && (servo.reconfigure(*cam_motor_hw_config) != OK))
+        result = NOK;
+
+    if ((left_motor_hw_config != NULL) && (drive.reconfigure(DRV_MTR_LEFT, *left_motor_hw_config) != OK))
+        result = NOK;
+
+    if ((right_motor_hw_config != NULL) && (drive.reconfigure(DRV_MTR_RIGHT, *right_motor_hw_config) != OK))
+        result = NOK;
+
+    NMT_log_write(DEBUG, (char *)"< result=%s", result_e2s[result]);
+    return result;
+}
+
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+NMT_result RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::get_servo_angle(LD27MG_MOTORS motor, double *angle)
+{
+    /*!
+     *  @brief      Current servo angle, including any angle staged in
+     *              the open batch
+     *  @param[in]  motor
+     *  @param[out] angle
+     *  @return     NMT_result
+     */
+
+    if (batching && servo_staged[motor])
+    {
+        *angle = staged_angle[motor];
+        return OK;
+    }
+
+    return servo.get_position(motor, angle);
+}
+
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+NMT_result RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::set_servo_angle(LD27MG_MOTORS motor, double angle)
+{
+    /*!
+     *  @brief     Move a servo, or stage the move if a batch is open
+     *  @param[in] motor
+     *  @param[in] angle
+     *  @return    NMT_result
+     */
+
+    if (!batching)
+        return servo.move_motor(motor, angle);
+
+    staged_angle[motor] = (angle > 180.00 ? 180.00 : (angle < 0.00 ? 0.00 : angle));
+    servo_staged[motor] = true;
+    return OK;
+}
+
+template <class PwmBackend, class ServoPolicy, class DrivePolicy>
+NMT_result RobotMotorControllerT<PwmBackend, ServoPolicy, DrivePolicy>::move_camera_motor(CAMERA_MOTOR_DIRECTIONS direction, 
+                                                                                          LD27MG_MOTORS camera_motor,
+                                                                                          double angle_to_move, 
+                                                                                          double default_angle)
+{
+    /*!
+     *  @brief     Method to move the Camera Motors
+     *  @param[in] direction
+     *  @param[in] camera_motor  (Optional - Manual override)
+     *  @param[in] angle_to_move (Optional - Manual override)
+     *  @param[in] default_angle (Optional - Change default precison)
+     *  @return    NMT_result
+     */
+
+    NMT_log_write(DEBUG, (char *)"> direction=%s, angle_to_move=%.2f, default_angle=%.2f",
+                  DIRECTION_TO_STR[direction].c_str(), angle_to_move, default_angle);
+
+    /*Initialize Varibles */
+    NMT_result result = OK;
+    double     angle;
+
+    /** Determine which motor needs to be moved */
+    if (direction != CUSTOM)
+    {
+        switch (direction)
         {
-            return new L9110(hw_settings);
+            case UP:
+            case DOWN:
+                camera_motor = CAM_VERT_MTR;
+                break;
+            case LEFT:
+            case RIGHT:
+                camera_motor = CAM_HRZN_MTR;
+                break;
+            case CUSTOM:
+            case MAX_DIRECTIONS:
+                break;
         }
 
-    protected:
-    /** @var left_drv_motor
-     *  Left Drive Motor Object */
-    L9110 *left_drv_motor;
+        /** Get the Motors current Position */
+        result = get_servo_angle(camera_motor, &angle);
+    }
 
-    /** @var right_drv_motor
-     *  Right Drive Motor Object */
-    L9110 *right_drv_motor;
-};
+    /** Determine the angle motor should move to */
+    if (result == OK)
+    {
+        switch (direction)
+        {
+            case UP:
+            case LEFT:
+                angle_to_move = angle + default_angle;
+                break;
+            case RIGHT:
+            case DOWN:
+                angle_to_move = angle - default_angle;
+                break;
+            case CUSTOM:
+            case MAX_DIRECTIONS:
+                break;
+        }
+
+        /** Move the actual motor */
+        result = set_servo_angle(camera_motor, angle_to_move);
+    }
+
+    /* Exit the Function */
+    NMT_log_write(DEBUG, (char * )"< result=%s", result_e2s[result]);
+    return result; 
+}
 #endif
@@ -0,0 +1,239 @@
+/**
+ *  @file      RMCT_proto.hpp
+ *  @brief     Header file for RMCT_proto.cpp
+ *  @details   Command protocols (binary and JSON) for the Robot Motor Controller
+ *  @author    Nitin Mohan
+ *  @date      April 20, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+#ifndef _RMCT_proto_
+#define _RMCT_proto_
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "NMT_stdlib.h"
+#include "RMCT_lib.hpp"
+
+/*--------------------------------------------------/
+/                   Constants                       /
+/--------------------------------------------------*/
+/** @var RMCT_PROTO_MAGIC
+ *  First two bytes of every binary message ("NB"). A JSON
+ *  command always starts with '[' so the two never collide */
+const uint16_t RMCT_PROTO_MAGIC = 0x424e;
+
+/** @var RMCT_PROTO_VERSION
+ *  Newest protocol version RMCT speaks */
+const uint8_t RMCT_PROTO_VERSION = 2;
+
+/** @var RMCT_PROTO_ACK_BATCH_VERSION
+ *  First version with RMCT_PROTO_ACK_BATCH and RMCT_PROTO_LATENCY */
+const uint8_t RMCT_PROTO_ACK_BATCH_VERSION = 2;
+
+/** @var RMCT_PROTO_MAX_CLIENTS
+ *  Client IDs the header can carry */
+const unsigned int RMCT_PROTO_MAX_CLIENTS = 256;
+
+/** @var RMCT_PROTO_MAX_ACTIONS
+ *  Max hw_actions carried in one message */
+const unsigned int RMCT_PROTO_MAX_ACTIONS = 32;
+
+/*--------------------------------------------------/
+/                   Structs/Classes/Enums           /
+/--------------------------------------------------*/
+/** @enum RMCT_PROTO_TYPES
+ *  Binary message types */
+typedef enum {RMCT_PROTO_HELLO,
+              RMCT_PROTO_ACTIONS,
+              RMCT_PROTO_EXIT,
+              RMCT_PROTO_ACK,
+              RMCT_PROTO_ACK_BATCH,
+              RMCT_PROTO_LATENCY,
+              MAX_RMCT_PROTO_TYPES} RMCT_PROTO_TYPES;
+
+/** @struct RMCT_proto_header
+ *  Wire header (little endian) */
+typedef struct __attribute__((packed)) RMCT_proto_header
+{
+    /** @var magic
+     *  RMCT_PROTO_MAGIC */
+    uint16_t magic;
+
+    /** @var version
+     *  Protocol version of the sender */
+    uint8_t version;
+
+    /** @var type
+     *  RMCT_PROTO_TYPES */
+    uint8_t type;
+
+    /** @var seq
+     *  Sequence number, per client (echoed in the ack). 0 is unsequenced */
+    uint32_t seq;
+
+    /** @var count
+     *  Number of RMCT_proto_action records that follow */
+    uint16_t count;
+
+    /** @var result
+     *  NMT_result of the command (acks only) */
+    uint8_t result;
+
+    /** @var client
+     *  ID RMCT assigned the sender in the hello ack (echoed in the ack).
+     *  A hello from client 0 asks for one */
+    uint8_t client;
+} RMCT_proto_header;
+
+/** @struct RMCT_proto_action
+ *  Wire format of one hw_action (little endian) */
+typedef struct __attribute__((packed)) RMCT_proto_action
+{
+    /** @var motor
+     *  RMCT_MOTORS */
+    uint8_t motor;
+
+    /** @var direction
+     *  RMCT_DIRECTIONS */
+    uint8_t direction;
+
+    /** @var speed
+     *  Drive speed (< 0 for the default) */
+    int16_t speed;
+
+    /** @var angle
+     *  Absolute camera angle (IEEE 754 single) */
+    float angle;
+} RMCT_proto_action;
+
+/** @struct RMCT_proto_ack_record
+ *  Wire format of one result in an RMCT_PROTO_ACK_BATCH (little endian) */
+typedef struct __attribute__((packed)) RMCT_proto_ack_record
+{
+    /** @var seq
+     *  Sequence number of the command */
+    uint32_t seq;
+
+    /** @var result
+     *  NMT_result of the command */
+    uint8_t result;
+
+    /** @var reserved
+     *  Zero */
+    uint8_t reserved[3];
+} RMCT_proto_ack_record;
+
+static_assert(sizeof(RMCT_proto_header) == 12, "RMCT_proto_header is part of the wire format");
+static_assert(sizeof(RMCT_proto_action) == 8,  "RMCT_proto_action is part of the wire format");
+static_assert(sizeof(RMCT_proto_ack_record) == sizeof(RMCT_proto_action), "Records share one size");
+
+/** @var RMCT_PROTO_MAX_MSG
+ *  Largest binary message */
+const size_t RMCT_PROTO_MAX_MSG = sizeof(RMCT_proto_header) + RMCT_PROTO_MAX_ACTIONS * sizeof(RMCT_proto_action);
+
+/** @struct RMCT_proto_ack
+ *  A decoded result of an RMCT_PROTO_ACK_BATCH */
+typedef struct RMCT_proto_ack
+{
+    uint32_t seq;
+    NMT_result result;
+} RMCT_proto_ack;
+
+/** @struct RMCT_proto_msg
+ *  A decoded message. A JSON command decodes to RMCT_PROTO_ACTIONS,
+ *  or RMCT_PROTO_EXIT / RMCT_PROTO_LATENCY when it also carries an
+ *  exit / latency proc_action (exit wins). */
+typedef struct RMCT_proto_msg
+{
+    /** @var version
+     *  Protocol version of the sender */
+    uint8_t version;
+
+    /** @var type
+     *  RMCT_PROTO_TYPES */
+    RMCT_PROTO_TYPES type;
+
+    /** @var seq
+     *  Sequence number (0 if unsequenced) */
+    uint32_t seq;
+
+    /** @var client
+     *  Client ID */
+    uint8_t client;
+
+    /** @var result
+     *  NMT_result (acks only) */
+    NMT_result result;
+
+    /** @var count
+     *  Valid entries in actions */
+    unsigned int count;
+
+    /** @var actions
+     *  Decoded hw_actions */
+    MotorAction actions[RMCT_PROTO_MAX_ACTIONS];
+
+    /** @var acks
+     *  Decoded results (RMCT_PROTO_ACK_BATCH only) */
+    RMCT_proto_ack acks[RMCT_PROTO_MAX_ACTIONS];
+} RMCT_proto_msg;
+
+/** @enum RMCT_SEQ_VERDICTS
+ *  Outcome of checking a sequence number */
+typedef enum {RMCT_SEQ_NEW,
+              RMCT_SEQ_DUPLICATE,
+              RMCT_SEQ_STALE} RMCT_SEQ_VERDICTS;
+
+/** @class RMCT_seq_filter
+ *  Newest sequence number accepted from each client. Numbers compare
+ *  with wraparound (serial number arithmetic), so a datagram that was
+ *  duplicated or overtaken by a newer one is recognised. */
+class RMCT_seq_filter
+{
+    public:
+        /* Prototypes */
+        RMCT_SEQ_VERDICTS check(uint8_t client, uint32_t seq);
+        void reset(uint8_t client, uint32_t seq);
+        uint8_t assign(uint32_t seq);
+
+        /* Getters */
+        unsigned long duplicates() const {return duplicate_count;}
+        unsigned long stale() const {return stale_count;}
+
+    private:
+        /** @var last_seq
+         *  Newest sequence number accepted per client */
+        uint32_t last_seq[RMCT_PROTO_MAX_CLIENTS] = {0};
+
+        /** @var seen
+         *  Clients a sequenced command was accepted from */
+        bool seen[RMCT_PROTO_MAX_CLIENTS] = {false};
+
+        /** @var next_client
+         *  Next client ID handed out by assign (never 0) */
+        uint8_t next_client = 1;
+
+        /* Counters */
+        unsigned long duplicate_count = 0;
+        unsigned long stale_count = 0;
+};
+
+/*--------------------------------------------------/
+/                   Prototypes                      /
+/--------------------------------------------------*/
+bool RMCT_proto_is_binary(const char *buffer, size_t length);
+NMT_result RMCT_proto_decode(const char *buffer, size_t length, RMCT_proto_msg &msg);
+size_t RMCT_proto_encode(const RMCT_proto_msg &msg, char *buffer, size_t capacity);
+size_t RMCT_proto_encode_ack(uint8_t client, uint32_t seq, NMT_result result, char *buffer, size_t capacity);
+size_t RMCT_proto_encode_ack_batch(uint8_t client, const RMCT_proto_ack *acks, unsigned int count,
+                                   char *buffer, size_t capacity);
+NMT_result RMCT_proto_parse_json(const char *buffer, size_t length, RMCT_proto_msg &msg);
+
+#endif
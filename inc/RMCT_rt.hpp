@@ -0,0 +1,105 @@
+/**
+ *  @file      RMCT_rt.hpp
+ *  @brief     Header File for RMCT_rt.cpp
+ *  @details   Real-time fixed rate control loop for the Robot Motor Controller
+ *  @author    Nitin Mohan
+ *  @date      April 23, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+#ifndef _RMCT_rt_
+#define _RMCT_rt_
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <functional>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "NMT_stdlib.h"
+#include "RMCT_trace.hpp"
+
+/*--------------------------------------------------/
+/                   Constants                       /
+/--------------------------------------------------*/
+/** @var DEFAULT_RT_RATE
+ *  Default control loop rate (Hz) */
+const unsigned int DEFAULT_RT_RATE = 200;
+
+/** @var DEFAULT_RT_PRIORITY
+ *  SCHED_FIFO priority of the control loop */
+const int DEFAULT_RT_PRIORITY = 80;
+
+/*--------------------------------------------------/
+/                   Classes                         /
+/--------------------------------------------------*/
+/** @class RMCT_rt_loop
+ *  Calls on_tick at a fixed rate off absolute deadlines
+ *  (clock_nanosleep TIMER_ABSTIME on CLOCK_MONOTONIC). run() locks the
+ *  process memory, pins the calling thread to one CPU and switches it
+ *  to SCHED_FIFO, then loops until stop(). Wakeup jitter is kept per
+ *  tick; a tick that runs past the next deadline is an overrun and the
+ *  missed deadlines are skipped rather than run back to back. */
+class RMCT_rt_loop
+{
+    public:
+        /* Constructor */
+        RMCT_rt_loop(unsigned int rate_hz, int cpu, int priority, std::function<void()> on_tick);
+
+        /* Prototypes */
+        NMT_result run();
+        void stop();
+        void stats(RMCT_latency_histogram &jitter, uint64_t &overruns) const;
+
+        /* Getters */
+        uint64_t ticks() const {return tick_count;}
+        std::chrono::nanoseconds get_period() const {return period;}
+
+    private:
+        /** @var period
+         *  Time between ticks */
+        std::chrono::nanoseconds period;
+
+        /** @var cpu
+         *  CPU the loop is pinned to (< 0 for the last online CPU) */
+        int cpu;
+
+        /** @var priority
+         *  SCHED_FIFO priority */
+        int priority;
+
+        /** @var on_tick
+         *  Called from the loop thread every period */
+        std::function<void()> on_tick;
+
+        /** @var running
+         *  Cleared by stop() */
+        std::atomic<bool> running;
+
+        /** @var tick_count
+         *  Ticks run */
+        std::atomic<uint64_t> tick_count;
+
+        /** @var stats_lock
+         *  Guards jitter and overrun_count */
+        mutable std::mutex stats_lock;
+
+        /** @var jitter
+         *  Wakeup delay past each deadline */
+        RMCT_latency_histogram jitter;
+
+        /** @var overrun_count
+         *  Ticks that ran past the next deadline */
+        uint64_t overrun_count = 0;
+
+        /* Prototypes */
+        void setup();
+};
+
+#endif
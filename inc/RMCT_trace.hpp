@@ -0,0 +1,111 @@
+/**
+ *  @file      RMCT_trace.hpp
+ *  @brief     Header File for RMCT_trace.cpp
+ *  @details   Per stage command latency histograms for the Robot Motor Controller
+ *  @author    Nitin Mohan
+ *  @date      April 21, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+#ifndef _RMCT_trace_
+#define _RMCT_trace_
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <stdint.h>
+#include <time.h>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "NMT_stdlib.h"
+
+/*--------------------------------------------------/
+/                   Constants                       /
+/--------------------------------------------------*/
+/** @var RMCT_TRACE_BUCKETS
+ *  Power of 2 buckets per histogram - Bucket i holds latencies below
+ *  2^i ns (and at least 2^(i-1)), the last one everything longer */
+const unsigned int RMCT_TRACE_BUCKETS = 40;
+
+/*--------------------------------------------------/
+/                   Structs/Classes/Enums           /
+/--------------------------------------------------*/
+/** @enum RMCT_TRACE_STAGES
+ *  Points a command is stamped at, in order. The histogram of a stage
+ *  measures the time since the previous stamped stage. Commands are
+ *  acked on receipt, so dispatch includes the wait in the queue to
+ *  the actuation thread. */
+typedef enum {RMCT_STAGE_KERNEL,
+              RMCT_STAGE_RECV,
+              RMCT_STAGE_PARSE,
+              RMCT_STAGE_ACK_SEND,
+              RMCT_STAGE_DISPATCH,
+              RMCT_STAGE_I2C_ISSUE,
+              RMCT_STAGE_I2C_COMPLETE,
+              MAX_RMCT_TRACE_STAGES} RMCT_TRACE_STAGES;
+
+/** @var RMCT_TRACE_STAGE_TO_STR
+ *  Name of each stage in the latency report */
+const char *const RMCT_TRACE_STAGE_TO_STR[MAX_RMCT_TRACE_STAGES] = {"kernel",
+                                                                    "recv",
+                                                                    "parse",
+                                                                    "ack_send",
+                                                                    "dispatch",
+                                                                    "i2c_issue",
+                                                                    "i2c_complete"};
+
+/** @class RMCT_latency_histogram
+ *  Log2 histogram of latencies in ns */
+class RMCT_latency_histogram
+{
+    public:
+        /* Prototypes */
+        void add(uint64_t latency_ns);
+        uint64_t percentile(double percent) const;
+        void reset();
+
+        /* Getters */
+        uint64_t count() const {return samples;}
+        uint64_t max() const {return max_ns;}
+        uint64_t mean() const {return (samples ? sum_ns / samples : 0);}
+        uint64_t bucket(unsigned int index) const {return buckets[index];}
+
+    private:
+        /** @var buckets
+         *  Samples per power of 2 */
+        uint64_t buckets[RMCT_TRACE_BUCKETS] = {0};
+
+        /* Summary */
+        uint64_t samples = 0;
+        uint64_t sum_ns = 0;
+        uint64_t max_ns = 0;
+};
+
+/** @class RMCT_trace
+ *  Latency of every stage a command goes through, from the kernel
+ *  receive to the ack. A stage that was not stamped (zero) is skipped
+ *  and the next one is measured from the last stage that was. */
+class RMCT_trace
+{
+    public:
+        /* Prototypes */
+        static void stamp(struct timespec &stamp);
+        void record(const struct timespec stamps[MAX_RMCT_TRACE_STAGES]);
+        void reset();
+
+        /* Getters */
+        const RMCT_latency_histogram &stage(RMCT_TRACE_STAGES stage) const {return stages[stage];}
+        const RMCT_latency_histogram &total() const {return end_to_end;}
+
+    private:
+        /** @var stages
+         *  Latency into each stage (RMCT_STAGE_KERNEL stays empty) */
+        RMCT_latency_histogram stages[MAX_RMCT_TRACE_STAGES];
+
+        /** @var end_to_end
+         *  First to last stamped stage */
+        RMCT_latency_histogram end_to_end;
+};
+#endif
@@ -0,0 +1,102 @@
+/**
+ *  @file      RMCT_watchdog.hpp
+ *  @brief     Header File for RMCT_watchdog.cpp
+ *  @details   Deadman watchdog for the Robot Motor Controller
+ *  @author    Nitin Mohan
+ *  @date      April 12, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+#ifndef _RMCT_watchdog_
+#define _RMCT_watchdog_
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <functional>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "NMT_stdlib.h"
+
+/*--------------------------------------------------/
+/                   Constants                       /
+/--------------------------------------------------*/
+/** @var DEFAULT_CMD_DEADLINE
+ *  Default time (ms) a command stays fresh. 0 disables the deadman,
+ *  as clients that do not send heartbeats (see rmct_sock_lib) send a
+ *  drive command only once */
+const unsigned int DEFAULT_CMD_DEADLINE = 0;
+
+/** @var WATCHDOG_CHECKS_PER_DEADLINE
+ *  Number of times the deadline is checked per deadline period */
+const unsigned int WATCHDOG_CHECKS_PER_DEADLINE = 4;
+
+/*--------------------------------------------------/
+/                   Classes                         /
+/--------------------------------------------------*/
+/** @class RMCT_watchdog
+ *  Fires on_expire once when the watchdog has been fed and no further
+ *  feed arrives within the deadline. It is re-armed by the next feed.
+ *  A deadline of 0 disables it. */
+class RMCT_watchdog
+{
+    public:
+        /* Constructor */
+        RMCT_watchdog(std::chrono::milliseconds deadline, std::function<void()> on_expire);
+
+        /* Destructor */
+        ~RMCT_watchdog();
+
+        /* Prototypes */
+        void feed();
+        bool check(std::chrono::steady_clock::time_point now);
+        NMT_result start();
+        void stop();
+
+        /* Getters */
+        unsigned int expiries() const {return expiry_count;}
+        std::chrono::milliseconds get_deadline() const {return deadline;}
+        bool enabled() const {return deadline.count() > 0;}
+
+    private:
+        /** @var deadline
+         *  Time a feed stays fresh */
+        std::chrono::milliseconds deadline;
+
+        /** @var check_period
+         *  Time between deadline checks */
+        std::chrono::microseconds check_period;
+
+        /** @var on_expire
+         *  Called from the watchdog thread when the deadline passes */
+        std::function<void()> on_expire;
+
+        /** @var last_feed
+         *  Time of the last feed (steady_clock ticks) */
+        std::atomic<std::chrono::steady_clock::rep> last_feed;
+
+        /** @var armed
+         *  True from a feed until the deadline expires */
+        std::atomic<bool> armed;
+
+        /** @var expiry_count
+         *  Number of times the deadline expired */
+        std::atomic<unsigned int> expiry_count;
+
+        /** @var running
+         *  True while the watchdog thread runs */
+        std::atomic<bool> running;
+
+        /** @var worker
+         *  Watchdog thread */
+        std::thread worker;
+
+        /* Prototypes */
+        void run();
+};
+#endif
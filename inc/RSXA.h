@@ -13,6 +13,8 @@
 /                   System Imports                  /
 /--------------------------------------------------*/
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 /*--------------------------------------------------/
 /                   Local Imports                   /
@@ -22,22 +24,47 @@
 /*--------------------------------------------------/
 /                   Constants                       /
 /--------------------------------------------------*/
-#define MAX_CHAR_LEN_SHORT 20
 #define MAX_CHAR_LEN_LONG 100
 
+/** \def RSXA_STR_NONE
+ *  Handle of a string that is not in the table */
+#define RSXA_STR_NONE UINT32_MAX
+
+/** \def RS_SETTINGS_PATH
+ *  Hard coded path to the RSXA.json file */
+#define RS_SETTINGS_PATH "/etc/NiBot/RSXA.json"
+
+/** \def RS_IMAGE_PATH
+ *  Image rsxa-compile writes from RS_SETTINGS_PATH */
+#define RS_IMAGE_PATH "/etc/NiBot/RSXA.bin"
+
+/** \def RS_SHM_NAME
+ *  Shared memory segment rsxa-server publishes RS_SETTINGS_PATH in */
+#define RS_SHM_NAME "/NiBot_RSXA"
+
 /*------------------Prototypes----------------------*/
 #ifdef __cplusplus
     extern "C" 
     {
 #endif
 
+    /** @typedef RSXA_str
+     *  Handle of a string in an RSXA_strtab. Equal strings of one table
+     *  have equal handles, so names compare as integers. 0 is the empty
+     *  string. */
+    typedef uint32_t RSXA_str;
+
+    /** @struct RSXA_strtab
+     *  Interned strings of one RSXA (private to RSXA.c) */
+    struct RSXA_strtab;
+
     /** @struct RSXA_pins
      * Structure which holds hw interface info */
     typedef struct RSXA_pins
     {
         /** @var pin_name
          * Name of GPIO Pin */
-        char pin_name[MAX_CHAR_LEN_SHORT];
+        RSXA_str pin_name;
 
         /** @var pin_no
          *  Hardware Pin No */
@@ -51,19 +78,23 @@
     {
         /** @var hw_name
          *  @brief Hardware Name */
-        char hw_name[MAX_CHAR_LEN_SHORT];
+        RSXA_str hw_name;
 
         /** @var hw_sim_mode
          *  @brief True if in Simulation else False Name */
         bool hw_sim_mode;
 
+        /** @var array_len_hw_int
+         *  No of hw interfaces */
+        int array_len_hw_int;
+
         /** @var hw_interface
          *  Hardware Interface Definitions */
         RSXA_pins *hw_interface;
 
-        /** @var array_len_hw_int
-         *  No of hw interfaces */
-        int array_len_hw_int;
+        /** @var strings
+         *  Table hw_name and the pin names are in */
+        const struct RSXA_strtab *strings;
 
     }RSXA_hw;
 
@@ -73,11 +104,11 @@
     {
         /** @var proc_name
          *  Process Name */
-        char proc_name[MAX_CHAR_LEN_SHORT];
+        RSXA_str proc_name;
 
         /** @var server_ip
          *  IP Address that server subsribes to */
-        char server_ip[MAX_CHAR_LEN_SHORT];
+        RSXA_str server_ip;
 
         /** @var server_p
          *  Server Port Number */
@@ -85,21 +116,41 @@
 
         /** @var client_ip
          *  IP Address that client subsribes to */
-        char client_ip[MAX_CHAR_LEN_SHORT];
+        RSXA_str client_ip;
 
         /** @var client_p
          *  Client Port Number */
         int client_p;
 
+        /** @var transport
+         *  Transport to the proc - udp (default), unix or shm */
+        RSXA_str transport;
+
+        /** @var strings
+         *  Table the names and addresses are in */
+        const struct RSXA_strtab *strings;
+
     }RSXA_procs;
 
+    /** @enum RSXA_HW_CHANGES
+     *  Changes RSXA_diff_hw reports (bit mask) */
+    typedef enum {RSXA_HW_SAME = 0x0, RSXA_HW_SIM_MODE = 0x1, RSXA_HW_PINS = 0x2} RSXA_HW_CHANGES;
+
+    /** @struct RSXA_index
+     *  Hash tables over the hw and proc names (private to RSXA.c) */
+    struct RSXA_index;
+
     /** @struct RSXA
      * Root struct with all Robot Settings */
     typedef struct RSXA
     {
         /** @var log_dir
          *  Default Log Directory */
-        char log_dir[MAX_CHAR_LEN_LONG];
+        RSXA_str log_dir;
+
+        /** @var strings
+         *  Every string of the settings (in the arena) */
+        const struct RSXA_strtab *strings;
 
         /** @var procs
          *  List of all proceses */
@@ -116,11 +167,49 @@
         /** @var array_len_hw
          *  No of hw structs */
         int array_len_hw;
+
+        /** @var image
+         *  Mapped image holding the arena (NULL if parsed from JSON) */
+        void *image;
+
+        /** @var image_size
+         *  Size of the mapped image */
+        size_t image_size;
+
+        /** @var arena
+         *  Single block holding procs, hw, their pins and index */
+        void *arena;
+
+        /** @var index
+         *  Name lookups for RSXA_find_hw and RSXA_find_proc (in the arena) */
+        struct RSXA_index *index;
+
+        /** @var generation
+         *  Generation of the published settings it was read from (0 if not) */
+        uint64_t generation;
         }RSXA;
 
     /* External Interfaces Definitions */
     extern NMT_result RSXA_init(RSXA *RSXA_Object);
+    extern NMT_result RSXA_compile(const char *json_path, const char *image_path);
+    extern NMT_result RSXA_publish(const char *json_path, const char *shm_name);
+    extern uint64_t RSXA_shm_generation(const char *shm_name);
     extern void RSXA_free_mem(RSXA *RSXA_Object);
+    extern RSXA_hw *RSXA_find_hw(const RSXA *RSXA_Object, const char *hw_name);
+    extern RSXA_procs *RSXA_find_proc(const RSXA *RSXA_Object, const char *proc_name);
+    extern RSXA_pins *RSXA_find_pin(const RSXA_hw *hw, const char *pin_name);
+    extern int RSXA_diff_hw(const RSXA_hw *old_hw, const RSXA_hw *new_hw);
+    extern bool RSXA_diff_proc(const RSXA_procs *old_proc, const RSXA_procs *new_proc);
+    extern int RSXA_watch(const char *json_path);
+    extern bool RSXA_watch_changed(int watch_fd, const char *json_path);
+    extern const char *RSXA_str_get(const struct RSXA_strtab *strings, RSXA_str id);
+    extern size_t RSXA_str_len(const struct RSXA_strtab *strings, RSXA_str id);
+    extern RSXA_str RSXA_str_find(const struct RSXA_strtab *strings, const char *str, size_t len);
+    extern bool RSXA_str_equal(const struct RSXA_strtab *a_strings, RSXA_str a,
+                               const struct RSXA_strtab *b_strings, RSXA_str b);
+    extern struct RSXA_strtab *RSXA_strtab_new(uint32_t count, size_t chars);
+    extern RSXA_str RSXA_intern(struct RSXA_strtab *strings, const char *str, size_t len);
+    extern void RSXA_strtab_free(struct RSXA_strtab *strings);
 
 #ifdef __cplusplus
     }
@@ -0,0 +1,87 @@
+/**
+ *  @file      RSXA.hpp
+ *  @brief     C++ reader for the Robot Settings
+ *  @details   Owns an RSXA loaded by RSXA_init (published copy, else
+ *             image, else RSXA.json) and frees it when destroyed
+ *  @author    Nitin Mohan
+ *  @date      May 30, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+#ifndef DEF_RSXA_HPP
+#define DEF_RSXA_HPP
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <stdint.h>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "NMT_stdlib.h"
+#include "RSXA.h"
+
+/*--------------------------------------------------/
+/                   Classes                         /
+/--------------------------------------------------*/
+/** @class RSXA_reader
+ *  Empty until load() succeeds. Not copyable - The hw, procs and pins
+ *  it hands out point into the RSXA it owns. */
+class RSXA_reader
+{
+    public:
+        RSXA_reader() = default;
+        RSXA_reader(const RSXA_reader &) = delete;
+        RSXA_reader &operator=(const RSXA_reader &) = delete;
+        ~RSXA_reader() {RSXA_free_mem(&this->rsxa);}
+
+        NMT_result load()
+        {
+            /*!
+             *  @brief     Read the current settings, replacing the ones held
+             *  @return    NMT_result (Empty if NOK)
+             */
+
+            RSXA_free_mem(&this->rsxa);
+            this->rsxa = {};
+
+            return RSXA_init(&this->rsxa);
+        }
+
+        RSXA &settings() {return this->rsxa;}
+        const RSXA &settings() const {return this->rsxa;}
+
+        const RSXA_hw *find_hw(const char *hw_name) const {return RSXA_find_hw(&this->rsxa, hw_name);}
+        const RSXA_procs *find_proc(const char *proc_name) const {return RSXA_find_proc(&this->rsxa, proc_name);}
+
+        const char *str(RSXA_str id) const {return RSXA_str_get(this->rsxa.strings, id);}
+
+        uint64_t generation() const
+        {
+            /*!
+             *  @brief     Generation of the published settings read (0 if
+             *             they were read from the image or the JSON)
+             *  @return    uint64_t
+             */
+
+            return this->rsxa.generation;
+        }
+
+        bool stale() const
+        {
+            /*!
+             *  @brief     Whether rsxa-server has published settings newer
+             *             than the ones held
+             *  @return    bool
+             */
+
+            return RSXA_shm_generation(RS_SHM_NAME) > this->rsxa.generation;
+        }
+
+    private:
+        /** @var rsxa
+         *  Settings owned */
+        RSXA rsxa = {};
+};
+
+#endif
@@ -14,6 +14,7 @@
 #include <chrono>
 #include <cstring>
 #include <stdexcept>
+#include <algorithm>
 
 /*--------------------------------------------------/
 /                   Local Imports                   /
@@ -24,9 +25,7 @@
 /*--------------------------------------------------/
 /                   Constants                       /
 /--------------------------------------------------*/
-static const unsigned int MAX_MOTORS = 2;
 static const unsigned int MAX_PINS = 2;
-static const double SETTLE_TIME = 500;
 static const double DELAY_TIME = 0.00;
 
 
@@ -35,43 +34,43 @@ static const double DELAY_TIME = 0.00;
 /                   Start of Program                /
 /--------------------------------------------------*/
 using namespace std;
-L9110::L9110(RSXA_hw hw_config)
+L9110::L9110(RSXA_hw hw_config, L9110_ramp_settings ramp_settings, bool init_hw)
 {
     /*!
      *  @brief     Constructor definition for L9110 Object
      *  @param[in] hw_config RSXA HW Settings
+     *  @param[in] ramp_settings (Optional)
+     *  @param[in] init_hw (Optional - If false, call L9110_init later)
      *  @return    void
      */
 
-    NMT_log_write(DEBUG, (char *)"> ");
+    NMT_log_write(DEBUG, (char *)"> slew_rate=%.2f dead_time=%.2f", 
+                                 ramp_settings.slew_rate, ramp_settings.dead_time);
     NMT_result result = OK;
 
     /* Get the hardware Name and mode */
-    this->hw_name = hw_config.hw_name;
+    this->hw_name = RSXA_str_get(hw_config.strings, hw_config.hw_name);
     this->sim_mode = hw_config.hw_sim_mode;
+    this->ramp = ramp_settings;
 
     /* Find and fill the forward/reverse pins */
-    for (unsigned int i = 0; i < MAX_MOTORS; i++)
-    {
-        if (strcmp(hw_config.hw_interface[i].pin_name, "forward") == 0)
-        {
-            this->forward = (PCA9685_PWM_CHANNEL)hw_config.hw_interface[i].pin_no;
-        }
+    const RSXA_pins *forward_pin = RSXA_find_pin(&hw_config, "forward");
+    const RSXA_pins *reverse_pin = RSXA_find_pin(&hw_config, "reverse");
 
-        else if (strcmp(hw_config.hw_interface[i].pin_name, "reverse") == 0)
-        {
-            this->reverse = (PCA9685_PWM_CHANNEL)hw_config.hw_interface[i].pin_no;
-        }
-        else
-        {
-            NMT_log_write(ERROR, (char *)"Forward or Reverse pinNo not found for %s", this->hw_name.c_str());
-            result = NOK;
-        }
+    if ((forward_pin == NULL) || (reverse_pin == NULL))
+    {
+        NMT_log_write(ERROR, (char *)"Forward or Reverse pinNo not found for %s", this->hw_name.c_str());
+        result = NOK;
+    }
+    else
+    {
+        this->forward = (PCA9685_PWM_CHANNEL)forward_pin->pin_no;
+        this->reverse = (PCA9685_PWM_CHANNEL)reverse_pin->pin_no;
     }
 
     /* Initialize Motoros to Stop */
-    if (result == OK)
-        result = L9110::L9110_move_motor(STOP);
+    if ((result == OK) && (init_hw))
+        result = L9110::L9110_init();
 
     if (result == NOK)
         throw std::runtime_error("Error! Unable to Initialize L9110 Motors");
@@ -81,6 +80,16 @@ L9110::L9110(RSXA_hw hw_config)
                                  this->hw_name.c_str(), btoa(this->sim_mode), this->forward, this->reverse);
 } 
 
+NMT_result L9110::L9110_init()
+{
+    /*!
+     *  @brief     Bring the hardware up with the motor stopped
+     *  @return    NMT_result
+     */
+
+    return L9110::L9110_move_motor(STOP);
+}
+
 NMT_result L9110::L9110_move_motor(L9110_DIRECTIONS direction, int speed)
 {
     /*!
@@ -97,6 +106,9 @@ NMT_result L9110::L9110_move_motor(L9110_DIRECTIONS direction, int speed)
     /* Cap Max Speed to 100 and Min to 0 */
     speed = (speed > 100 ? 100 : (speed < 0 ? 0 : speed));
 
+    /* Moving directly overrides any ramp in progress */
+    std::lock_guard<std::mutex> guard(this->ramp_lock);
+
     if (!(this->sim_mode))
     {
         switch (direction)
@@ -115,7 +127,334 @@ NMT_result L9110::L9110_move_motor(L9110_DIRECTIONS direction, int speed)
                 break;
         }
     }
+
+    /* Record what the H-Bridge is now driven at */
+    if (result == OK)
+    {
+        this->drive_dir      = direction;
+        this->drive_duty     = (direction == STOP ? 0 : speed);
+        this->target_dir     = this->drive_dir;
+        this->target_duty    = this->drive_duty;
+        this->coast_dir      = STOP;
+        this->dead_time_left = 0;
+        this->out_forward    = (direction == FORWARD ? this->drive_duty : 0);
+        this->out_reverse    = (direction == REVERSE ? this->drive_duty : 0);
+        this->step_forward   = this->out_forward;
+        this->step_reverse   = this->out_reverse;
+    }
+
     NMT_log_write(DEBUG, (char *)"< result=%s", result_e2s[result]);
     return result;
 }
 
+NMT_result L9110::L9110_ramp_motor(L9110_DIRECTIONS direction, int speed)
+{
+    /*!
+     *  @brief     Set the direction/speed the motor ramps towards.
+     *             No hardware is touched, the ramp scheduler applies
+     *             the change on its next ticks.
+     *  @param[in] dir
+     *  @param[in] speed (Optional)
+     *  @return    NMT_result
+     */
+
+    NMT_log_write(DEBUG, (char *)"> dir=%s speed=%d", L9110_DIR_TO_STR[direction].c_str(), speed);
+
+    /* Cap Max Speed to 100 and Min to 0 */
+    speed = (speed > 100 ? 100 : (speed < 0 ? 0 : speed));
+
+    /* Update the target */
+    {
+        std::lock_guard<std::mutex> guard(this->ramp_lock);
+        this->target_dir  = direction;
+        this->target_duty = (direction == STOP ? 0 : speed);
+    }
+
+    NMT_log_write(DEBUG, (char *)"< result=%s", result_e2s[OK]);
+    return OK;
+}
+
+void L9110::L9110_halt()
+{
+    /*!
+     *  @brief     Drop any ramp in progress after the outputs have been
+     *             forced off (see L9110_ramp_scheduler::halt). A motor
+     *             that was driving is left coasting so a reversal still
+     *             waits out the dead time.
+     *  @return    void
+     */
+
+    std::lock_guard<std::mutex> guard(this->ramp_lock);
+
+    if (this->drive_dir != STOP)
+    {
+        this->coast_dir      = this->drive_dir;
+        this->dead_time_left = this->ramp.dead_time;
+    }
+
+    this->drive_dir    = STOP;
+    this->drive_duty   = 0;
+    this->target_dir   = STOP;
+    this->target_duty  = 0;
+    this->out_forward  = 0;
+    this->out_reverse  = 0;
+    this->step_forward = 0;
+    this->step_reverse = 0;
+}
+
+NMT_result L9110::L9110_reconfigure(RSXA_hw hw_config)
+{
+    /*!
+     *  @brief     Apply new pins and sim mode without stopping the
+     *             ramp. The old channels are turned off and the next
+     *             ramp step writes the current duty cycle to the new
+     *             ones, so a moving motor keeps its speed.
+     *  @param[in] hw_config RSXA HW Settings
+     *  @return    NMT_result (a missing pin changes nothing)
+     */
+
+    NMT_log_write(DEBUG, (char *)"> hw_name=%s sim_mode=%s", RSXA_str_get(hw_config.strings, hw_config.hw_name), btoa(hw_config.hw_sim_mode));
+
+    /* Initialize Variables */
+    NMT_result result = OK;
+    const RSXA_pins *forward_pin = RSXA_find_pin(&hw_config, "forward");
+    const RSXA_pins *reverse_pin = RSXA_find_pin(&hw_config, "reverse");
+
+    if ((forward_pin == NULL) || (reverse_pin == NULL))
+    {
+        NMT_log_write(ERROR, (char *)"Forward or Reverse pinNo not found for %s", this->hw_name.c_str());
+        result = NOK;
+    }
+
+    if (result == OK)
+    {
+        std::lock_guard<std::mutex> guard(this->ramp_lock);
+
+        /* Release the channels this motor is no longer driven through */
+        if (!(this->sim_mode))
+        {
+            if (this->out_forward > 0) {result = PCA9685_setPWM(0.00, DELAY_TIME, this->forward);}
+            if ((result == OK) && (this->out_reverse > 0)) {result = PCA9685_setPWM(0.00, DELAY_TIME, this->reverse);}
+        }
+
+        if (result == OK)
+        {
+            this->sim_mode     = hw_config.hw_sim_mode;
+            this->forward      = (PCA9685_PWM_CHANNEL)forward_pin->pin_no;
+            this->reverse      = (PCA9685_PWM_CHANNEL)reverse_pin->pin_no;
+            this->out_forward  = 0;
+            this->out_reverse  = 0;
+            this->step_forward = 0;
+            this->step_reverse = 0;
+        }
+    }
+
+    NMT_log_write(DEBUG, (char *)"< forward=%d reverse=%d result=%s", this->forward, this->reverse, result_e2s[result]);
+    return result;
+}
+
+unsigned int L9110::L9110_ramp_step(double elapsed_ms, PCA9685_pwm_update *updates)
+{
+    /*!
+     *  @brief      Advance the ramp by elapsed_ms and report the channel
+     *              changes needed since the last acked write. Direction
+     *              changes ramp down to zero first and reversals wait
+     *              out the dead time.
+     *  @param[in]  elapsed_ms
+     *  @param[out] updates (room for L9110_MAX_UPDATES)
+     *  @return     Number of updates written
+     */
+
+    /* Initialize Variables */
+    unsigned int count = 0;
+    std::lock_guard<std::mutex> guard(this->ramp_lock);
+    double step = this->ramp.slew_rate * (elapsed_ms / 1000.00);
+
+    /* Count down the dead time */
+    this->dead_time_left = (this->dead_time_left > elapsed_ms ? this->dead_time_left - elapsed_ms : 0);
+
+    /* Leaving the current direction - Ramp down and coast */
+    if ((this->drive_dir != STOP) && (this->drive_dir != this->target_dir))
+    {
+        this->drive_duty = (this->drive_duty > step ? this->drive_duty - step : 0);
+
+        if (this->drive_duty == 0)
+        {
+            this->coast_dir      = this->drive_dir;
+            this->drive_dir      = STOP;
+            this->dead_time_left = this->ramp.dead_time;
+        }
+    }
+
+    /* At rest - Start the new direction once a reversal is safe */
+    else if ((this->drive_dir == STOP) && (this->target_dir != STOP))
+    {
+        if ((this->coast_dir == this->target_dir) || (this->coast_dir == STOP) || 
+            (this->dead_time_left == 0))
+        {
+            this->drive_dir = this->target_dir;
+            this->coast_dir = STOP;
+        }
+    }
+
+    /* Driving in the target direction - Slew towards the target speed */
+    if ((this->drive_dir != STOP) && (this->drive_dir == this->target_dir))
+    {
+        if (this->drive_duty < this->target_duty)
+            this->drive_duty = std::min(this->drive_duty + step, this->target_duty);
+        else
+            this->drive_duty = std::max(this->drive_duty - step, this->target_duty);
+    }
+
+    /* Report the channels that changed (the one turning off first) */
+    double forward_duty = (this->drive_dir == FORWARD ? this->drive_duty : 0);
+    double reverse_duty = (this->drive_dir == REVERSE ? this->drive_duty : 0);
+
+    if (forward_duty < this->out_forward)
+        updates[count++] = {this->forward, forward_duty, DELAY_TIME};
+    if (reverse_duty != this->out_reverse)
+        updates[count++] = {this->reverse, reverse_duty, DELAY_TIME};
+    if (forward_duty > this->out_forward)
+        updates[count++] = {this->forward, forward_duty, DELAY_TIME};
+
+    /* Held until the write is acked - A failed write is re-sent next step */
+    this->step_forward = forward_duty;
+    this->step_reverse = reverse_duty;
+
+    /* Nothing is written in sim mode */
+    if (this->sim_mode) {count = 0;}
+
+    return count;
+}
+
+void L9110::L9110_ramp_ack()
+{
+    /*!
+     *  @brief     Mark the updates of the last L9110_ramp_step as
+     *             written. Call only once the PWM write succeeded.
+     *  @return    void
+     */
+
+    std::lock_guard<std::mutex> guard(this->ramp_lock);
+
+    this->out_forward = this->step_forward;
+    this->out_reverse = this->step_reverse;
+}
+
+L9110_ramp_scheduler::L9110_ramp_scheduler(double tick_rate)
+{
+    /*!
+     *  @brief     Constructor definition for L9110_ramp_scheduler
+     *  @param[in] tick_rate (Hz)
+     *  @return    void
+     */
+
+    this->tick_period = std::chrono::microseconds((long)(1000000.00 / tick_rate));
+}
+
+void L9110_ramp_scheduler::attach_motor(L9110 *motor)
+{
+    /*!
+     *  @brief     Add a motor to be stepped on every tick
+     *  @param[in] motor
+     *  @return    void
+     */
+
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->motors.push_back(motor);
+}
+
+unsigned int L9110_ramp_scheduler::collect_steps(PCA9685_pwm_update *updates)
+{
+    /*!
+     *  @brief      Step every motor by the time since the last step
+     *  @param[out] updates
+     *  @return     Number of updates written
+     */
+
+    /* Initialize Variables */
+    unsigned int count = 0;
+    auto now = std::chrono::steady_clock::now();
+    double elapsed_ms = std::chrono::duration<double, std::milli>(this->tick_period).count();
+
+    if (this->stepped)
+        elapsed_ms = std::chrono::duration<double, std::milli>(now - this->last_step).count();
+
+    this->last_step = now;
+    this->stepped   = true;
+
+    for (L9110 *motor : this->motors)
+        count += motor->L9110_ramp_step(elapsed_ms, &updates[count]);
+
+    return count;
+}
+
+NMT_result L9110_ramp_scheduler::tick(PCA9685_pwm_update *updates, unsigned int *update_count)
+{
+    /*!
+     *  @brief      Step all motors once
+     *  @param[out] updates (Room for L9110_MAX_UPDATES per motor)
+     *  @param[out] update_count
+     *  @return     NMT_result
+     */
+
+    return this->commit(NULL, 0, updates, update_count);
+}
+
+NMT_result L9110_ramp_scheduler::commit(const L9110_ramp_target *targets, unsigned int target_count,
+                                        PCA9685_pwm_update *updates, unsigned int *update_count)
+{
+    /*!
+     *  @brief      Apply new ramp targets and step all motors in one go.
+     *              A tick cannot run in between, so all targets take
+     *              effect on the same step.
+     *  @param[in]  targets
+     *  @param[in]  target_count
+     *  @param[out] updates (Room for L9110_MAX_UPDATES per motor)
+     *  @param[out] update_count
+     *  @return     NMT_result
+     */
+
+    /* Initialize Variables */
+    NMT_result result = OK;
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    for (unsigned int i = 0; ((result == OK) && (i < target_count)); i++)
+        result = targets[i].motor->L9110_ramp_motor(targets[i].direction, targets[i].speed);
+
+    *update_count = (result == OK ? this->collect_steps(updates) : 0);
+
+    return result;
+}
+
+void L9110_ramp_scheduler::ack()
+{
+    /*!
+     *  @brief     The updates of the last tick/commit were written
+     *  @return    void
+     */
+
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    for (L9110 *motor : this->motors)
+        motor->L9110_ramp_ack();
+}
+
+void L9110_ramp_scheduler::halt()
+{
+    /*!
+     *  @brief     Emergency stop. The attached motors drop their ramps,
+     *             so the next tick does not drive them again. The caller
+     *             forces the channels off.
+     *  @return    void
+     */
+
+    NMT_log_write(DEBUG, (char *)"> motors=%u", (unsigned int)this->motors.size());
+
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    for (L9110 *motor : this->motors)
+        motor->L9110_halt();
+
+    NMT_log_write(DEBUG, (char *)"<");
+}
@@ -79,7 +79,6 @@ bool SIM_MODE;
 static PCA9685_PWM_CHANNEL LD27MG_m2c(LD27MG_MOTORS motor);
 static double              LD27MG_get_duty_cycle(double angle, double freq);
 static double              LD27MG_get_angle(double duty_cycle, double freq);
-static NMT_result          LD27MG_mtr_str2enum(char *mtr_str, LD27MG_MOTORS *mtr_enum);
 
 /*--------------------------------------------------/
 /                   Start of Program                /
@@ -95,7 +94,6 @@ NMT_result LD27MG_init(RSXA_hw hw_config)
     /* Initialize Variables */
     NMT_result result = OK;
     bool initialized = false;
-    LD27MG_MOTORS camera_motor;
 
     NMT_log_write(DEBUG, "> ");
 
@@ -113,14 +111,19 @@ NMT_result LD27MG_init(RSXA_hw hw_config)
     /* Apply Motor Settings */
     for (int i = 0; ((result == OK) && (i < MAX_NR_OF_MOTORS)); i++)
     {
-        /* Convert Motor String to ENUM */
-        result = LD27MG_mtr_str2enum(hw_config.hw_interface[i].pin_name, &camera_motor);
+        /* Find the pin named after the motor */
+        const RSXA_pins *pin = RSXA_find_pin(&hw_config, LD27MG_m2s[i]);
 
         /* Fill Struct */
-        if (result == OK)
+        if (pin != NULL)
         {
-            LD27MG_M2C_MAP[i].channel = (PCA9685_PWM_CHANNEL)hw_config.hw_interface[i].pin_no;
-            LD27MG_M2C_MAP[i].motor = camera_motor;
+            LD27MG_M2C_MAP[i].channel = (PCA9685_PWM_CHANNEL)pin->pin_no;
+            LD27MG_M2C_MAP[i].motor = (LD27MG_MOTORS)i;
+        }
+        else
+        {
+            result = NOK;
+            NMT_log_write(ERROR, "Incorrect LD27MG Motor Name!");
         }
     }
 
@@ -145,6 +148,67 @@ NMT_result LD27MG_init(RSXA_hw hw_config)
     return result;
 }
 
+NMT_result LD27MG_reconfigure(RSXA_hw hw_config)
+{
+    /*!
+     *  @brief     Apply new channels and sim mode without homing the
+     *             motors. A motor moved to another channel keeps its
+     *             angle and its old channel is turned off. Coming out
+     *             of sim mode, a motor stays where it is until moved.
+     *  @param[in] hw_config
+     *  @return    NMT_result (a missing pin changes nothing)
+     */
+
+    /* Initialize Variables */
+    NMT_result result = OK;
+    PCA9685_PWM_CHANNEL channels[MAX_NR_OF_MOTORS];
+    double duty_cycle = 0;
+
+    NMT_log_write(DEBUG, "> sim_mode=%s", btoa(hw_config.hw_sim_mode));
+
+    /* Every motor needs a pin before anything is changed */
+    for (int i = 0; ((result == OK) && (i < MAX_NR_OF_MOTORS)); i++)
+    {
+        const RSXA_pins *pin = RSXA_find_pin(&hw_config, LD27MG_m2s[i]);
+
+        if (pin != NULL)
+        {
+            channels[i] = (PCA9685_PWM_CHANNEL)pin->pin_no;
+        }
+        else
+        {
+            result = NOK;
+            NMT_log_write(ERROR, "Incorrect LD27MG Motor Name!");
+        }
+    }
+
+    for (int i = 0; ((result == OK) && (i < MAX_NR_OF_MOTORS)); i++)
+    {
+        PCA9685_PWM_CHANNEL old_channel = LD27MG_M2C_MAP[i].channel;
+
+        /* Carry the angle over to the new channel */
+        if ((!SIM_MODE) && (channels[i] != old_channel))
+        {
+            result = PCA9685_getPWM(&duty_cycle, old_channel);
+            if ((result == OK) && (!hw_config.hw_sim_mode)) {result = PCA9685_setPWM(duty_cycle, 0, channels[i]);}
+            if (result == OK) {result = PCA9685_setPWM(0.00, 0, old_channel);}
+        }
+
+        /* Leaving for sim mode - Let go of the channel */
+        else if ((!SIM_MODE) && (hw_config.hw_sim_mode))
+        {
+            result = PCA9685_setPWM(0.00, 0, old_channel);
+        }
+
+        if (result == OK) {LD27MG_M2C_MAP[i].channel = channels[i];}
+    }
+
+    if (result == OK) {SIM_MODE = hw_config.hw_sim_mode;}
+
+    NMT_log_write(DEBUG, "< result=%s", result_e2s[result]);
+    return result;
+}
+
 NMT_result LD27MG_get_current_position(LD27MG_MOTORS motor, double *angle)
 {
     /*!
@@ -191,27 +255,40 @@ NMT_result LD27MG_move_motor(LD27MG_MOTORS motor, double angle)
 
     /* Initialize varibles */
     NMT_result result = OK;
-    PCA9685_PWM_CHANNEL channel;
-    double duty_cycle;
-    double delay_time;
-
-    /* Get corresponding channel to motor string */
-    channel = LD27MG_m2c(motor);
+    PCA9685_pwm_update update;
 
     /* Set PWM for the corresponding channel */
-    duty_cycle = LD27MG_get_duty_cycle(angle, PCA9685_get_curret_freq());
-    
-    delay_time = 0;
-
-    if (!SIM_MODE)
+    if (LD27MG_stage_move(motor, angle, &update) > 0)
     {
-        result = PCA9685_setPWM(duty_cycle, delay_time, channel);
+        result = PCA9685_setPWM(update.duty_cycle, update.delay_time, update.channel);
     }
 
     NMT_log_write(DEBUG, "< result=%s",result_e2s[result]);
     return result;
 }
 
+unsigned int LD27MG_stage_move(LD27MG_MOTORS motor, double angle, PCA9685_pwm_update *update)
+{
+    /*!
+     *  @brief      Work out the channel update that moves the motor to
+     *              the provided angle without writing it, so it can be
+     *              sent as part of a PCA9685_setPWM_batch
+     *  @param[in]  motor
+     *  @param[in]  angle
+     *  @param[out] update
+     *  @return     Number of updates written (0 in simulation mode)
+     */
+
+    if (SIM_MODE)
+        return 0;
+
+    update->channel    = LD27MG_m2c(motor);
+    update->duty_cycle = LD27MG_get_duty_cycle(angle, PCA9685_get_curret_freq());
+    update->delay_time = 0;
+
+    return 1;
+}
+
 static PCA9685_PWM_CHANNEL LD27MG_m2c(LD27MG_MOTORS motor)
 {
     //Input     : String with motor name
@@ -302,36 +379,3 @@ static double LD27MG_get_angle(double duty_cycle, double freq)
 
     return angle;
 }
-
-static NMT_result LD27MG_mtr_str2enum(char *mtr_str, LD27MG_MOTORS *mtr_enum)
-{
-    /*!
-     *  @brief     Convert Motor String to LD27MG_MOTORS ENUM
-     *  @param[in] mtr_str
-     *  @param[in] mtr_enum
-     *  @return    NMT_result
-     */
-    NMT_log_write(DEBUG, "> mtr_str=%s",mtr_str);
-
-    /* Initialize Varibles */
-    NMT_result result = OK;
-
-    /* Convert Algorithm */
-    if (strcmp(mtr_str, "CAM_HRZN_MTR") == 0)
-    {
-        *mtr_enum = CAM_HRZN_MTR;
-    }
-    else if (strcmp(mtr_str, "CAM_VERT_MTR") == 0)
-    {
-        *mtr_enum = CAM_VERT_MTR;
-    }
-    else
-    {
-        result = NOK;
-        NMT_log_write(ERROR, "Incorrect LD27MG Motor Name!");
-    }
-
-    /* Exit the function */
-    NMT_log_write(DEBUG, "< result=%s",result_e2s[result]);
-    return result;
-}
@@ -12,7 +12,23 @@
 /--------------------------------------------------*/
 #include <iostream>
 #include <string.h> 
+#include <stdlib.h>
 #include <unistd.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <sys/un.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <pthread.h>
+#include <errno.h>
+#include <time.h>
+#include <atomic>
+#include <utility>
 
 /*--------------------------------------------------/
 /                   Local Imports                   /
@@ -21,12 +37,48 @@
 #include "NMT_stdlib.h"
 #include "NMT_log.h"
 
-/*--------------------------------------------------/
-/                   Constants                       /
-/--------------------------------------------------*/
-const unsigned int MAX_BUFFER_SIZE = 10240;
-
 using namespace std;
+
+/** @var NMT_SOCK_CMSG_SPACE
+ *  Control buffer for the receive timestamp */
+static const size_t NMT_SOCK_CMSG_SPACE = CMSG_SPACE(sizeof(struct timespec));
+
+static void NMT_enable_rx_time(int fd)
+{
+    /*!
+     *  @brief     Ask the kernel to stamp every datagram it receives on
+     *             fd. Reads fall back to the time of the read without it.
+     *  @param[in] fd
+     *  @return    void
+     */
+
+    int opt = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &opt, sizeof(opt)) < 0)
+        NMT_log_write(WARNING, (char *)"Kernel receive timestamps not available errno=%d", errno);
+}
+
+static void NMT_get_rx_time(struct msghdr *hdr, struct timespec *rx_time)
+{
+    /*!
+     *  @brief      Kernel receive time of a datagram (SCM_TIMESTAMPNS),
+     *              or now if the kernel did not stamp it
+     *  @param[in]  hdr
+     *  @param[out] rx_time
+     *  @return     void
+     */
+
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(hdr); cmsg; cmsg = CMSG_NXTHDR(hdr, cmsg))
+    {
+        if ((cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_TIMESTAMPNS))
+        {
+            memcpy(rx_time, CMSG_DATA(cmsg), sizeof(*rx_time));
+            return;
+        }
+    }
+
+    clock_gettime(CLOCK_REALTIME, rx_time);
+}
+
 NMT_sock_multicast::NMT_sock_multicast(unsigned int port, string multicast_ip,
                                        sock_mode socket_mode, unsigned int socket_timeout) : socket_timeout(socket_timeout)
 {
@@ -47,6 +99,58 @@ NMT_sock_multicast::NMT_sock_multicast(unsigned int port, string multicast_ip,
     else {this->result = NMT_init_multicast_client();}
 }
 
+NMT_sock_multicast::NMT_sock_multicast(NMT_sock_multicast &&other) noexcept :
+    result(other.result), port(other.port), multicast_ip(std::move(other.multicast_ip)), sock(other.sock),
+    socket_timeout(other.socket_timeout), mode(other.mode), my_address(other.my_address)
+{
+    /*!
+     *  @brief     Move Constructor - Takes over the socket of other
+     *  @param[in] other (Left without a socket)
+     *  @return    void
+     */
+
+    other.sock   = -1;
+    other.result = NOK;
+}
+
+NMT_sock_multicast &NMT_sock_multicast::operator=(NMT_sock_multicast &&other) noexcept
+{
+    /*!
+     *  @brief     Move Assignment - Closes this socket and takes over
+     *             the socket of other
+     *  @param[in] other (Left without a socket)
+     *  @return    *this
+     */
+
+    if (this != &other)
+    {
+        if (this->sock >= 0) {close(this->sock);}
+
+        this->result         = other.result;
+        this->port           = other.port;
+        this->multicast_ip   = std::move(other.multicast_ip);
+        this->sock           = other.sock;
+        this->socket_timeout = other.socket_timeout;
+        this->mode           = other.mode;
+        this->my_address     = other.my_address;
+
+        other.sock   = -1;
+        other.result = NOK;
+    }
+
+    return *this;
+}
+
+NMT_sock_multicast::~NMT_sock_multicast()
+{
+    /*!
+     *  @brief     Destructor - Close the socket
+     *  @return    void
+     */
+
+    if (this->sock >= 0) {close(this->sock);}
+}
+
 NMT_result NMT_sock_multicast::NMT_init_multicast_server()
 {
     /*!
@@ -153,6 +257,9 @@ NMT_result NMT_sock_multicast::NMT_init_multicast_client()
         }
     }
 
+    if (result == OK)
+        NMT_enable_rx_time(this->sock);
+
     /* Exit the function */
     NMT_log_write(DEBUG, (char *)"< result=%s", result_e2s[result]);
     return result;
@@ -184,7 +291,9 @@ NMT_result NMT_sock_multicast::NMT_write_socket(char *message)
 NMT_result NMT_sock_multicast::NMT_read_socket(char **message)
 {
     /*!
-     *  @brief     Function to read message on the socket
+     *  @brief     Function to read message on the socket. The message
+     *             is allocated to its exact size and must be freed
+     *             by the caller.
      *  @param[out] message
      *  @return    NMT_result
      */
@@ -193,14 +302,10 @@ NMT_result NMT_sock_multicast::NMT_read_socket(char **message)
 
     /* Initialize Varibles */
     NMT_result result = OK;
-    char msgbuf[MAX_BUFFER_SIZE];
-    socklen_t adder_len = sizeof(this->my_address);
-
-    int nbytes = recvfrom(this->sock, msgbuf, MAX_BUFFER_SIZE,
-        0,
-        (struct sockaddr *) &(this->my_address),
-        &(adder_len)
-    );
+    NMT_sock_msg msg;
+
+    /* Wait for the next datagram and get its size without consuming it */
+    int nbytes = recv(this->sock, NULL, 0, MSG_PEEK | MSG_TRUNC);
     if (nbytes < 0) 
     {
         result = NOK;
@@ -208,11 +313,990 @@ NMT_result NMT_sock_multicast::NMT_read_socket(char **message)
     }
     else
     {
-        msgbuf[nbytes] = '\0';
-        *message = (char *)malloc((sizeof(char) * strlen(msgbuf)) + 1);
-        strcpy(*message, msgbuf);
+        *message = (char *)malloc(nbytes + 1);
+        msg = {*message, (size_t)nbytes + 1, 0, false};
+        result = NMT_read_socket(&msg);
+
+        if (result != OK) 
+        {
+            free(*message);
+            *message = NULL;
+        }
     }
 
     NMT_log_write(DEBUG, (char *)"< result=%s", result_e2s[result]);
     return result;
 }
+
+NMT_result NMT_sock_multicast::NMT_read_socket(NMT_sock_msg *msg)
+{
+    /*!
+     *  @brief      Read one datagram directly into msg->buffer. The data
+     *              is copied once (kernel to buffer) and nothing is
+     *              allocated, so the same msg can be reused every call.
+     *  @param[out] msg
+     *  @return     NMT_result
+     */
+
+    NMT_log_write(DEBUG, (char *)"> capacity=%u", (unsigned int)msg->capacity);
+
+    /* Initialize Varibles */
+    NMT_result result = OK;
+
+    /* MSG_TRUNC returns the real datagram size even if it did not fit */
+    char control[NMT_SOCK_CMSG_SPACE];
+    struct iovec  iov = {msg->buffer, msg->capacity - 1};
+    struct msghdr hdr;
+
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_iov        = &iov;
+    hdr.msg_iovlen     = 1;
+    hdr.msg_control    = control;
+    hdr.msg_controllen = sizeof(control);
+
+    int nbytes = recvmsg(this->sock, &hdr, MSG_TRUNC);
+    if (nbytes < 0) 
+    {
+        result = NOK;
+        msg->length = 0;
+        NMT_log_write(WARNING, (char *)"No Message recived on socket");
+    }
+    else
+    {
+        msg->truncated = ((size_t)nbytes > (msg->capacity - 1));
+        msg->length    = (msg->truncated ? msg->capacity - 1 : nbytes);
+        msg->buffer[msg->length] = '\0';
+        NMT_get_rx_time(&hdr, &msg->rx_time);
+
+        if (msg->truncated)
+            NMT_log_write(WARNING, (char *)"Message of %d bytes truncated", nbytes);
+    }
+
+    NMT_log_write(DEBUG, (char *)"< length=%u result=%s", (unsigned int)msg->length, result_e2s[result]);
+    return result;
+}
+
+NMT_result NMT_sock_multicast::NMT_read_socket_batch(NMT_sock_msg *msgs, unsigned int max_msgs, 
+                                                     unsigned int *count, bool wait)
+{
+    /*!
+     *  @brief      Read up to max_msgs datagrams with one recvmmsg call.
+     *              Blocks (up to the socket timeout) for the first one
+     *              and then takes whatever else is already queued.
+     *  @param[out] msgs
+     *  @param[in]  max_msgs
+     *  @param[out] count
+     *  @param[in]  wait (Optional - false to return NOK at once if empty)
+     *  @return     NMT_result
+     */
+
+    NMT_log_write(DEBUG, (char *)"> max_msgs=%u", max_msgs);
+
+    /* Initialize Varibles */
+    NMT_result result = OK;
+    struct mmsghdr hdrs[NMT_SOCK_MAX_BATCH];
+    struct iovec   iovs[NMT_SOCK_MAX_BATCH];
+    char           controls[NMT_SOCK_MAX_BATCH][NMT_SOCK_CMSG_SPACE];
+    unsigned int   slots = (max_msgs < NMT_SOCK_MAX_BATCH ? max_msgs : NMT_SOCK_MAX_BATCH);
+
+    *count = 0;
+    memset(hdrs, 0, sizeof(hdrs[0]) * slots);
+
+    for (unsigned int i = 0; i < slots; i++)
+    {
+        iovs[i].iov_base = msgs[i].buffer;
+        iovs[i].iov_len  = msgs[i].capacity - 1;
+        hdrs[i].msg_hdr.msg_iov        = &iovs[i];
+        hdrs[i].msg_hdr.msg_iovlen     = 1;
+        hdrs[i].msg_hdr.msg_control    = controls[i];
+        hdrs[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+    }
+
+    int nmsgs = recvmmsg(this->sock, hdrs, slots, (wait ? MSG_WAITFORONE : MSG_DONTWAIT), NULL);
+    if (nmsgs <= 0)
+    {
+        result = NOK;
+        if (wait || ((errno != EAGAIN) && (errno != EWOULDBLOCK)))
+            NMT_log_write(WARNING, (char *)"No Message recived on socket");
+    }
+    else
+    {
+        for (int i = 0; i < nmsgs; i++)
+        {
+            msgs[i].length    = hdrs[i].msg_len;
+            msgs[i].truncated = (hdrs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+            msgs[i].buffer[msgs[i].length] = '\0';
+            NMT_get_rx_time(&hdrs[i].msg_hdr, &msgs[i].rx_time);
+
+            if (msgs[i].truncated)
+                NMT_log_write(WARNING, (char *)"Message truncated to %u bytes", (unsigned int)msgs[i].length);
+        }
+        *count = nmsgs;
+    }
+
+    NMT_log_write(DEBUG, (char *)"< count=%u result=%s", *count, result_e2s[result]);
+    return result;
+}
+
+NMT_result NMT_sock_multicast::NMT_write_socket_batch(const NMT_sock_msg *msgs, unsigned int count)
+{
+    /*!
+     *  @brief     Send count datagrams using as few sendmmsg calls as
+     *             possible (NMT_SOCK_MAX_BATCH per call)
+     *  @param[in] msgs
+     *  @param[in] count
+     *  @return    NMT_result
+     */
+
+    NMT_log_write(DEBUG, (char *)"> count=%u", count);
+
+    /* Initialize Varibles */
+    NMT_result result = OK;
+    struct mmsghdr hdrs[NMT_SOCK_MAX_BATCH];
+    struct iovec   iovs[NMT_SOCK_MAX_BATCH];
+    unsigned int   sent = 0;
+
+    while ((result == OK) && (sent < count))
+    {
+        unsigned int slots = ((count - sent) < NMT_SOCK_MAX_BATCH ? (count - sent) : NMT_SOCK_MAX_BATCH);
+        memset(hdrs, 0, sizeof(hdrs[0]) * slots);
+
+        for (unsigned int i = 0; i < slots; i++)
+        {
+            iovs[i].iov_base = msgs[sent + i].buffer;
+            iovs[i].iov_len  = msgs[sent + i].length;
+            hdrs[i].msg_hdr.msg_iov     = &iovs[i];
+            hdrs[i].msg_hdr.msg_iovlen  = 1;
+            hdrs[i].msg_hdr.msg_name    = &(this->my_address);
+            hdrs[i].msg_hdr.msg_namelen = sizeof(this->my_address);
+        }
+
+        /* sendmmsg may stop early - Carry on from the first unsent one */
+        int nmsgs = sendmmsg(this->sock, hdrs, slots, 0);
+        if (nmsgs <= 0)
+            result = NOK;
+        else
+            sent += nmsgs;
+    }
+
+    /* Exit the function */
+    NMT_log_write(DEBUG, (char *)"< sent=%u result=%s", sent, result_e2s[result]);
+    return result;
+}
+
+/*--------------------------------------------------/
+/                 Unix Domain Transport             /
+/--------------------------------------------------*/
+NMT_sock_unix::NMT_sock_unix(unsigned int port, sock_mode socket_mode, unsigned int socket_timeout) :
+    mode(socket_mode), socket_timeout(socket_timeout)
+{
+    /*!
+     *  @brief     Constructor for NMT_sock_unix
+     *  @param[in] port
+     *  @param[in] socket_mode
+     *  @param[in] socket_timeout
+     *  @return    void
+     */
+
+    NMT_log_write(DEBUG, (char *)"> port=%u mode=%d", port, socket_mode);
+    this->path = std::string(NMT_SOCK_LOCAL_DIR) + "/nmt_sock_" + std::to_string(port);
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, this->path.c_str(), sizeof(address.sun_path) - 1);
+
+    /* Readers own the path - Writers connect on their first write */
+    if (this->mode == SOCK_CLIENT)
+    {
+        struct epoll_event event;
+        unlink(this->path.c_str());
+
+        this->sock     = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        this->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        event.events   = EPOLLIN;
+        event.data.fd  = this->sock;
+
+        if ((this->sock < 0) || (this->epoll_fd < 0) ||
+            (bind(this->sock, (struct sockaddr *)&address, sizeof(address)) < 0) ||
+            (listen(this->sock, SOMAXCONN) < 0) ||
+            (epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, this->sock, &event) < 0))
+        {
+            NMT_log_write(ERROR, (char *)"Failed to listen on %s errno=%d", this->path.c_str(), errno);
+            this->result = NOK;
+        }
+        else
+        {
+            struct stat st;
+            if (stat(this->path.c_str(), &st) == 0) {this->path_ino = st.st_ino;}
+        }
+    }
+
+    NMT_log_write(DEBUG, (char *)"< result=%s", result_e2s[this->result]);
+}
+
+NMT_sock_unix::~NMT_sock_unix()
+{
+    /*!
+     *  @brief     Destructor - Close the peers and remove the path
+     *  @return    void
+     */
+
+    /* Leave the path alone if a newer reader has taken it over */
+    struct stat st;
+    if ((this->mode == SOCK_CLIENT) && (stat(this->path.c_str(), &st) == 0) && (st.st_ino == this->path_ino))
+        unlink(this->path.c_str());
+
+    for (int peer : this->peers) {close(peer);}
+    if (this->epoll_fd >= 0) {close(this->epoll_fd);}
+    if (this->sock >= 0) {close(this->sock);}
+}
+
+NMT_result NMT_sock_unix::NMT_connect()
+{
+    /*!
+     *  @brief     Connect to the reader
+     *  @return    NMT_result
+     */
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, this->path.c_str(), sizeof(address.sun_path) - 1);
+
+    this->sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if ((this->sock >= 0) && (connect(this->sock, (struct sockaddr *)&address, sizeof(address)) == 0))
+        return OK;
+
+    NMT_log_write(WARNING, (char *)"No reader on %s errno=%d", this->path.c_str(), errno);
+    if (this->sock >= 0) {close(this->sock);}
+    this->sock = -1;
+    return NOK;
+}
+
+void NMT_sock_unix::NMT_accept()
+{
+    /*!
+     *  @brief     Accept every pending peer
+     *  @return    void
+     */
+
+    int peer;
+    while ((peer = accept4(this->sock, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+    {
+        struct epoll_event event;
+        event.events  = EPOLLIN;
+        event.data.fd = peer;
+
+        if (epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, peer, &event) < 0)
+        {
+            close(peer);
+        }
+        else
+        {
+            NMT_enable_rx_time(peer);
+            this->peers.push_back(peer);
+        }
+    }
+}
+
+void NMT_sock_unix::NMT_drop_peer(int peer)
+{
+    /*!
+     *  @brief     Forget a peer that hung up
+     *  @param[in] peer
+     *  @return    void
+     */
+
+    epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, peer, NULL);
+    close(peer);
+
+    for (size_t i = 0; i < this->peers.size(); i++)
+    {
+        if (this->peers[i] == peer)
+        {
+            this->peers[i] = this->peers.back();
+            this->peers.pop_back();
+            break;
+        }
+    }
+}
+
+NMT_result NMT_sock_unix::NMT_read_batch(NMT_sock_msg *msgs, unsigned int max_msgs, unsigned int *count, bool wait)
+{
+    /*!
+     *  @brief      Read up to max_msgs messages from the connected peers
+     *  @param[out] msgs
+     *  @param[in]  max_msgs
+     *  @param[out] count
+     *  @param[in]  wait (Optional - false to return NOK at once if empty)
+     *  @return     NMT_result
+     */
+
+    NMT_log_write(DEBUG, (char *)"> max_msgs=%u", max_msgs);
+
+    /* Initialize Varibles */
+    NMT_result result = NOK;
+    struct epoll_event events[NMT_SOCK_MAX_BATCH];
+    int timeout = (wait ? (int)(this->socket_timeout * 1000) : 0);
+    *count = 0;
+
+    while ((this->mode == SOCK_CLIENT) && (*count == 0))
+    {
+        int ready = epoll_wait(this->epoll_fd, events, NMT_SOCK_MAX_BATCH, timeout);
+        if (ready <= 0)
+            break;
+
+        for (int i = 0; i < ready; i++)
+        {
+            int fd = events[i].data.fd;
+
+            if (fd == this->sock)
+            {
+                NMT_accept();
+                continue;
+            }
+
+            /* Level triggered - Whatever is left wakes the next read */
+            while (*count < max_msgs)
+            {
+                NMT_sock_msg &msg = msgs[*count];
+                struct iovec  iov = {msg.buffer, msg.capacity - 1};
+                struct msghdr hdr;
+                char control[NMT_SOCK_CMSG_SPACE];
+
+                memset(&hdr, 0, sizeof(hdr));
+                hdr.msg_iov        = &iov;
+                hdr.msg_iovlen     = 1;
+                hdr.msg_control    = control;
+                hdr.msg_controllen = sizeof(control);
+
+                ssize_t length = recvmsg(fd, &hdr, MSG_DONTWAIT);
+                if (length == 0)
+                {
+                    NMT_drop_peer(fd);
+                    break;
+                }
+                else if (length < 0)
+                {
+                    if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {NMT_drop_peer(fd);}
+                    break;
+                }
+
+                msg.length    = length;
+                msg.truncated = (hdr.msg_flags & MSG_TRUNC) != 0;
+                msg.buffer[msg.length] = '\0';
+                NMT_get_rx_time(&hdr, &msg.rx_time);
+                (*count)++;
+
+                if (msg.truncated)
+                    NMT_log_write(WARNING, (char *)"Message truncated to %u bytes", (unsigned int)msg.length);
+            }
+        }
+
+        if (!wait) {break;}
+    }
+
+    if (*count > 0)
+        result = OK;
+    else if (wait)
+        NMT_log_write(WARNING, (char *)"No Message recived on %s", this->path.c_str());
+
+    NMT_log_write(DEBUG, (char *)"< count=%u result=%s", *count, result_e2s[result]);
+    return result;
+}
+
+NMT_result NMT_sock_unix::NMT_write_batch(const NMT_sock_msg *msgs, unsigned int count)
+{
+    /*!
+     *  @brief     Send count messages to the reader with one sendmmsg.
+     *             Never blocks - A reader that falls behind loses messages.
+     *  @param[in] msgs
+     *  @param[in] count
+     *  @return    NMT_result
+     */
+
+    NMT_log_write(DEBUG, (char *)"> count=%u", count);
+
+    /* Initialize Varibles */
+    NMT_result result = OK;
+    struct mmsghdr hdrs[NMT_SOCK_MAX_BATCH];
+    struct iovec   iovs[NMT_SOCK_MAX_BATCH];
+    unsigned int   sent = 0;
+
+    if ((this->mode != SOCK_SERVER) || ((this->sock < 0) && (NMT_connect() != OK)))
+        result = NOK;
+
+    while ((result == OK) && (sent < count))
+    {
+        unsigned int slots = ((count - sent) < NMT_SOCK_MAX_BATCH ? (count - sent) : NMT_SOCK_MAX_BATCH);
+        memset(hdrs, 0, sizeof(hdrs[0]) * slots);
+
+        for (unsigned int i = 0; i < slots; i++)
+        {
+            iovs[i].iov_base = msgs[sent + i].buffer;
+            iovs[i].iov_len  = msgs[sent + i].length;
+            hdrs[i].msg_hdr.msg_iov    = &iovs[i];
+            hdrs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int nmsgs = sendmmsg(this->sock, hdrs, slots, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (nmsgs > 0)
+        {
+            sent += nmsgs;
+        }
+        else
+        {
+            /* Reader went away - Reconnect on the next write */
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+            {
+                close(this->sock);
+                this->sock = -1;
+            }
+            NMT_log_write(WARNING, (char *)"Failed to send on %s errno=%d", this->path.c_str(), errno);
+            result = NOK;
+        }
+    }
+
+    NMT_log_write(DEBUG, (char *)"< sent=%u result=%s", sent, result_e2s[result]);
+    return result;
+}
+
+/*--------------------------------------------------/
+/               Shared Memory Transport             /
+/--------------------------------------------------*/
+/** @var NMT_SHM_MAGIC
+ *  Marks an initialized ring */
+static const uint32_t NMT_SHM_MAGIC = 0x4e4d5452;
+
+/** @struct NMT_shm_ring
+ *  Ring header followed by NMT_SHM_SLOTS slots. head is only written
+ *  by the consumer, tail only by the producer. */
+typedef struct NMT_shm_ring
+{
+    std::atomic<uint32_t> magic;
+    uint32_t slots;
+    uint32_t slot_size;
+    alignas(64) std::atomic<uint64_t> head;
+    alignas(64) std::atomic<uint64_t> tail;
+    alignas(64) std::atomic<uint32_t> waiting;
+} NMT_shm_ring;
+
+/** @struct NMT_shm_slot
+ *  One message in the ring */
+typedef struct NMT_shm_slot
+{
+    uint32_t length;
+    struct timespec queued;
+    char data[NMT_SOCK_MAX_MSG];
+} NMT_shm_slot;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "NMT_shm_ring needs lock-free 64 bit atomics");
+
+static inline NMT_shm_slot *NMT_shm_get_slot(NMT_shm_ring *ring, uint64_t index)
+{
+    /*!
+     *  @brief     Slot for a ring index
+     *  @param[in] ring
+     *  @param[in] index
+     *  @return    NMT_shm_slot
+     */
+
+    return (NMT_shm_slot *)((char *)(ring + 1) + (index & (NMT_SHM_SLOTS - 1)) * sizeof(NMT_shm_slot));
+}
+
+NMT_sock_shm::NMT_sock_shm(unsigned int port, sock_mode socket_mode, unsigned int socket_timeout) :
+    mode(socket_mode), socket_timeout(socket_timeout)
+{
+    /*!
+     *  @brief     Constructor for NMT_sock_shm - Either side may create the ring
+     *  @param[in] port
+     *  @param[in] socket_mode
+     *  @param[in] socket_timeout
+     *  @return    void
+     */
+
+    NMT_log_write(DEBUG, (char *)"> port=%u mode=%d", port, socket_mode);
+
+    std::string name = "/nmt_sock_" + std::to_string(port);
+    this->bell_path  = std::string(NMT_SOCK_LOCAL_DIR) + "/nmt_sock_" + std::to_string(port) + ".bell";
+    this->ring_size  = sizeof(NMT_shm_ring) + NMT_SHM_SLOTS * sizeof(NMT_shm_slot);
+
+    /* 1. Map the ring */
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+    struct stat st;
+
+    if ((fd < 0) || (fstat(fd, &st) < 0) ||
+        (((size_t)st.st_size < this->ring_size) && (ftruncate(fd, this->ring_size) < 0)))
+    {
+        NMT_log_write(ERROR, (char *)"Failed to open shared memory %s errno=%d", name.c_str(), errno);
+        this->result = NOK;
+    }
+    else
+    {
+        this->ring = mmap(NULL, this->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (this->ring == MAP_FAILED)
+        {
+            NMT_log_write(ERROR, (char *)"Failed to map shared memory %s errno=%d", name.c_str(), errno);
+            this->ring   = NULL;
+            this->result = NOK;
+        }
+    }
+
+    if (fd >= 0) {close(fd);}
+
+    /* 2. A fresh mapping is all zeros - Only the sizes need filling in. A ring
+     *    left by a build with another slot layout cannot be read, so it starts over */
+    NMT_shm_ring *ring = (NMT_shm_ring *)this->ring;
+    if ((this->result == OK) && (ring->magic.load(std::memory_order_acquire) == NMT_SHM_MAGIC) &&
+        ((ring->slots != NMT_SHM_SLOTS) || (ring->slot_size != sizeof(NMT_shm_slot))))
+    {
+        NMT_log_write(WARNING, (char *)"Shared memory %s has a different layout - Resetting", name.c_str());
+        ring->magic.store(0);
+        ring->head.store(0);
+        ring->tail.store(0);
+        ring->waiting.store(0);
+    }
+
+    if ((this->result == OK) && (ring->magic.load(std::memory_order_acquire) != NMT_SHM_MAGIC))
+    {
+        ring->slots     = NMT_SHM_SLOTS;
+        ring->slot_size = sizeof(NMT_shm_slot);
+        ring->magic.store(NMT_SHM_MAGIC, std::memory_order_release);
+    }
+
+    /* 3. Consumer owns the doorbell - Drops anything a previous run left behind */
+    if ((this->result == OK) && (this->mode == SOCK_CLIENT))
+    {
+        if ((mkfifo(this->bell_path.c_str(), 0666) < 0) && (errno != EEXIST))
+            this->result = NOK;
+
+        this->bell_fd      = open(this->bell_path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        this->bell_keep_fd = open(this->bell_path.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+
+        if ((this->result != OK) || (this->bell_fd < 0) || (this->bell_keep_fd < 0))
+        {
+            NMT_log_write(ERROR, (char *)"Failed to open doorbell %s errno=%d", this->bell_path.c_str(), errno);
+            this->result = NOK;
+        }
+        else
+        {
+            ring->head.store(ring->tail.load(std::memory_order_acquire), std::memory_order_release);
+            ring->waiting.store(1);
+        }
+    }
+
+    NMT_log_write(DEBUG, (char *)"< result=%s", result_e2s[this->result]);
+}
+
+NMT_sock_shm::~NMT_sock_shm()
+{
+    /*!
+     *  @brief     Destructor - Unmap the ring (it stays for the other side)
+     *  @return    void
+     */
+
+    if (this->ring) {munmap(this->ring, this->ring_size);}
+    if (this->bell_fd >= 0) {close(this->bell_fd);}
+    if (this->bell_keep_fd >= 0) {close(this->bell_keep_fd);}
+}
+
+bool NMT_sock_shm::NMT_ring_bell(int fd)
+{
+    /*!
+     *  @brief     Wake the consumer. SIGPIPE is held off so a consumer
+     *             that exited cannot take the producer down with it.
+     *  @param[in] fd (write end of the doorbell)
+     *  @return    False if the consumer has gone away
+     */
+
+    char bell = 1;
+    sigset_t pipe_set, old_set;
+    struct timespec no_wait = {0, 0};
+
+    sigemptyset(&pipe_set);
+    sigaddset(&pipe_set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+
+    /* FIFO full (EAGAIN) is fine - The consumer is awake anyway */
+    bool gone = ((write(fd, &bell, 1) < 0) && (errno == EPIPE));
+    if (gone)
+        sigtimedwait(&pipe_set, NULL, &no_wait);
+
+    pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+    return !gone;
+}
+
+void NMT_sock_shm::NMT_drain_bell()
+{
+    /*!
+     *  @brief     Clear the doorbell
+     *  @return    void
+     */
+
+    char bells[64];
+    while (read(this->bell_fd, bells, sizeof(bells)) == (ssize_t)sizeof(bells)) {}
+}
+
+NMT_result NMT_sock_shm::NMT_read_batch(NMT_sock_msg *msgs, unsigned int max_msgs, unsigned int *count, bool wait)
+{
+    /*!
+     *  @brief      Copy up to max_msgs messages out of the ring. Only
+     *              touches the doorbell when the ring is empty.
+     *  @param[out] msgs
+     *  @param[in]  max_msgs
+     *  @param[out] count
+     *  @param[in]  wait (Optional - false to return NOK at once if empty)
+     *  @return     NMT_result
+     */
+
+    NMT_log_write(DEBUG, (char *)"> max_msgs=%u", max_msgs);
+
+    /* Initialize Varibles */
+    NMT_result result  = NOK;
+    NMT_shm_ring *ring = (NMT_shm_ring *)this->ring;
+    bool waited        = false;
+    *count = 0;
+
+    while ((this->bell_fd >= 0) && (ring))
+    {
+        NMT_drain_bell();
+
+        uint64_t head = ring->head.load(std::memory_order_relaxed);
+        uint64_t tail = ring->tail.load(std::memory_order_acquire);
+
+        for (; ((head != tail) && (*count < max_msgs)); head++)
+        {
+            NMT_shm_slot *slot = NMT_shm_get_slot(ring, head);
+            NMT_sock_msg &msg  = msgs[*count];
+
+            msg.length    = (slot->length < msg.capacity - 1 ? slot->length : msg.capacity - 1);
+            msg.truncated = (msg.length < slot->length);
+            memcpy(msg.buffer, slot->data, msg.length);
+            msg.buffer[msg.length] = '\0';
+            msg.rx_time   = slot->queued;
+            (*count)++;
+        }
+        ring->head.store(head, std::memory_order_release);
+
+        if (head == tail)
+        {
+            /* Empty - Ask for the doorbell, then look once more for a racing write */
+            ring->waiting.store(1);
+            if ((ring->tail.load() != head) && (*count == 0))
+                continue;
+            else if (ring->tail.load() != head)
+                NMT_ring_bell(this->bell_keep_fd);
+        }
+        else
+        {
+            /* Still more queued - Make sure the next read gets woken */
+            NMT_ring_bell(this->bell_keep_fd);
+        }
+
+        if ((*count > 0) || (waited) || (!wait))
+            break;
+
+        struct pollfd pfd = {this->bell_fd, POLLIN, 0};
+        waited = true;
+        if (poll(&pfd, 1, (int)(this->socket_timeout * 1000)) <= 0)
+            break;
+    }
+
+    if (*count > 0)
+        result = OK;
+    else if (wait)
+        NMT_log_write(WARNING, (char *)"No Message recived on %s", this->bell_path.c_str());
+
+    NMT_log_write(DEBUG, (char *)"< count=%u result=%s", *count, result_e2s[result]);
+    return result;
+}
+
+NMT_result NMT_sock_shm::NMT_write_batch(const NMT_sock_msg *msgs, unsigned int count)
+{
+    /*!
+     *  @brief     Copy count messages into the ring and publish them
+     *             together. Messages that do not fit are dropped.
+     *  @param[in] msgs
+     *  @param[in] count
+     *  @return    NMT_result
+     */
+
+    NMT_log_write(DEBUG, (char *)"> count=%u", count);
+
+    /* Initialize Varibles */
+    NMT_result result  = (((this->mode == SOCK_SERVER) && (this->ring)) ? OK : NOK);
+    NMT_shm_ring *ring = (NMT_shm_ring *)this->ring;
+    unsigned int sent  = 0;
+
+    if (result == OK)
+    {
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        struct timespec queued;
+
+        clock_gettime(CLOCK_REALTIME, &queued);
+
+        for (; ((sent < count) && (result == OK)); sent++)
+        {
+            if (tail - head >= NMT_SHM_SLOTS)
+                head = ring->head.load(std::memory_order_acquire);
+
+            if ((tail - head >= NMT_SHM_SLOTS) || (msgs[sent].length > NMT_SOCK_MAX_MSG))
+            {
+                NMT_log_write(WARNING, (char *)"Dropped message of %u bytes (ring full or too large)",
+                              (unsigned int)msgs[sent].length);
+                result = NOK;
+                break;
+            }
+
+            NMT_shm_slot *slot = NMT_shm_get_slot(ring, tail);
+            memcpy(slot->data, msgs[sent].buffer, msgs[sent].length);
+            slot->length = msgs[sent].length;
+            slot->queued = queued;
+            tail++;
+        }
+
+        /* Publish, then wake the consumer if it went idle */
+        ring->tail.store(tail);
+        if ((sent > 0) && (ring->waiting.exchange(0)))
+        {
+            if (this->bell_fd < 0)
+                this->bell_fd = open(this->bell_path.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+
+            /* Reopened on the next wakeup if the consumer restarted */
+            if ((this->bell_fd >= 0) && (!NMT_ring_bell(this->bell_fd)))
+            {
+                close(this->bell_fd);
+                this->bell_fd = -1;
+            }
+        }
+    }
+
+    NMT_log_write(DEBUG, (char *)"< sent=%u result=%s", sent, result_e2s[result]);
+    return result;
+}
+
+std::unique_ptr<NMT_transport> NMT_sock_open(const char *transport, unsigned int port, string ip,
+                                             sock_mode socket_mode, unsigned int socket_timeout)
+{
+    /*!
+     *  @brief     Open the transport named in RSXA.json (udp if empty)
+     *  @param[in] transport
+     *  @param[in] port
+     *  @param[in] ip (udp only)
+     *  @param[in] socket_mode
+     *  @param[in] socket_timeout
+     *  @return    Transport, or NULL if the name is unknown
+     */
+
+    NMT_log_write(DEBUG, (char *)"> transport=%s port=%u", transport, port);
+    std::unique_ptr<NMT_transport> sock;
+
+    if ((transport == NULL) || (transport[0] == '\0') || (strcmp(transport, NMT_TRANSPORT_TO_STR[NMT_TRANSPORT_UDP]) == 0))
+        sock.reset(new NMT_sock_multicast(port, ip, socket_mode, socket_timeout));
+    else if (strcmp(transport, NMT_TRANSPORT_TO_STR[NMT_TRANSPORT_UNIX]) == 0)
+        sock.reset(new NMT_sock_unix(port, socket_mode, socket_timeout));
+    else if (strcmp(transport, NMT_TRANSPORT_TO_STR[NMT_TRANSPORT_SHM]) == 0)
+        sock.reset(new NMT_sock_shm(port, socket_mode, socket_timeout));
+    else
+        NMT_log_write(ERROR, (char *)"Unknown transport %s", transport);
+
+    NMT_log_write(DEBUG, (char *)"< valid=%s", btoa(sock != NULL));
+    return sock;
+}
+
+NMT_reactor::NMT_reactor()
+{
+    /*!
+     *  @brief     Constructor for NMT_reactor
+     *  @return    void
+     */
+
+    NMT_log_write(DEBUG, (char *)"> ");
+
+    this->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    this->stop_fd  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if ((this->epoll_fd < 0) || (this->stop_fd < 0))
+    {
+        NMT_log_write(ERROR, (char *)"Failed to create reactor errno=%d", errno);
+        this->result = NOK;
+    }
+    else
+    {
+        this->result = NMT_register(this->stop_fd, EPOLLIN, true, true, [this](uint64_t) {
+            this->running = false;
+        });
+    }
+
+    NMT_log_write(DEBUG, (char *)"< result=%s", result_e2s[this->result]);
+}
+
+NMT_reactor::~NMT_reactor()
+{
+    /*!
+     *  @brief     Destructor - Close the fds the reactor created
+     *  @return    void
+     */
+
+    for (reactor_entry &entry : this->entries)
+    {
+        if (entry.owned) {close(entry.fd);}
+    }
+
+    if (this->epoll_fd >= 0) {close(this->epoll_fd);}
+}
+
+NMT_result NMT_reactor::NMT_register(int fd, uint32_t events, bool owned, bool counter, 
+                                     NMT_reactor_handler handler)
+{
+    /*!
+     *  @brief     Add fd to the epoll set
+     *  @param[in] fd
+     *  @param[in] events
+     *  @param[in] owned (closed by the reactor)
+     *  @param[in] counter (timerfd/eventfd - read the count before dispatch)
+     *  @param[in] handler
+     *  @return    NMT_result
+     */
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events   = events;
+    event.data.u32 = this->entries.size();
+
+    if ((fd < 0) || (epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0))
+    {
+        NMT_log_write(ERROR, (char *)"Failed to register fd=%d errno=%d", fd, errno);
+        if (owned && (fd >= 0)) {close(fd);}
+        return NOK;
+    }
+
+    this->entries.push_back({fd, owned, counter, handler});
+    return OK;
+}
+
+NMT_result NMT_reactor::NMT_add_fd(int fd, uint32_t events, NMT_reactor_handler handler)
+{
+    /*!
+     *  @brief     Call handler(events) whenever fd is ready. The fd stays
+     *             owned by the caller.
+     *  @param[in] fd
+     *  @param[in] events (EPOLLIN, EPOLLOUT, ...)
+     *  @param[in] handler
+     *  @return    NMT_result
+     */
+
+    return NMT_register(fd, events, false, false, handler);
+}
+
+int NMT_reactor::NMT_add_timer(std::chrono::microseconds period, NMT_reactor_handler handler)
+{
+    /*!
+     *  @brief     Call handler(expirations) every period. Expirations
+     *             is > 1 if the loop fell behind.
+     *  @param[in] period
+     *  @param[in] handler
+     *  @return    timer fd (< 0 on failure)
+     */
+
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    struct itimerspec spec;
+
+    spec.it_interval.tv_sec  = period.count() / 1000000;
+    spec.it_interval.tv_nsec = (period.count() % 1000000) * 1000;
+    spec.it_value            = spec.it_interval;
+
+    if ((fd >= 0) && (timerfd_settime(fd, 0, &spec, NULL) < 0))
+    {
+        close(fd);
+        fd = -1;
+    }
+
+    return (NMT_register(fd, EPOLLIN, true, true, handler) == OK ? fd : -1);
+}
+
+int NMT_reactor::NMT_add_event(NMT_reactor_handler handler)
+{
+    /*!
+     *  @brief     Create a wakeup event. NMT_notify() on the returned fd
+     *             (from any thread) runs handler(count) on the loop.
+     *  @param[in] handler
+     *  @return    event fd (< 0 on failure)
+     */
+
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    return (NMT_register(fd, EPOLLIN, true, true, handler) == OK ? fd : -1);
+}
+
+NMT_result NMT_reactor::NMT_notify(int event_fd)
+{
+    /*!
+     *  @brief     Signal an event created by NMT_add_event (thread safe)
+     *  @param[in] event_fd
+     *  @return    NMT_result
+     */
+
+    uint64_t one = 1;
+    return (write(event_fd, &one, sizeof(one)) == sizeof(one) ? OK : NOK);
+}
+
+NMT_result NMT_reactor::NMT_run_once(int timeout_ms)
+{
+    /*!
+     *  @brief     Wait up to timeout_ms (-1 forever) and dispatch
+     *             everything that is ready
+     *  @param[in] timeout_ms
+     *  @return    NMT_result
+     */
+
+    struct epoll_event events[NMT_SOCK_MAX_BATCH];
+
+    int ready = epoll_wait(this->epoll_fd, events, NMT_SOCK_MAX_BATCH, timeout_ms);
+    if (ready < 0)
+        return (errno == EINTR ? OK : NOK);
+
+    for (int i = 0; i < ready; i++)
+    {
+        reactor_entry &entry = this->entries[events[i].data.u32];
+        uint64_t arg = events[i].events;
+
+        /* timerfd/eventfd - Consume the count so the fd stops being ready */
+        if (entry.counter && (read(entry.fd, &arg, sizeof(arg)) != sizeof(arg)))
+            continue;
+
+        entry.handler(arg);
+    }
+
+    return OK;
+}
+
+NMT_result NMT_reactor::NMT_run()
+{
+    /*!
+     *  @brief     Dispatch events until NMT_stop() is called
+     *  @return    NMT_result
+     */
+
+    NMT_log_write(DEBUG, (char *)"> entries=%u", (unsigned int)this->entries.size());
+
+    NMT_result result = this->result;
+    this->running = true;
+
+    while ((result == OK) && (this->running))
+        result = NMT_run_once(-1);
+
+    NMT_log_write(DEBUG, (char *)"< result=%s", result_e2s[result]);
+    return result;
+}
+
+void NMT_reactor::NMT_stop()
+{
+    /*!
+     *  @brief     Make NMT_run() return (thread safe)
+     *  @return    void
+     */
+
+    NMT_notify(this->stop_fd);
+}
@@ -21,13 +21,15 @@ boost::python::tuple NMT_read_socket_py(NMT_sock_multicast &nmt_sock_multicast)
      *  @return    NMT_result, message
      */
 
-    char *message;
+    /* Reused for every read on this thread - The only copy left is into the python str */
+    static thread_local char buffer[NMT_SOCK_MAX_MSG];
+    NMT_sock_msg msg = {buffer, sizeof(buffer), 0, false};
     NMT_result result = OK;
-    result = nmt_sock_multicast.NMT_read_socket(&message);
+    result = nmt_sock_multicast.NMT_read_socket(&msg);
     
     if (result == OK)
     {
-        return boost::python::make_tuple(result, std::string(message));
+        return boost::python::make_tuple(result, boost::python::str(msg.buffer, msg.length));
     }
     else 
     {
@@ -35,6 +37,43 @@ boost::python::tuple NMT_read_socket_py(NMT_sock_multicast &nmt_sock_multicast)
     }
 }
 
+template <class Transport>
+boost::python::tuple NMT_read_transport_py(Transport &nmt_transport)
+{
+    /*!
+     *  @brief     A python wrapper function for NMT_read_batch (one message)
+     *  @param[in] nmt_transport
+     *  @return    NMT_result, message
+     */
+
+    static thread_local char buffer[NMT_SOCK_MAX_MSG];
+    NMT_sock_msg msg   = {buffer, sizeof(buffer), 0, false};
+    unsigned int count = 0;
+    NMT_result result  = nmt_transport.NMT_read_batch(&msg, 1, &count);
+
+    if (result == OK)
+    {
+        return boost::python::make_tuple(result, boost::python::str(msg.buffer, msg.length));
+    }
+    else
+    {
+        return boost::python::make_tuple(result, "");
+    }
+}
+
+template <class Transport>
+NMT_result NMT_write_transport_py(Transport &nmt_transport, std::string message)
+{
+    /*!
+     *  @brief     A python wrapper function for NMT_write_message
+     *  @param[in] nmt_transport
+     *  @param[in] message
+     *  @return    NMT_result
+     */
+
+    return nmt_transport.NMT_write_message(message.c_str());
+}
+
 BOOST_PYTHON_MODULE(NMT_sock)
 {
     /*!
@@ -56,11 +95,22 @@ BOOST_PYTHON_MODULE(NMT_sock)
         .value("SOCK_SERVER", SOCK_SERVER);
 
     /* Class Declerations for Python */
-    class_<NMT_sock_multicast>("NMT_sock_multicast", init<unsigned int,
-                                                       std::string,
-                                                       sock_mode,
-                                                       unsigned int>())
+    class_<NMT_sock_multicast, boost::noncopyable>("NMT_sock_multicast", init<unsigned int,
+                                                                           std::string,
+                                                                           sock_mode,
+                                                                           unsigned int>())
       .def("NMT_write_socket", &NMT_sock_multicast::NMT_write_socket)
       .def("NMT_read_socket", NMT_read_socket_py)
       .def("NMT_get_result", &NMT_sock_multicast::NMT_get_result);
+
+    /* Same host transports (RSXA procs "transport": "unix"/"shm") */
+    class_<NMT_sock_unix, boost::noncopyable>("NMT_sock_unix", init<unsigned int, sock_mode, unsigned int>())
+      .def("NMT_write_socket", NMT_write_transport_py<NMT_sock_unix>)
+      .def("NMT_read_socket", NMT_read_transport_py<NMT_sock_unix>)
+      .def("NMT_get_result", &NMT_sock_unix::NMT_get_result);
+
+    class_<NMT_sock_shm, boost::noncopyable>("NMT_sock_shm", init<unsigned int, sock_mode, unsigned int>())
+      .def("NMT_write_socket", NMT_write_transport_py<NMT_sock_shm>)
+      .def("NMT_read_socket", NMT_read_transport_py<NMT_sock_shm>)
+      .def("NMT_get_result", &NMT_sock_shm::NMT_get_result);
 }
@@ -0,0 +1,671 @@
+/**
+ *  @file      NMT_uring.cpp
+ *  @brief     io_uring transport for NMT sockets
+ *  @details   Talks to the kernel io_uring ABI directly (no liburing).
+ *             The rings are shared memory with the kernel: head/tail
+ *             are read with acquire and published with release.
+ *  @author    Nitin Mohan
+ *  @date      April 19, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+
+#if !defined(NMT_NO_URING) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
+
+/* Multishot receive and provided buffer rings need 6.0+ kernel headers */
+#if defined(IORING_RECV_MULTISHOT) && defined(__NR_io_uring_setup)
+#define NMT_HAVE_URING
+#endif
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "NMT_uring.hpp"
+#include "NMT_stdlib.h"
+#include "NMT_log.h"
+
+/*--------------------------------------------------/
+/                   Constants                       /
+/--------------------------------------------------*/
+/** @var URING_ENTRIES
+ *  Submission queue size */
+static const unsigned int URING_ENTRIES = 64;
+
+/** @var URING_RX_TAG
+ *  user_data of the receive (sends use the slot index) */
+static const uint64_t URING_RX_TAG = ~0ULL;
+
+/** @var URING_BGID
+ *  Provided buffer group used for receives */
+static const uint16_t URING_BGID = 0;
+
+/*--------------------------------------------------/
+/                   Start of Program                /
+/--------------------------------------------------*/
+NMT_uring_transport::NMT_uring_transport(NMT_sock_multicast &sock, bool sq_poll) :
+    NMT_uring_transport(sock, sock, sq_poll)
+{
+    /*!
+     *  @brief     Constructor - Send and receive on the same socket
+     *  @param[in] sock
+     *  @param[in] sq_poll
+     *  @return    void
+     */
+}
+
+NMT_uring_transport::NMT_uring_transport(NMT_sock_multicast &rx_sock, NMT_sock_multicast &tx_sock, bool sq_poll) :
+    rx_sock(rx_sock), tx_sock(tx_sock)
+{
+    /*!
+     *  @brief     Constructor - Set up the ring, or fall back to the sockets
+     *  @param[in] rx_sock
+     *  @param[in] tx_sock
+     *  @param[in] sq_poll (Ask for a kernel thread to poll submissions)
+     *  @return    void
+     */
+
+    NMT_log_write(DEBUG, (char *)"> sq_poll=%s", btoa(sq_poll));
+
+    if (NMT_uring_setup(sq_poll) != OK)
+    {
+        NMT_uring_teardown();
+        NMT_log_write(WARNING, (char *)"io_uring not available - Using the sockets directly");
+    }
+
+    NMT_log_write(DEBUG, (char *)"< uring=%s sq_poll=%s", btoa(NMT_is_uring()), btoa(this->sq_poll));
+}
+
+NMT_uring_transport::~NMT_uring_transport()
+{
+    /*!
+     *  @brief     Destructor - Release the ring
+     *  @return    void
+     */
+
+#ifdef NMT_HAVE_URING
+    /* Let queued sends (e.g. the last acks) go out before the ring closes */
+    for (unsigned int i = 0; ((NMT_is_uring()) && (i < this->tx_slots.size())); i++)
+    {
+        while ((this->tx_slots[i].busy) && (NMT_uring_wait_tx() == OK)) {}
+    }
+#endif
+
+    NMT_uring_teardown();
+}
+
+int NMT_uring_transport::NMT_get_fd()
+{
+    /*!
+     *  @brief     fd that becomes readable when a read may succeed
+     *  @return    eventfd (uring) or the receive socket (fallback)
+     */
+
+    return (NMT_is_uring() ? this->event_fd : this->rx_sock.NMT_get_fd());
+}
+
+#ifdef NMT_HAVE_URING
+NMT_result NMT_uring_transport::NMT_uring_setup(bool sq_poll)
+{
+    /*!
+     *  @brief     Create the ring, map it, and register the eventfd and
+     *             receive buffers. Tries SQ polling first if asked.
+     *  @param[in] sq_poll
+     *  @return    NMT_result
+     */
+
+    NMT_log_write(DEBUG, (char *)">");
+
+    /* Initialize Varibles */
+    NMT_result result = OK;
+    struct io_uring_params params;
+
+    /* 1. Create the ring */
+    memset(&params, 0, sizeof(params));
+    if (sq_poll)
+    {
+        params.flags          = IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = NMT_URING_SQ_IDLE;
+        this->ring_fd         = (int)syscall(__NR_io_uring_setup, URING_ENTRIES, &params);
+
+        if (this->ring_fd < 0)
+            NMT_log_write(WARNING, (char *)"io_uring SQ polling not available errno=%d", errno);
+    }
+
+    if (this->ring_fd < 0)
+    {
+        memset(&params, 0, sizeof(params));
+        this->ring_fd = (int)syscall(__NR_io_uring_setup, URING_ENTRIES, &params);
+    }
+
+    if (this->ring_fd < 0)
+    {
+        NMT_log_write(WARNING, (char *)"io_uring_setup failed errno=%d", errno);
+        result = NOK;
+    }
+    else
+    {
+        this->sq_poll = (params.flags & IORING_SETUP_SQPOLL) != 0;
+    }
+
+    /* 2. Map the submission/completion rings and the SQE array */
+    if (result == OK)
+    {
+        this->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        this->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        this->sqes_size    = params.sq_entries * sizeof(struct io_uring_sqe);
+
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+        {
+            if (this->cq_ring_size > this->sq_ring_size) {this->sq_ring_size = this->cq_ring_size;}
+            this->cq_ring_size = this->sq_ring_size;
+        }
+
+        this->sq_ring = mmap(NULL, this->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             this->ring_fd, IORING_OFF_SQ_RING);
+
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+            this->cq_ring = this->sq_ring;
+        else
+            this->cq_ring = mmap(NULL, this->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                 this->ring_fd, IORING_OFF_CQ_RING);
+
+        void *sqes = mmap(NULL, this->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          this->ring_fd, IORING_OFF_SQES);
+
+        if ((this->sq_ring == MAP_FAILED) || (this->cq_ring == MAP_FAILED) || (sqes == MAP_FAILED))
+        {
+            NMT_log_write(ERROR, (char *)"Failed to map io_uring errno=%d", errno);
+            if (this->sq_ring == MAP_FAILED) {this->sq_ring = NULL;}
+            if (this->cq_ring == MAP_FAILED) {this->cq_ring = NULL;}
+            if (sqes != MAP_FAILED) {munmap(sqes, this->sqes_size);}
+            result = NOK;
+        }
+        else
+        {
+            char *sq = (char *)this->sq_ring;
+            char *cq = (char *)this->cq_ring;
+
+            this->sqes       = (struct io_uring_sqe *)sqes;
+            this->sq_head    = (unsigned int *)(sq + params.sq_off.head);
+            this->sq_tail    = (unsigned int *)(sq + params.sq_off.tail);
+            this->sq_flags   = (unsigned int *)(sq + params.sq_off.flags);
+            this->sq_array   = (unsigned int *)(sq + params.sq_off.array);
+            this->sq_mask    = *(unsigned int *)(sq + params.sq_off.ring_mask);
+            this->sq_entries = params.sq_entries;
+            this->cq_head    = (unsigned int *)(cq + params.cq_off.head);
+            this->cq_tail    = (unsigned int *)(cq + params.cq_off.tail);
+            this->cq_mask    = *(unsigned int *)(cq + params.cq_off.ring_mask);
+            this->cqes       = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+        }
+    }
+
+    /* 3. Completions signal an eventfd so the ring can sit in a reactor */
+    if (result == OK)
+    {
+        this->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if ((this->event_fd < 0) ||
+            (syscall(__NR_io_uring_register, this->ring_fd, IORING_REGISTER_EVENTFD, &(this->event_fd), 1) < 0))
+        {
+            NMT_log_write(WARNING, (char *)"Failed to register io_uring eventfd errno=%d", errno);
+            result = NOK;
+        }
+    }
+
+    /* 4. Register the receive buffers once - The kernel picks one per datagram */
+    if (result == OK)
+    {
+        struct io_uring_buf_reg reg;
+
+        this->buf_ring_size = NMT_URING_RX_BUFFERS * sizeof(struct io_uring_buf);
+        void *ring = mmap(NULL, this->buf_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        memset(&reg, 0, sizeof(reg));
+        reg.ring_addr    = (uint64_t)(uintptr_t)ring;
+        reg.ring_entries = NMT_URING_RX_BUFFERS;
+        reg.bgid         = URING_BGID;
+
+        if (ring == MAP_FAILED)
+        {
+            NMT_log_write(ERROR, (char *)"Failed to map io_uring buffer ring errno=%d", errno);
+            result = NOK;
+        }
+        else
+        {
+            this->buf_ring = (struct io_uring_buf_ring *)ring;
+            if (syscall(__NR_io_uring_register, this->ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+            {
+                NMT_log_write(WARNING, (char *)"io_uring provided buffers not available errno=%d", errno);
+                result = NOK;
+            }
+        }
+    }
+
+    /* 5. Fill the buffer ring and the send slots */
+    if (result == OK)
+    {
+        this->rx_pool.resize(NMT_URING_RX_BUFFERS * NMT_SOCK_MAX_MSG);
+        this->rx_done.resize(NMT_URING_RX_BUFFERS);
+
+        for (unsigned int i = 0; i < NMT_URING_RX_BUFFERS; i++)
+            NMT_uring_recycle((uint16_t)i);
+
+        this->tx_pool.resize(NMT_URING_TX_SLOTS * NMT_SOCK_MAX_MSG);
+        this->tx_slots.resize(NMT_URING_TX_SLOTS);
+
+        for (unsigned int i = 0; i < NMT_URING_TX_SLOTS; i++)
+        {
+            uring_tx_slot &slot = this->tx_slots[i];
+            memset(&slot, 0, sizeof(slot));
+            slot.iov.iov_base    = &(this->tx_pool[i * NMT_SOCK_MAX_MSG]);
+            slot.hdr.msg_iov     = &slot.iov;
+            slot.hdr.msg_iovlen  = 1;
+            slot.hdr.msg_name    = (void *)this->tx_sock.NMT_get_address();
+            slot.hdr.msg_namelen = sizeof(struct sockaddr_in);
+        }
+    }
+
+    /* 6. Start receiving */
+    if (result == OK)
+        result = NMT_uring_arm_recv();
+
+    NMT_log_write(DEBUG, (char *)"< result=%s", result_e2s[result]);
+    return result;
+}
+
+void NMT_uring_transport::NMT_uring_teardown()
+{
+    /*!
+     *  @brief     Close the ring (cancels the receive) and unmap it
+     *  @return    void
+     */
+
+    if (this->ring_fd >= 0) {close(this->ring_fd);}
+    if (this->event_fd >= 0) {close(this->event_fd);}
+    if (this->buf_ring) {munmap(this->buf_ring, this->buf_ring_size);}
+    if (this->sqes) {munmap(this->sqes, this->sqes_size);}
+    if ((this->cq_ring) && (this->cq_ring != this->sq_ring)) {munmap(this->cq_ring, this->cq_ring_size);}
+    if (this->sq_ring) {munmap(this->sq_ring, this->sq_ring_size);}
+
+    this->ring_fd  = -1;
+    this->event_fd = -1;
+    this->buf_ring = NULL;
+    this->sqes     = NULL;
+    this->cq_ring  = NULL;
+    this->sq_ring  = NULL;
+    this->sq_poll  = false;
+}
+
+struct io_uring_sqe *NMT_uring_transport::NMT_uring_get_sqe()
+{
+    /*!
+     *  @brief     Next free submission entry (published by submit)
+     *  @return    SQE or NULL when the queue is full
+     */
+
+    unsigned int head = __atomic_load_n(this->sq_head, __ATOMIC_ACQUIRE);
+    unsigned int tail = *(this->sq_tail) + this->sq_pending;
+
+    if ((tail - head) >= this->sq_entries)
+        return NULL;
+
+    unsigned int index = tail & this->sq_mask;
+    struct io_uring_sqe *sqe = &(this->sqes[index]);
+
+    memset(sqe, 0, sizeof(*sqe));
+    this->sq_array[index] = index;
+    this->sq_pending++;
+
+    return sqe;
+}
+
+NMT_result NMT_uring_transport::NMT_uring_submit()
+{
+    /*!
+     *  @brief     Publish the pending SQEs. With SQ polling the kernel
+     *             thread picks them up, and is only woken if it slept.
+     *  @return    NMT_result
+     */
+
+    NMT_result result = OK;
+    unsigned int to_submit = this->sq_pending;
+    long rc = 0;
+
+    if (to_submit == 0)
+        return OK;
+
+    __atomic_store_n(this->sq_tail, *(this->sq_tail) + to_submit, __ATOMIC_RELEASE);
+    this->sq_pending = 0;
+
+    if (this->sq_poll)
+    {
+        /* Tail store must be visible before the wakeup flag is read */
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(this->sq_flags, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP)
+            rc = syscall(__NR_io_uring_enter, this->ring_fd, 0, 0, IORING_ENTER_SQ_WAKEUP, NULL, 0);
+    }
+    else
+    {
+        rc = syscall(__NR_io_uring_enter, this->ring_fd, to_submit, 0, 0, NULL, 0);
+    }
+
+    if (rc < 0)
+    {
+        NMT_log_write(ERROR, (char *)"io_uring_enter failed errno=%d", errno);
+        result = NOK;
+    }
+
+    return result;
+}
+
+NMT_result NMT_uring_transport::NMT_uring_arm_recv()
+{
+    /*!
+     *  @brief     Queue a multishot receive - One completion per datagram
+     *             until it runs out of buffers
+     *  @return    NMT_result
+     */
+
+    struct io_uring_sqe *sqe = NMT_uring_get_sqe();
+
+    if (sqe == NULL)
+        return NOK;
+
+    sqe->opcode    = IORING_OP_RECV;
+    sqe->fd        = this->rx_sock.NMT_get_fd();
+    sqe->ioprio    = IORING_RECV_MULTISHOT;
+    sqe->flags     = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BGID;
+    sqe->user_data = URING_RX_TAG;
+
+    this->rx_armed = true;
+    return NMT_uring_submit();
+}
+
+void NMT_uring_transport::NMT_uring_recycle(uint16_t bid)
+{
+    /*!
+     *  @brief     Hand a receive buffer back to the kernel
+     *  @param[in] bid
+     *  @return    void
+     */
+
+    /* Not buf_ring->bufs - Its uapi flex array wrapper lands at offset 8 in C++ */
+    struct io_uring_buf *bufs = (struct io_uring_buf *)this->buf_ring;
+    struct io_uring_buf *buf  = &(bufs[this->buf_tail & (NMT_URING_RX_BUFFERS - 1)]);
+
+    buf->addr = (uint64_t)(uintptr_t)&(this->rx_pool[bid * NMT_SOCK_MAX_MSG]);
+    buf->len  = NMT_SOCK_MAX_MSG;
+    buf->bid  = bid;
+
+    this->buf_tail++;
+    __atomic_store_n(&(this->buf_ring->tail), this->buf_tail, __ATOMIC_RELEASE);
+}
+
+void NMT_uring_transport::NMT_uring_reap()
+{
+    /*!
+     *  @brief     Drain the completion queue. Receives are queued in
+     *             rx_done; send completions free their slot.
+     *  @return    void
+     */
+
+    unsigned int head = *(this->cq_head);
+    unsigned int tail = __atomic_load_n(this->cq_tail, __ATOMIC_ACQUIRE);
+    struct timespec reaped = {0, 0};
+
+    for (; head != tail; head++)
+    {
+        struct io_uring_cqe *cqe = &(this->cqes[head & this->cq_mask]);
+
+        if (cqe->user_data == URING_RX_TAG)
+        {
+            if (!(cqe->flags & IORING_CQE_F_MORE))
+                this->rx_armed = false;
+
+            if ((cqe->res >= 0) && (cqe->flags & IORING_CQE_F_BUFFER))
+            {
+                /* Every receive holds a buffer, so rx_done cannot overflow */
+                unsigned int slot = (this->rx_done_head + this->rx_done_count) % NMT_URING_RX_BUFFERS;
+                this->rx_done[slot].bid    = (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+                this->rx_done[slot].length = (uint32_t)cqe->res;
+
+                /* A plain receive has no kernel timestamp - Stamp it once per reap */
+                if (reaped.tv_sec == 0) {clock_gettime(CLOCK_REALTIME, &reaped);}
+                this->rx_done[slot].rx_time = reaped;
+                this->rx_done_count++;
+            }
+            else if ((cqe->res < 0) && (cqe->res != -ENOBUFS))
+            {
+                /* ENOBUFS only means the reader fell behind - Anything else is fatal */
+                NMT_log_write(ERROR, (char *)"io_uring receive failed res=%d", cqe->res);
+                this->rx_failed = true;
+            }
+        }
+        else if (cqe->user_data < this->tx_slots.size())
+        {
+            this->tx_slots[cqe->user_data].busy = false;
+            if (cqe->res < 0)
+                NMT_log_write(WARNING, (char *)"io_uring send failed res=%d", cqe->res);
+        }
+    }
+
+    __atomic_store_n(this->cq_head, head, __ATOMIC_RELEASE);
+}
+
+NMT_result NMT_uring_transport::NMT_uring_wait_tx()
+{
+    /*!
+     *  @brief     Block until a completion arrives (every send slot is busy)
+     *  @return    NMT_result
+     */
+
+    if (syscall(__NR_io_uring_enter, this->ring_fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0)
+    {
+        NMT_log_write(ERROR, (char *)"io_uring wait failed errno=%d", errno);
+        return NOK;
+    }
+
+    NMT_uring_reap();
+    return OK;
+}
+#else
+NMT_result NMT_uring_transport::NMT_uring_setup(bool)
+{
+    /*!
+     *  @brief     Built without io_uring support
+     *  @return    NOK
+     */
+
+    return NOK;
+}
+
+void NMT_uring_transport::NMT_uring_teardown()
+{
+    /*!
+     *  @brief     Nothing to release
+     *  @return    void
+     */
+}
+#endif
+
+NMT_result NMT_uring_transport::NMT_read_batch(NMT_sock_msg *msgs, unsigned int max_msgs, unsigned int *count,
+                                               bool wait)
+{
+    /*!
+     *  @brief      Copy up to max_msgs received datagrams into msgs. No
+     *              syscall is made unless the eventfd has to be drained
+     *              or the call has to wait.
+     *  @param[out] msgs
+     *  @param[in]  max_msgs
+     *  @param[out] count
+     *  @param[in]  wait (Optional - false to return NOK at once if empty)
+     *  @return     NMT_result
+     */
+
+    if (!NMT_is_uring())
+        return this->rx_sock.NMT_read_socket_batch(msgs, max_msgs, count, wait);
+
+    NMT_log_write(DEBUG, (char *)"> max_msgs=%u", max_msgs);
+
+    /* Initialize Varibles */
+    NMT_result result = OK;
+    *count = 0;
+
+#ifdef NMT_HAVE_URING
+    uint64_t signals;
+    bool waited = false;
+
+    while (result == OK)
+    {
+        /* Clear the signal before reaping so later completions raise it again */
+        if (read(this->event_fd, &signals, sizeof(signals)) < 0) {/* Nothing signalled */}
+        NMT_uring_reap();
+
+        while ((*count < max_msgs) && (this->rx_done_count > 0))
+        {
+            uring_rx_done &done = this->rx_done[this->rx_done_head];
+            NMT_sock_msg  &msg  = msgs[*count];
+            size_t length = (done.length < msg.capacity - 1 ? done.length : msg.capacity - 1);
+
+            memcpy(msg.buffer, &(this->rx_pool[done.bid * NMT_SOCK_MAX_MSG]), length);
+            msg.buffer[length] = '\0';
+            msg.length    = length;
+            msg.truncated = (done.length >= NMT_SOCK_MAX_MSG) || (done.length > length);
+            msg.rx_time   = done.rx_time;
+
+            if (msg.truncated)
+                NMT_log_write(WARNING, (char *)"Message truncated to %u bytes", (unsigned int)length);
+
+            NMT_uring_recycle(done.bid);
+            this->rx_done_head = (this->rx_done_head + 1) % NMT_URING_RX_BUFFERS;
+            this->rx_done_count--;
+            (*count)++;
+        }
+
+        /* The receive stops when it runs out of buffers - Restart it now they are back */
+        if ((!this->rx_armed) && (!this->rx_failed))
+            result = NMT_uring_arm_recv();
+
+        if ((*count > 0) || (!wait) || (waited) || (result != OK))
+            break;
+
+        /* Nothing yet - Sleep on the eventfd for up to the socket timeout */
+        struct pollfd pfd = {this->event_fd, POLLIN, 0};
+        waited = true;
+        if (poll(&pfd, 1, (int)(this->rx_sock.NMT_get_timeout() * 1000)) <= 0)
+            break;
+    }
+
+    /* Anything left over still needs a wakeup */
+    if (this->rx_done_count > 0)
+    {
+        signals = 1;
+        if (write(this->event_fd, &signals, sizeof(signals)) < 0) {/* Counter already raised */}
+    }
+#endif
+
+    if (*count == 0)
+    {
+        result = NOK;
+        if (wait)
+            NMT_log_write(WARNING, (char *)"No Message recived on socket");
+    }
+
+    NMT_log_write(DEBUG, (char *)"< count=%u result=%s", *count, result_e2s[result]);
+    return result;
+}
+
+NMT_result NMT_uring_transport::NMT_write_batch(const NMT_sock_msg *msgs, unsigned int count)
+{
+    /*!
+     *  @brief     Queue count datagrams on the send slots and submit them
+     *             together. Send errors are logged when they complete.
+     *  @param[in] msgs
+     *  @param[in] count
+     *  @return    NMT_result
+     */
+
+    if (!NMT_is_uring())
+        return this->tx_sock.NMT_write_socket_batch(msgs, count);
+
+    NMT_log_write(DEBUG, (char *)"> count=%u", count);
+
+    /* Initialize Varibles */
+    NMT_result result = OK;
+    unsigned int queued = 0;
+
+#ifdef NMT_HAVE_URING
+    NMT_uring_reap();
+
+    for (unsigned int i = 0; ((i < count) && (result == OK)); i++)
+    {
+        if (msgs[i].length > NMT_SOCK_MAX_MSG)
+        {
+            NMT_log_write(ERROR, (char *)"Message of %u bytes is too large to send", (unsigned int)msgs[i].length);
+            result = NOK;
+            break;
+        }
+
+        /* Find a free slot - Flush what is queued and wait if all are in flight */
+        unsigned int slot = NMT_URING_TX_SLOTS;
+        while ((result == OK) && (slot == NMT_URING_TX_SLOTS))
+        {
+            for (unsigned int j = 0; j < NMT_URING_TX_SLOTS; j++)
+            {
+                unsigned int k = (this->tx_next + j) % NMT_URING_TX_SLOTS;
+                if (!this->tx_slots[k].busy) {slot = k; break;}
+            }
+
+            if (slot == NMT_URING_TX_SLOTS)
+            {
+                result = NMT_uring_submit();
+                if (result == OK) {result = NMT_uring_wait_tx();}
+            }
+        }
+
+        struct io_uring_sqe *sqe = (result == OK ? NMT_uring_get_sqe() : NULL);
+        if (sqe == NULL)
+        {
+            result = NOK;
+            break;
+        }
+
+        uring_tx_slot &tx = this->tx_slots[slot];
+        memcpy(tx.iov.iov_base, msgs[i].buffer, msgs[i].length);
+        tx.iov.iov_len = msgs[i].length;
+        tx.busy        = true;
+
+        sqe->opcode    = IORING_OP_SENDMSG;
+        sqe->fd        = this->tx_sock.NMT_get_fd();
+        sqe->addr      = (uint64_t)(uintptr_t)&(tx.hdr);
+        sqe->len       = 1;
+        sqe->user_data = slot;
+
+        this->tx_next = (slot + 1) % NMT_URING_TX_SLOTS;
+        queued++;
+    }
+
+    /* One submission for the whole batch */
+    if (NMT_uring_submit() != OK)
+        result = NOK;
+#endif
+
+    NMT_log_write(DEBUG, (char *)"< queued=%u result=%s", queued, result_e2s[result]);
+    return result;
+}
@@ -13,6 +13,7 @@
 /--------------------------------------------------*/
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 #include <wiringPi.h>
 #include <wiringPiI2C.h>
 
@@ -69,6 +70,22 @@
  * PCA9685 I2C Address */
 #define PCA9685_I2C_ADDRESS 0x40
 
+/** @def ALL_LED_ON_L
+ * Address of the first ALL_LED register (writes every channel) */
+#define ALL_LED_ON_L 0xFA
+
+/** @def FULL_OFF
+ * LEDn_OFF_H bit which forces the output fully off */
+#define FULL_OFF     0x10
+
+/**@def MAX_CHANNELS
+ * Number of PWM Channels on the PCA9685 */
+#define MAX_CHANNELS 16
+
+/**@def REGS_PER_CHANNEL
+ * Number of registers (ON_L, ON_H, OFF_L, OFF_H) per channel */
+#define REGS_PER_CHANNEL 4
+
 /*--------------------------------------------------/
 /                   Global Varibles                 /
 /--------------------------------------------------*/
@@ -86,6 +103,9 @@ static float CURRENT_FREQ = 0.00;
 
 //------------------Prototypes----------------------//
 static NMT_result PCA9685_setFreq(float freq);
+static void       PCA9685_calc_tics(double duty_cycle, double delay_time,
+                                    int *tics_to_on, int *tics_to_off);
+static NMT_result PCA9685_write_block(unsigned char *block, int block_len);
 
 NMT_result PCA9685_init(PCA9685_settings settings)
 {
@@ -234,24 +254,17 @@ NMT_result PCA9685_setPWM(double duty_cycle, double delay_time,
     {
         NMT_log_write(DEBUG, "hw_name=%s SIM_MODE=%s", PCA9685_HW_NAME, btoa(SIM_MODE));
 
-        /* Cap max delay to 100 and min to 0 */
-        duty_cycle = (duty_cycle > 100 ? 100 : 
-                (duty_cycle < 0 ? 0 : duty_cycle));
-        delay_time = (delay_time > 100 ? 100 : 
-                (delay_time < 0 ? 0 : delay_time));
-
         /* Calculate number of tics for time on & off */
-        int tics_to_on       = (((delay_time/100)*MAX_TICS) + 0.5) - 1;
-        int tics_on_duration = (((duty_cycle/100)*MAX_TICS) + 0.5);
-        int tics_to_off      = tics_to_on + tics_on_duration -1; 
+        int tics_to_on;
+        int tics_to_off;
+        PCA9685_calc_tics(duty_cycle, delay_time, &tics_to_on, &tics_to_off);
 
         /* Calculate the register address */
-        int channel_reg_on  = (channel * 4) + LED0_ON_L;
+        int channel_reg_on  = (channel * REGS_PER_CHANNEL) + LED0_ON_L;
         int channel_reg_off = channel_reg_on + 2;
 
-        NMT_log_write(DEBUG, "tics_to_on:%d tics_on_duration:%d tics_to_off:%d channel_reg_on:%X channel_reg_off:%X", 
-                              tics_to_on, tics_on_duration, tics_to_off, 
-                              channel_reg_on, channel_reg_off);
+        NMT_log_write(DEBUG, "tics_to_on:%d tics_to_off:%d channel_reg_on:%X channel_reg_off:%X", 
+                              tics_to_on, tics_to_off, channel_reg_on, channel_reg_off);
         if (!SIM_MODE)
         {
             /* Write to the registers */
@@ -265,6 +278,105 @@ NMT_result PCA9685_setPWM(double duty_cycle, double delay_time,
     return result;
 }
 
+NMT_result PCA9685_setPWM_batch(const PCA9685_pwm_update *updates,
+                                unsigned int count)
+{
+    /*!
+     *  @brief     Apply several channel updates in as few I2C transfers
+     *             as possible. Each run of adjacent channels is written
+     *             as one auto-increment burst starting at its LEDn_ON_L.
+     *  @param[in] updates
+     *  @param[in] count
+     *  @return    NMT_result
+     */
+
+    /* Initialize Variables */
+    NMT_result result = OK;
+    int  tics_to_on[MAX_CHANNELS];
+    int  tics_to_off[MAX_CHANNELS];
+    bool staged[MAX_CHANNELS] = {false};
+    unsigned char block[1 + (MAX_CHANNELS * REGS_PER_CHANNEL)];
+
+    if (FD < 0)
+        return result = NOK;
+
+    NMT_log_write(DEBUG, "> count=%u fd=%d", count, FD);
+
+    /* Stage the register values (a later update for a channel wins) */
+    for (unsigned int i = 0; ((result == OK) && (i < count)); i++)
+    {
+        PCA9685_PWM_CHANNEL channel = updates[i].channel;
+
+        if ((channel < CHANNEL_0) || (channel > CHANNEL_15))
+        {
+            NMT_log_write(ERROR, "Invalid channel=%d in batch", channel);
+            result = NOK;
+        }
+        else
+        {
+            PCA9685_calc_tics(updates[i].duty_cycle, updates[i].delay_time,
+                              &tics_to_on[channel], &tics_to_off[channel]);
+            staged[channel] = true;
+        }
+    }
+
+    /* Write each run of adjacent staged channels as a single burst */
+    for (int channel = 0; ((result == OK) && (channel < MAX_CHANNELS)); channel++)
+    {
+        if (!staged[channel])
+            continue;
+
+        int first_channel = channel;
+        int block_len     = 0;
+        block[block_len++] = (channel * REGS_PER_CHANNEL) + LED0_ON_L;
+
+        while ((channel < MAX_CHANNELS) && (staged[channel]))
+        {
+            block[block_len++] = tics_to_on[channel] & 0xFF;
+            block[block_len++] = (tics_to_on[channel] >> 8) & 0xFF;
+            block[block_len++] = tics_to_off[channel] & 0xFF;
+            block[block_len++] = (tics_to_off[channel] >> 8) & 0xFF;
+            channel++;
+        }
+
+        NMT_log_write(DEBUG, "burst first=%s channels=%d SIM_MODE=%s",
+                      PCA9685_PWM_CHANNEL_e2s[first_channel],
+                      channel - first_channel, btoa(SIM_MODE));
+
+        if (!SIM_MODE)
+            result = PCA9685_write_block(block, block_len);
+    }
+
+    /* Exit function */
+    NMT_log_write(DEBUG, "< %s", result_e2s[result]);
+    return result;
+}
+
+NMT_result PCA9685_stop_all(void)
+{
+    /*!
+     *  @brief     Force every channel fully off with a single write
+     *             to the ALL_LED registers
+     *  @return    NMT_result
+     */
+
+    /* Initialize Variables */
+    NMT_result result = OK;
+    unsigned char block[] = {ALL_LED_ON_L, 0x00, 0x00, 0x00, FULL_OFF};
+
+    if (FD < 0)
+        return result = NOK;
+
+    NMT_log_write(DEBUG, "> SIM_MODE=%s", btoa(SIM_MODE));
+
+    if (!SIM_MODE)
+        result = PCA9685_write_block(block, sizeof(block));
+
+    /* Exit function */
+    NMT_log_write(DEBUG, "< %s", result_e2s[result]);
+    return result;
+}
+
 NMT_result PCA9685_getPWM(double *duty_cycle,
                           PCA9685_PWM_CHANNEL channel)
 {
@@ -368,3 +480,65 @@ float PCA9685_get_curret_freq()
     NMT_log_write(DEBUG, "< freq=%.2f", CURRENT_FREQ);
     return CURRENT_FREQ;
 }
+
+static void PCA9685_calc_tics(double duty_cycle, double delay_time,
+                              int *tics_to_on, int *tics_to_off)
+{
+    /*!
+     *  @brief      Convert duty cycle and delay to ON/OFF tic counts
+     *  @param[in]  duty_cycle
+     *  @param[in]  delay_time
+     *  @param[out] tics_to_on
+     *  @param[out] tics_to_off
+     *  @return     void
+     */
+
+    /* Cap max delay to 100 and min to 0 */
+    duty_cycle = (duty_cycle > 100 ? 100 : 
+            (duty_cycle < 0 ? 0 : duty_cycle));
+    delay_time = (delay_time > 100 ? 100 : 
+            (delay_time < 0 ? 0 : delay_time));
+
+    /* Calculate number of tics for time on & off */
+    int tics_on_duration = (((duty_cycle/100)*MAX_TICS) + 0.5);
+    *tics_to_on          = (((delay_time/100)*MAX_TICS) + 0.5) - 1;
+    *tics_to_off         = *tics_to_on + tics_on_duration -1; 
+}
+
+static NMT_result PCA9685_write_block(unsigned char *block, int block_len)
+{
+    /*!
+     *  @brief     Write a register block in one I2C transfer. The first
+     *             byte is the start register, MODE1 auto-increment
+     *             advances through the rest.
+     *  @param[in] block
+     *  @param[in] block_len
+     *  @return    NMT_result
+     */
+
+    /* Initialize Variables */
+    NMT_result result = OK;
+
+    if (PCA9685_i2c_write_block(FD, block, block_len) != block_len)
+    {
+        NMT_log_write(ERROR, "I2C block write failed reg=0x%X len=%d", block[0], block_len);
+        result = NOK;
+    }
+
+    return result;
+}
+
+int PCA9685_i2c_write_block(int fd, const unsigned char *block, int block_len)
+{
+    /*!
+     *  @brief     Write a block to the I2C slave on fd in one transfer.
+     *             wiringPiI2C has no block write, so this is a raw write
+     *             on its fd.
+     *  @param[in] fd
+     *  @param[in] block
+     *  @param[in] block_len
+     *  @return    Bytes written (-1 on error)
+     */
+
+    return (int)write(fd, block, block_len);
+}
@@ -0,0 +1,225 @@
+/**
+ *  @file      RMCT_init.cpp
+ *  @brief     Hardware bring-up for RMCT
+ *  @details   Brings independent devices up at the same time once the
+ *             devices they hang off are up, and times each of them
+ *  @author    Nitin Mohan
+ *  @date      May 31, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <thread>
+#include <stdexcept>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "RMCT_init.hpp"
+#include "NMT_log.h"
+
+/*--------------------------------------------------/
+/                   Start of Program                /
+/--------------------------------------------------*/
+NMT_result RMCT_init_graph::add(const std::string &name, RMCT_init_fn init,
+                                std::initializer_list<std::string> after)
+{
+    /*!
+     *  @brief     Add a device that is brought up once every device in
+     *             after is up. A bad device fails the next run().
+     *  @param[in] name (Unique)
+     *  @param[in] init
+     *  @param[in] after (Devices already added)
+     *  @return    NMT_result
+     */
+
+    /* Initialize Variables */
+    NMT_result result = OK;
+    size_t id         = this->nodes.size();
+    std::vector<size_t> parents;
+
+    for (size_t i = 0; (result == OK) && (i < id); i++)
+    {
+        if (this->reports[i].name == name)
+        {
+            NMT_log_write(ERROR, (char *)"Device %s added twice", name.c_str());
+            result = NOK;
+        }
+    }
+
+    /* Dependencies are looked up among the devices added before */
+    for (const std::string &dep : after)
+    {
+        size_t parent = 0;
+        while ((parent < id) && (this->reports[parent].name != dep))
+            parent++;
+
+        if (parent == id)
+        {
+            NMT_log_write(ERROR, (char *)"Device %s needs %s, which is not added", name.c_str(), dep.c_str());
+            result = NOK;
+        }
+        else
+        {
+            parents.push_back(parent);
+        }
+    }
+
+    if (result == OK)
+    {
+        for (size_t parent : parents)
+            this->nodes[parent].children.push_back(id);
+
+        this->nodes.push_back({init, {}, (unsigned int)parents.size(), 0, false});
+        this->reports.push_back({name, NOK, false, 0, 0});
+    }
+    else
+    {
+        this->valid = false;
+    }
+
+    return result;
+}
+
+NMT_result RMCT_init_graph::run(unsigned int workers)
+{
+    /*!
+     *  @brief     Bring every device up on up to workers threads (the
+     *             caller is one of them). Devices that need a failed
+     *             device are skipped.
+     *  @param[in] workers
+     *  @return    NMT_result (NOK if any device failed)
+     */
+
+    NMT_log_write(DEBUG, (char *)"> devices=%zu workers=%u", this->nodes.size(), workers);
+
+    /* Initialize Variables */
+    NMT_result result = (this->valid ? OK : NOK);
+    auto start        = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    double init_ms    = 0;
+
+    if (result == OK)
+    {
+        this->ready.clear();
+        this->settled = 0;
+
+        for (size_t i = 0; i < this->nodes.size(); i++)
+        {
+            this->nodes[i].pending = this->nodes[i].deps;
+            this->nodes[i].blocked = false;
+            this->reports[i]       = {this->reports[i].name, NOK, false, 0, 0};
+
+            if (this->nodes[i].deps == 0)
+                this->ready.push_back(i);
+        }
+
+        /* No more threads than devices */
+        workers = (workers < this->nodes.size() ? workers : this->nodes.size());
+        for (unsigned int i = 1; i < workers; i++)
+            pool.emplace_back(&RMCT_init_graph::work, this, start);
+
+        this->work(start);
+
+        for (std::thread &worker : pool)
+            worker.join();
+    }
+
+    for (const RMCT_init_report &device : this->reports)
+    {
+        NMT_log_write(DEBUG, (char *)"device=%s result=%s ran=%s init=%.2fms ready=%.2fms",
+                      device.name.c_str(), result_e2s[device.result], btoa(device.ran),
+                      device.init_ms, device.ready_ms);
+
+        init_ms += device.init_ms;
+        if (device.result != OK)
+            result = NOK;
+    }
+
+    this->total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    /* Exit the function */
+    NMT_log_write(DEBUG, (char *)"< elapsed=%.2fms sum=%.2fms result=%s",
+                  this->total_ms, init_ms, result_e2s[result]);
+    return result;
+}
+
+void RMCT_init_graph::work(std::chrono::steady_clock::time_point start)
+{
+    /*!
+     *  @brief     Worker - Bring up ready devices until every device
+     *             settled
+     *  @param[in] start (Of the run)
+     *  @return    void
+     */
+
+    std::unique_lock<std::mutex> guard(this->lock);
+
+    while (true)
+    {
+        this->wake.wait(guard, [this]() {return (!this->ready.empty()) || (this->settled == this->nodes.size());});
+        if (this->ready.empty())
+            break;
+
+        size_t id = this->ready.front();
+        this->ready.pop_front();
+
+        /* Nothing else touches this node until it settles */
+        RMCT_init_fn &init = this->nodes[id].init;
+        guard.unlock();
+
+        NMT_result result = NOK;
+        auto begin        = std::chrono::steady_clock::now();
+
+        try
+        {
+            result = (init ? init() : OK);
+        }
+        catch (std::exception &e)
+        {
+            NMT_log_write(ERROR, (char *)"%s", e.what());
+        }
+
+        auto end = std::chrono::steady_clock::now();
+
+        guard.lock();
+        this->reports[id].ran      = true;
+        this->reports[id].init_ms  = std::chrono::duration<double, std::milli>(end - begin).count();
+        this->reports[id].ready_ms = std::chrono::duration<double, std::milli>(end - start).count();
+        this->settle(id, result);
+        this->wake.notify_all();
+    }
+}
+
+void RMCT_init_graph::settle(size_t id, NMT_result result)
+{
+    /*!
+     *  @brief     Record how a device ended and release the devices that
+     *             need it (Called with the lock held)
+     *  @param[in] id
+     *  @param[in] result
+     *  @return    void
+     */
+
+    this->reports[id].result = result;
+    this->settled++;
+
+    for (size_t child : this->nodes[id].children)
+    {
+        RMCT_init_node &node = this->nodes[child];
+
+        if (result != OK)
+            node.blocked = true;
+
+        /* Children are added after their parents, so this ends */
+        if (--node.pending == 0)
+        {
+            if (node.blocked)
+                this->settle(child, NOK);
+            else
+                this->ready.push_back(child);
+        }
+    }
+}
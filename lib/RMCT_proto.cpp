@@ -0,0 +1,724 @@
+/**
+ *  @file      RMCT_proto.cpp
+ *  @brief     Command codecs for RMCT
+ *  @details   Fixed layout binary protocol and a schema specific JSON
+ *             parser. Every read is bounds checked against the
+ *             datagram length.
+ *  @author    Nitin Mohan
+ *  @date      April 20, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <endian.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "RMCT_proto.hpp"
+#include "NMT_log.h"
+
+/*--------------------------------------------------/
+/                   Start of Program                /
+/--------------------------------------------------*/
+static void rmct_proto_put_header(RMCT_PROTO_TYPES type, uint8_t client, uint32_t seq, NMT_result result,
+                                  unsigned int count, char *buffer)
+{
+    /*!
+     *  @brief      Write a header carrying RMCT_PROTO_VERSION
+     *  @param[in]  type
+     *  @param[in]  client
+     *  @param[in]  seq
+     *  @param[in]  result
+     *  @param[in]  count
+     *  @param[out] buffer
+     */
+
+    RMCT_proto_header header;
+
+    header.magic    = htole16(RMCT_PROTO_MAGIC);
+    header.version  = RMCT_PROTO_VERSION;
+    header.type     = (uint8_t)type;
+    header.seq      = htole32(seq);
+    header.count    = htole16((uint16_t)count);
+    header.result   = (uint8_t)result;
+    header.client   = client;
+    memcpy(buffer, &header, sizeof(header));
+}
+
+bool RMCT_proto_is_binary(const char *buffer, size_t length)
+{
+    /*!
+     *  @brief     Check if a message uses the binary protocol
+     *  @param[in] buffer
+     *  @param[in] length
+     *  @return    True if the message starts with RMCT_PROTO_MAGIC
+     */
+
+    uint16_t magic;
+
+    if (length < sizeof(magic))
+        return false;
+
+    memcpy(&magic, buffer, sizeof(magic));
+    return le16toh(magic) == RMCT_PROTO_MAGIC;
+}
+
+NMT_result RMCT_proto_decode(const char *buffer, size_t length, RMCT_proto_msg &msg)
+{
+    /*!
+     *  @brief      Decode a binary message. The length must match the
+     *              header exactly and every enum must be in range.
+     *              Runs per command, so it only logs failures.
+     *  @param[in]  buffer
+     *  @param[in]  length
+     *  @param[out] msg
+     *  @return     NMT_result
+     */
+
+    /* Initialize Varibles */
+    NMT_result result = OK;
+    RMCT_proto_header header;
+    RMCT_proto_action action;
+    RMCT_proto_ack_record record;
+    uint32_t angle;
+
+    if (length < sizeof(header))
+    {
+        NMT_log_write(ERROR, (char *)"Binary message shorter than its header");
+        result = NOK;
+    }
+
+    if (result == OK)
+    {
+        memcpy(&header, buffer, sizeof(header));
+        msg.version = header.version;
+        msg.type    = (RMCT_PROTO_TYPES)header.type;
+        msg.seq     = le32toh(header.seq);
+        msg.client  = header.client;
+        msg.result  = (header.result == OK ? OK : NOK);
+        msg.count   = le16toh(header.count);
+
+        /* Anything newer than this build is only understood in a hello */
+        if ((le16toh(header.magic) != RMCT_PROTO_MAGIC) || (header.version == 0) ||
+            ((header.version > RMCT_PROTO_VERSION) && (header.type != RMCT_PROTO_HELLO)))
+        {
+            NMT_log_write(ERROR, (char *)"Unsupported binary protocol version=%u", header.version);
+            result = NOK;
+        }
+        else if ((header.type >= MAX_RMCT_PROTO_TYPES) ||
+                 ((header.type > RMCT_PROTO_ACK) && (header.version < RMCT_PROTO_ACK_BATCH_VERSION)))
+        {
+            NMT_log_write(ERROR, (char *)"Unknown binary message type=%u", header.type);
+            result = NOK;
+        }
+        else if ((msg.count > RMCT_PROTO_MAX_ACTIONS) ||
+                 (length != sizeof(header) + msg.count * sizeof(action)))
+        {
+            NMT_log_write(ERROR, (char *)"Binary message length=%zu does not match count=%u", length, msg.count);
+            result = NOK;
+        }
+    }
+
+    for (unsigned int i = 0; (result == OK) && (msg.type == RMCT_PROTO_ACK_BATCH) && (i < msg.count); i++)
+    {
+        memcpy(&record, buffer + sizeof(header) + i * sizeof(record), sizeof(record));
+        msg.acks[i].seq    = le32toh(record.seq);
+        msg.acks[i].result = (record.result == OK ? OK : NOK);
+    }
+
+    for (unsigned int i = 0; (result == OK) && (msg.type != RMCT_PROTO_ACK_BATCH) && (i < msg.count); i++)
+    {
+        memcpy(&action, buffer + sizeof(header) + i * sizeof(action), sizeof(action));
+        memcpy(&angle, &action.angle, sizeof(angle));
+        angle = le32toh(angle);
+
+        msg.actions[i].motor     = (RMCT_MOTORS)action.motor;
+        msg.actions[i].direction = (RMCT_DIRECTIONS)action.direction;
+        msg.actions[i].speed     = (int16_t)le16toh((uint16_t)action.speed);
+        memcpy(&action.angle, &angle, sizeof(angle));
+        msg.actions[i].angle     = action.angle;
+
+        if ((action.motor >= MAX_RMCT_MOTORS) || (action.direction > RMCT_NO_DIRECTION) ||
+            (!std::isfinite(msg.actions[i].angle)))
+        {
+            NMT_log_write(ERROR, (char *)"Invalid hw_action %u in binary message", i);
+            result = NOK;
+        }
+    }
+
+    return result;
+}
+
+size_t RMCT_proto_encode(const RMCT_proto_msg &msg, char *buffer, size_t capacity)
+{
+    /*!
+     *  @brief      Encode a message
+     *  @param[in]  msg
+     *  @param[out] buffer
+     *  @param[in]  capacity
+     *  @return     Bytes written (0 if it does not fit)
+     */
+
+    RMCT_proto_action action;
+    uint32_t angle;
+    size_t length = sizeof(RMCT_proto_header) + msg.count * sizeof(action);
+
+    if ((msg.count > RMCT_PROTO_MAX_ACTIONS) || (length > capacity))
+        return 0;
+
+    if (msg.type == RMCT_PROTO_ACK_BATCH)
+        return RMCT_proto_encode_ack_batch(msg.client, msg.acks, msg.count, buffer, capacity);
+
+    rmct_proto_put_header(msg.type, msg.client, msg.seq, msg.result, msg.count, buffer);
+
+    for (unsigned int i = 0; i < msg.count; i++)
+    {
+        action.motor     = (uint8_t)msg.actions[i].motor;
+        action.direction = (uint8_t)msg.actions[i].direction;
+        action.speed     = (int16_t)htole16((uint16_t)msg.actions[i].speed);
+        action.angle     = (float)msg.actions[i].angle;
+
+        memcpy(&angle, &action.angle, sizeof(angle));
+        angle = htole32(angle);
+        memcpy(&action.angle, &angle, sizeof(angle));
+
+        memcpy(buffer + sizeof(RMCT_proto_header) + i * sizeof(action), &action, sizeof(action));
+    }
+
+    return length;
+}
+
+size_t RMCT_proto_encode_ack(uint8_t client, uint32_t seq, NMT_result result, char *buffer, size_t capacity)
+{
+    /*!
+     *  @brief      Encode the ack for a binary command. It carries
+     *              RMCT_PROTO_VERSION, which answers a hello.
+     *  @param[in]  client
+     *  @param[in]  seq
+     *  @param[in]  result
+     *  @param[out] buffer
+     *  @param[in]  capacity
+     *  @return     Bytes written (0 if it does not fit)
+     */
+
+    RMCT_proto_msg ack;
+
+    ack.type   = RMCT_PROTO_ACK;
+    ack.client = client;
+    ack.seq    = seq;
+    ack.result = result;
+    ack.count  = 0;
+
+    return RMCT_proto_encode(ack, buffer, capacity);
+}
+
+size_t RMCT_proto_encode_ack_batch(uint8_t client, const RMCT_proto_ack *acks, unsigned int count,
+                                   char *buffer, size_t capacity)
+{
+    /*!
+     *  @brief      Encode the results of several binary commands from
+     *              one client into one datagram. The header carries the
+     *              newest seq, and OK only if every command succeeded.
+     *              Only for clients at RMCT_PROTO_ACK_BATCH_VERSION+.
+     *  @param[in]  client
+     *  @param[in]  acks
+     *  @param[in]  count
+     *  @param[out] buffer
+     *  @param[in]  capacity
+     *  @return     Bytes written (0 if it does not fit)
+     */
+
+    RMCT_proto_ack_record record;
+    NMT_result result = OK;
+    size_t length = sizeof(RMCT_proto_header) + count * sizeof(record);
+
+    if ((count == 0) || (count > RMCT_PROTO_MAX_ACTIONS) || (length > capacity))
+        return 0;
+
+    memset(record.reserved, 0, sizeof(record.reserved));
+    for (unsigned int i = 0; i < count; i++)
+    {
+        record.seq    = htole32(acks[i].seq);
+        record.result = (uint8_t)acks[i].result;
+        memcpy(buffer + sizeof(RMCT_proto_header) + i * sizeof(record), &record, sizeof(record));
+
+        if (acks[i].result != OK)
+            result = NOK;
+    }
+
+    rmct_proto_put_header(RMCT_PROTO_ACK_BATCH, client, acks[count - 1].seq, result, count, buffer);
+
+    return length;
+}
+
+RMCT_SEQ_VERDICTS RMCT_seq_filter::check(uint8_t client, uint32_t seq)
+{
+    /*!
+     *  @brief     Accept seq if it is newer than anything accepted from
+     *             the client. Unsequenced commands (seq 0) always pass.
+     *  @param[in] client
+     *  @param[in] seq
+     *  @return    RMCT_SEQ_VERDICTS (only RMCT_SEQ_NEW is accepted)
+     */
+
+    if ((seq == 0) || (!this->seen[client]) || ((int32_t)(seq - this->last_seq[client]) > 0))
+    {
+        if (seq != 0)
+            this->reset(client, seq);
+        return RMCT_SEQ_NEW;
+    }
+
+    if (seq == this->last_seq[client])
+    {
+        this->duplicate_count++;
+        return RMCT_SEQ_DUPLICATE;
+    }
+
+    this->stale_count++;
+    return RMCT_SEQ_STALE;
+}
+
+void RMCT_seq_filter::reset(uint8_t client, uint32_t seq)
+{
+    /*!
+     *  @brief     Restart the client at seq (a hello from a client
+     *             that restarted its numbering)
+     *  @param[in] client
+     *  @param[in] seq
+     *  @return    void
+     */
+
+    this->last_seq[client] = seq;
+    this->seen[client]     = true;
+}
+
+uint8_t RMCT_seq_filter::assign(uint32_t seq)
+{
+    /*!
+     *  @brief     Hand a new client its own ID, starting its sequence
+     *             at seq. IDs go round robin, so one is only reused
+     *             after every other ID has been handed out.
+     *  @param[in] seq (of the hello)
+     *  @return    Client ID (1 - 255)
+     */
+
+    uint8_t client = this->next_client;
+
+    this->next_client = (uint8_t)((client % (RMCT_PROTO_MAX_CLIENTS - 1)) + 1);
+    this->reset(client, seq);
+
+    return client;
+}
+
+/*--------------------------------------------------/
+/                   JSON Fast Path                  /
+/--------------------------------------------------*/
+/** @enum RMCT_JSON_KINDS
+ *  Kind of value seen for a schema field */
+typedef enum {RMCT_JSON_ABSENT,
+              RMCT_JSON_STRING,
+              RMCT_JSON_NUMBER,
+              RMCT_JSON_OTHER} RMCT_JSON_KINDS;
+
+/** @struct rmct_json_field
+ *  One schema field of an action object. Strings point into the
+ *  message, so nothing is copied or allocated. */
+typedef struct rmct_json_field
+{
+    RMCT_JSON_KINDS kind;
+    const char *str;
+    size_t len;
+    double number;
+} rmct_json_field;
+
+/** @enum RMCT_JSON_FIELDS
+ *  Fields of the hw_action/proc_action schema */
+typedef enum {RMCT_JSON_TYPE,
+              RMCT_JSON_MOTOR,
+              RMCT_JSON_DIRECTION,
+              RMCT_JSON_ANGLE,
+              RMCT_JSON_SPEED,
+              RMCT_JSON_ACTION,
+              MAX_RMCT_JSON_FIELDS} RMCT_JSON_FIELDS;
+
+/** @var RMCT_JSON_FIELD_TO_STR
+ *  Key of each schema field */
+static const char *RMCT_JSON_FIELD_TO_STR[MAX_RMCT_JSON_FIELDS] = {"type",
+                                                                  "motor",
+                                                                  "direction",
+                                                                  "angle",
+                                                                  "speed",
+                                                                  "action"};
+
+/** @var RMCT_JSON_MAX_NUMBER
+ *  Longest number literal accepted */
+static const size_t RMCT_JSON_MAX_NUMBER = 32;
+
+static void rmct_json_ws(const char *&pos, const char *end)
+{
+    while ((pos < end) && ((*pos == ' ') || (*pos == '\t') || (*pos == '\n') || (*pos == '\r')))
+        pos++;
+}
+
+static bool rmct_json_string(const char *&pos, const char *end, const char *&str, size_t &len)
+{
+    /*!
+     *  @brief      Read a string. Escapes are skipped over but not
+     *              decoded - no schema name contains one.
+     *  @param[in]  pos (at the opening quote, moved past the closing one)
+     *  @param[in]  end
+     *  @param[out] str
+     *  @param[out] len
+     *  @return     True if a well formed string was read
+     */
+
+    if ((pos >= end) || (*pos != '"'))
+        return false;
+
+    str = ++pos;
+    while ((pos < end) && (*pos != '"'))
+    {
+        if ((unsigned char)*pos < 0x20)
+            return false;
+
+        pos += (*pos == '\\' ? 2 : 1);
+    }
+
+    if (pos >= end)
+        return false;
+
+    len = pos - str;
+    pos++;
+    return true;
+}
+
+static bool rmct_json_number(const char *&pos, const char *end, double &number)
+{
+    /*!
+     *  @brief      Read a number. The JSON grammar is checked first so
+     *              strtod never sees hex, inf or nan.
+     *  @param[in]  pos
+     *  @param[in]  end
+     *  @param[out] number
+     *  @return     True if a well formed number was read
+     */
+
+    const char *start = pos;
+    char literal[RMCT_JSON_MAX_NUMBER + 1];
+    double integer = 0;
+
+    if ((pos < end) && (*pos == '-'))
+        pos++;
+
+    if ((pos < end) && (*pos == '0'))
+        pos++;
+    else if ((pos < end) && (*pos >= '1') && (*pos <= '9'))
+        while ((pos < end) && (*pos >= '0') && (*pos <= '9')) integer = integer * 10 + (*pos++ - '0');
+    else
+        return false;
+
+    /* Plain integers (most angles and speeds) are exact without strtod */
+    if (((pos >= end) || ((*pos != '.') && (*pos != 'e') && (*pos != 'E'))) && (pos - start <= 15))
+    {
+        number = (*start == '-' ? -integer : integer);
+        return true;
+    }
+
+    if ((pos < end) && (*pos == '.'))
+    {
+        if ((++pos >= end) || (*pos < '0') || (*pos > '9'))
+            return false;
+        while ((pos < end) && (*pos >= '0') && (*pos <= '9')) pos++;
+    }
+
+    if ((pos < end) && ((*pos == 'e') || (*pos == 'E')))
+    {
+        pos++;
+        if ((pos < end) && ((*pos == '+') || (*pos == '-')))
+            pos++;
+        if ((pos >= end) || (*pos < '0') || (*pos > '9'))
+            return false;
+        while ((pos < end) && (*pos >= '0') && (*pos <= '9')) pos++;
+    }
+
+    if ((size_t)(pos - start) > RMCT_JSON_MAX_NUMBER)
+        return false;
+
+    memcpy(literal, start, pos - start);
+    literal[pos - start] = '\0';
+    number = strtod(literal, NULL);
+    return std::isfinite(number);
+}
+
+static bool rmct_json_literal(const char *&pos, const char *end, const char *literal)
+{
+    size_t len = strlen(literal);
+
+    if (((size_t)(end - pos) < len) || (memcmp(pos, literal, len) != 0))
+        return false;
+
+    pos += len;
+    return true;
+}
+
+static bool rmct_json_skip(const char *&pos, const char *end)
+{
+    /*!
+     *  @brief      Skip a value the schema does not use. Nested
+     *              containers are skipped by bracket depth.
+     *  @param[in]  pos
+     *  @param[in]  end
+     *  @return     True if a value was skipped
+     */
+
+    const char *str;
+    size_t len;
+    double number;
+    unsigned int depth = 0;
+
+    if (pos >= end)
+        return false;
+
+    switch (*pos)
+    {
+        case '"': return rmct_json_string(pos, end, str, len);
+        case 't': return rmct_json_literal(pos, end, "true");
+        case 'f': return rmct_json_literal(pos, end, "false");
+        case 'n': return rmct_json_literal(pos, end, "null");
+        case '{':
+        case '[': break;
+        default:  return rmct_json_number(pos, end, number);
+    }
+
+    do
+    {
+        if (*pos == '"')
+        {
+            if (!rmct_json_string(pos, end, str, len))
+                return false;
+            continue;
+        }
+
+        if ((*pos == '{') || (*pos == '['))
+            depth++;
+        else if ((*pos == '}') || (*pos == ']'))
+            depth--;
+        pos++;
+    } while ((depth > 0) && (pos < end));
+
+    return depth == 0;
+}
+
+static bool rmct_json_object(const char *&pos, const char *end, rmct_json_field fields[MAX_RMCT_JSON_FIELDS])
+{
+    /*!
+     *  @brief      Read one action object into its schema fields.
+     *              Keys may come in any order; unknown keys are skipped
+     *              and a repeated key keeps its last value.
+     *  @param[in]  pos
+     *  @param[in]  end
+     *  @param[out] fields
+     *  @return     True if a well formed object was read
+     */
+
+    const char *key;
+    size_t key_len;
+
+    for (unsigned int f = 0; f < MAX_RMCT_JSON_FIELDS; f++)
+        fields[f].kind = RMCT_JSON_ABSENT;
+
+    if ((pos >= end) || (*pos != '{'))
+        return false;
+
+    pos++;
+    rmct_json_ws(pos, end);
+    if ((pos < end) && (*pos == '}'))
+    {
+        pos++;
+        return true;
+    }
+
+    while (pos < end)
+    {
+        unsigned int f = 0;
+
+        if (!rmct_json_string(pos, end, key, key_len))
+            return false;
+
+        rmct_json_ws(pos, end);
+        if ((pos >= end) || (*pos++ != ':'))
+            return false;
+        rmct_json_ws(pos, end);
+
+        while ((f < MAX_RMCT_JSON_FIELDS) && (!RMCT_name_equals(RMCT_JSON_FIELD_TO_STR[f], key, key_len)))
+            f++;
+
+        if ((f < MAX_RMCT_JSON_FIELDS) && (pos < end) && (*pos == '"'))
+        {
+            fields[f].kind = RMCT_JSON_STRING;
+            if (!rmct_json_string(pos, end, fields[f].str, fields[f].len))
+                return false;
+        }
+        else if ((f < MAX_RMCT_JSON_FIELDS) && (pos < end) && ((*pos == '-') || ((*pos >= '0') && (*pos <= '9'))))
+        {
+            fields[f].kind = RMCT_JSON_NUMBER;
+            if (!rmct_json_number(pos, end, fields[f].number))
+                return false;
+        }
+        else
+        {
+            if (f < MAX_RMCT_JSON_FIELDS)
+                fields[f].kind = RMCT_JSON_OTHER;
+            if (!rmct_json_skip(pos, end))
+                return false;
+        }
+
+        rmct_json_ws(pos, end);
+        if ((pos < end) && (*pos == ','))
+        {
+            pos++;
+            rmct_json_ws(pos, end);
+        }
+        else if ((pos < end) && (*pos == '}'))
+        {
+            pos++;
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+static NMT_result rmct_json_action(const rmct_json_field fields[MAX_RMCT_JSON_FIELDS], RMCT_proto_msg &msg)
+{
+    /*!
+     *  @brief      Validate one action against the schema and add it
+     *  @param[in]  fields
+     *  @param[out] msg
+     *  @return     NMT_result
+     */
+
+    const rmct_json_field &type = fields[RMCT_JSON_TYPE];
+    const rmct_json_field &speed = fields[RMCT_JSON_SPEED];
+
+    if (type.kind != RMCT_JSON_STRING)
+        return NOK;
+
+    if (RMCT_name_equals("hw_action", type.str, type.len))
+    {
+        if ((fields[RMCT_JSON_MOTOR].kind != RMCT_JSON_STRING) || (fields[RMCT_JSON_DIRECTION].kind != RMCT_JSON_STRING) ||
+            (fields[RMCT_JSON_ANGLE].kind != RMCT_JSON_NUMBER) || (speed.kind != RMCT_JSON_NUMBER) ||
+            (speed.number < INT32_MIN) || (speed.number > INT32_MAX) || (msg.count >= RMCT_PROTO_MAX_ACTIONS))
+        {
+            return NOK;
+        }
+
+        if (RMCT_parse_motor_action(fields[RMCT_JSON_MOTOR].str, fields[RMCT_JSON_MOTOR].len,
+                                    fields[RMCT_JSON_DIRECTION].str, fields[RMCT_JSON_DIRECTION].len,
+                                    fields[RMCT_JSON_ANGLE].number, (int)speed.number,
+                                    msg.actions[msg.count]) != OK)
+        {
+            NMT_log_write(ERROR, (char *)"Unknown motor in hw_action");
+            return NOK;
+        }
+
+        msg.count++;
+        return OK;
+    }
+
+    if (RMCT_name_equals("proc_action", type.str, type.len))
+    {
+        if (fields[RMCT_JSON_ACTION].kind != RMCT_JSON_STRING)
+            return NOK;
+
+        if (RMCT_name_equals("exit", fields[RMCT_JSON_ACTION].str, fields[RMCT_JSON_ACTION].len))
+            msg.type = RMCT_PROTO_EXIT;
+        else if ((RMCT_name_equals("latency", fields[RMCT_JSON_ACTION].str, fields[RMCT_JSON_ACTION].len)) &&
+                 (msg.type != RMCT_PROTO_EXIT))
+            msg.type = RMCT_PROTO_LATENCY;
+
+        return OK;
+    }
+
+    return NOK;
+}
+
+NMT_result RMCT_proto_parse_json(const char *buffer, size_t length, RMCT_proto_msg &msg)
+{
+    /*!
+     *  @brief      Parse a JSON command (an array of hw_action and
+     *              proc_action objects) in one pass, straight into
+     *              msg. Nothing is allocated, and only failures are
+     *              logged (NMT_log_write allocates).
+     *  @param[in]  buffer
+     *  @param[in]  length
+     *  @param[out] msg
+     *  @return     NMT_result
+     */
+
+    /* Initialize Varibles */
+    NMT_result result = NOK;
+    const char *pos = buffer;
+    const char *end = buffer + length;
+    rmct_json_field fields[MAX_RMCT_JSON_FIELDS];
+
+    msg.version = 0;
+    msg.type    = RMCT_PROTO_ACTIONS;
+    msg.seq     = 0;
+    msg.client  = 0;
+    msg.result  = OK;
+    msg.count   = 0;
+
+    rmct_json_ws(pos, end);
+    if ((pos < end) && (*pos == '['))
+    {
+        pos++;
+        rmct_json_ws(pos, end);
+
+        if ((pos < end) && (*pos == ']'))
+        {
+            pos++;
+            result = OK;
+        }
+
+        while ((result != OK) && (rmct_json_object(pos, end, fields)) && (rmct_json_action(fields, msg) == OK))
+        {
+            rmct_json_ws(pos, end);
+
+            if ((pos < end) && (*pos == ']'))
+            {
+                pos++;
+                result = OK;
+            }
+            else if ((pos < end) && (*pos == ','))
+            {
+                pos++;
+                rmct_json_ws(pos, end);
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    /* Nothing but whitespace (or the terminating nul) may follow */
+    rmct_json_ws(pos, end);
+    if ((result == OK) && (pos < end) && (*pos != '\0'))
+        result = NOK;
+
+    if (result != OK)
+        NMT_log_write(ERROR, (char *)"Invalid Message Recieved");
+
+    return result;
+}
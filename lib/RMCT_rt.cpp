@@ -0,0 +1,178 @@
+/**
+ *  @file      RMCT_rt.cpp
+ *  @brief     Real-time control loop for RMCT
+ *  @details   Runs the actuator updates from a fixed rate clock instead
+ *             of the arrival of datagrams, and measures how well the
+ *             clock is kept
+ *  @author    Nitin Mohan
+ *  @date      April 23, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <cstring>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "RMCT_rt.hpp"
+#include "NMT_log.h"
+
+/*--------------------------------------------------/
+/                   Macros                          /
+/--------------------------------------------------*/
+/** @var NSEC_PER_SEC
+ *  Nanoseconds per second */
+#define NSEC_PER_SEC 1000000000LL
+
+/*--------------------------------------------------/
+/                   Start of Program                /
+/--------------------------------------------------*/
+static inline int64_t rmct_rt_ns(const struct timespec &time)
+{
+    /*!
+     *  @brief     Convert a timespec to ns
+     *  @param[in] time
+     *  @return    ns
+     */
+
+    return ((int64_t)time.tv_sec * NSEC_PER_SEC + time.tv_nsec);
+}
+
+RMCT_rt_loop::RMCT_rt_loop(unsigned int rate_hz, int cpu, int priority, std::function<void()> on_tick) :
+    cpu(cpu), priority(priority), on_tick(on_tick), running(true), tick_count(0)
+{
+    /*!
+     *  @brief     Constructor definition for RMCT_rt_loop
+     *  @param[in] rate_hz (0 uses DEFAULT_RT_RATE)
+     *  @param[in] cpu (< 0 for the last online CPU)
+     *  @param[in] priority (SCHED_FIFO priority)
+     *  @param[in] on_tick
+     *  @return    void
+     */
+
+    if (rate_hz == 0) {rate_hz = DEFAULT_RT_RATE;}
+    this->period = std::chrono::nanoseconds(NSEC_PER_SEC / rate_hz);
+}
+
+NMT_result RMCT_rt_loop::run()
+{
+    /*!
+     *  @brief     Run the loop on the calling thread until stop()
+     *  @return    NMT_result (NOK if the clock could not be slept on)
+     */
+
+    /* Initialize Varibles */
+    NMT_result result  = OK;
+    int64_t period_ns  = this->period.count();
+    int64_t next_ns;
+    struct timespec next, now;
+
+    NMT_log_write(DEBUG, (char *)"> period=%lldns cpu=%d priority=%d",
+                  (long long)period_ns, this->cpu, this->priority);
+
+    this->setup();
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    next_ns = rmct_rt_ns(now);
+
+    while ((this->running) && (result == OK))
+    {
+        next_ns     += period_ns;
+        next.tv_sec  = next_ns / NSEC_PER_SEC;
+        next.tv_nsec = next_ns % NSEC_PER_SEC;
+
+        int rc;
+        while ((rc = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL)) == EINTR) {}
+        if (rc != 0)
+        {
+            NMT_log_write(ERROR, (char *)"clock_nanosleep failed: %s", strerror(rc));
+            result = NOK;
+            break;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        int64_t late_ns = rmct_rt_ns(now) - next_ns;
+
+        this->on_tick();
+
+        /* Ran past the next deadline - Skip the ones already missed */
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        int64_t missed = (rmct_rt_ns(now) - next_ns) / period_ns;
+        next_ns       += missed * period_ns;
+
+        {
+            std::lock_guard<std::mutex> lock(this->stats_lock);
+            this->jitter.add(late_ns > 0 ? (uint64_t)late_ns : 0);
+            if (missed > 0) {this->overrun_count++;}
+        }
+        this->tick_count++;
+    }
+
+    NMT_log_write(DEBUG, (char *)"< ticks=%llu result=%s", (unsigned long long)this->tick_count.load(),
+                  result_e2s[result]);
+    return result;
+}
+
+void RMCT_rt_loop::stop()
+{
+    /*!
+     *  @brief     Make run() return after the current tick. Safe to
+     *             call from any thread, including from on_tick.
+     *  @return    void
+     */
+
+    this->running = false;
+}
+
+void RMCT_rt_loop::stats(RMCT_latency_histogram &jitter, uint64_t &overruns) const
+{
+    /*!
+     *  @brief      Copy out the tick statistics
+     *  @param[out] jitter (Wakeup delay past each deadline)
+     *  @param[out] overruns (Ticks that ran past the next deadline)
+     *  @return     void
+     */
+
+    std::lock_guard<std::mutex> lock(this->stats_lock);
+    jitter   = this->jitter;
+    overruns = this->overrun_count;
+}
+
+void RMCT_rt_loop::setup()
+{
+    /*!
+     *  @brief     Make the calling thread real-time: no page faults, its
+     *             own CPU and SCHED_FIFO. Without the privileges the loop
+     *             still runs, just with more jitter.
+     *  @return    void
+     */
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        NMT_log_write(WARNING, (char *)"Control loop memory not locked: %s", strerror(errno));
+
+    int target = this->cpu;
+    if (target < 0) {target = (int)sysconf(_SC_NPROCESSORS_ONLN) - 1;}
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET((target < 0 ? 0 : target), &cpus);
+
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (rc != 0)
+        NMT_log_write(WARNING, (char *)"Control loop not pinned to CPU %d: %s", target, strerror(rc));
+
+    struct sched_param param;
+    param.sched_priority = this->priority;
+
+    rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (rc != 0)
+        NMT_log_write(WARNING, (char *)"Control loop running without RT priority: %s", strerror(rc));
+}
@@ -0,0 +1,142 @@
+/**
+ *  @file      RMCT_trace.cpp
+ *  @brief     Command latency tracing for RMCT
+ *  @details   Aggregates the time each command spends between the
+ *             kernel receive and the hardware write into per stage
+ *             histograms. Recording is allocation free so it can run per command.
+ *  @author    Nitin Mohan
+ *  @date      April 21, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <string.h>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "RMCT_trace.hpp"
+
+/*--------------------------------------------------/
+/                   Start of Program                /
+/--------------------------------------------------*/
+void RMCT_latency_histogram::add(uint64_t latency_ns)
+{
+    /*!
+     *  @brief     Count one latency
+     *  @param[in] latency_ns
+     *  @return    void
+     */
+
+    /* Bit length of the latency - 0 for 0ns, i for [2^(i-1), 2^i) */
+    unsigned int index = (latency_ns ? 64 - __builtin_clzll(latency_ns) : 0);
+    if (index >= RMCT_TRACE_BUCKETS) {index = RMCT_TRACE_BUCKETS - 1;}
+
+    this->buckets[index]++;
+    this->samples++;
+    this->sum_ns += latency_ns;
+    if (latency_ns > this->max_ns) {this->max_ns = latency_ns;}
+}
+
+uint64_t RMCT_latency_histogram::percentile(double percent) const
+{
+    /*!
+     *  @brief     Upper bound of the bucket holding the given percentile
+     *  @param[in] percent (0 - 100)
+     *  @return    Latency in ns (never above the max seen, 0 if empty)
+     */
+
+    uint64_t rank = (uint64_t)((percent / 100.0) * this->samples + 0.5);
+    uint64_t seen = 0;
+
+    if (rank < 1) {rank = 1;}
+
+    for (unsigned int i = 0; ((this->samples > 0) && (i < RMCT_TRACE_BUCKETS)); i++)
+    {
+        seen += this->buckets[i];
+        if (seen >= rank)
+        {
+            uint64_t bound = (i ? ((uint64_t)1 << i) - 1 : 0);
+            return (bound < this->max_ns ? bound : this->max_ns);
+        }
+    }
+
+    return this->max_ns;
+}
+
+void RMCT_latency_histogram::reset()
+{
+    /*!
+     *  @brief     Forget every sample
+     *  @return    void
+     */
+
+    memset(this->buckets, 0, sizeof(this->buckets));
+    this->samples = 0;
+    this->sum_ns  = 0;
+    this->max_ns  = 0;
+}
+
+void RMCT_trace::stamp(struct timespec &stamp)
+{
+    /*!
+     *  @brief      Stamp a stage. Uses CLOCK_REALTIME, the clock the
+     *              kernel receive timestamps (SO_TIMESTAMPNS) are in.
+     *  @param[out] stamp
+     *  @return     void
+     */
+
+    clock_gettime(CLOCK_REALTIME, &stamp);
+}
+
+void RMCT_trace::record(const struct timespec stamps[MAX_RMCT_TRACE_STAGES])
+{
+    /*!
+     *  @brief     Add the stage latencies of one command. A clock step
+     *             backwards counts as 0ns rather than wrapping.
+     *  @param[in] stamps (Indexed by RMCT_TRACE_STAGES, zero if skipped)
+     *  @return    void
+     */
+
+    int first = -1;
+    int last  = -1;
+
+    for (int i = 0; i < MAX_RMCT_TRACE_STAGES; i++)
+    {
+        if ((stamps[i].tv_sec == 0) && (stamps[i].tv_nsec == 0))
+            continue;
+
+        if (last >= 0)
+        {
+            int64_t delta = ((int64_t)(stamps[i].tv_sec - stamps[last].tv_sec) * 1000000000 +
+                             (stamps[i].tv_nsec - stamps[last].tv_nsec));
+            this->stages[i].add(delta > 0 ? (uint64_t)delta : 0);
+        }
+        else
+        {
+            first = i;
+        }
+        last = i;
+    }
+
+    if ((first >= 0) && (last > first))
+    {
+        int64_t delta = ((int64_t)(stamps[last].tv_sec - stamps[first].tv_sec) * 1000000000 +
+                         (stamps[last].tv_nsec - stamps[first].tv_nsec));
+        this->end_to_end.add(delta > 0 ? (uint64_t)delta : 0);
+    }
+}
+
+void RMCT_trace::reset()
+{
+    /*!
+     *  @brief     Forget every recorded command
+     *  @return    void
+     */
+
+    for (int i = 0; i < MAX_RMCT_TRACE_STAGES; i++)
+        this->stages[i].reset();
+    this->end_to_end.reset();
+}
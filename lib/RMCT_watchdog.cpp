@@ -0,0 +1,156 @@
+/**
+ *  @file      RMCT_watchdog.cpp
+ *  @brief     Deadman watchdog for RMCT
+ *  @details   Stops the robot when commands stop arriving, without
+ *             depending on the socket loop that waits for them
+ *  @author    Nitin Mohan
+ *  @date      April 12, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <pthread.h>
+#include <sched.h>
+#include <cstring>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "RMCT_watchdog.hpp"
+#include "NMT_log.h"
+
+/*--------------------------------------------------/
+/                   Start of Program                /
+/--------------------------------------------------*/
+RMCT_watchdog::RMCT_watchdog(std::chrono::milliseconds deadline, std::function<void()> on_expire) :
+    deadline(deadline), on_expire(on_expire), last_feed(0), armed(false), expiry_count(0), running(false)
+{
+    /*!
+     *  @brief     Constructor definition for RMCT_watchdog
+     *  @param[in] deadline
+     *  @param[in] on_expire
+     *  @return    void
+     */
+
+    this->check_period = std::chrono::duration_cast<std::chrono::microseconds>(deadline) / WATCHDOG_CHECKS_PER_DEADLINE;
+
+    if (this->check_period.count() < 1000)
+        this->check_period = std::chrono::microseconds(1000);
+}
+
+RMCT_watchdog::~RMCT_watchdog()
+{
+    /*!
+     *  @brief     Destructor - Stop the watchdog thread
+     *  @return    void
+     */
+
+    this->stop();
+}
+
+void RMCT_watchdog::feed()
+{
+    /*!
+     *  @brief     A fresh command arrived - Restart the deadline
+     *  @return    void
+     */
+
+    this->last_feed = std::chrono::steady_clock::now().time_since_epoch().count();
+    this->armed     = true;
+}
+
+bool RMCT_watchdog::check(std::chrono::steady_clock::time_point now)
+{
+    /*!
+     *  @brief     Fire on_expire if the last feed is older than the
+     *             deadline. Fires once per feed.
+     *  @param[in] now
+     *  @return    True if the deadline expired on this check
+     */
+
+    std::chrono::steady_clock::time_point fed((std::chrono::steady_clock::duration(this->last_feed.load())));
+
+    if ((!this->enabled()) || (!this->armed) || ((now - fed) <= this->deadline))
+        return false;
+
+    /* Only one of the checker and a racing feed gets to disarm */
+    bool was_armed = true;
+    if (!this->armed.compare_exchange_strong(was_armed, false))
+        return false;
+
+    /* A feed landed after the deadline was read - Stay armed */
+    if (this->last_feed.load() != fed.time_since_epoch().count())
+    {
+        this->armed = true;
+        return false;
+    }
+
+    this->expiry_count++;
+    NMT_log_write(ERROR, (char *)"Command deadline of %ldms expired (count=%u)",
+                  (long)this->deadline.count(), this->expiry_count.load());
+
+    if (this->on_expire)
+        this->on_expire();
+
+    return true;
+}
+
+NMT_result RMCT_watchdog::start()
+{
+    /*!
+     *  @brief     Start the watchdog thread. It asks for real-time
+     *             priority so a busy system cannot starve the check.
+     *             Nothing is started when the watchdog is disabled.
+     *  @return    NMT_result
+     */
+
+    NMT_log_write(DEBUG, (char *)"> deadline=%ldms check_period=%ldus",
+                  (long)this->deadline.count(), (long)this->check_period.count());
+
+    if ((this->enabled()) && (!this->running.exchange(true)))
+    {
+        this->worker = std::thread(&RMCT_watchdog::run, this);
+
+        struct sched_param param;
+        param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+
+        int rc = pthread_setschedparam(this->worker.native_handle(), SCHED_FIFO, &param);
+        if (rc != 0)
+            NMT_log_write(WARNING, (char *)"Watchdog running without RT priority: %s", strerror(rc));
+    }
+
+    NMT_log_write(DEBUG, (char *)"< result=%s", result_e2s[OK]);
+    return OK;
+}
+
+void RMCT_watchdog::stop()
+{
+    /*!
+     *  @brief     Stop the watchdog thread and wait for it to exit
+     *  @return    void
+     */
+
+    this->running = false;
+    if (this->worker.joinable())
+        this->worker.join();
+}
+
+void RMCT_watchdog::run()
+{
+    /*!
+     *  @brief     Watchdog thread. Checks run off absolute times
+     *  @return    void
+     */
+
+    auto next_check = std::chrono::steady_clock::now();
+
+    while (this->running)
+    {
+        this->check(std::chrono::steady_clock::now());
+
+        next_check += this->check_period;
+        std::this_thread::sleep_until(next_check);
+    }
+}
@@ -3,6 +3,12 @@
  *  @brief     Facility for reading RSXA.json
  *  @details   Read RSXA.json file and write contents to memory for 
  *             use by other components to determine their sim_mode.
+ *             The settings live in one arena, which rsxa-compile
+ *             writes out as an image that is mapped instead of the
+ *             JSON while it matches it. rsxa-server publishes the
+ *             same image in shared memory, which is read first.
+ *             RSXA_watch reports edits of the JSON so running tasks
+ *             can reload it.
  *  @author    Nitin Mohan
  *  @date      Feb 6, 2019
  *  @copyright 2020 - NM Technologies
@@ -12,7 +18,16 @@
 /                   System Imports                  /
 /--------------------------------------------------*/
 #include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#include <sys/file.h>
+#include <sched.h>
 #include <json-c/json.h>
 
 /*--------------------------------------------------/
@@ -24,10 +39,171 @@
 /*--------------------------------------------------/
 /                   Macros                          /
 /--------------------------------------------------*/
-/** \def RS_SETTINGS_PATH 
- *  Hard coded path to the RSXA.json file
-*/
-#define RS_SETTINGS_PATH "/etc/NiBot/RSXA.json"
+/** \def RSXA_IMAGE_MAGIC
+ *  First word of the image ("RSXA") */
+#define RSXA_IMAGE_MAGIC 0x41585352
+
+/** \def RSXA_IMAGE_VERSION
+ *  Bumped whenever the image layout changes */
+#define RSXA_IMAGE_VERSION 3
+
+/** \def RSXA_IMAGE_ALIGN
+ *  Alignment of the image's arena and of each part in an arena */
+#define RSXA_IMAGE_ALIGN 8
+
+/** \def RSXA_SHM_MAGIC
+ *  First word of the shared segment ("RSXS") */
+#define RSXA_SHM_MAGIC 0x53585352
+
+/** \def RSXA_SHM_IMAGE_OFF
+ *  Start of the image in the shared segment */
+#define RSXA_SHM_IMAGE_OFF RSXA_align(sizeof(RSXA_shm_hdr))
+
+/** \def RSXA_SHM_RETRIES
+ *  Copies tried while the segment keeps being rewritten */
+#define RSXA_SHM_RETRIES 100
+
+/** \def RSXA_HW_SLOTS
+ *  hw name slots, right after the RSXA_index */
+#define RSXA_HW_SLOTS(index) ((int32_t *)((RSXA_index *)(index) + 1))
+
+/** \def RSXA_PROCS_SLOTS
+ *  Proc name slots, after the hw ones */
+#define RSXA_PROCS_SLOTS(index) (RSXA_HW_SLOTS(index) + (index)->hw_mask + 1)
+
+/** \def RSXA_STR_SLOTS
+ *  String slots, right after the RSXA_strtab */
+#define RSXA_STR_SLOTS(strings) ((const uint32_t *)((const struct RSXA_strtab *)(strings) + 1))
+
+/** \def RSXA_STR_DATA
+ *  String data, after the slots */
+#define RSXA_STR_DATA(strings) ((const char *)(RSXA_STR_SLOTS(strings) + (strings)->mask + 1))
+
+/** \def RSXA_STR_LEN
+ *  Length a string in the data starts with */
+#define RSXA_STR_LEN(strings, id) (*(const uint32_t *)(RSXA_STR_DATA(strings) + (id)))
+
+/** \def RSXA_STR_ENTRY
+ *  Bytes a string of len characters takes in the data */
+#define RSXA_STR_ENTRY(len) ((sizeof(uint32_t) + (uint64_t)(len) + 1 + 3) & ~(uint64_t)3)
+
+/** \def RSXA_NAME_AT
+ *  Name handle of entry i of an array of structs */
+#define RSXA_NAME_AT(names, stride, i) (*(const RSXA_str *)((const char *)(names) + (size_t)(i) * (stride)))
+
+/*--------------------------------------------------/
+/                   Structs                         /
+/--------------------------------------------------*/
+/** @struct RSXA_image_hdr
+ *  Header of the image. The arena RSXA_init would have parsed the JSON
+ *  into follows as it is, with hw_interface cleared. The image is only
+ *  read on the machine that wrote it, so the record sizes are checked
+ *  instead of defining a portable encoding. */
+typedef struct RSXA_image_hdr
+{
+    /* Identification */
+    uint32_t magic;
+    uint32_t version;
+
+    /** @var checksum
+     *  CRC-32 of everything after the header */
+    uint32_t checksum;
+
+    /** @var size
+     *  Size of the whole image */
+    uint32_t size;
+
+    /* Record sizes of the writer */
+    uint32_t procs_size;
+    uint32_t hw_size;
+    uint32_t pins_size;
+
+    /* Counts the arena is laid out from */
+    uint32_t procs_count;
+    uint32_t hw_count;
+    uint32_t pins_count;
+
+    /** @var arena_off
+     *  Start of the arena */
+    uint32_t arena_off;
+
+    /* Size of the string table */
+    uint32_t str_slots;
+    uint32_t str_capacity;
+
+    /** @var log_dir
+     *  Handle of the log directory */
+    RSXA_str log_dir;
+
+    /* JSON the image was compiled from */
+    int64_t src_mtime_sec;
+    int64_t src_mtime_nsec;
+    int64_t src_size;
+} RSXA_image_hdr;
+
+/** @struct RSXA_shm_hdr
+ *  Header of the shared segment, followed by an image as RSXA_compile
+ *  writes it. The image is copied out, so readers never hold on to it. */
+typedef struct RSXA_shm_hdr
+{
+    /* Identification */
+    uint32_t magic;
+    uint32_t version;
+
+    /** @var generation
+     *  Odd while the image is rewritten, twice the published generation after */
+    uint64_t generation;
+
+    /** @var image_size
+     *  Size of the image (the segment may be larger) */
+    uint64_t image_size;
+} RSXA_shm_hdr;
+
+/** @struct RSXA_index
+ *  Open addressed hash tables over the hw and proc names, followed by
+ *  their slots. A slot holds the array index + 1 of its entry, 0 if
+ *  free. The first of several entries with the same name wins, as a
+ *  scan of the array would. Holds no pointers, so it can be mapped. */
+typedef struct RSXA_index
+{
+    uint32_t hw_mask;
+    uint32_t procs_mask;
+} RSXA_index;
+
+/** @struct RSXA_strtab
+ *  Open addressed hash table over the strings, followed by its slots
+ *  and the string data. A slot holds the handle + 1 of its string, 0 if
+ *  free. A string is stored as its length, its characters and a
+ *  terminator, padded to 4 bytes, and its handle is where it starts in
+ *  the data. Holds no pointers, so it can be mapped. */
+struct RSXA_strtab
+{
+    uint32_t mask;
+    uint32_t capacity;
+    uint32_t used;
+    uint32_t count;
+};
+
+/** @struct RSXA_layout
+ *  Offsets of each part of an arena */
+typedef struct RSXA_layout
+{
+    uint64_t procs_off;
+    uint64_t hw_off;
+    uint64_t pins_off;
+    uint64_t index_off;
+    uint64_t strtab_off;
+    uint64_t size;
+
+    /* Slots of each hash table */
+    uint32_t hw_slots;
+    uint32_t procs_slots;
+    uint32_t str_slots;
+
+    /** @var str_capacity
+     *  Bytes of string data */
+    uint64_t str_capacity;
+} RSXA_layout;
 
 /*--------------------------------------------------/
 /                   Global Variables                /
@@ -60,6 +236,14 @@ const char *CLIENT_IP   = "client_ip";
  *  client_p key */
 const char *CLIENT_P    = "client_p";
 
+/** @var TRANSPORT
+ *  transport key (optional) */
+const char *TRANSPORT   = "transport";
+
+/** @var DEFAULT_TRANSPORT
+ *  Transport used when a proc does not name one */
+const char *DEFAULT_TRANSPORT = "udp";
+
 /** @var HW
  *  hw key */
 const char *HW          = "hw";
@@ -85,14 +269,42 @@ const char *PIN_NAME    = "pin_name";
 const char *PIN_NO      = "pin_no";
 
 /*------------------Prototypes----------------------*/
+static NMT_result RSXA_load_json(const char *json_path, RSXA *RSXA_Object);
+static NMT_result RSXA_load_image(const char *image_path, const struct stat *json_stat, RSXA *RSXA_Object);
+static NMT_result RSXA_load_shm(const char *shm_name, const struct stat *json_stat, RSXA *RSXA_Object);
+static NMT_result RSXA_attach_image(unsigned char *image, size_t image_size, const struct stat *json_stat,
+                                    RSXA *RSXA_Object, const char **reason);
+static NMT_result RSXA_build_image(const char *json_path, unsigned char **image, size_t *image_size);
 static NMT_result RSXA_parse_json(char *data_to_parse, RSXA *RSXA_Object);
 static NMT_result RSXA_find_key(json_object *in_obj, const char *key, json_object **out_obj);
+static NMT_result RSXA_copy_str(json_object *in_obj, const char *key, struct RSXA_strtab *strings, RSXA_str *dst);
+static const char *RSXA_json_str(json_object *jvalue, size_t *len);
+static void RSXA_count_str(json_object *in_obj, const char *key, uint32_t *str_count, uint64_t *str_chars);
+static uint32_t RSXA_crc32(const unsigned char *data, size_t len);
+static uint64_t RSXA_align(uint64_t offset);
+static void RSXA_fill_index(RSXA *RSXA_Object, const RSXA_layout *layout);
+static void RSXA_arena_layout(int procs_count, int hw_count, int pins_count, uint32_t str_slots,
+                              uint64_t str_capacity, RSXA_layout *layout);
+static void RSXA_strtab_size(uint32_t count, uint64_t chars, uint32_t *slots, uint64_t *capacity);
+static uint32_t RSXA_index_size(int count);
+static void RSXA_index_add(int32_t *slots, uint32_t mask, const RSXA_str *names, size_t stride, int count);
+static int RSXA_index_find(const int32_t *slots, uint32_t mask, const RSXA_str *names, size_t stride,
+                           int count, RSXA_str name);
+static void RSXA_strtab_init(struct RSXA_strtab *strings, uint32_t slots, uint64_t capacity);
+static uint32_t RSXA_str_probe(const struct RSXA_strtab *strings, const char *str, size_t len, RSXA_str *id);
+static bool RSXA_str_valid(const struct RSXA_strtab *strings, RSXA_str id);
+static bool RSXA_strtab_valid(const struct RSXA_strtab *strings, const RSXA_layout *layout);
+static RSXA_str RSXA_str_move(const struct RSXA_strtab *to, const struct RSXA_strtab *from, RSXA_str id);
+static RSXA_pins *RSXA_find_pin_id(const RSXA_hw *hw, RSXA_str pin_name);
+static uint32_t RSXA_hash(const char *str, size_t len);
+static uint32_t RSXA_hash_id(RSXA_str id);
 
 NMT_result RSXA_init(RSXA *RSXA_Object)
 {
     /*!
-     *  @brief     Read RSXA.json file and parse to RSXA_parse_json
-     *              to parse the contents
+     *  @brief     Copy the settings rsxa-server published from the current
+     *             RSXA.json, else map the image compiled from it, else
+     *             read RSXA.json and parse it
      *  @param[in] hw
      *  @return    NMT_result
      */
@@ -101,199 +313,1584 @@ NMT_result RSXA_init(RSXA *RSXA_Object)
 
     /* Initialize Variables */
     NMT_result result = OK;
-    char *file_content;
-
-    /* Read and parse the Json settings file */
-    result = NMT_stdlib_read_file(RS_SETTINGS_PATH, &file_content);
+    struct stat json_stat;
+    bool have_json = (stat(RS_SETTINGS_PATH, &json_stat) == 0);
+
+    RSXA_Object->log_dir         = 0;
+    RSXA_Object->strings         = NULL;
+    RSXA_Object->procs           = NULL;
+    RSXA_Object->hw              = NULL;
+    RSXA_Object->array_len_procs = 0;
+    RSXA_Object->array_len_hw    = 0;
+    RSXA_Object->image           = NULL;
+    RSXA_Object->image_size      = 0;
+    RSXA_Object->arena           = NULL;
+    RSXA_Object->index           = NULL;
+    RSXA_Object->generation      = 0;
+
+    /* Prefer the published settings, then the image - Nothing to parse */
+    result = RSXA_load_shm(RS_SHM_NAME, (have_json ? &json_stat : NULL), RSXA_Object);
 
     if (result == OK)
-        result = RSXA_parse_json(file_content, RSXA_Object);
+    {
+        printf("Attached: %s generation=%llu and the result=%s \n", RS_SHM_NAME,
+               (unsigned long long)RSXA_Object->generation, result_e2s[result]);
+        return result;
+    }
 
-    /* Free Used Memory */
-    free(file_content);
+    result = RSXA_load_image(RS_IMAGE_PATH, (have_json ? &json_stat : NULL), RSXA_Object);
+
+    if (result == OK)
+    {
+        printf("Mapped: %s and the result=%s \n", RS_IMAGE_PATH, result_e2s[result]);
+    }
+    else
+    {
+        result = RSXA_load_json(RS_SETTINGS_PATH, RSXA_Object);
+        printf("Parsed: %s and the result=%s \n", RS_SETTINGS_PATH,
+                                                  result_e2s[result]);
+    }
 
     /* Exit the Function */
-    printf("Parsed: %s and the result=%s \n", RS_SETTINGS_PATH, 
-                                              result_e2s[result]);
     return result;
 }
 
-static NMT_result RSXA_find_key(json_object *in_obj, const char *key, json_object **out_obj)
+RSXA_hw *RSXA_find_hw(const RSXA *RSXA_Object, const char *hw_name)
 {
     /*!
-     *  @brief      Wrapper function for json_object_object_get_ex
-     *  @param[in]  in_obj
-     *  @param[in]  key
-     *  @param[out] out_obj
-     *  @return     NMT_result
+     *  @brief     Find a hw entry by name
+     *  @param[in] RSXA_Object
+     *  @param[in] hw_name
+     *  @return    hw entry (NULL if not found)
+     */
+
+    const RSXA_index *index = RSXA_Object->index;
+    RSXA_str name           = RSXA_str_find(RSXA_Object->strings, hw_name, strlen(hw_name));
+    int found;
+
+    /* A name that is not in the table is not the name of anything */
+    if ((RSXA_Object->array_len_hw <= 0) || (name == RSXA_STR_NONE)) {return NULL;}
+
+    found = RSXA_index_find((index != NULL ? RSXA_HW_SLOTS(index) : NULL), (index != NULL ? index->hw_mask : 0),
+                            &RSXA_Object->hw[0].hw_name, sizeof(RSXA_hw), RSXA_Object->array_len_hw, name);
+
+    return (found >= 0 ? &RSXA_Object->hw[found] : NULL);
+}
+
+RSXA_procs *RSXA_find_proc(const RSXA *RSXA_Object, const char *proc_name)
+{
+    /*!
+     *  @brief     Find a procs entry by name
+     *  @param[in] RSXA_Object
+     *  @param[in] proc_name
+     *  @return    procs entry (NULL if not found)
+     */
+
+    const RSXA_index *index = RSXA_Object->index;
+    RSXA_str name           = RSXA_str_find(RSXA_Object->strings, proc_name, strlen(proc_name));
+    int found;
+
+    if ((RSXA_Object->array_len_procs <= 0) || (name == RSXA_STR_NONE)) {return NULL;}
+
+    found = RSXA_index_find((index != NULL ? RSXA_PROCS_SLOTS(index) : NULL),
+                            (index != NULL ? index->procs_mask : 0),
+                            &RSXA_Object->procs[0].proc_name, sizeof(RSXA_procs),
+                            RSXA_Object->array_len_procs, name);
+
+    return (found >= 0 ? &RSXA_Object->procs[found] : NULL);
+}
+
+RSXA_pins *RSXA_find_pin(const RSXA_hw *hw, const char *pin_name)
+{
+    /*!
+     *  @brief     Find a pin of a hw entry by name. A device only has a
+     *             handful of pins, so they are scanned rather than hashed,
+     *             which also works on copies of RSXA_hw.
+     *  @param[in] hw
+     *  @param[in] pin_name
+     *  @return    pin (NULL if not found)
+     */
+
+    return RSXA_find_pin_id(hw, RSXA_str_find(hw->strings, pin_name, strlen(pin_name)));
+}
+
+int RSXA_diff_hw(const RSXA_hw *old_hw, const RSXA_hw *new_hw)
+{
+    /*!
+     *  @brief     Compare two versions of a hw entry. Pins are matched
+     *             by name, so reordering them in the JSON is no change.
+     *  @param[in] old_hw
+     *  @param[in] new_hw
+     *  @return    RSXA_HW_CHANGES bit mask (RSXA_HW_SAME if equal)
+     */
+
+    int changes = RSXA_HW_SAME;
+
+    if (old_hw->hw_sim_mode != new_hw->hw_sim_mode)
+        changes |= RSXA_HW_SIM_MODE;
+
+    if (old_hw->array_len_hw_int != new_hw->array_len_hw_int)
+        changes |= RSXA_HW_PINS;
+
+    for (int i = 0; (!(changes & RSXA_HW_PINS)) && (new_hw->hw_interface != NULL) &&
+                    (i < new_hw->array_len_hw_int); i++)
+    {
+        RSXA_str pin_name        = RSXA_str_move(old_hw->strings, new_hw->strings, new_hw->hw_interface[i].pin_name);
+        const RSXA_pins *old_pin = RSXA_find_pin_id(old_hw, pin_name);
+
+        if ((old_pin == NULL) || (old_pin->pin_no != new_hw->hw_interface[i].pin_no))
+            changes |= RSXA_HW_PINS;
+    }
+
+    return changes;
+}
+
+bool RSXA_diff_proc(const RSXA_procs *old_proc, const RSXA_procs *new_proc)
+{
+    /*!
+     *  @brief     Compare two versions of a procs entry
+     *  @param[in] old_proc
+     *  @param[in] new_proc
+     *  @return    True if any setting differs
+     */
+
+    return ((old_proc->server_p != new_proc->server_p) || (old_proc->client_p != new_proc->client_p) ||
+            (!RSXA_str_equal(old_proc->strings, old_proc->server_ip, new_proc->strings, new_proc->server_ip)) ||
+            (!RSXA_str_equal(old_proc->strings, old_proc->client_ip, new_proc->strings, new_proc->client_ip)) ||
+            (!RSXA_str_equal(old_proc->strings, old_proc->transport, new_proc->strings, new_proc->transport)));
+}
+
+int RSXA_watch(const char *json_path)
+{
+    /*!
+     *  @brief     Watch json_path for edits. The directory is watched,
+     *             as editors and copies often replace the file rather
+     *             than write it in place, which would drop a watch on
+     *             the file itself.
+     *  @param[in] json_path
+     *  @return    Non-blocking inotify fd for RSXA_watch_changed (-1 on error)
      */
 
     /* Initialize Variables */
-    NMT_result result = OK;
+    char dir[MAX_CHAR_LEN_LONG];
+    const char *slash = strrchr(json_path, '/');
+    int fd;
 
-    if (!(json_object_object_get_ex(in_obj, key, &(*out_obj))))
+    if (slash == NULL)
+        strcpy(dir, ".");
+    else if ((size_t)(slash - json_path) < sizeof(dir))
+        snprintf(dir, sizeof(dir), "%.*s", (int)(slash == json_path ? 1 : slash - json_path), json_path);
+    else
+        return -1;
+
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if ((fd >= 0) && (inotify_add_watch(fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0))
     {
-        result = NOK;
-        printf("Parse Error! %s not found in %s \n", key, RS_SETTINGS_PATH);
+        printf("Unable to watch %s \n", dir);
+        close(fd);
+        fd = -1;
     }
 
-    /* Exit the function */
-    return result;
+    return fd;
 }
 
-static NMT_result RSXA_parse_json(char *data_to_parse, RSXA *RSXA_Object)
+bool RSXA_watch_changed(int watch_fd, const char *json_path)
 {
     /*!
-     *  @brief      Parse JSON data passed and populate the RSXA Structure
-     *  @param[in]  data_to_parse
-     *  @param[out] RSXA_Object
-     *  @return     NMT_result
+     *  @brief     Drain the events of an RSXA_watch fd
+     *  @param[in] watch_fd
+     *  @param[in] json_path
+     *  @return    True if json_path was written or replaced
      */
 
     /* Initialize Variables */
-    NMT_result result      = OK;
+    char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    const char *slash = strrchr(json_path, '/');
+    const char *name  = (slash != NULL ? slash + 1 : json_path);
+    bool changed      = false;
+    ssize_t length;
 
-    /* Create json-c objects that will be needed */
-    struct json_object *rsxa_root_obj = {0};
-    struct json_object *jobj_hw = {0};
-    struct json_object *jobj_hw_v = {0};
-    struct json_object *jobj_hw_gpio = {0};
-    struct json_object *jobj_hw_gpio_v = {0};
-    struct json_object *jobj_procs = {0};
-    struct json_object *jobj_procs_v = {0};
-    struct json_object *jvalues = {0};
-    
-    /* Parse the file */
-    rsxa_root_obj = json_tokener_parse(data_to_parse);
+    while ((length = read(watch_fd, events, sizeof(events))) > 0)
+    {
+        for (char *ptr = events; ptr < events + length; )
+        {
+            const struct inotify_event *event = (const struct inotify_event *)ptr;
 
-    /* Get the logger directory */
-    result = RSXA_find_key(rsxa_root_obj, LOG_DIR, &jvalues);
+            /* Events were lost - Assume the file was among them */
+            if ((event->mask & IN_Q_OVERFLOW) || ((event->len > 0) && (strcmp(event->name, name) == 0)))
+                changed = true;
+
+            ptr += sizeof(struct inotify_event) + event->len;
+        }
+    }
 
-    /* Copy log directory to struct */
-    if (result == OK) {strcpy(RSXA_Object->log_dir, json_object_get_string(jvalues));}
+    return changed;
+}
 
-    /* Get the procs object */
-    if (result == OK) {result = RSXA_find_key(rsxa_root_obj, PROCS, &jobj_procs);}
+const char *RSXA_str_get(const struct RSXA_strtab *strings, RSXA_str id)
+{
+    /*!
+     *  @brief     String of a handle
+     *  @param[in] strings
+     *  @param[in] id
+     *  @return    Terminated string ("" if not in the table)
+     */
 
-    /* Get the hw object */
-    if (result == OK) {result = RSXA_find_key(rsxa_root_obj, HW, &jobj_hw);}
+    if ((strings == NULL) || (id >= strings->used)) {return "";}
 
-    /* Get number of procs elements */
-    if (result == OK) {RSXA_Object->array_len_procs = json_object_array_length(jobj_procs);}
+    return RSXA_STR_DATA(strings) + id + sizeof(uint32_t);
+}
 
-    /* Get number of hw elements */
-    if (result == OK) {RSXA_Object->array_len_hw = json_object_array_length(jobj_hw);}
+size_t RSXA_str_len(const struct RSXA_strtab *strings, RSXA_str id)
+{
+    /*!
+     *  @brief     Length of the string of a handle, which may hold a
+     *             terminator of its own
+     *  @param[in] strings
+     *  @param[in] id
+     *  @return    length (0 if not in the table)
+     */
 
-    if ((result == OK) && (RSXA_Object->array_len_procs > 0))
+    if ((strings == NULL) || (id >= strings->used)) {return 0;}
+
+    return RSXA_STR_LEN(strings, id);
+}
+
+RSXA_str RSXA_str_find(const struct RSXA_strtab *strings, const char *str, size_t len)
+{
+    /*!
+     *  @brief     Handle of a string, so it can be compared with the
+     *             names of the table as an integer
+     *  @param[in] strings
+     *  @param[in] str (Need not be terminated)
+     *  @param[in] len
+     *  @return    handle (RSXA_STR_NONE if not in the table)
+     */
+
+    RSXA_str id = RSXA_STR_NONE;
+
+    if (strings != NULL) {RSXA_str_probe(strings, str, len, &id);}
+
+    return id;
+}
+
+bool RSXA_str_equal(const struct RSXA_strtab *a_strings, RSXA_str a,
+                    const struct RSXA_strtab *b_strings, RSXA_str b)
+{
+    /*!
+     *  @brief     Compare strings of two tables - The handles alone if
+     *             it is the same table
+     *  @param[in] a_strings
+     *  @param[in] a
+     *  @param[in] b_strings
+     *  @param[in] b
+     *  @return    True if equal
+     */
+
+    size_t len;
+
+    if (a_strings == b_strings) {return (a == b);}
+
+    len = RSXA_str_len(a_strings, a);
+    return ((len == RSXA_str_len(b_strings, b)) &&
+            (memcmp(RSXA_str_get(a_strings, a), RSXA_str_get(b_strings, b), len) == 0));
+}
+
+struct RSXA_strtab *RSXA_strtab_new(uint32_t count, size_t chars)
+{
+    /*!
+     *  @brief     Allocate a table for count strings of chars characters
+     *             in all, to build settings without RSXA_init
+     *  @param[in] count
+     *  @param[in] chars
+     *  @return    table (NULL if out of memory), free with RSXA_strtab_free
+     */
+
+    uint32_t slots    = 0;
+    uint64_t capacity = 0;
+    struct RSXA_strtab *strings;
+
+    RSXA_strtab_size(count, chars, &slots, &capacity);
+    strings = (struct RSXA_strtab *)calloc(1, sizeof(struct RSXA_strtab) + slots * sizeof(uint32_t) + capacity);
+
+    if (strings != NULL) {RSXA_strtab_init(strings, slots, capacity);}
+
+    return strings;
+}
+
+RSXA_str RSXA_intern(struct RSXA_strtab *strings, const char *str, size_t len)
+{
+    /*!
+     *  @brief     Add a string to the table, unless it is there already
+     *  @param[in] strings
+     *  @param[in] str (Need not be terminated)
+     *  @param[in] len
+     *  @return    handle (RSXA_STR_NONE if the table is full)
+     */
+
+    /* Initialize Variables */
+    RSXA_str id   = RSXA_STR_NONE;
+    uint32_t slot = RSXA_str_probe(strings, str, len, &id);
+    char *data    = (char *)RSXA_STR_DATA(strings);
+
+    if (id != RSXA_STR_NONE) {return id;}
+
+    /* Keep half the slots free, so probes end */
+    if ((strings->count + 1 > (strings->mask + 1) / 2) ||
+        (RSXA_STR_ENTRY(len) > (uint64_t)(strings->capacity - strings->used)))
+    {
+        return RSXA_STR_NONE;
+    }
+
+    id = strings->used;
+    memset(data + id, 0, RSXA_STR_ENTRY(len));
+    *(uint32_t *)(data + id) = (uint32_t)len;
+    memcpy(data + id + sizeof(uint32_t), str, len);
+
+    ((uint32_t *)RSXA_STR_SLOTS(strings))[slot] = id + 1;
+    strings->used += RSXA_STR_ENTRY(len);
+    strings->count++;
+
+    return id;
+}
+
+void RSXA_strtab_free(struct RSXA_strtab *strings)
+{
+    /*!
+     *  @brief     Free a table from RSXA_strtab_new
+     *  @param[in] strings
+     *  @return    void
+     */
+
+    free(strings);
+}
+
+NMT_result RSXA_compile(const char *json_path, const char *image_path)
+{
+    /*!
+     *  @brief     Validate json_path and write its arena as an image
+     *             RSXA_init can map. The image is renamed into place, so a
+     *             process starting meanwhile maps either the old or the
+     *             new one.
+     *  @param[in] json_path
+     *  @param[in] image_path
+     *  @return    NMT_result
+     */
+
+    /* Initialize Variables */
+    NMT_result result    = OK;
+    unsigned char *image = NULL;
+    size_t image_size    = 0;
+    char tmp_path[MAX_CHAR_LEN_LONG * 2];
+
+    result = RSXA_build_image(json_path, &image, &image_size);
+
+    /* Write next to the image and rename over it */
+    if (result == OK)
     {
-        /* Allocate Memory for RSXA_procs */
-        RSXA_Object->procs = (RSXA_procs *)malloc(sizeof(RSXA_procs) * RSXA_Object->array_len_procs);
+        snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", image_path);
+        FILE *fp = fopen(tmp_path, "wb");
 
-        for (int i = 0; i < RSXA_Object->array_len_procs; i++)
+        if (fp == NULL)
+        {
+            printf("Unable to open %s \n", tmp_path);
+            result = NOK;
+        }
+        else
         {
-            jobj_procs_v = json_object_array_get_idx(jobj_procs, i);
+            if (fwrite(image, 1, image_size, fp) != image_size) {result = NOK;}
+            if (fclose(fp) != 0) {result = NOK;}
+            if ((result == OK) && (rename(tmp_path, image_path) != 0)) {result = NOK;}
 
-            /* Get and populate the hardware name */
-            result = RSXA_find_key(jobj_procs_v, PROC_NAME, &jvalues);
-            if (result == OK) {strcpy(RSXA_Object->procs[i].proc_name, json_object_get_string(jvalues));}
+            if (result != OK)
+            {
+                printf("Unable to write %s \n", image_path);
+                unlink(tmp_path);
+            }
+        }
+    }
 
-            /* Get and server ip address*/
-            result = RSXA_find_key(jobj_procs_v, SERVER_IP, &jvalues);
-            if (result == OK) {strcpy(RSXA_Object->procs[i].server_ip, json_object_get_string(jvalues));}
+    /* Free Used Memory */
+    free(image);
 
-            /* Get and populate the hardware name */
-            result = RSXA_find_key(jobj_procs_v, SERVER_P, &jvalues);
-            if (result == OK) {RSXA_Object->procs[i].server_p  = json_object_get_int(jvalues);}
+    /* Exit the Function */
+    return result;
+}
 
-            /* Get and populate the hardware name */
-            result = RSXA_find_key(jobj_procs_v, CLIENT_IP, &jvalues);
-            if (result == OK) {strcpy(RSXA_Object->procs[i].client_ip, json_object_get_string(jvalues));}
+NMT_result RSXA_publish(const char *json_path, const char *shm_name)
+{
+    /*!
+     *  @brief     Validate json_path and publish its image in the shared
+     *             memory segment shm_name, which RSXA_init reads before
+     *             the image file. The generation is odd while the image
+     *             is rewritten, so readers never take a torn copy. Other
+     *             users get read access only.
+     *  @param[in] json_path
+     *  @param[in] shm_name
+     *  @return    NMT_result
+     */
 
-            /* Get and populate the hardware name */
-            result = RSXA_find_key(jobj_procs_v, CLIENT_P, &jvalues);
-            if (result == OK) {RSXA_Object->procs[i].client_p  = json_object_get_int(jvalues);}
+    /* Initialize Variables */
+    NMT_result result    = OK;
+    unsigned char *image = NULL;
+    size_t image_size    = 0;
+    unsigned char *shm   = MAP_FAILED;
+    size_t shm_size      = 0;
+    RSXA_shm_hdr *hdr    = NULL;
+    struct stat shm_stat;
+    int fd = -1;
+
+    result = RSXA_build_image(json_path, &image, &image_size);
+
+    /* One publisher at a time */
+    if (result == OK)
+    {
+        fd = shm_open(shm_name, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if ((fd < 0) || (flock(fd, LOCK_EX) != 0) || (fstat(fd, &shm_stat) != 0))
+        {
+            printf("Unable to open %s \n", shm_name);
+            result = NOK;
         }
     }
 
-    if ((result == OK) && (RSXA_Object->array_len_hw > 0))
+    /* The segment only grows - A reader never maps past its end */
+    if (result == OK)
     {
-        /* Allocate Memory for RSXA_hw */
-        RSXA_Object->hw = (RSXA_hw *)malloc(sizeof(RSXA_hw) * RSXA_Object->array_len_hw);
+        shm_size = RSXA_SHM_IMAGE_OFF + image_size;
+        if ((size_t)shm_stat.st_size > shm_size) {shm_size = shm_stat.st_size;}
 
-        for (int i = 0; i < RSXA_Object->array_len_hw; i++)
+        if ((ftruncate(fd, shm_size) != 0) ||
+            ((shm = (unsigned char *)mmap(NULL, shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED))
         {
-            jobj_hw_v = json_object_array_get_idx(jobj_hw, i);
-
-            /* Get and populate hw_name */
-            result = RSXA_find_key(jobj_hw_v, HW_NAME, &jvalues);
+            printf("Unable to map %s \n", shm_name);
+            result = NOK;
+        }
+    }
 
-            /* Copy hardware name to struct */
-            if (result == OK) {strcpy(RSXA_Object->hw[i].hw_name, json_object_get_string(jvalues));}
+    if (result == OK)
+    {
+        uint64_t generation = 0;
+        hdr = (RSXA_shm_hdr *)shm;
 
-            /* Get and populate hw_sim_mode */
-            if (result == OK) {result = RSXA_find_key(jobj_hw_v, HW_SIM_MODE, &jvalues);}
+        /* A segment this build did not write starts over */
+        if ((hdr->magic == RSXA_SHM_MAGIC) && (hdr->version == RSXA_IMAGE_VERSION))
+            generation = __atomic_load_n(&hdr->generation, __ATOMIC_RELAXED) & ~(uint64_t)1;
 
-            /* Copy the sim_mode to struct */
-            if (result == OK) {RSXA_Object->hw[i].hw_sim_mode = json_object_get_boolean(jvalues);}
+        __atomic_store_n(&hdr->generation, generation + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
 
-            /* Get hw_gpio elements */
-            if (result == OK) {result = RSXA_find_key(jobj_hw_v, HW_GPIO_PIN, &jobj_hw_gpio);}
+        hdr->magic      = RSXA_SHM_MAGIC;
+        hdr->version    = RSXA_IMAGE_VERSION;
+        hdr->image_size = image_size;
+        memcpy(shm + RSXA_SHM_IMAGE_OFF, image, image_size);
 
-            /* Get number of hw_gpio elements */
-            if (result == OK) {RSXA_Object->hw[i].array_len_hw_int = json_object_array_length(jobj_hw_gpio);}
+        __atomic_store_n(&hdr->generation, generation + 2, __ATOMIC_RELEASE);
+    }
 
-            /* Proceed if array_len_hw_int has elements */
-            if ((result == OK) && (RSXA_Object->hw[i].array_len_hw_int > 0))
-            {
-                /* Allocate Memory for RSXA_pins struct */
-                RSXA_Object->hw[i].hw_interface = 
-                    (RSXA_pins *)malloc(sizeof(RSXA_pins) * RSXA_Object->hw[i].array_len_hw_int);
+    /* Free Used Memory */
+    if (shm != MAP_FAILED) {munmap(shm, shm_size);}
+    if (fd >= 0) {close(fd);}
+    free(image);
 
-                for (int j = 0; j < RSXA_Object->hw[i].array_len_hw_int; j++)
-                {
-                    jobj_hw_gpio_v = json_object_array_get_idx(jobj_hw_gpio, j);
+    /* Exit the Function */
+    return result;
+}
 
-                    /* Get the pin number */
-                    result = RSXA_find_key(jobj_hw_gpio_v, PIN_NO, &jvalues);
+uint64_t RSXA_shm_generation(const char *shm_name)
+{
+    /*!
+     *  @brief     Generation of the settings published in shm_name. Lets a
+     *             reader poll for a new one without reading the image.
+     *  @param[in] shm_name
+     *  @return    Generation (0 if nothing is published)
+     */
 
-                    /* Copy Pin number */
-                    if (result == OK)
-                        RSXA_Object->hw[i].hw_interface[j].pin_no = json_object_get_int(jvalues);
+    /* Initialize Variables */
+    uint64_t generation = 0;
+    RSXA_shm_hdr *hdr   = NULL;
+    struct stat shm_stat;
+    int fd = shm_open(shm_name, O_RDONLY | O_CLOEXEC, 0);
 
-                    if (result == OK) {result = RSXA_find_key(jobj_hw_gpio_v, PIN_NAME, &jvalues);} 
+    if ((fd >= 0) && (fstat(fd, &shm_stat) == 0) && ((size_t)shm_stat.st_size >= sizeof(RSXA_shm_hdr)))
+    {
+        hdr = (RSXA_shm_hdr *)mmap(NULL, sizeof(RSXA_shm_hdr), PROT_READ, MAP_SHARED, fd, 0);
 
-                    /* Get the pin name */
-                    if (result == OK) 
-                        strcpy(RSXA_Object->hw[i].hw_interface[j].pin_name, json_object_get_string(jvalues));
-                   }
-                }
-             }
+        if (hdr != MAP_FAILED)
+        {
+            if (hdr->magic == RSXA_SHM_MAGIC)
+                generation = __atomic_load_n(&hdr->generation, __ATOMIC_ACQUIRE) / 2;
+            munmap(hdr, sizeof(RSXA_shm_hdr));
+        }
     }
 
-    /* Free Memory */
-    json_object_put(rsxa_root_obj);
+    if (fd >= 0) {close(fd);}
 
-    /* Exit the function */
-    return result;
+    return generation;
 }
 
-void RSXA_free_mem(RSXA *RSXA_Object)
+static NMT_result RSXA_build_image(const char *json_path, unsigned char **image, size_t *image_size)
 {
-     /*!
-     *  @brief      Free RSXA_Object
-     *  @param[in]  RSXA_Object
-     *  @return     void
+    /*!
+     *  @brief      Validate json_path and lay out its arena as an image
+     *  @param[in]  json_path
+     *  @param[out] image (allocated, free it)
+     *  @param[out] image_size
+     *  @return     NMT_result
      */
 
-    /* Free RSXA_hw */
-    for (int i = 0; i < RSXA_Object->array_len_hw; i++)
+    /* Initialize Variables */
+    NMT_result result    = OK;
+    RSXA settings        = {0};
+    RSXA_image_hdr hdr   = {0};
+    RSXA_layout layout   = {0};
+    uint32_t pins_count  = 0;
+    struct stat json_stat;
+
+    *image      = NULL;
+    *image_size = 0;
+
+    /* Stamp the JSON before reading it - An edit in between leaves the image stale, not wrong */
+    if (stat(json_path, &json_stat) != 0)
+    {
+        printf("Unable to stat %s \n", json_path);
+        result = NOK;
+    }
+
+    if (result == OK) {result = RSXA_load_json(json_path, &settings);}
+
+    for (int i = 0; (result == OK) && (i < settings.array_len_hw); i++)
+        pins_count += settings.hw[i].array_len_hw_int;
+
+    /* The arena goes after the header as it is */
+    if (result == OK)
+    {
+        RSXA_arena_layout(settings.array_len_procs, settings.array_len_hw, pins_count,
+                          settings.strings->mask + 1, settings.strings->capacity, &layout);
+
+        hdr.magic       = RSXA_IMAGE_MAGIC;
+        hdr.version     = RSXA_IMAGE_VERSION;
+        hdr.procs_size  = sizeof(RSXA_procs);
+        hdr.hw_size     = sizeof(RSXA_hw);
+        hdr.pins_size   = sizeof(RSXA_pins);
+        hdr.procs_count = settings.array_len_procs;
+        hdr.hw_count    = settings.array_len_hw;
+        hdr.pins_count  = pins_count;
+        hdr.arena_off   = RSXA_align(sizeof(RSXA_image_hdr));
+        hdr.size        = hdr.arena_off + layout.size;
+
+        hdr.str_slots    = layout.str_slots;
+        hdr.str_capacity = layout.str_capacity;
+        hdr.log_dir      = settings.log_dir;
+
+        hdr.src_mtime_sec  = json_stat.st_mtim.tv_sec;
+        hdr.src_mtime_nsec = json_stat.st_mtim.tv_nsec;
+        hdr.src_size       = json_stat.st_size;
+
+        *image = (unsigned char *)calloc(1, hdr.size);
+        if (*image == NULL) {result = NOK;}
+    }
+
+    if (result == OK)
     {
-        if (RSXA_Object->hw[i].array_len_hw_int > 0)
-            free(RSXA_Object->hw[i].hw_interface);
+        memcpy(*image + hdr.arena_off, settings.arena, layout.size);
+
+        /* hw_interface and strings are set when mapped */
+        RSXA_hw *hw       = (RSXA_hw *)(*image + hdr.arena_off + layout.hw_off);
+        RSXA_procs *procs = (RSXA_procs *)(*image + hdr.arena_off + layout.procs_off);
+
+        for (uint32_t i = 0; i < hdr.hw_count; i++)
+        {
+            hw[i].hw_interface = NULL;
+            hw[i].strings      = NULL;
+        }
+
+        for (uint32_t i = 0; i < hdr.procs_count; i++) {procs[i].strings = NULL;}
+
+        hdr.checksum = RSXA_crc32(*image + sizeof(hdr), hdr.size - sizeof(hdr));
+        memcpy(*image, &hdr, sizeof(hdr));
+        *image_size = hdr.size;
     }
 
-    free(RSXA_Object->hw);
+    /* Free Used Memory */
+    RSXA_free_mem(&settings);
+
+    /* Exit the Function */
+    return result;
+}
+
+static NMT_result RSXA_load_json(const char *json_path, RSXA *RSXA_Object)
+{
+    /*!
+     *  @brief      Read a RSXA.json file and parse it
+     *  @param[in]  json_path
+     *  @param[out] RSXA_Object
+     *  @return     NMT_result
+     */
+
+    /* Initialize Variables */
+    NMT_result result  = OK;
+    char *file_content = NULL;
+
+    RSXA_Object->image      = NULL;
+    RSXA_Object->image_size = 0;
+    RSXA_Object->arena      = NULL;
+    RSXA_Object->index      = NULL;
+
+    /* Read and parse the Json settings file */
+    result = NMT_stdlib_read_file((char *)json_path, &file_content);
+
+    if (result == OK)
+        result = RSXA_parse_json(file_content, RSXA_Object);
+
+    /* Free Used Memory */
+    free(file_content);
+
+    /* Exit the Function */
+    return result;
+}
+
+static NMT_result RSXA_load_image(const char *image_path, const struct stat *json_stat, RSXA *RSXA_Object)
+{
+    /*!
+     *  @brief      Map an image written by RSXA_compile and point
+     *              RSXA_Object into the arena it holds. The mapping is
+     *              private, so setting hw_interface only copies the pages
+     *              holding RSXA_hw.
+     *  @param[in]  image_path
+     *  @param[in]  json_stat (NULL if there is no JSON to match)
+     *  @param[out] RSXA_Object
+     *  @return     NMT_result (NOK if missing, stale or damaged)
+     */
+
+    /* Initialize Variables */
+    NMT_result result    = OK;
+    unsigned char *image = NULL;
+    const char *reason   = NULL;
+    size_t image_size    = 0;
+    struct stat image_stat;
+    int fd;
+
+    /* No image is not worth a message */
+    fd = open(image_path, O_RDONLY);
+    if (fd < 0) {result = NOK;}
+
+    if ((result == OK) && (fstat(fd, &image_stat) != 0)) {result = NOK;}
+    if (result == OK) {image_size = image_stat.st_size;}
+
+    if ((result == OK) && (image_size < sizeof(RSXA_image_hdr)))
+    {
+        reason = "truncated";
+        result = NOK;
+    }
+
+    if (result == OK)
+    {
+        image = (unsigned char *)mmap(NULL, image_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (image == MAP_FAILED)
+        {
+            image  = NULL;
+            reason = "mmap failed";
+            result = NOK;
+        }
+    }
+
+    if (fd >= 0) {close(fd);}
+
+    if (result == OK) {result = RSXA_attach_image(image, image_size, json_stat, RSXA_Object, &reason);}
+
+    if ((result != OK) && (image != NULL)) {munmap(image, image_size);}
+
+    if (reason != NULL) {printf("Ignoring %s: %s \n", image_path, reason);}
+
+    /* Exit the function */
+    return result;
+}
+
+static NMT_result RSXA_load_shm(const char *shm_name, const struct stat *json_stat, RSXA *RSXA_Object)
+{
+    /*!
+     *  @brief      Copy the image published by RSXA_publish out of the
+     *              shared segment and point RSXA_Object into the copy.
+     *              The copy is retaken if the generation moved while it
+     *              was made.
+     *  @param[in]  shm_name
+     *  @param[in]  json_stat (NULL if there is no JSON to match)
+     *  @param[out] RSXA_Object
+     *  @return     NMT_result (NOK if not published, stale or damaged)
+     */
+
+    /* Initialize Variables */
+    NMT_result result    = OK;
+    unsigned char *shm   = MAP_FAILED;
+    unsigned char *image = NULL;
+    RSXA_shm_hdr *hdr    = NULL;
+    const char *reason   = NULL;
+    size_t shm_size      = 0;
+    size_t image_size    = 0;
+    uint64_t generation  = 0;
+    struct stat shm_stat;
+    int fd;
+
+    /* Nothing published is not worth a message */
+    fd = shm_open(shm_name, O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) {result = NOK;}
+
+    if ((result == OK) && ((fstat(fd, &shm_stat) != 0) || ((size_t)shm_stat.st_size < RSXA_SHM_IMAGE_OFF)))
+        result = NOK;
+
+    if (result == OK)
+    {
+        shm_size = shm_stat.st_size;
+        shm      = (unsigned char *)mmap(NULL, shm_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (shm == MAP_FAILED) {result = NOK;}
+    }
+
+    if (fd >= 0) {close(fd);}
+
+    hdr = (RSXA_shm_hdr *)shm;
+    if ((result == OK) && ((hdr->magic != RSXA_SHM_MAGIC) || (hdr->version != RSXA_IMAGE_VERSION)))
+    {
+        reason = "wrong version";
+        result = NOK;
+    }
+
+    for (int retry = 0; (result == OK) && (image == NULL) && (retry < RSXA_SHM_RETRIES); retry++)
+    {
+        generation = __atomic_load_n(&hdr->generation, __ATOMIC_ACQUIRE);
+        image_size = hdr->image_size;
+
+        /* Being rewritten */
+        if (generation & 1)
+        {
+            sched_yield();
+            continue;
+        }
+
+        /* A size is only wrong if nothing was written meanwhile */
+        if ((image_size < sizeof(RSXA_image_hdr)) || (image_size > shm_size - RSXA_SHM_IMAGE_OFF))
+        {
+            if (__atomic_load_n(&hdr->generation, __ATOMIC_ACQUIRE) == generation)
+            {
+                reason = "damaged";
+                result = NOK;
+            }
+            continue;
+        }
+
+        image = (unsigned char *)mmap(NULL, image_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (image == MAP_FAILED)
+        {
+            image  = NULL;
+            reason = "mmap failed";
+            result = NOK;
+            continue;
+        }
+
+        memcpy(image, shm + RSXA_SHM_IMAGE_OFF, image_size);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (__atomic_load_n(&hdr->generation, __ATOMIC_RELAXED) != generation)
+        {
+            munmap(image, image_size);
+            image = NULL;
+        }
+    }
+
+    if ((result == OK) && (image == NULL))
+    {
+        reason = "busy";
+        result = NOK;
+    }
+
+    if (shm != MAP_FAILED) {munmap(shm, shm_size);}
+
+    if (result == OK) {result = RSXA_attach_image(image, image_size, json_stat, RSXA_Object, &reason);}
+    if (result == OK) {RSXA_Object->generation = generation / 2;}
+
+    if ((result != OK) && (image != NULL)) {munmap(image, image_size);}
+
+    if (reason != NULL) {printf("Ignoring %s: %s \n", shm_name, reason);}
+
+    /* Exit the function */
+    return result;
+}
+
+static NMT_result RSXA_attach_image(unsigned char *image, size_t image_size, const struct stat *json_stat,
+                                    RSXA *RSXA_Object, const char **reason)
+{
+    /*!
+     *  @brief      Check an image and point RSXA_Object into the arena it
+     *              holds. RSXA_Object takes over the (writable) mapping.
+     *  @param[in]  image
+     *  @param[in]  image_size
+     *  @param[in]  json_stat (NULL if there is no JSON to match)
+     *  @param[out] RSXA_Object
+     *  @param[out] reason (Why the image was not taken)
+     *  @return     NMT_result (NOK if stale or damaged)
+     */
+
+    /* Initialize Variables */
+    NMT_result result    = OK;
+    unsigned char *arena = NULL;
+    RSXA_image_hdr *hdr  = (RSXA_image_hdr *)image;
+    RSXA_index *index    = NULL;
+    RSXA_layout layout   = {0};
+    struct RSXA_strtab *strings = NULL;
+
+    /* Check it is an image this build wrote */
+    if ((hdr->magic != RSXA_IMAGE_MAGIC) || (hdr->version != RSXA_IMAGE_VERSION) ||
+        (hdr->procs_size != sizeof(RSXA_procs)) || (hdr->hw_size != sizeof(RSXA_hw)) ||
+        (hdr->pins_size != sizeof(RSXA_pins)) || (hdr->str_slots == 0) ||
+        ((hdr->str_slots & (hdr->str_slots - 1)) != 0))
+    {
+        *reason = "wrong version";
+        result  = NOK;
+    }
+
+    if ((result == OK) && (json_stat != NULL) &&
+        ((hdr->src_mtime_sec != json_stat->st_mtim.tv_sec) ||
+         (hdr->src_mtime_nsec != json_stat->st_mtim.tv_nsec) ||
+         (hdr->src_size != json_stat->st_size)))
+    {
+        *reason = "not compiled from the current JSON";
+        result  = NOK;
+    }
+
+    /* The arena must be the one the counts lay out */
+    if (result == OK)
+    {
+        RSXA_arena_layout(hdr->procs_count, hdr->hw_count, hdr->pins_count, hdr->str_slots,
+                          hdr->str_capacity, &layout);
+        arena   = image + hdr->arena_off;
+        index   = (RSXA_index *)(arena + layout.index_off);
+        strings = (struct RSXA_strtab *)(arena + layout.strtab_off);
+    }
+
+    if ((result == OK) &&
+        ((hdr->size != image_size) || (hdr->arena_off != RSXA_align(sizeof(RSXA_image_hdr))) ||
+         ((uint64_t)hdr->arena_off + layout.size != image_size) ||
+         (hdr->checksum != RSXA_crc32(image + sizeof(RSXA_image_hdr), image_size - sizeof(RSXA_image_hdr))) ||
+         (index->hw_mask != layout.hw_slots - 1) || (index->procs_mask != layout.procs_slots - 1) ||
+         (!RSXA_strtab_valid(strings, &layout)) || (!RSXA_str_valid(strings, hdr->log_dir))))
+    {
+        *reason = "damaged";
+        result  = NOK;
+    }
+
+    /* Every name must be a string of the table */
+    if (result == OK)
+    {
+        RSXA_procs *procs = (RSXA_procs *)(arena + layout.procs_off);
+
+        for (uint32_t i = 0; (result == OK) && (i < hdr->procs_count); i++)
+        {
+            if ((!RSXA_str_valid(strings, procs[i].proc_name)) || (!RSXA_str_valid(strings, procs[i].server_ip)) ||
+                (!RSXA_str_valid(strings, procs[i].client_ip)) || (!RSXA_str_valid(strings, procs[i].transport)))
+            {
+                *reason = "damaged";
+                result  = NOK;
+            }
+            else
+            {
+                procs[i].strings = strings;
+            }
+        }
+    }
+
+    /* Point each hw at its run of the pins array */
+    if (result == OK)
+    {
+        RSXA_hw *hw     = (RSXA_hw *)(arena + layout.hw_off);
+        RSXA_pins *pins = (RSXA_pins *)(arena + layout.pins_off);
+        uint32_t pin    = 0;
+
+        for (uint32_t i = 0; (result == OK) && (i < hdr->hw_count); i++)
+        {
+            if ((hw[i].array_len_hw_int < 0) ||
+                ((uint32_t)hw[i].array_len_hw_int > hdr->pins_count - pin) ||
+                (!RSXA_str_valid(strings, hw[i].hw_name)))
+            {
+                *reason = "damaged";
+                result  = NOK;
+            }
+            else
+            {
+                hw[i].hw_interface = (hw[i].array_len_hw_int > 0 ? &pins[pin] : NULL);
+                hw[i].strings      = strings;
+                pin += hw[i].array_len_hw_int;
+            }
+        }
+
+        for (uint32_t i = 0; (result == OK) && (i < hdr->pins_count); i++)
+        {
+            if (!RSXA_str_valid(strings, pins[i].pin_name))
+            {
+                *reason = "damaged";
+                result  = NOK;
+            }
+        }
+    }
+
+    if (result == OK)
+    {
+        RSXA_Object->log_dir         = hdr->log_dir;
+        RSXA_Object->strings         = strings;
+        RSXA_Object->procs           = (RSXA_procs *)(arena + layout.procs_off);
+        RSXA_Object->hw              = (RSXA_hw *)(arena + layout.hw_off);
+        RSXA_Object->array_len_procs = hdr->procs_count;
+        RSXA_Object->array_len_hw    = hdr->hw_count;
+        RSXA_Object->image           = image;
+        RSXA_Object->image_size      = image_size;
+        RSXA_Object->arena           = arena;
+        RSXA_Object->index           = index;
+    }
+
+    /* Exit the function */
+    return result;
+}
+
+static uint32_t RSXA_crc32(const unsigned char *data, size_t len)
+{
+    /*!
+     *  @brief     CRC-32 (IEEE 802.3) of a buffer
+     *  @param[in] data
+     *  @param[in] len
+     *  @return    crc
+     */
+
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+
+    return ~crc;
+}
+
+static uint64_t RSXA_align(uint64_t offset)
+{
+    /*!
+     *  @brief     Round an offset up to RSXA_IMAGE_ALIGN
+     *  @param[in] offset
+     *  @return    offset
+     */
+
+    return ((offset + RSXA_IMAGE_ALIGN - 1) & ~(uint64_t)(RSXA_IMAGE_ALIGN - 1));
+}
+
+static NMT_result RSXA_find_key(json_object *in_obj, const char *key, json_object **out_obj)
+{
+    /*!
+     *  @brief      Wrapper function for json_object_object_get_ex
+     *  @param[in]  in_obj
+     *  @param[in]  key
+     *  @param[out] out_obj
+     *  @return     NMT_result
+     */
+
+    /* Initialize Variables */
+    NMT_result result = OK;
+
+    if (!(json_object_object_get_ex(in_obj, key, &(*out_obj))))
+    {
+        result = NOK;
+        printf("Parse Error! %s not found \n", key);
+    }
+
+    /* Exit the function */
+    return result;
+}
+
+static NMT_result RSXA_copy_str(json_object *in_obj, const char *key, struct RSXA_strtab *strings, RSXA_str *dst)
+{
+    /*!
+     *  @brief      Intern a string value
+     *  @param[in]  in_obj
+     *  @param[in]  key
+     *  @param[in]  strings (Sized by RSXA_count_str)
+     *  @param[out] dst
+     *  @return     NMT_result (NOK if missing)
+     */
+
+    /* Initialize Variables */
+    NMT_result result          = OK;
+    struct json_object *jvalue = NULL;
+    const char *value          = NULL;
+    size_t len                 = 0;
+
+    result = RSXA_find_key(in_obj, key, &jvalue);
+    if (result == OK) {value = RSXA_json_str(jvalue, &len);}
+    if (result == OK) {*dst = RSXA_intern(strings, value, len);}
+
+    /* Only if the counting pass missed it */
+    if ((result == OK) && (*dst == RSXA_STR_NONE))
+    {
+        result = NOK;
+        printf("Parse Error! No room for %s \n", key);
+    }
+
+    /* Exit the function */
+    return result;
+}
+
+static const char *RSXA_json_str(json_object *jvalue, size_t *len)
+{
+    /*!
+     *  @brief      String of a value - Other types are taken as their JSON
+     *  @param[in]  jvalue
+     *  @param[out] len
+     *  @return     string
+     */
+
+    const char *value = json_object_get_string(jvalue);
+
+    /* Only strings have a length of their own */
+    *len = json_object_get_string_len(jvalue);
+    if ((*len == 0) && (value != NULL)) {*len = strlen(value);}
+
+    return (value != NULL ? value : "");
+}
+
+static void RSXA_count_str(json_object *in_obj, const char *key, uint32_t *str_count, uint64_t *str_chars)
+{
+    /*!
+     *  @brief      Add a string value to the ones the table must hold - A
+     *              missing key is reported when it is copied
+     *  @param[in]  in_obj
+     *  @param[in]  key
+     *  @param[out] str_count
+     *  @param[out] str_chars
+     *  @return     void
+     */
+
+    struct json_object *jvalue = NULL;
+    size_t len                 = 0;
+
+    if (json_object_object_get_ex(in_obj, key, &jvalue))
+    {
+        RSXA_json_str(jvalue, &len);
+        *str_count += 1;
+        *str_chars += len;
+    }
+}
+
+static NMT_result RSXA_parse_json(char *data_to_parse, RSXA *RSXA_Object)
+{
+    /*!
+     *  @brief      Parse JSON data passed and populate the RSXA Structure.
+     *              The arrays and strings are counted first so procs, hw,
+     *              every pin, the name index and the strings land in one
+     *              arena.
+     *  @param[in]  data_to_parse
+     *  @param[out] RSXA_Object
+     *  @return     NMT_result
+     */
+
+    /* Initialize Variables */
+    NMT_result result      = OK;
+    RSXA_layout layout     = {0};
+    unsigned char *arena   = NULL;
+    RSXA_pins *pins        = NULL;
+    int pins_count         = 0;
+    uint32_t str_count     = 0;
+    uint64_t str_chars     = 0;
+    uint32_t str_slots     = 0;
+    uint64_t str_capacity  = 0;
+    struct RSXA_strtab *strings = NULL;
+
+    /* Create json-c objects that will be needed */
+    struct json_object *rsxa_root_obj = {0};
+    struct json_object *jobj_hw = {0};
+    struct json_object *jobj_hw_v = {0};
+    struct json_object *jobj_hw_gpio = {0};
+    struct json_object *jobj_hw_gpio_v = {0};
+    struct json_object *jobj_procs = {0};
+    struct json_object *jobj_procs_v = {0};
+    struct json_object *jvalues = {0};
+
+    /* Parse the file */
+    rsxa_root_obj = json_tokener_parse(data_to_parse);
+
+    /* Get the procs object */
+    result = RSXA_find_key(rsxa_root_obj, PROCS, &jobj_procs);
+
+    /* Get the hw object */
+    if (result == OK) {result = RSXA_find_key(rsxa_root_obj, HW, &jobj_hw);}
+
+    /* Get number of procs elements */
+    if (result == OK) {RSXA_Object->array_len_procs = json_object_array_length(jobj_procs);}
+
+    /* Get number of hw elements */
+    if (result == OK) {RSXA_Object->array_len_hw = json_object_array_length(jobj_hw);}
+
+    /* Count the pins and strings - A missing key is reported when filling */
+    RSXA_count_str(rsxa_root_obj, LOG_DIR, &str_count, &str_chars);
+
+    for (int i = 0; (result == OK) && (i < RSXA_Object->array_len_procs); i++)
+    {
+        jobj_procs_v = json_object_array_get_idx(jobj_procs, i);
+        RSXA_count_str(jobj_procs_v, PROC_NAME, &str_count, &str_chars);
+        RSXA_count_str(jobj_procs_v, SERVER_IP, &str_count, &str_chars);
+        RSXA_count_str(jobj_procs_v, CLIENT_IP, &str_count, &str_chars);
+
+        /* Or the default transport */
+        str_count += 1;
+        str_chars += strlen(DEFAULT_TRANSPORT);
+        RSXA_count_str(jobj_procs_v, TRANSPORT, &str_count, &str_chars);
+    }
+
+    for (int i = 0; (result == OK) && (i < RSXA_Object->array_len_hw); i++)
+    {
+        jobj_hw_v = json_object_array_get_idx(jobj_hw, i);
+        RSXA_count_str(jobj_hw_v, HW_NAME, &str_count, &str_chars);
+
+        if (json_object_object_get_ex(jobj_hw_v, HW_GPIO_PIN, &jobj_hw_gpio))
+        {
+            pins_count += json_object_array_length(jobj_hw_gpio);
+            for (size_t j = 0; j < json_object_array_length(jobj_hw_gpio); j++)
+                RSXA_count_str(json_object_array_get_idx(jobj_hw_gpio, j), PIN_NAME, &str_count, &str_chars);
+        }
+    }
+
+    /* Allocate the arena */
+    if (result == OK)
+    {
+        RSXA_strtab_size(str_count, str_chars, &str_slots, &str_capacity);
+        RSXA_arena_layout(RSXA_Object->array_len_procs, RSXA_Object->array_len_hw, pins_count,
+                          str_slots, str_capacity, &layout);
+        arena = (unsigned char *)calloc(1, layout.size);
+
+        if (arena == NULL)
+        {
+            printf("Unable to allocate %llu bytes \n", (unsigned long long)layout.size);
+            result = NOK;
+        }
+    }
+
+    if (result == OK)
+    {
+        RSXA_Object->arena = arena;
+        RSXA_Object->procs = (RSXA_procs *)(arena + layout.procs_off);
+        RSXA_Object->hw    = (RSXA_hw *)(arena + layout.hw_off);
+        RSXA_Object->index = (RSXA_index *)(arena + layout.index_off);
+        pins               = (RSXA_pins *)(arena + layout.pins_off);
+        strings            = (struct RSXA_strtab *)(arena + layout.strtab_off);
+
+        RSXA_strtab_init(strings, layout.str_slots, layout.str_capacity);
+        RSXA_Object->strings = strings;
+    }
+
+    /* Get and copy the logger directory */
+    if (result == OK) {result = RSXA_copy_str(rsxa_root_obj, LOG_DIR, strings, &RSXA_Object->log_dir);}
+
+    for (int i = 0; (result == OK) && (i < RSXA_Object->array_len_procs); i++)
+    {
+        jobj_procs_v = json_object_array_get_idx(jobj_procs, i);
+
+        /* Get and populate the process name */
+        RSXA_Object->procs[i].strings = strings;
+        result = RSXA_copy_str(jobj_procs_v, PROC_NAME, strings, &RSXA_Object->procs[i].proc_name);
+
+        /* Get and server ip address*/
+        if (result == OK)
+            result = RSXA_copy_str(jobj_procs_v, SERVER_IP, strings, &RSXA_Object->procs[i].server_ip);
+
+        /* Get and populate the server port */
+        if (result == OK) {result = RSXA_find_key(jobj_procs_v, SERVER_P, &jvalues);}
+        if (result == OK) {RSXA_Object->procs[i].server_p  = json_object_get_int(jvalues);}
+
+        /* Get and populate the client ip address */
+        if (result == OK)
+            result = RSXA_copy_str(jobj_procs_v, CLIENT_IP, strings, &RSXA_Object->procs[i].client_ip);
+
+        /* Get and populate the client port */
+        if (result == OK) {result = RSXA_find_key(jobj_procs_v, CLIENT_P, &jvalues);}
+        if (result == OK) {RSXA_Object->procs[i].client_p  = json_object_get_int(jvalues);}
+
+        /* Get and populate the transport (optional) */
+        if ((result == OK) && (json_object_object_get_ex(jobj_procs_v, TRANSPORT, &jvalues)))
+            result = RSXA_copy_str(jobj_procs_v, TRANSPORT, strings, &RSXA_Object->procs[i].transport);
+        else if (result == OK)
+            RSXA_Object->procs[i].transport = RSXA_intern(strings, DEFAULT_TRANSPORT, strlen(DEFAULT_TRANSPORT));
+    }
+
+    for (int i = 0; (result == OK) && (i < RSXA_Object->array_len_hw); i++)
+    {
+        jobj_hw_v = json_object_array_get_idx(jobj_hw, i);
+
+        /* Get and copy hw_name to struct */
+        RSXA_Object->hw[i].strings = strings;
+        result = RSXA_copy_str(jobj_hw_v, HW_NAME, strings, &RSXA_Object->hw[i].hw_name);
+
+        /* Get and populate hw_sim_mode */
+        if (result == OK) {result = RSXA_find_key(jobj_hw_v, HW_SIM_MODE, &jvalues);}
+
+        /* Copy the sim_mode to struct */
+        if (result == OK) {RSXA_Object->hw[i].hw_sim_mode = json_object_get_boolean(jvalues);}
+
+        /* Get hw_gpio elements */
+        if (result == OK) {result = RSXA_find_key(jobj_hw_v, HW_GPIO_PIN, &jobj_hw_gpio);}
+
+        /* Get number of hw_gpio elements - Its pins follow the previous hw's */
+        if (result == OK)
+        {
+            RSXA_Object->hw[i].array_len_hw_int = json_object_array_length(jobj_hw_gpio);
+            RSXA_Object->hw[i].hw_interface     = (RSXA_Object->hw[i].array_len_hw_int > 0 ? pins : NULL);
+        }
+
+        for (int j = 0; (result == OK) && (j < RSXA_Object->hw[i].array_len_hw_int); j++, pins++)
+        {
+            jobj_hw_gpio_v = json_object_array_get_idx(jobj_hw_gpio, j);
+
+            /* Get the pin number */
+            result = RSXA_find_key(jobj_hw_gpio_v, PIN_NO, &jvalues);
+
+            /* Copy Pin number */
+            if (result == OK) {pins->pin_no = json_object_get_int(jvalues);}
+
+            /* Get the pin name */
+            if (result == OK) {result = RSXA_copy_str(jobj_hw_gpio_v, PIN_NAME, strings, &pins->pin_name);}
+        }
+    }
+
+    /* Index the names for the lookups */
+    if (result == OK) {RSXA_fill_index(RSXA_Object, &layout);}
+
+    /* Free Memory */
+    json_object_put(rsxa_root_obj);
+
+    /* Exit the function */
+    return result;
+}
+
+static void RSXA_fill_index(RSXA *RSXA_Object, const RSXA_layout *layout)
+{
+    /*!
+     *  @brief      Hash the hw and proc names into the arena's index
+     *  @param[out] RSXA_Object
+     *  @param[in]  layout
+     *  @return     void
+     */
+
+    RSXA_index *index = RSXA_Object->index;
+
+    index->hw_mask    = layout->hw_slots - 1;
+    index->procs_mask = layout->procs_slots - 1;
+
+    if (RSXA_Object->array_len_hw > 0)
+        RSXA_index_add(RSXA_HW_SLOTS(index), index->hw_mask, &RSXA_Object->hw[0].hw_name,
+                       sizeof(RSXA_hw), RSXA_Object->array_len_hw);
+
+    if (RSXA_Object->array_len_procs > 0)
+        RSXA_index_add(RSXA_PROCS_SLOTS(index), index->procs_mask, &RSXA_Object->procs[0].proc_name,
+                       sizeof(RSXA_procs), RSXA_Object->array_len_procs);
+}
+
+static void RSXA_arena_layout(int procs_count, int hw_count, int pins_count, uint32_t str_slots,
+                              uint64_t str_capacity, RSXA_layout *layout)
+{
+    /*!
+     *  @brief      Place procs, hw, pins, the name index and the strings
+     *              in an arena. Counts come from a parse or an image
+     *              header, so the sizes are worked out in 64 bits.
+     *  @param[in]  procs_count
+     *  @param[in]  hw_count
+     *  @param[in]  pins_count
+     *  @param[in]  str_slots
+     *  @param[in]  str_capacity
+     *  @param[out] layout
+     *  @return     void
+     */
+
+    layout->hw_slots     = RSXA_index_size(hw_count);
+    layout->procs_slots  = RSXA_index_size(procs_count);
+    layout->str_slots    = str_slots;
+    layout->str_capacity = str_capacity;
+
+    layout->procs_off  = 0;
+    layout->hw_off     = RSXA_align(layout->procs_off + (uint64_t)procs_count * sizeof(RSXA_procs));
+    layout->pins_off   = RSXA_align(layout->hw_off + (uint64_t)hw_count * sizeof(RSXA_hw));
+    layout->index_off  = RSXA_align(layout->pins_off + (uint64_t)pins_count * sizeof(RSXA_pins));
+    layout->strtab_off = RSXA_align(layout->index_off + sizeof(RSXA_index) +
+                                    ((uint64_t)layout->hw_slots + layout->procs_slots) * sizeof(int32_t));
+    layout->size       = layout->strtab_off + sizeof(struct RSXA_strtab) +
+                         (uint64_t)str_slots * sizeof(uint32_t) + str_capacity;
+}
+
+static void RSXA_strtab_size(uint32_t count, uint64_t chars, uint32_t *slots, uint64_t *capacity)
+{
+    /*!
+     *  @brief      Size a string table for count strings of chars
+     *              characters in all, plus the empty string
+     *  @param[in]  count
+     *  @param[in]  chars
+     *  @param[out] slots
+     *  @param[out] capacity (Bytes of string data)
+     *  @return     void
+     */
+
+    /* A string takes at most 8 bytes more than its characters */
+    *slots    = RSXA_index_size((int)(count + 1));
+    *capacity = RSXA_STR_ENTRY(0) + (uint64_t)count * 8 + chars;
+}
+
+static uint32_t RSXA_index_size(int count)
+{
+    /*!
+     *  @brief     Slots for count names - A power of 2 at most half full
+     *  @param[in] count
+     *  @return    slots
+     */
+
+    uint32_t size = 1;
+    while (size < (uint32_t)(count > 0 ? count : 0) * 2) {size <<= 1;}
+
+    return size;
+}
+
+static void RSXA_index_add(int32_t *slots, uint32_t mask, const RSXA_str *names, size_t stride, int count)
+{
+    /*!
+     *  @brief     Hash the names of an array of entries
+     *  @param[in] slots
+     *  @param[in] mask (slots - 1)
+     *  @param[in] names (Name of the first entry)
+     *  @param[in] stride (Size of an entry)
+     *  @param[in] count
+     *  @return    void
+     */
+
+    for (int i = 0; i < count; i++)
+    {
+        RSXA_str name = RSXA_NAME_AT(names, stride, i);
+        uint32_t slot = RSXA_hash_id(name) & mask;
+
+        /* Probe to a free slot unless the name is already there */
+        while ((slots[slot] != 0) && (RSXA_NAME_AT(names, stride, slots[slot] - 1) != name))
+            slot = (slot + 1) & mask;
+
+        if (slots[slot] == 0) {slots[slot] = i + 1;}
+    }
+}
+
+static int RSXA_index_find(const int32_t *slots, uint32_t mask, const RSXA_str *names, size_t stride,
+                           int count, RSXA_str name)
+{
+    /*!
+     *  @brief     Find a name in an array of entries, scanning it if it
+     *             was not indexed by RSXA_init
+     *  @param[in] slots (NULL to scan)
+     *  @param[in] mask (slots - 1)
+     *  @param[in] names (Name of the first entry)
+     *  @param[in] stride (Size of an entry)
+     *  @param[in] count
+     *  @param[in] name
+     *  @return    array index (-1 if not found)
+     */
+
+    if (slots == NULL)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (RSXA_NAME_AT(names, stride, i) == name) {return i;}
+        }
+        return -1;
+    }
+
+    for (uint32_t slot = RSXA_hash_id(name) & mask; slots[slot] != 0; slot = (slot + 1) & mask)
+    {
+        if (RSXA_NAME_AT(names, stride, slots[slot] - 1) == name)
+            return slots[slot] - 1;
+    }
+
+    return -1;
+}
+
+static void RSXA_strtab_init(struct RSXA_strtab *strings, uint32_t slots, uint64_t capacity)
+{
+    /*!
+     *  @brief      Set up an empty table in zeroed memory. The empty
+     *              string goes first, so a zeroed handle is valid.
+     *  @param[out] strings
+     *  @param[in]  slots (Power of 2)
+     *  @param[in]  capacity (Bytes of string data)
+     *  @return     void
+     */
+
+    strings->mask     = slots - 1;
+    strings->capacity = (uint32_t)capacity;
+    strings->used     = 0;
+    strings->count    = 0;
+
+    RSXA_intern(strings, "", 0);
+}
+
+static uint32_t RSXA_str_probe(const struct RSXA_strtab *strings, const char *str, size_t len, RSXA_str *id)
+{
+    /*!
+     *  @brief      Look a string up in the table
+     *  @param[in]  strings
+     *  @param[in]  str
+     *  @param[in]  len
+     *  @param[out] id (RSXA_STR_NONE if not in the table)
+     *  @return     Slot it is in, or the free slot it would go in
+     */
+
+    const uint32_t *slots = RSXA_STR_SLOTS(strings);
+    uint32_t slot         = RSXA_hash(str, len) & strings->mask;
+
+    for (*id = RSXA_STR_NONE; slots[slot] != 0; slot = (slot + 1) & strings->mask)
+    {
+        RSXA_str found = slots[slot] - 1;
+
+        if ((RSXA_STR_LEN(strings, found) == len) &&
+            (memcmp(RSXA_STR_DATA(strings) + found + sizeof(uint32_t), str, len) == 0))
+        {
+            *id = found;
+            break;
+        }
+    }
+
+    return slot;
+}
+
+static bool RSXA_str_valid(const struct RSXA_strtab *strings, RSXA_str id)
+{
+    /*!
+     *  @brief     Check a handle from an image is a whole string of the
+     *             table
+     *  @param[in] strings
+     *  @param[in] id
+     *  @return    True if valid
+     */
+
+    if ((id % sizeof(uint32_t) != 0) || ((uint64_t)id + RSXA_STR_ENTRY(0) > strings->used))
+        return false;
+
+    return (((uint64_t)id + RSXA_STR_ENTRY(RSXA_STR_LEN(strings, id)) <= strings->used) &&
+            (RSXA_STR_DATA(strings)[id + sizeof(uint32_t) + RSXA_STR_LEN(strings, id)] == '\0'));
+}
+
+static bool RSXA_strtab_valid(const struct RSXA_strtab *strings, const RSXA_layout *layout)
+{
+    /*!
+     *  @brief     Check the string table of an image is the one the
+     *             header lays out and its slots hold valid handles
+     *  @param[in] strings
+     *  @param[in] layout
+     *  @return    True if valid
+     */
+
+    const uint32_t *slots = RSXA_STR_SLOTS(strings);
+    uint32_t count        = 0;
+
+    if ((strings->mask != layout->str_slots - 1) || (strings->capacity != layout->str_capacity) ||
+        (strings->used > strings->capacity) || (strings->count > layout->str_slots / 2))
+    {
+        return false;
+    }
+
+    for (uint32_t slot = 0; slot < layout->str_slots; slot++)
+    {
+        if (slots[slot] == 0) {continue;}
+        if (!RSXA_str_valid(strings, slots[slot] - 1)) {return false;}
+        count++;
+    }
+
+    /* Probes end at a free slot */
+    return (count == strings->count);
+}
+
+static RSXA_str RSXA_str_move(const struct RSXA_strtab *to, const struct RSXA_strtab *from, RSXA_str id)
+{
+    /*!
+     *  @brief     Handle in another table of the string of a handle
+     *  @param[in] to
+     *  @param[in] from
+     *  @param[in] id
+     *  @return    handle (RSXA_STR_NONE if not in the other table)
+     */
+
+    if (to == from) {return id;}
+
+    return RSXA_str_find(to, RSXA_str_get(from, id), RSXA_str_len(from, id));
+}
+
+static RSXA_pins *RSXA_find_pin_id(const RSXA_hw *hw, RSXA_str pin_name)
+{
+    /*!
+     *  @brief     Find a pin of a hw entry by the handle of its name
+     *  @param[in] hw
+     *  @param[in] pin_name
+     *  @return    pin (NULL if not found)
+     */
+
+    for (int i = 0; (pin_name != RSXA_STR_NONE) && (hw->hw_interface != NULL) && (i < hw->array_len_hw_int); i++)
+    {
+        if (hw->hw_interface[i].pin_name == pin_name)
+            return &hw->hw_interface[i];
+    }
+
+    return NULL;
+}
+
+static uint32_t RSXA_hash(const char *str, size_t len)
+{
+    /*!
+     *  @brief     FNV-1a hash of a string
+     *  @param[in] str
+     *  @param[in] len
+     *  @return    hash
+     */
+
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static uint32_t RSXA_hash_id(RSXA_str id)
+{
+    /*!
+     *  @brief     Hash of a handle - Handles are multiples of 4
+     *  @param[in] id
+     *  @return    hash
+     */
+
+    return (id >> 2) * 2654435761u;
+}
+
+void RSXA_free_mem(RSXA *RSXA_Object)
+{
+     /*!
+     *  @brief      Free RSXA_Object - Everything sits in one arena, which
+     *              is either allocated or part of the mapped image (or
+     *              the mapped copy of a published one)
+     *  @param[in]  RSXA_Object
+     *  @return     void
+     */
 
-    /* Free RSXA_Procs */
-    free(RSXA_Object->procs);
+    if (RSXA_Object->image != NULL)
+        munmap(RSXA_Object->image, RSXA_Object->image_size);
+    else
+        free(RSXA_Object->arena);
+
+    RSXA_Object->log_dir    = 0;
+    RSXA_Object->strings    = NULL;
+    RSXA_Object->procs      = NULL;
+    RSXA_Object->hw         = NULL;
+    RSXA_Object->image      = NULL;
+    RSXA_Object->image_size = 0;
+    RSXA_Object->arena      = NULL;
+    RSXA_Object->index      = NULL;
+    RSXA_Object->generation = 0;
 }
@@ -14,35 +14,105 @@ from ctypes import *
 #---------------------------------------------------#
 #                   Globals                         #
 #---------------------------------------------------#
-MAX_LEN_1 = 20
-MAX_LEN_2 = 100
+#Handle of a string that is not in the table
+RSXA_STR_NONE = 0xFFFFFFFF
 
 #Create RSXA Object
 rsxa = CDLL("Obj/libRSXA.so")
 
 #RSXA Pins Struct
 class RSXA_pins(Structure):
-    _fields_ = [('pin_name', c_char * MAX_LEN_1),
+    _fields_ = [('pin_name', c_uint32),
                 ('pin_no'  , c_int)]
 
 #RSXA Settings Struct
 class RSXA_hw(Structure):
-    _fields_ = [('hw_name'     ,c_char * MAX_LEN_1),
+    _fields_ = [('hw_name'     ,c_uint32),
                 ('hw_sim_mode' ,c_bool),
+                ('array_len_hw_int', c_int),
                 ('hw_interface',POINTER(RSXA_pins)),
-                ('array_len_hw_int', c_int)]
+                ('strings', c_void_p)]
 
 # RSXA procs
 class RSXA_procs(Structure):
-    _fields_ = [('proc_name', c_char * MAX_LEN_1),
-                ('server_ip', c_char * MAX_LEN_1 ),
+    _fields_ = [('proc_name', c_uint32),
+                ('server_ip', c_uint32),
                 ('server_p',  c_int),
-                ('client_ip' ,c_char * MAX_LEN_1),
-                ('client_p', c_int)]
+                ('client_ip' ,c_uint32),
+                ('client_p', c_int),
+                ('transport', c_uint32),
+                ('strings', c_void_p)]
 # RSXA Struct
 class RSXA(Structure):
-    _fields_ = [('log_dir', c_char * MAX_LEN_2),
+    _fields_ = [('log_dir', c_uint32),
+                ('strings', c_void_p),
                 ('procs',POINTER(RSXA_procs)),
                 ('hw'     , POINTER(RSXA_hw)),
                 ('array_len_procs', c_int),
-                ('array_len_hw', c_int)]
+                ('array_len_hw', c_int),
+                ('image', c_void_p),
+                ('image_size', c_size_t),
+                ('arena', c_void_p),
+                ('index', c_void_p),
+                ('generation', c_uint64)]
+
+#Lookups return pointers into the RSXA object (NULL if not found)
+rsxa.RSXA_find_hw.restype   = POINTER(RSXA_hw)
+rsxa.RSXA_find_proc.restype = POINTER(RSXA_procs)
+rsxa.RSXA_find_pin.restype  = POINTER(RSXA_pins)
+
+#Names are handles into the strings of the hw, proc or RSXA holding them
+rsxa.RSXA_str_get.restype  = c_char_p
+rsxa.RSXA_str_get.argtypes = [c_void_p, c_uint32]
+rsxa.RSXA_str_find.restype  = c_uint32
+rsxa.RSXA_str_find.argtypes = [c_void_p, c_char_p, c_size_t]
+
+def rsxa_str(strings, id):
+    """
+    "  @brief   String a handle stands for
+    "  @param   strings - strings field of the hw, proc or RSXA
+    "  @param   id      - handle
+    "  @return  str
+    """
+
+    return rsxa.RSXA_str_get(strings, id).decode()
+
+#Changes RSXA_diff_hw reports (bit mask)
+RSXA_HW_SAME     = 0x0
+RSXA_HW_SIM_MODE = 0x1
+RSXA_HW_PINS     = 0x2
+
+rsxa.RSXA_diff_proc.restype     = c_bool
+rsxa.RSXA_watch_changed.restype = c_bool
+
+#Generation rsxa-server published (0 if none)
+rsxa.RSXA_shm_generation.restype = c_uint64
+
+def rsxa_settings():
+    """
+    "  @brief   Read the settings the way the C tasks do - published copy,
+    "           else image, else RSXA.json - as a dict shaped like RSXA.json
+    "  @return  dict (None if the settings are invalid)
+    """
+
+    settings = RSXA()
+    if rsxa.RSXA_init(byref(settings)) != 0:
+        return None
+
+    text = lambda id: rsxa_str(settings.strings, id)
+
+    procs = [{"proc_name": text(p.proc_name), "server_ip": text(p.server_ip),
+              "server_p" : p.server_p, "client_ip": text(p.client_ip),
+              "client_p" : p.client_p, "transport": text(p.transport)}
+             for p in settings.procs[:settings.array_len_procs]]
+
+    hw = [{"hw_name": text(h.hw_name), "hw_sim_mode": h.hw_sim_mode,
+           "hw_interface": [{"pin_name": text(pin.pin_name), "pin_no": pin.pin_no}
+                            for pin in h.hw_interface[:h.array_len_hw_int]]}
+          for h in settings.hw[:settings.array_len_hw]]
+
+    result = {"log_dir": text(settings.log_dir), "procs": procs, "hw": hw,
+              "generation": settings.generation}
+
+    rsxa.RSXA_free_mem(byref(settings))
+    return result
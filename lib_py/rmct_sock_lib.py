@@ -13,8 +13,13 @@
 #                   System Imports                  #
 #---------------------------------------------------#
 import socket
+import select
 import struct
+import time
 import json
+import random
+import threading
+import collections
 
 #---------------------------------------------------#
 #                   Local Imports                   #
@@ -32,34 +37,157 @@ RMCT = "RMCT"
 MAX_BUFF_SIZE = 4096
 SOCK_TIMEOUT  = 2
 
+""" @var LOCAL_TRANSPORTS Same host transports (served by Obj/NMT_sock.so) """
+LOCAL_TRANSPORTS = ["unix", "shm"]
+
+""" @var HEARTBEAT_PERIOD Time (s) between re-sends of a held drive command. RMCT's
+"                     command deadline (RMCT -w) must span several of these """
+HEARTBEAT_PERIOD = 0.1
+
+""" @var DRIVE_MOTORS Motors whose last command is held by the heartbeat """
+DRIVE_MOTORS = ["LEFT_DRV_MTR", "RIGHT_DRV_MTR"]
+
+""" @var INBOX_DEPTH Messages the heartbeat keeps for rx_message while draining acks """
+INBOX_DEPTH = 16
+
+# -- Binary protocol (must match inc/RMCT_proto.hpp) -- #
+PROTO_MAGIC   = b"NB"
+PROTO_VERSION = 2
+PROTO_HEADER  = struct.Struct("<2sBBIHBB")
+PROTO_ACTION  = struct.Struct("<BBhf")
+PROTO_RESULT  = struct.Struct("<IB3x")
+
+""" @var PROTO_TYPES Binary message types (RMCT_PROTO_TYPES) """
+PROTO_HELLO, PROTO_ACTIONS, PROTO_EXIT, PROTO_ACK, PROTO_ACK_BATCH, PROTO_LATENCY = range(6)
+
+""" @var PROTO_MOTORS Motor IDs in RMCT_MOTORS order """
+PROTO_MOTORS = ["CAMERA", "CAM_HRZN_MTR", "CAM_VERT_MTR", "LEFT_DRV_MTR", "RIGHT_DRV_MTR"]
+
+""" @var PROTO_DIRECTIONS Direction IDs in RMCT_DIRECTIONS order (last is no direction) """
+PROTO_DIRECTIONS = ["UP", "DOWN", "LEFT", "RIGHT", "FORWARD", "REVERSE", "STOP", ""]
+
+# -- Binary Codec -- #
+def proto_encode(msg_type, seq, actions=[], client=0, version=PROTO_VERSION):
+    """ 
+    "  @brief              Encode a binary message
+    "  param[in] msg_type  One of PROTO_TYPES
+    "  param[in] seq       Sequence number (echoed in the ack, 0 is unsequenced)
+    "  param[in] actions   List of (motor, direction, angle, speed)
+    "  param[in] client    Client ID (echoed in the ack)
+    "  param[in] version   Negotiated version (RMCT batches acks from 2)
+    "  @return             Encoded message
+    """
+
+    message = PROTO_HEADER.pack(PROTO_MAGIC, version, msg_type, seq & 0xffffffff, len(actions), 0, client)
+
+    for motor, direction, angle, speed in actions:
+        # -- Unknown names go out as out of range IDs and RMCT answers NOK -- #
+        motor_id = PROTO_MOTORS.index(motor) if motor in PROTO_MOTORS else len(PROTO_MOTORS)
+        direction_id = PROTO_DIRECTIONS.index(direction) if direction in PROTO_DIRECTIONS else len(PROTO_DIRECTIONS)
+        message += PROTO_ACTION.pack(motor_id, direction_id, speed, angle)
+
+    return message
+
+def proto_decode(message):
+    """ 
+    "  @brief              Decode a binary message (bounds checked)
+    "  param[in] message   Raw message
+    "  @return             Dict with version/type/seq/client/result/actions (results
+    "                      for a batched ack) or None if malformed
+    """
+
+    if len(message) < PROTO_HEADER.size:
+        return None
+
+    magic, version, msg_type, seq, count, result, client = PROTO_HEADER.unpack_from(message)
+    if magic != PROTO_MAGIC or len(message) != PROTO_HEADER.size + count * PROTO_ACTION.size:
+        return None
+
+    # -- A batched ack carries (seq, result) per command -- #
+    if msg_type == PROTO_ACK_BATCH:
+        results = [PROTO_RESULT.unpack_from(message, PROTO_HEADER.size + i * PROTO_RESULT.size) for i in range(count)]
+        return {"version": version, "type": msg_type, "seq": seq, "client": client, "result": result,
+                "results": results}
+
+    actions = []
+    for i in range(count):
+        motor, direction, speed, angle = PROTO_ACTION.unpack_from(message, PROTO_HEADER.size + i * PROTO_ACTION.size)
+        if motor >= len(PROTO_MOTORS) or direction >= len(PROTO_DIRECTIONS):
+            return None
+        actions.append((PROTO_MOTORS[motor], PROTO_DIRECTIONS[direction], angle, speed))
+
+    return {"version": version, "type": msg_type, "seq": seq, "client": client, "result": result, "actions": actions}
+
 # -- Library Implementation -- #
 class RMCTSockConnect(object):
 
-    def __init__(self):
-        self.ip = str(getip.get_local_ip())
+    def __init__(self, negotiate=True):
+        """ 
+        "  @brief              Open the RMCT transport
+        "  param[in] negotiate Offer the binary protocol straight away, so
+        "                      commands are sequenced (JSON ones are not)
+        """
+
         self.__rsxa_settings()
-        self.multi_sock_tx = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
-        self.multi_sock_rx = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
-        self.multi_sock_rx.settimeout(SOCK_TIMEOUT)
-        self.__config_multicast()
+        self.multi_sock_tx = None
+        self.multi_sock_rx = None
+        self.protocol = "json"
+        self.proto_version = PROTO_VERSION
+        self.seq = 0
+
+        # -- rx_message waits for the ack of ack_seq, heartbeat acks are skipped -- #
+        self.ack_seq = 0
+
+        # -- Heartbeat state, all guarded by lock -- #
+        self.lock = threading.Lock()
+        self.held = {}
+        self.unsent = False
+        self.rx_busy = False
+        self.inbox = collections.deque(maxlen=INBOX_DEPTH)
+        self.heartbeat = None
+
+        # -- RMCT drops duplicate/stale commands per client ID. The ID -- #
+        # -- is assigned by RMCT in the hello ack (0 until then)      -- #
+        self.client_id = 0
+
+        if self.rmct_transport in LOCAL_TRANSPORTS:
+            self.__config_local()
+        else:
+            self.ip = str(getip.get_local_ip())
+            self.multi_sock_tx = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
+            self.multi_sock_rx = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
+            self.multi_sock_rx.settimeout(SOCK_TIMEOUT)
+            self.__config_multicast()
+
+        if negotiate:
+            self.negotiate_protocol()
     
 
     #---------------------------------------------------#
     #                   Private Methods                 #
     #---------------------------------------------------#
     def __del__(self):
-        self.multi_sock_tx.close()
-        self.multi_sock_rx.close()
+        if self.multi_sock_tx:
+            self.multi_sock_tx.close()
+        if self.multi_sock_rx:
+            self.multi_sock_rx.close()
     
     def __rsxa_settings(self):
 
         """ 
-        "  @brief  Read the Robot Settings file and get needed settings
+        "  @brief  Read the Robot Settings and get needed settings
         """
 
-        # -- Read the File -- #
-        with open(RSXA_FILE, "r") as rsxa_file:
-            rsxa = json.load(rsxa_file)
+        # -- Read the published settings, else the File -- #
+        try:
+            from lib_py.RSXA import rsxa_settings
+            rsxa = rsxa_settings()
+        except (OSError, ImportError):
+            rsxa = None
+
+        if rsxa is None:
+            with open(RSXA_FILE, "r") as rsxa_file:
+                rsxa = json.load(rsxa_file)
 
         # -- Find the Settings Needed -- #
         rmct_proc = list(filter(lambda p: p["proc_name"] == RMCT, rsxa["procs"]))[0]
@@ -70,6 +198,19 @@ class RMCTSockConnect(object):
         self.rmct_server_port = rmct_proc["server_p"]
         self.rmct_client_ip = rmct_proc["client_ip"]
         self.rmct_client_port = rmct_proc["client_p"]
+        self.rmct_transport = rmct_proc.get("transport", "udp")
+
+    def __config_local(self):
+        """ 
+        "  @brief  Open the same host transport RMCT was configured with
+        """
+
+        from Obj import NMT_sock
+
+        transport = NMT_sock.NMT_sock_unix if self.rmct_transport == "unix" else NMT_sock.NMT_sock_shm
+        self.local_ok = NMT_sock.NMT_result.OK
+        self.local_tx = transport(self.rmct_server_port, NMT_sock.sock_mode.SOCK_SERVER, SOCK_TIMEOUT)
+        self.local_rx = transport(self.rmct_client_port, NMT_sock.sock_mode.SOCK_CLIENT, SOCK_TIMEOUT)
 
     def __config_multicast(self):
         """ 
@@ -108,20 +249,138 @@ class RMCTSockConnect(object):
 
             return tx_message
 
+    def __hold(self, actions):
+        """ 
+        "  @brief              Track the drive motors the heartbeat keeps moving
+        "  param[in] actions   Actions about to be sent (lock held)
+        """
+
+        for action in actions:
+            if action[0] in DRIVE_MOTORS:
+                if action[1] in ["FORWARD", "REVERSE"]:
+                    self.held[action[0]] = action
+                else:
+                    self.held.pop(action[0], None)
+
+    def __heartbeat_main(self):
+        """ 
+        "  @brief  Heartbeat thread. Re-sends the held drive commands every
+        "          HEARTBEAT_PERIOD as new commands, so RMCT's command deadline
+        "          only stops the robot once this process stops sending
+        """
+
+        while True:
+            time.sleep(HEARTBEAT_PERIOD)
+
+            with self.lock:
+                # -- A command built but not yet sent goes first, so the -- #
+                # -- sequence numbers reach RMCT in order                 -- #
+                if self.held and not self.unsent:
+                    self.__tx_raw(proto_encode(PROTO_ACTIONS, self.__next_seq(), list(self.held.values()),
+                                               self.client_id, self.proto_version))
+                self.__drain()
+
+    def __drain(self):
+        """ 
+        "  @brief  Drop the heartbeat acks nobody reads, so they do not fill the
+        "          socket buffer during a long hold. Anything else is kept for
+        "          rx_message. Only done between rx_message calls (lock held)
+        "          and on UDP (the local transports have no non-blocking read).
+        """
+
+        if self.rx_busy or not self.multi_sock_rx:
+            return
+
+        # -- Only read what is queued (recv would wait out SOCK_TIMEOUT) -- #
+        while select.select([self.multi_sock_rx], [], [], 0)[0]:
+            raw = self.multi_sock_rx.recv(MAX_BUFF_SIZE)
+
+            if raw[:len(PROTO_MAGIC)] == PROTO_MAGIC:
+                message = proto_decode(raw)
+                if not message or message["client"] != self.client_id:
+                    continue
+                if message["type"] == PROTO_ACK and message["seq"] != self.ack_seq:
+                    continue
+                if message["type"] == PROTO_ACK_BATCH and self.ack_seq not in dict(message["results"]):
+                    continue
+
+            self.inbox.append(raw)
+
+    def __tx_raw(self, message):
+        """ 
+        "  @brief                Send a message on the configured transport
+        "  @param[in]            message -> Message to send
+        """
+
+        if not isinstance(message, bytes):
+            message = message.encode()
+
+        if self.multi_sock_tx:
+            self.multi_sock_tx.sendto(message,(self.rmct_server_ip, self.rmct_server_port))
+        else:
+            self.local_tx.NMT_write_socket(message)
+
+    def __next_seq(self):
+        # -- 0 is unsequenced, so the numbers wrap to 1 -- #
+        self.seq = (self.seq % 0xffffffff) + 1
+        return self.seq
+
+    def __rx_raw(self):
+        """ 
+        "  @brief          Recieve one raw message on the configured transport
+        "  @return         Message text (raises socket.timeout if none arrived)
+        """
+
+        with self.lock:
+            if self.inbox:
+                return self.inbox.popleft()
+
+        if self.multi_sock_rx:
+            return self.multi_sock_rx.recv(MAX_BUFF_SIZE)
+
+        result, message = self.local_rx.NMT_read_socket()
+        if result != self.local_ok:
+            raise socket.timeout()
+        return message
+
     #---------------------------------------------------#
     #                   Public Methods                  #
     #---------------------------------------------------#
     
+    def negotiate_protocol(self):
+        """ 
+        "  @brief          Offer the binary protocol to RMCT. Stays on JSON
+        "                  unless RMCT answers the hello in binary. The ack
+        "                  carries the client ID RMCT assigned us.
+        "  @return         Protocol in use ("binary" or "json")
+        """
+
+        # -- The hello goes out as client 0 and a random sequence number, so -- #
+        # -- its ack is told apart from other clients' hellos                -- #
+        self.client_id = 0
+        self.seq = random.randint(1, 0xffffffff)
+        self.ack_seq = self.seq
+        self.tx_message(proto_encode(PROTO_HELLO, self.seq))
+        ack = self.rx_message()
+
+        if ack and ack.get("version") and ack["result"] == NMT_result.OK:
+            self.protocol = "binary"
+            self.proto_version = min(ack["version"], PROTO_VERSION)
+            self.client_id = ack["client"]
+
+        return self.protocol
+
     def show_rsxa_settings(self):
 
         """ 
         "  @brief                Show RSXA Settings on the screen
         """
 
-        print ("server_ip=%s\nclient_ip=%s\nserver_port=%d\nclient_port=%d"%(self.rmct_server_ip, 
-                                                                             self.rmct_client_ip,
-                                                                             self.rmct_server_port,
-                                                                             self.rmct_client_port))
+        print ("server_ip=%s\nclient_ip=%s\nserver_port=%d\nclient_port=%d\ntransport=%s"%(self.rmct_server_ip, 
+                                                                                          self.rmct_client_ip,
+                                                                                          self.rmct_server_port,
+                                                                                          self.rmct_client_port,
+                                                                                          self.rmct_transport))
 
     def tx_message(self, message):
         """ 
@@ -129,8 +388,11 @@ class RMCTSockConnect(object):
         "  @param[in]            message -> Message to send
         """
 
-        print ("Sending request to NiBot ..... {}".format(message))
-        self.multi_sock_tx.sendto(message.encode(),(self.rmct_server_ip, self.rmct_server_port))
+        print ("Sending request to NiBot ..... {}".format(repr(message)))
+
+        with self.lock:
+            self.__tx_raw(message)
+            self.unsent = False
 
     def rx_message(self):
         """ 
@@ -138,17 +400,102 @@ class RMCTSockConnect(object):
         "  @return         Message recieved from the server
         """
 
+        with self.lock:
+            self.rx_busy = True
+
+        try:
+            # -- Skip unsolicited telemetry (e.g. watchdog expiry) -- #
+            while True:
+                raw = self.__rx_raw()
+
+                # -- Binary acks are returned in the same shape as JSON ones. Acks -- #
+                # -- for other clients or earlier commands are skipped (any       -- #
+                # -- client's until RMCT has assigned ours)                       -- #
+                if raw[:len(PROTO_MAGIC)] == PROTO_MAGIC:
+                    message = proto_decode(raw)
+                    if not message or self.client_id not in (0, message["client"]):
+                        continue
+
+                    if message["type"] == PROTO_ACK_BATCH:
+                        results = dict(message.pop("results"))
+                        if self.ack_seq in results:
+                            message.update({"type": "ack", "seq": self.ack_seq, "result": results[self.ack_seq]})
+                            return message
+                    elif message["type"] == PROTO_ACK and message["seq"] == self.ack_seq:
+                        message["type"] = "ack"
+                        return message
+                    continue
+
+                message = json.loads(raw)
+                if not (isinstance(message, dict) and message.get("type") == "telemetry"):
+                    return message
+        except socket.timeout:
+            return False
+        finally:
+            with self.lock:
+                self.rx_busy = False
+
+    def query_latency(self):
+        """ 
+        "  @brief          Ask RMCT for its per stage command latency histograms
+        "  @return         Latency report (stage -> count/mean_ns/p50_ns/p99_ns/max_ns/buckets)
+        "                  or False if RMCT did not answer
+        """
+
+        self.tx_message(json.dumps([{"type": "proc_action", "action": "latency"}]))
+
+        with self.lock:
+            self.rx_busy = True
+
         try:
-            return json.loads(self.multi_sock_rx.recv(MAX_BUFF_SIZE))
+            # -- The report follows the ack as telemetry -- #
+            while True:
+                raw = self.__rx_raw()
+                if raw[:len(PROTO_MAGIC)] == PROTO_MAGIC:
+                    continue
+
+                message = json.loads(raw)
+                if isinstance(message, dict) and message.get("event") == "latency":
+                    return message["stages"]
         except socket.timeout:
             return False
+        finally:
+            with self.lock:
+                self.rx_busy = False
+
+    def release(self):
+        """ 
+        "  @brief          Stop holding the drive commands. The heartbeat goes
+        "                  quiet, so RMCT's command deadline stops the robot
+        """
+
+        with self.lock:
+            self.held.clear()
 
     def construct_tx_message(self, actions):
         """ 
-        "  @brief              Construct Array of TX Messages
+        "  @brief              Construct Array of TX Messages in the negotiated protocol.
+        "                      On binary, drive commands other than STOP are held:
+        "                      A heartbeat re-sends them until the motor is sent STOP.
+        "                      JSON acks carry no sequence number to tell the
+        "                      heartbeat's apart, so nothing is held on JSON.
         "  param[in] actions   Actions to be performed
         """
 
+        if self.protocol == "binary":
+            with self.lock:
+                self.__hold(actions)
+                self.ack_seq = self.__next_seq()
+                self.unsent = True
+                message = proto_encode(PROTO_ACTIONS, self.ack_seq, actions, self.client_id, self.proto_version)
+
+                if self.held and not self.heartbeat:
+                    self.heartbeat = threading.Thread(target=self.__heartbeat_main)
+                    self.heartbeat.daemon = True
+                    self.heartbeat.start()
+
+            return message
+
         return json.dumps(list(map(lambda action: self.__get_tx_message(action[0],
                                                                         action[1],
                                                                         action[2],
@@ -83,6 +83,9 @@ class GUI_Application(object):
         "  @brief Disconnect from NiBot and delete object
         """
 
+        # -- Stop holding the drive commands -- #
+        self.rmct.release()
+
         del(self.nibot)
         zope.event.notify("disconnected")
 
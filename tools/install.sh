@@ -30,6 +30,10 @@ if [ ! -d $CNF_DIR ]; then mkdir $CNF_DIR; fi
 # -- Copy Needed Files ---------#
 cp $SRC_CNF_DIR/RSXA.json $CNF_DIR
 
+# -- Precompile the Settings ---#
+if [ -x bld/rsxa-compile ]; then bld/rsxa-compile -i $CNF_DIR/RSXA.json -o $CNF_DIR/RSXA.bin; fi
+# Start bld/rsxa-server before the tasks to share one copy of the settings
+
 # -----Set Appropriate Permissions --#
 chmod 777 $CNF_DIR
 chmod -R 777 $LOG_DIR
@@ -14,6 +14,7 @@
 #---------------------------------------------------#
 import argparse
 import json
+import time
 
 #---------------------------------------------------#
 #                   Local Imports                   #
@@ -60,9 +61,28 @@ if __name__ == '__main__':
     parser.add_argument('-a', '--angle', required=False, type=int, default= -1, help ="Manually set the camera motor angle")
     parser.add_argument('-s', '--speed', required=False, type=int, default= -1, help ="Manually set drive motor speed")
     parser.add_argument('-e', '--exit', required=False, action="store_true", help ="Shutdown the RMCT Process")
+    parser.add_argument('-l', '--latency', required=False, action="store_true", help ="Show RMCT command latency per stage")
+    parser.add_argument('-k', '--hold', required=False, action="store_true", help ="Keep a drive command alive (RMCT -w) until Ctrl-C, then stop")
+    parser.add_argument('-j', '--json', required=False, action="store_true", help ="Stay on the JSON protocol (commands are not sequenced)")
     args = parser.parse_args()
 
-    rmct = RMCTSockConnect()
+    rmct = RMCTSockConnect(negotiate=not args.json)
+    print("Protocol=%s"%(rmct.protocol))
+
+    if (args.latency):
+        report = rmct.query_latency()
+        if not report:
+            print("ERROR! Did not recieve a response from NiBot")
+        for stage in ["recv", "parse", "ack_send", "dispatch", "i2c_issue", "i2c_complete", "total"]:
+            if report and stage in report:
+                print("%-12s count=%-8d mean=%-10d p50=%-10d p99=%-10d max=%d (ns)"%(stage,
+                                                                                     report[stage]["count"],
+                                                                                     report[stage]["mean_ns"],
+                                                                                     report[stage]["p50_ns"],
+                                                                                     report[stage]["p99_ns"],
+                                                                                     report[stage]["max_ns"]))
+        exit(0)
+
     if (args.exit):
         tx_message = json.dumps([({"type": "proc_action", "action": "exit"})])
     else:
@@ -78,3 +98,13 @@ if __name__ == '__main__':
         print("NiBOT Response=%s"%(NMT_result.get_result(response["result"])))
     else:
         print("ERROR! Did not recieve a response from NiBot")
+
+    # -- The heartbeat keeps the drive motors moving until Ctrl-C -- #
+    if (args.hold and not args.exit and args.motor in DRIVE_MOTORS):
+        try:
+            while True:
+                time.sleep(1)
+        except KeyboardInterrupt:
+            rmct.tx_message(rmct.construct_tx_message([(args.motor, "STOP", -1, -1)]))
+            response = rmct.rx_message()
+            print("NiBOT Response=%s"%(NMT_result.get_result(response["result"]) if response else "None"))
@@ -0,0 +1,180 @@
+/**
+ *  @file      benchmark_RMCT_proto.cc
+ *  @brief     Benchmark for the RMCT command parsers
+ *  @details   Compares the JSON fast path (RMCT_proto_parse_json) with
+ *             the jsoncpp DOM path RMCT used before it, and the binary
+ *             decoder. Usage: benchmark_RMCT_proto [iterations]
+ *  @author    Nitin Mohan
+ *  @date      April 21, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <functional>
+#include <jsoncpp/json/json.h>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "RMCT_proto.hpp"
+#include "NMT_log.h"
+
+/*--------------------------------------------------/
+/                   Constants                       /
+/--------------------------------------------------*/
+/** @var DEFAULT_ITERATIONS
+ *  Parses timed per message and parser */
+const unsigned int DEFAULT_ITERATIONS = 100000;
+
+/** @var COMMANDS
+ *  Commands as the GUI and nibot_mtr_ctrl.py send them */
+const char *COMMANDS[] = {"[{\"type\": \"hw_action\", \"motor\": \"CAMERA\", \"direction\": \"LEFT\", \"angle\": -1, \"speed\": -1}]",
+                          "[{\"type\": \"hw_action\", \"motor\": \"LEFT_DRV_MTR\", \"direction\": \"FORWARD\", \"angle\": -1, \"speed\": 60}, "
+                          "{\"type\": \"hw_action\", \"motor\": \"RIGHT_DRV_MTR\", \"direction\": \"FORWARD\", \"angle\": -1, \"speed\": 60}, "
+                          "{\"type\": \"hw_action\", \"motor\": \"CAM_HRZN_MTR\", \"direction\": \"\", \"angle\": 90, \"speed\": -1}, "
+                          "{\"type\": \"hw_action\", \"motor\": \"CAM_VERT_MTR\", \"direction\": \"\", \"angle\": 45.5, \"speed\": -1}]",
+                          "[{\"type\": \"proc_action\", \"action\": \"exit\"}]"};
+
+/*--------------------------------------------------/
+/                   Reference Parser                /
+/--------------------------------------------------*/
+static bool jsoncpp_validate(Json::Value mc)
+{
+    /* As rmct_validate_robot_action (Json::Value taken by value) */
+    bool valid = false;
+
+    if (mc["type"].isString())
+    {
+        if (mc["type"].asString() == "hw_action")
+            valid = mc["motor"].isString() && mc["direction"].isString() &&
+                    mc["angle"].isNumeric() && mc["speed"].isNumeric();
+        else if (mc["type"].asString() == "proc_action")
+            valid = mc["action"].isString();
+    }
+
+    return valid;
+}
+
+static NMT_result jsoncpp_parse(const char *buffer, size_t length, RMCT_proto_msg &msg)
+{
+    /*!
+     *  @brief      The jsoncpp DOM path RMCT used before the fast path
+     *  @param[in]  buffer
+     *  @param[in]  length
+     *  @param[out] msg
+     *  @return     NMT_result
+     */
+
+    NMT_result result = OK;
+    Json::Value  mc;
+    Json::Reader reader;
+
+    msg.type  = RMCT_PROTO_ACTIONS;
+    msg.count = 0;
+
+    if (!reader.parse(buffer, buffer + length, mc) || !mc.isArray())
+        return NOK;
+
+    for (Json::Value::ArrayIndex i = 0; i != mc.size() && result == OK; i++)
+    {
+        if (!jsoncpp_validate(mc[i]))
+            result = NOK;
+        else if ((mc[i]["type"].asString() == "hw_action") && (msg.count < RMCT_PROTO_MAX_ACTIONS))
+        {
+            const char *motor_begin, *motor_end, *dir_begin, *dir_end;
+
+            mc[i]["motor"].getString(&motor_begin, &motor_end);
+            mc[i]["direction"].getString(&dir_begin, &dir_end);
+
+            result = RMCT_parse_motor_action(motor_begin, motor_end - motor_begin,
+                                             dir_begin, dir_end - dir_begin,
+                                             mc[i]["angle"].asDouble(),
+                                             mc[i]["speed"].asInt(), msg.actions[msg.count++]);
+        }
+        else if (mc[i]["action"].asString() == "exit")
+            msg.type = RMCT_PROTO_EXIT;
+    }
+
+    return result;
+}
+
+/*--------------------------------------------------/
+/                   Start of Program                /
+/--------------------------------------------------*/
+static bool same_actions(const RMCT_proto_msg &a, const RMCT_proto_msg &b)
+{
+    if ((a.type != b.type) || (a.count != b.count))
+        return false;
+
+    for (unsigned int i = 0; i < a.count; i++)
+    {
+        if ((a.actions[i].motor != b.actions[i].motor) || (a.actions[i].direction != b.actions[i].direction) ||
+            ((float)a.actions[i].angle != (float)b.actions[i].angle) || (a.actions[i].speed != b.actions[i].speed))
+            return false;
+    }
+
+    return true;
+}
+
+static double time_ns(unsigned int iterations, const std::function<NMT_result()> &parse)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (unsigned int i = 0; i < iterations; i++)
+    {
+        if (parse() != OK)
+            return -1;
+    }
+
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char *argv[])
+{
+    /*!
+     *  @brief     Time each parser on each command. Exits NOK if the
+     *             parsers disagree on any command.
+     *  @return    NMT_result
+     */
+
+    unsigned int iterations = (argc > 1 ? (unsigned int)atoi(argv[1]) : DEFAULT_ITERATIONS);
+    RMCT_proto_msg fast, reference, binary;
+    char encoded[sizeof(RMCT_proto_header) + RMCT_PROTO_MAX_ACTIONS * sizeof(RMCT_proto_action)];
+    NMT_result result = OK;
+
+    /* Errors are still logged - Keep the timed loops quiet */
+    NMT_log_init((char *)"/tmp/", false);
+
+    printf("%-8s %-6s %12s %12s %12s %8s\n", "command", "bytes", "jsoncpp(ns)", "fast(ns)", "binary(ns)", "speedup");
+
+    for (unsigned int c = 0; c < sizeof(COMMANDS) / sizeof(COMMANDS[0]); c++)
+    {
+        const char *cmd = COMMANDS[c];
+        size_t length = strlen(cmd);
+
+        if ((RMCT_proto_parse_json(cmd, length, fast) != OK) || (jsoncpp_parse(cmd, length, reference) != OK) ||
+            (!same_actions(fast, reference)))
+        {
+            printf("command %u: parsers disagree\n", c);
+            result = NOK;
+            continue;
+        }
+
+        size_t encoded_len = RMCT_proto_encode(fast, encoded, sizeof(encoded));
+
+        double dom_ns  = time_ns(iterations, [&]() {return jsoncpp_parse(cmd, length, reference);});
+        double fast_ns = time_ns(iterations, [&]() {return RMCT_proto_parse_json(cmd, length, fast);});
+        double bin_ns  = time_ns(iterations, [&]() {return RMCT_proto_decode(encoded, encoded_len, binary);});
+
+        printf("%-8u %-6zu %12.0f %12.0f %12.0f %7.1fx\n", c, length, dom_ns, fast_ns, bin_ns, dom_ns / fast_ns);
+    }
+
+    NMT_log_finish();
+    return result;
+}
@@ -38,7 +38,8 @@ class RMCT_Test(unittest.TestCase):
 
     def setUp(self):
         os.system("sudo %s"%CLR_LOGS)
-        self.rmct = RMCTSockConnect()
+        # -- The base log was recorded over JSON -- #
+        self.rmct = RMCTSockConnect(negotiate=False)
 
     def test_RMCT(self):
         camera = "CAMERA"
@@ -16,3 +16,5 @@
 CMOCK_MOCK_FUNCTION2(LD27MGMocker, LD27MG_move_motor, NMT_result(LD27MG_MOTORS, double));
 CMOCK_MOCK_FUNCTION2(LD27MGMocker, LD27MG_get_current_position, NMT_result(LD27MG_MOTORS, double*));
 CMOCK_MOCK_FUNCTION1(LD27MGMocker, LD27MG_init, NMT_result(RSXA_hw));
+CMOCK_MOCK_FUNCTION3(LD27MGMocker, LD27MG_stage_move, unsigned int(LD27MG_MOTORS, double, PCA9685_pwm_update*));
+CMOCK_MOCK_FUNCTION1(LD27MGMocker, LD27MG_reconfigure, NMT_result(RSXA_hw));
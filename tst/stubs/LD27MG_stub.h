@@ -24,6 +24,8 @@ public:
     MOCK_METHOD2(LD27MG_move_motor, NMT_result(LD27MG_MOTORS, double));
     MOCK_METHOD2(LD27MG_get_current_position, NMT_result(LD27MG_MOTORS, double*));
     MOCK_METHOD1(LD27MG_init, NMT_result(RSXA_hw));
+    MOCK_METHOD3(LD27MG_stage_move, unsigned int(LD27MG_MOTORS, double, PCA9685_pwm_update*));
+    MOCK_METHOD1(LD27MG_reconfigure, NMT_result(RSXA_hw));
 };
 
 #endif
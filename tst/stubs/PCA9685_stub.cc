@@ -16,6 +16,8 @@
 CMOCK_MOCK_FUNCTION1(PCA9685Mocker, PCA9685_init, NMT_result(PCA9685_settings));
 CMOCK_MOCK_FUNCTION1(PCA9685Mocker, PCA9685_chgFreq, NMT_result(float));
 CMOCK_MOCK_FUNCTION3(PCA9685Mocker, PCA9685_setPWM, NMT_result(double, double, PCA9685_PWM_CHANNEL));
+CMOCK_MOCK_FUNCTION0(PCA9685Mocker, PCA9685_stop_all, NMT_result());
+CMOCK_MOCK_FUNCTION2(PCA9685Mocker, PCA9685_setPWM_batch, NMT_result(const PCA9685_pwm_update *, unsigned int));
 CMOCK_MOCK_FUNCTION2(PCA9685Mocker, PCA9685_getPWM, NMT_result(double *, PCA9685_PWM_CHANNEL));
 CMOCK_MOCK_FUNCTION1(PCA9685Mocker, PCA9685_get_init_status, NMT_result(bool*));
 CMOCK_MOCK_FUNCTION0(PCA9685Mocker, PCA9685_get_curret_freq, float());
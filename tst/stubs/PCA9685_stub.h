@@ -23,6 +23,8 @@ public:
     MOCK_METHOD1(PCA9685_init, NMT_result(PCA9685_settings));
     MOCK_METHOD1(PCA9685_chgFreq, NMT_result(float));
     MOCK_METHOD3(PCA9685_setPWM, NMT_result(double, double, PCA9685_PWM_CHANNEL));
+    MOCK_METHOD0(PCA9685_stop_all, NMT_result());
+    MOCK_METHOD2(PCA9685_setPWM_batch, NMT_result(const PCA9685_pwm_update *, unsigned int));
     MOCK_METHOD2(PCA9685_getPWM, NMT_result(double *, PCA9685_PWM_CHANNEL));
     MOCK_METHOD1(PCA9685_get_init_status, NMT_result(bool*));
     MOCK_METHOD0(PCA9685_get_curret_freq, float()); };
@@ -0,0 +1,53 @@
+/** 
+ *  @file      RMCT_backends_mock.h
+ *  @brief     RMCT Backend Mocks
+ *  @details   gmock policies for RobotMotorControllerT
+ *  @author    Nitin Mohan
+ *  @date      April 05, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+#ifndef CMOCK_TEST_RMCT_BACKENDS_MOCK_H_
+#define CMOCK_TEST_RMCT_BACKENDS_MOCK_H_
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <gmock/gmock.h>
+#include "RMCT_backends.hpp" /* Policies being mocked */
+
+/* PWM Backend Mock */
+class PwmBackendMock
+{
+public:
+    PwmBackendMock(RSXA_hw, RMCT_init_graph &) {}
+    MOCK_METHOD2(set_pwm_batch, NMT_result(const PCA9685_pwm_update *, unsigned int));
+    MOCK_METHOD0(stop_all, NMT_result());
+};
+
+/* Servo Policy Mock */
+class ServoPolicyMock
+{
+public:
+    ServoPolicyMock(RSXA_hw, RMCT_init_graph &) {}
+    MOCK_METHOD2(move_motor, NMT_result(LD27MG_MOTORS, double));
+    MOCK_METHOD2(get_position, NMT_result(LD27MG_MOTORS, double *));
+    MOCK_METHOD3(stage_move, unsigned int(LD27MG_MOTORS, double, PCA9685_pwm_update *));
+    MOCK_METHOD1(reconfigure, NMT_result(RSXA_hw));
+};
+
+/* Drive Policy Mock */
+class DrivePolicyMock
+{
+public:
+    DrivePolicyMock(RSXA_hw, RSXA_hw, RMCT_init_graph &) {}
+    MOCK_METHOD3(ramp_motor, NMT_result(DRV_MOTORS, L9110_DIRECTIONS, int));
+    MOCK_METHOD2(tick, NMT_result(PCA9685_pwm_update *, unsigned int *));
+    MOCK_METHOD0(ack, void());
+    MOCK_METHOD0(halt, void());
+    MOCK_METHOD2(reconfigure, NMT_result(DRV_MOTORS, RSXA_hw));
+    MOCK_METHOD4(commit, NMT_result(const RMCT_drive_target *, unsigned int,
+                                    PCA9685_pwm_update *, unsigned int *));
+};
+
+#endif
@@ -24,3 +24,4 @@ CMOCK_MOCK_FUNCTION0(wiringPiMocker, wiringPiSetup, int(void));
 CMOCK_MOCK_FUNCTION2(wiringPiMocker, pinMode, void(int, int));
 CMOCK_MOCK_FUNCTION2(wiringPiMocker, digitalWrite, void(int, int));
 CMOCK_MOCK_FUNCTION1(wiringPiMocker, digitalRead, int(int));
+CMOCK_MOCK_FUNCTION3(wiringPiMocker, PCA9685_i2c_write_block, int(int, const unsigned char *, int));
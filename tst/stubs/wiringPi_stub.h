@@ -16,6 +16,7 @@
 #include "cmock/cmock.h"
 #include "wiringPi.h"
 #include "wiringPiI2C.h" /* Library being stubbed */
+#include "PCA9685.h"     /* I2C block write wrapper */
 
 /* C++ Mocking Interface */
 class wiringPiMocker : public CMockMocker<wiringPiMocker>
@@ -30,6 +31,9 @@ public:
     MOCK_METHOD2(pinMode, void(int, int));
     MOCK_METHOD2(digitalWrite, void(int, int));
     MOCK_METHOD1(digitalRead, int(int));
+
+    /* Block transfers go through the PCA9685 I2C wrapper */
+    MOCK_METHOD3(PCA9685_i2c_write_block, int(int, const unsigned char *, int));
 };
 
 #endif /* CMOCK_TEST_MATH_MOCKER_H_ */
@@ -42,17 +42,25 @@ class L9110_Test_Fixture : public ::testing::Test
        RSXA_hw hw_config;
        PCA9685Mocker pca9685mock;
 
+       struct RSXA_strtab *strings = RSXA_strtab_new(16, 256);
+
        L9110_Test_Fixture()
        {
            hw_config = {0};
-           strcpy(hw_config.hw_name, "LEFT_DRV_MOTOR");
+           hw_config.strings = strings;
+           hw_config.hw_name = name("LEFT_DRV_MOTOR");
            hw_config.hw_sim_mode = false;
            hw_config.hw_interface = (RSXA_pins *)malloc(sizeof(RSXA_pins) * 2);
-           strcpy(hw_config.hw_interface[0].pin_name, "forward");
-           strcpy(hw_config.hw_interface[1].pin_name, "reverse");
+           hw_config.array_len_hw_int = 2;
+           hw_config.hw_interface[0].pin_name = name("forward");
+           hw_config.hw_interface[1].pin_name = name("reverse");
            hw_config.hw_interface[0].pin_no = 1;
            hw_config.hw_interface[1].pin_no = 2;
        }
+
+       ~L9110_Test_Fixture() {RSXA_strtab_free(strings);}
+
+       RSXA_str name(const char *str) {return RSXA_intern(strings, str, strlen(str));}
 };
 
 /* ---- Start of Tests -------------*/
@@ -84,7 +92,7 @@ TEST_F(L9110_Test_Fixture, VerifyConstructorBW)
     */
 
     /* Scenario 1 - Not in Sim Mode */
-    strcpy(hw_config.hw_interface[0].pin_name, "Test1");
+    hw_config.hw_interface[0].pin_name = name("Test1");
     EXPECT_CALL(pca9685mock, PCA9685_setPWM(_, _, _)).Times(0);
 
     /* Construct Object and catch Exception */
@@ -123,7 +131,7 @@ TEST_F(L9110_Test_Fixture, VerifyConstructor2BW)
     */
 
     /* Scenario 1 - Not in Sim Mode */
-    strcpy(hw_config.hw_interface[1].pin_name, "Test2");
+    hw_config.hw_interface[1].pin_name = name("Test2");
     EXPECT_CALL(pca9685mock, PCA9685_setPWM(_, _, _)).Times(0);
 
     /* Construct Object and catch Exception */
@@ -276,6 +284,232 @@ TEST_F(L9110_Test_Fixture, VerifyMoveMotorsBWNOK)
     ASSERT_EQ(l9110_obj.L9110_move_motor(STOP), NOK);
 }
 
+TEST_F(L9110_Test_Fixture, VerifyRampSlewRate)
+{
+   /*!
+    *  @test Verify L9110_ramp_motor
+    *  Speed changes are limited by the slew rate and no hardware
+    *  is touched until the motor is stepped
+    */
+
+    L9110_ramp_settings ramp = {100.00, 100.00};
+    PCA9685_pwm_update updates[L9110_MAX_UPDATES];
+
+    EXPECT_CALL(pca9685mock, PCA9685_setPWM(_, _, _)).Times(2);
+    L9110 l9110_obj(hw_config, ramp);
+
+    /* Setting the target alone does not write */
+    EXPECT_CALL(pca9685mock, PCA9685_setPWM(_, _, _)).Times(0);
+    ASSERT_EQ(OK, l9110_obj.L9110_ramp_motor(FORWARD, 50));
+
+    /* 100%/s for 100ms -> 10% */
+    ASSERT_EQ(1u, l9110_obj.L9110_ramp_step(100.00, updates));
+    EXPECT_EQ(CHANNEL_1, updates[0].channel);
+    EXPECT_DOUBLE_EQ(10.00, updates[0].duty_cycle);
+    l9110_obj.L9110_ramp_ack();
+
+    /* Capped at the target speed */
+    ASSERT_EQ(1u, l9110_obj.L9110_ramp_step(1000.00, updates));
+    EXPECT_DOUBLE_EQ(50.00, updates[0].duty_cycle);
+    l9110_obj.L9110_ramp_ack();
+
+    /* Nothing left to do */
+    ASSERT_EQ(0u, l9110_obj.L9110_ramp_step(100.00, updates));
+}
+
+TEST_F(L9110_Test_Fixture, VerifyRampReversalDeadTime)
+{
+   /*!
+    *  @test Verify L9110_ramp_step
+    *  A reversal ramps down to zero and waits out the dead time
+    *  before driving the other output
+    */
+
+    L9110_ramp_settings ramp = {100.00, 100.00};
+    PCA9685_pwm_update updates[L9110_MAX_UPDATES];
+
+    EXPECT_CALL(pca9685mock, PCA9685_setPWM(_, _, _)).Times(AtLeast(2));
+    L9110 l9110_obj(hw_config, ramp);
+    l9110_obj.L9110_move_motor(FORWARD, 50);
+
+    /* Ramp down forward */
+    l9110_obj.L9110_ramp_motor(REVERSE, 50);
+    ASSERT_EQ(1u, l9110_obj.L9110_ramp_step(500.00, updates));
+    EXPECT_EQ(CHANNEL_1, updates[0].channel);
+    EXPECT_DOUBLE_EQ(0.00, updates[0].duty_cycle);
+    l9110_obj.L9110_ramp_ack();
+
+    /* Still inside the dead time */
+    ASSERT_EQ(0u, l9110_obj.L9110_ramp_step(50.00, updates));
+
+    /* Dead time over - Reverse starts ramping */
+    ASSERT_EQ(1u, l9110_obj.L9110_ramp_step(50.00, updates));
+    EXPECT_EQ(CHANNEL_2, updates[0].channel);
+    EXPECT_DOUBLE_EQ(5.00, updates[0].duty_cycle);
+}
+
+TEST_F(L9110_Test_Fixture, VerifyRampResendUnacked)
+{
+   /*!
+    *  @test Verify L9110_ramp_ack
+    *  A step whose write was not acked is sent again, so a failed
+    *  write of the final step to STOP does not leave the motor driving
+    */
+
+    L9110_ramp_settings ramp = {100.00, 100.00};
+    PCA9685_pwm_update updates[L9110_MAX_UPDATES];
+
+    EXPECT_CALL(pca9685mock, PCA9685_setPWM(_, _, _)).Times(2);
+    L9110 l9110_obj(hw_config, ramp);
+
+    /* Driving Forward at 10% */
+    l9110_obj.L9110_ramp_motor(FORWARD, 10);
+    ASSERT_EQ(1u, l9110_obj.L9110_ramp_step(100.00, updates));
+    l9110_obj.L9110_ramp_ack();
+
+    /* Ramp to STOP - The write fails */
+    l9110_obj.L9110_ramp_motor(STOP);
+    ASSERT_EQ(1u, l9110_obj.L9110_ramp_step(100.00, updates));
+    EXPECT_DOUBLE_EQ(0.00, updates[0].duty_cycle);
+
+    /* Sent again until acked */
+    ASSERT_EQ(1u, l9110_obj.L9110_ramp_step(100.00, updates));
+    EXPECT_EQ(CHANNEL_1, updates[0].channel);
+    EXPECT_DOUBLE_EQ(0.00, updates[0].duty_cycle);
+    l9110_obj.L9110_ramp_ack();
+
+    ASSERT_EQ(0u, l9110_obj.L9110_ramp_step(100.00, updates));
+}
+
+TEST_F(L9110_Test_Fixture, VerifyRampSimMode)
+{
+   /*!
+    *  @test Verify L9110_ramp_step
+    *  No updates are produced in Sim Mode
+    */
+
+    PCA9685_pwm_update updates[L9110_MAX_UPDATES];
+
+    hw_config.hw_sim_mode = true;
+    L9110 l9110_obj(hw_config);
+
+    l9110_obj.L9110_ramp_motor(FORWARD, 50);
+    ASSERT_EQ(0u, l9110_obj.L9110_ramp_step(100.00, updates));
+}
+
+TEST_F(L9110_Test_Fixture, VerifyRampSchedulerTick)
+{
+   /*!
+    *  @test Verify L9110_ramp_scheduler::tick
+    *  Both motors step into one batch, idle ticks collect nothing and
+    *  the scheduler writes nothing itself
+    */
+
+    PCA9685_pwm_update updates[2 * L9110_MAX_UPDATES];
+    unsigned int count = 1;
+
+    RSXA_hw hw_config1 = hw_config;
+    hw_config1.hw_interface = (RSXA_pins *)malloc(sizeof(RSXA_pins) * 2);
+    hw_config1.array_len_hw_int = 2;
+    hw_config1.hw_interface[0].pin_name = name("forward");
+    hw_config1.hw_interface[1].pin_name = name("reverse");
+    hw_config1.hw_interface[0].pin_no = 3;
+    hw_config1.hw_interface[1].pin_no = 4;
+
+    EXPECT_CALL(pca9685mock, PCA9685_setPWM(_, _, _)).Times(4);
+    L9110 left(hw_config);
+    L9110 right(hw_config1);
+
+    L9110_ramp_scheduler scheduler;
+    scheduler.attach_motor(&left);
+    scheduler.attach_motor(&right);
+
+    EXPECT_CALL(pca9685mock, PCA9685_setPWM_batch(_, _)).Times(0);
+
+    /* Idle - Nothing to write */
+    ASSERT_EQ(OK, scheduler.tick(updates, &count));
+    ASSERT_EQ(0u, count);
+
+    /* Both motors move - One batch */
+    left.L9110_ramp_motor(FORWARD);
+    right.L9110_ramp_motor(REVERSE);
+    ASSERT_EQ(OK, scheduler.tick(updates, &count));
+    ASSERT_EQ(2u, count);
+    EXPECT_NE(updates[0].channel, updates[1].channel);
+
+    free(hw_config1.hw_interface);
+}
+
+TEST_F(L9110_Test_Fixture, VerifyRampSchedulerHalt)
+{
+   /*!
+    *  @test Verify L9110_ramp_scheduler::halt
+    *  The ramp is dropped and does not resume
+    */
+
+    PCA9685_pwm_update updates[L9110_MAX_UPDATES];
+    unsigned int count = 1;
+
+    EXPECT_CALL(pca9685mock, PCA9685_setPWM(_, _, _)).Times(2);
+    L9110 motor(hw_config);
+
+    L9110_ramp_scheduler scheduler;
+    scheduler.attach_motor(&motor);
+
+    /* Driving Forward */
+    motor.L9110_ramp_motor(FORWARD, 50);
+    ASSERT_EQ(1, motor.L9110_ramp_step(100.00, updates));
+
+    /* The caller forces the channels off */
+    EXPECT_CALL(pca9685mock, PCA9685_stop_all()).Times(0);
+    scheduler.halt();
+
+    /* Ramp state was dropped - Nothing to write */
+    ASSERT_EQ(OK, scheduler.tick(updates, &count));
+    ASSERT_EQ(0u, count);
+
+    /* A reversal still waits out the dead time */
+    motor.L9110_ramp_motor(REVERSE, 50);
+    ASSERT_EQ(0, motor.L9110_ramp_step(100.00, updates));
+}
+
+TEST_F(L9110_Test_Fixture, VerifyReconfigure)
+{
+   /*!
+    *  @test Verify L9110_reconfigure
+    *  A moving motor moves to its new channel at the same speed
+    *  and a missing pin changes nothing
+    */
+
+    L9110_ramp_settings ramp = {100.00, 100.00};
+    PCA9685_pwm_update updates[L9110_MAX_UPDATES];
+
+    EXPECT_CALL(pca9685mock, PCA9685_setPWM(_, _, _)).Times(2);
+    L9110 l9110_obj(hw_config, ramp);
+
+    /* Driving Forward at 10% on CHANNEL_1 */
+    l9110_obj.L9110_ramp_motor(FORWARD, 10);
+    ASSERT_EQ(1u, l9110_obj.L9110_ramp_step(100.00, updates));
+    l9110_obj.L9110_ramp_ack();
+
+    /* Forward moves to CHANNEL_3 - Only the old channel is turned off */
+    hw_config.hw_interface[0].pin_no = 3;
+    EXPECT_CALL(pca9685mock, PCA9685_setPWM(0.00, _, CHANNEL_1)).Times(1).WillOnce(Return(OK));
+    ASSERT_EQ(OK, l9110_obj.L9110_reconfigure(hw_config));
+
+    /* The next step drives the new channel at the same speed */
+    ASSERT_EQ(1u, l9110_obj.L9110_ramp_step(100.00, updates));
+    EXPECT_EQ(CHANNEL_3, updates[0].channel);
+    EXPECT_DOUBLE_EQ(10.00, updates[0].duty_cycle);
+    l9110_obj.L9110_ramp_ack();
+
+    /* Missing pin */
+    hw_config.hw_interface[1].pin_name = name("Test1");
+    EXPECT_CALL(pca9685mock, PCA9685_setPWM(_, _, _)).Times(0);
+    ASSERT_EQ(NOK, l9110_obj.L9110_reconfigure(hw_config));
+    ASSERT_EQ(0u, l9110_obj.L9110_ramp_step(100.00, updates));
+}
+
 int main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
     MyEnvironment* env = new MyEnvironment(); 
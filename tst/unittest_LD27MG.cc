@@ -54,21 +54,29 @@ class LD27MG_Test_Fixture : public ::testing::Test
        NMT_result result;
        RSXA_hw hw_config;
 
+       struct RSXA_strtab *strings = RSXA_strtab_new(16, 256);
+
        LD27MG_Test_Fixture()
        {
            this->hw_settings = {0};
            this->result = OK;
 
            hw_config = {0};
-           strcpy(hw_config.hw_name, "CAMERA_MOTORS");
+           hw_config.strings = strings;
+           hw_config.hw_name = name("CAMERA_MOTORS");
            hw_config.hw_sim_mode = false;
            hw_config.hw_interface = (RSXA_pins *)malloc(sizeof(RSXA_pins) * 2);
-           strcpy(hw_config.hw_interface[0].pin_name, "CAM_HRZN_MTR");
-           strcpy(hw_config.hw_interface[1].pin_name, "CAM_VERT_MTR");
+           hw_config.array_len_hw_int = 2;
+           hw_config.hw_interface[0].pin_name = name("CAM_HRZN_MTR");
+           hw_config.hw_interface[1].pin_name = name("CAM_VERT_MTR");
            hw_config.hw_interface[0].pin_no = 1;
            hw_config.hw_interface[1].pin_no = 2;
        }
 
+       ~LD27MG_Test_Fixture() {RSXA_strtab_free(strings);}
+
+       RSXA_str name(const char *str) {return RSXA_intern(strings, str, strlen(str));}
+
        void LD27MG_Init_Test()
        {
             EXPECT_CALL(PCA9685mock, PCA9685_setPWM(_, _, _))
@@ -218,6 +226,27 @@ TEST_F(LD27MG_Test_Fixture, Verify_get_duty_cycle)
     }
 }
 
+TEST_F(LD27MG_Test_Fixture, VerifyStageMove)
+{
+   /*!
+    *  @test Verify LD27MG_stage_move fills in the channel
+    *  update without writing to the PCA9685
+    */
+
+    /* Initialize Variables */
+    PCA9685_pwm_update update;
+    double precison = 0.0001;
+
+    EXPECT_CALL(PCA9685mock, PCA9685_setPWM(_, _, _)).Times(0);
+    EXPECT_CALL(PCA9685mock, PCA9685_get_curret_freq())
+        .Times(1)
+        .WillOnce(Return(LD27MG_FREQ));
+    ASSERT_EQ(1, LD27MG_stage_move(CAM_VERT_MTR, 50, &update));
+    ASSERT_EQ(CHANNEL_2, update.channel);
+    ASSERT_NEAR(4.35185, update.duty_cycle, precison);
+    ASSERT_EQ(0, update.delay_time);
+}
+
 TEST_F(LD27MG_Test_Fixture, VerifyInit)
 {
    /*!
@@ -299,6 +328,40 @@ TEST_F(LD27MG_Test_Fixture, InitBW3)
     ASSERT_EQ(result, LD27MG_init(hw_config));
 }
 
+TEST_F(LD27MG_Test_Fixture, VerifyReconfigure)
+{
+   /*!
+    *  @test Verify LD27MG_reconfigure moves a motor to its new
+    *  channel at the same angle without homing the other one,
+    *  and a missing pin changes nothing
+    */
+
+    /* Initialize Variables */
+    PCA9685_pwm_update update;
+    double duty_cycle = 4.35185;
+
+    LD27MG_Init_Test();
+
+    /* CAM_HRZN_MTR moves to CHANNEL_3 */
+    hw_config.hw_interface[0].pin_no = 3;
+    EXPECT_CALL(PCA9685mock, PCA9685_getPWM(_, CHANNEL_1))
+        .WillOnce(DoAll(SetArgPointee<0>(duty_cycle), Return(OK)));
+    EXPECT_CALL(PCA9685mock, PCA9685_setPWM(duty_cycle, _, CHANNEL_3)).Times(1);
+    EXPECT_CALL(PCA9685mock, PCA9685_setPWM(0.00, _, CHANNEL_1)).Times(1);
+    ASSERT_EQ(OK, LD27MG_reconfigure(hw_config));
+
+    EXPECT_CALL(PCA9685mock, PCA9685_get_curret_freq())
+        .WillOnce(Return(LD27MG_FREQ));
+    ASSERT_EQ(1, LD27MG_stage_move(CAM_HRZN_MTR, 50, &update));
+    ASSERT_EQ(CHANNEL_3, update.channel);
+
+    /* Missing pin */
+    hw_config.hw_interface[1].pin_name = name("Test1");
+    EXPECT_CALL(PCA9685mock, PCA9685_getPWM(_, _)).Times(0);
+    EXPECT_CALL(PCA9685mock, PCA9685_setPWM(_, _, _)).Times(0);
+    ASSERT_EQ(NOK, LD27MG_reconfigure(hw_config));
+}
+
 int main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
     MyEnvironment* env = new MyEnvironment(); 
@@ -0,0 +1,514 @@
+/**
+ *  @file      unittest_NMT_sock.cc
+ *  @brief     Unittests for NMT_sock.cpp
+ *  @details   Unittests for the NMT_reactor event loop, the multicast
+ *             batch I/O and the io_uring, unix and shared memory
+ *             transports
+ *  @author    Nitin Mohan
+ *  @date      April 14, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <malloc.h>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <string>
+#include <chrono>
+#include <utility>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "NMT_sock.hpp"
+#include "NMT_uring.hpp"
+#include "NMT_log.h"
+
+/* @class MyEnvironment
+ *  Environment Setup for Test */
+class MyEnvironment: public ::testing::Environment
+{
+public:
+  virtual ~MyEnvironment() = default;
+
+  virtual void SetUp() {NMT_log_init((char *)"/tmp/", false);}
+
+  virtual void TearDown() {NMT_log_finish();}
+};
+
+/* ---- Start of Tests -------------*/
+using namespace testing;
+using namespace std::chrono;
+
+TEST(NMT_reactor_Test, VerifyTimer)
+{
+   /*!
+    *  @test Verify a timer fires periodically until stopped
+    */
+    NMT_reactor reactor;
+    int ticks = 0;
+
+    ASSERT_EQ(OK, reactor.NMT_get_result());
+    ASSERT_GE(reactor.NMT_add_timer(milliseconds(5), [&](uint64_t expirations) {
+        ticks += expirations;
+        if (ticks >= 3) {reactor.NMT_stop();}
+    }), 0);
+
+    ASSERT_EQ(OK, reactor.NMT_run());
+    ASSERT_GE(ticks, 3);
+}
+
+TEST(NMT_reactor_Test, VerifyEventAndFd)
+{
+   /*!
+    *  @test Verify events coalesce into one dispatch and fds are
+    *  dispatched when readable
+    */
+    NMT_reactor reactor;
+    uint64_t notified = 0;
+    int fds[2];
+    char data = 0;
+
+    ASSERT_EQ(0, pipe(fds));
+
+    int event = reactor.NMT_add_event([&](uint64_t count) {notified += count;});
+    ASSERT_GE(event, 0);
+    ASSERT_EQ(OK, reactor.NMT_add_fd(fds[0], EPOLLIN, [&](uint64_t events) {
+        ASSERT_TRUE(events & EPOLLIN);
+        ASSERT_EQ(1, read(fds[0], &data, 1));
+    }));
+
+    /* Nothing ready */
+    ASSERT_EQ(OK, reactor.NMT_run_once(0));
+    ASSERT_EQ(0u, notified);
+
+    ASSERT_EQ(OK, reactor.NMT_notify(event));
+    ASSERT_EQ(OK, reactor.NMT_notify(event));
+    ASSERT_EQ(1, write(fds[1], "x", 1));
+    ASSERT_EQ(OK, reactor.NMT_run_once(100));
+    ASSERT_EQ(2u, notified);
+    ASSERT_EQ('x', data);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(NMT_reactor_Test, VerifyAddFromHandler)
+{
+   /*!
+    *  @test Verify a handler can register more fds while it runs and
+    *  the new ones are dispatched on the next round
+    */
+    struct
+    {
+        NMT_reactor reactor;
+        std::vector<int> events;
+        int fired = 0;
+    } ctx;
+
+    /* Captures one reference, so the handler is stored in its entry */
+    int first = ctx.reactor.NMT_add_event([&ctx](uint64_t) {
+        for (int i = 0; i < 64; i++)
+            ctx.events.push_back(ctx.reactor.NMT_add_event([&ctx](uint64_t) {ctx.fired++;}));
+
+        /* Still running from the same entry */
+        for (int event : ctx.events) {ctx.reactor.NMT_notify(event);}
+    });
+
+    ASSERT_GE(first, 0);
+    ASSERT_EQ(OK, ctx.reactor.NMT_notify(first));
+    ASSERT_EQ(OK, ctx.reactor.NMT_run_once(100));
+    ASSERT_EQ(64u, ctx.events.size());
+
+    while (ctx.fired < 64) {ASSERT_EQ(OK, ctx.reactor.NMT_run_once(100));}
+}
+
+TEST(NMT_reactor_Test, VerifyStopFromThread)
+{
+   /*!
+    *  @test Verify NMT_stop wakes up a blocked NMT_run
+    */
+    NMT_reactor reactor;
+
+    std::thread stopper([&]() {
+        std::this_thread::sleep_for(milliseconds(20));
+        reactor.NMT_stop();
+    });
+
+    ASSERT_EQ(OK, reactor.NMT_run());
+    stopper.join();
+}
+
+TEST(NMT_sock_multicast_Test, VerifyReadBatchDrain)
+{
+   /*!
+    *  @test Verify a batch read drains what is queued (at most
+    *  NMT_SOCK_MAX_BATCH per call) without waiting to fill every slot,
+    *  and flags a datagram larger than its slot truncated
+    */
+    const unsigned int total = NMT_SOCK_MAX_BATCH + 8;
+    NMT_sock_multicast server_sock(5614, "239.255.0.14", SOCK_SERVER);
+    NMT_sock_multicast client_sock(5614, "239.255.0.14", SOCK_CLIENT, 1);
+    std::string payloads[total];
+    NMT_sock_msg tx[total];
+    char rx_pool[total + 4][16];
+    NMT_sock_msg rx[total + 4];
+    unsigned int count = 1;
+
+    ASSERT_EQ(OK, server_sock.NMT_get_result());
+    ASSERT_EQ(OK, client_sock.NMT_get_result());
+
+    for (unsigned int i = 0; i < total; i++)
+    {
+        payloads[i] = (i == 5 ? std::string(40, 'x') : "msg" + std::to_string(i));
+        tx[i] = {&payloads[i][0], payloads[i].size(), payloads[i].size(), false};
+    }
+
+    for (unsigned int i = 0; i < total + 4; i++)
+        rx[i] = {rx_pool[i], sizeof(rx_pool[i]), 0, false};
+
+    /* Nothing queued - Returns at once */
+    ASSERT_EQ(NOK, client_sock.NMT_read_socket_batch(rx, total + 4, &count, false));
+    ASSERT_EQ(0u, count);
+
+    /* Takes more than one sendmmsg call */
+    ASSERT_EQ(OK, server_sock.NMT_write_socket_batch(tx, total));
+
+    struct pollfd pfd = {client_sock.NMT_get_fd(), POLLIN, 0};
+    ASSERT_EQ(1, poll(&pfd, 1, 1000));
+    std::this_thread::sleep_for(milliseconds(50));
+
+    /* One call moves at most NMT_SOCK_MAX_BATCH */
+    ASSERT_EQ(OK, client_sock.NMT_read_socket_batch(rx, total + 4, &count));
+    ASSERT_EQ(NMT_SOCK_MAX_BATCH, count);
+
+    /* MSG_WAITFORONE - 8 queued for 12 slots comes back without the timeout */
+    auto start = steady_clock::now();
+    ASSERT_EQ(OK, client_sock.NMT_read_socket_batch(&rx[NMT_SOCK_MAX_BATCH], 12, &count));
+    ASSERT_EQ(8u, count);
+    ASSERT_LT(steady_clock::now() - start, milliseconds(500));
+
+    for (unsigned int i = 0; i < total; i++)
+    {
+        if (i == 5)
+            continue;
+        ASSERT_STREQ(payloads[i].c_str(), rx[i].buffer);
+        ASSERT_EQ(payloads[i].size(), rx[i].length);
+        ASSERT_FALSE(rx[i].truncated);
+    }
+
+    ASSERT_TRUE(rx[5].truncated);
+    ASSERT_EQ(sizeof(rx_pool[5]) - 1, rx[5].length);
+    ASSERT_EQ(std::string(15, 'x'), rx[5].buffer);
+
+    /* Drained */
+    ASSERT_EQ(NOK, client_sock.NMT_read_socket_batch(rx, 1, &count, false));
+}
+
+TEST(NMT_sock_multicast_Test, VerifyWriteBatchResume)
+{
+   /*!
+    *  @test Verify a batch write carries on after a partial sendmmsg.
+    *  The datagrams before one the kernel refuses still go out, and
+    *  the resumed call reports the failure.
+    */
+    NMT_sock_multicast server_sock(5615, "239.255.0.15", SOCK_SERVER);
+    NMT_sock_multicast client_sock(5615, "239.255.0.15", SOCK_CLIENT, 1);
+    std::string payloads[4] = {"one", "two", std::string(70000, 'x'), "four"};
+    NMT_sock_msg tx[4];
+    char rx_pool[4][16];
+    NMT_sock_msg rx[4];
+    unsigned int count    = 0;
+    unsigned int received = 0;
+
+    ASSERT_EQ(OK, server_sock.NMT_get_result());
+    ASSERT_EQ(OK, client_sock.NMT_get_result());
+
+    for (int i = 0; i < 4; i++)
+    {
+        tx[i] = {&payloads[i][0], payloads[i].size(), payloads[i].size(), false};
+        rx[i] = {rx_pool[i], sizeof(rx_pool[i]), 0, false};
+    }
+
+    /* Too large for a UDP datagram */
+    ASSERT_EQ(NOK, server_sock.NMT_write_socket_batch(tx, 4));
+
+    while (client_sock.NMT_read_socket_batch(&rx[received], 4 - received, &count) == OK)
+        received += count;
+
+    ASSERT_EQ(2u, received);
+    ASSERT_STREQ("one", rx[0].buffer);
+    ASSERT_STREQ("two", rx[1].buffer);
+}
+
+TEST(NMT_sock_multicast_Test, VerifyReadSocket)
+{
+   /*!
+    *  @test Verify a full-size datagram is read whole into an
+    *  allocation of its own size, and a reused caller buffer takes
+    *  the next datagrams with the truncated flag set per read
+    */
+    NMT_sock_multicast server_sock(5616, "239.255.0.16", SOCK_SERVER);
+    NMT_sock_multicast client_sock(5616, "239.255.0.16", SOCK_CLIENT, 1);
+    std::string big(NMT_SOCK_MAX_MSG, 'y');
+    std::string payloads[3] = {big, std::string(40, 'x'), "small"};
+    NMT_sock_msg tx[3];
+    char rx_buffer[16];
+    NMT_sock_msg rx = {rx_buffer, sizeof(rx_buffer), 0, false};
+    char *message = NULL;
+
+    ASSERT_EQ(OK, server_sock.NMT_get_result());
+    ASSERT_EQ(OK, client_sock.NMT_get_result());
+
+    for (int i = 0; i < 3; i++)
+        tx[i] = {&payloads[i][0], payloads[i].size(), payloads[i].size(), false};
+
+    ASSERT_EQ(OK, server_sock.NMT_write_socket_batch(tx, 3));
+
+    /* Exact size - No fixed buffer to overrun */
+    ASSERT_EQ(OK, client_sock.NMT_read_socket(&message));
+    ASSERT_EQ(big.size(), strlen(message));
+    ASSERT_EQ(big, message);
+    ASSERT_LT(malloc_usable_size(message), big.size() + 64);
+    free(message);
+
+    ASSERT_EQ(OK, client_sock.NMT_read_socket(&rx));
+    ASSERT_TRUE(rx.truncated);
+    ASSERT_EQ(sizeof(rx_buffer) - 1, rx.length);
+
+    ASSERT_EQ(OK, client_sock.NMT_read_socket(&rx));
+    ASSERT_FALSE(rx.truncated);
+    ASSERT_EQ(5u, rx.length);
+    ASSERT_STREQ("small", rx.buffer);
+
+    /* Nothing left */
+    ASSERT_EQ(NOK, client_sock.NMT_read_socket(&rx));
+    ASSERT_EQ(0u, rx.length);
+}
+
+TEST(NMT_uring_Test, VerifyReadBatch)
+{
+   /*!
+    *  @test Verify datagrams sent on the group are read through the
+    *  transport fd (io_uring, or the socket when it is not available)
+    */
+    NMT_sock_multicast server_sock(5611, "239.255.0.11", SOCK_SERVER);
+    NMT_sock_multicast client_sock(5611, "239.255.0.11", SOCK_CLIENT, 1);
+    NMT_uring_transport transport(client_sock);
+    std::string payloads[3] = {"one", "two", "three"};
+    NMT_sock_msg tx[3];
+    char rx_pool[3][64];
+    NMT_sock_msg rx[3];
+    unsigned int received = 0;
+
+    ASSERT_EQ(OK, server_sock.NMT_get_result());
+    ASSERT_EQ(OK, client_sock.NMT_get_result());
+
+    for (int i = 0; i < 3; i++)
+    {
+        tx[i] = {&payloads[i][0], payloads[i].size(), payloads[i].size(), false};
+        rx[i] = {rx_pool[i], sizeof(rx_pool[i]), 0, false};
+    }
+
+    /* Nothing sent yet */
+    unsigned int count = 1;
+    ASSERT_EQ(NOK, transport.NMT_read_batch(rx, 3, &count, false));
+    ASSERT_EQ(0u, count);
+
+    ASSERT_EQ(OK, server_sock.NMT_write_socket_batch(tx, 3));
+
+    while (received < 3)
+    {
+        struct pollfd pfd = {transport.NMT_get_fd(), POLLIN, 0};
+        ASSERT_EQ(1, poll(&pfd, 1, 1000));
+        ASSERT_EQ(OK, transport.NMT_read_batch(&rx[received], 3 - received, &count, false));
+        received += count;
+    }
+
+    /* Receive time - From the kernel, or the reap with io_uring */
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    for (int i = 0; i < 3; i++)
+    {
+        ASSERT_STREQ(payloads[i].c_str(), rx[i].buffer);
+        ASSERT_FALSE(rx[i].truncated);
+        ASSERT_NE(0, rx[i].rx_time.tv_sec);
+        ASSERT_LE(rx[i].rx_time.tv_sec, now.tv_sec);
+        ASSERT_GE(rx[i].rx_time.tv_sec + 5, now.tv_sec);
+    }
+}
+
+TEST(NMT_uring_Test, VerifyMulticastMove)
+{
+   /*!
+    *  @test Verify a moved multicast socket hands over its fd, the
+    *  moved from one is left without it and the fd is closed once
+    */
+    NMT_sock_multicast server_sock(5613, "239.255.0.13", SOCK_SERVER);
+    int fd = server_sock.NMT_get_fd();
+    ASSERT_EQ(OK, server_sock.NMT_get_result());
+
+    {
+        NMT_sock_multicast moved(std::move(server_sock));
+        ASSERT_EQ(fd, moved.NMT_get_fd());
+        ASSERT_EQ(OK, moved.NMT_get_result());
+        ASSERT_EQ(-1, server_sock.NMT_get_fd());
+        ASSERT_EQ(NOK, server_sock.NMT_get_result());
+        ASSERT_EQ(OK, moved.NMT_write_message("moved"));
+    }
+
+    /* Closed by the owner only */
+    ASSERT_EQ(-1, fcntl(fd, F_GETFD));
+}
+
+TEST(NMT_uring_Test, VerifyWriteAndTruncate)
+{
+   /*!
+    *  @test Verify sends from the transport loop back, and that a
+    *  datagram larger than the caller buffer is flagged truncated
+    */
+    NMT_sock_multicast server_sock(5612, "239.255.0.12", SOCK_SERVER);
+    NMT_sock_multicast client_sock(5612, "239.255.0.12", SOCK_CLIENT, 1);
+    NMT_uring_transport transport(client_sock, server_sock);
+    std::string big(100, 'x');
+    std::string small = "ack";
+    NMT_sock_msg tx[2] = {{&small[0], small.size(), small.size(), false},
+                          {&big[0], big.size(), big.size(), false}};
+    char rx_pool[2][16];
+    NMT_sock_msg rx[2] = {{rx_pool[0], sizeof(rx_pool[0]), 0, false},
+                          {rx_pool[1], sizeof(rx_pool[1]), 0, false}};
+    unsigned int count    = 0;
+    unsigned int received = 0;
+
+    ASSERT_EQ(OK, transport.NMT_write_batch(tx, 2));
+
+    while (received < 2)
+    {
+        ASSERT_EQ(OK, transport.NMT_read_batch(&rx[received], 2 - received, &count));
+        received += count;
+    }
+
+    ASSERT_STREQ("ack", rx[0].buffer);
+    ASSERT_FALSE(rx[0].truncated);
+    ASSERT_EQ(sizeof(rx_pool[1]) - 1, rx[1].length);
+    ASSERT_TRUE(rx[1].truncated);
+}
+
+TEST(NMT_sock_local_Test, VerifyUnixSeqpacket)
+{
+   /*!
+    *  @test Verify messages keep their boundaries over the unix
+    *  transport, and the writer reconnects after the reader restarts
+    */
+    std::unique_ptr<NMT_sock_unix> reader(new NMT_sock_unix(5631, SOCK_CLIENT, 1));
+    NMT_sock_unix writer(5631, SOCK_SERVER, 1);
+    std::string payloads[2] = {"first", std::string(100, 'y')};
+    NMT_sock_msg tx[2] = {{&payloads[0][0], payloads[0].size(), payloads[0].size(), false},
+                          {&payloads[1][0], payloads[1].size(), payloads[1].size(), false}};
+    char rx_pool[2][32];
+    NMT_sock_msg rx[2] = {{rx_pool[0], sizeof(rx_pool[0]), 0, false},
+                          {rx_pool[1], sizeof(rx_pool[1]), 0, false}};
+    unsigned int count    = 0;
+    unsigned int received = 0;
+
+    ASSERT_EQ(OK, reader->NMT_get_result());
+    ASSERT_EQ(OK, writer.NMT_write_batch(tx, 2));
+
+    while (received < 2)
+    {
+        ASSERT_EQ(OK, reader->NMT_read_batch(&rx[received], 2 - received, &count));
+        received += count;
+    }
+
+    ASSERT_STREQ("first", rx[0].buffer);
+    ASSERT_FALSE(rx[0].truncated);
+    ASSERT_NE(0, rx[0].rx_time.tv_sec);
+    ASSERT_EQ(sizeof(rx_pool[1]) - 1, rx[1].length);
+    ASSERT_TRUE(rx[1].truncated);
+
+    /* Reader restarts - The first write notices, the next one reconnects */
+    reader.reset(new NMT_sock_unix(5631, SOCK_CLIENT, 1));
+    writer.NMT_write_message("lost");
+    ASSERT_EQ(OK, writer.NMT_write_message("again"));
+    ASSERT_EQ(OK, reader->NMT_read_batch(rx, 1, &count));
+    ASSERT_STREQ("again", rx[0].buffer);
+}
+
+TEST(NMT_sock_local_Test, VerifyShmRing)
+{
+   /*!
+    *  @test Verify the shared memory ring wraps around, rings the
+    *  doorbell only when the reader is idle and drops on overflow
+    */
+    NMT_sock_shm reader(5632, SOCK_CLIENT, 1);
+    NMT_sock_shm writer(5632, SOCK_SERVER, 1);
+    char tx_pool[NMT_SHM_SLOTS + 1][16];
+    NMT_sock_msg tx[NMT_SHM_SLOTS + 1];
+    char rx_pool[NMT_SHM_SLOTS][16];
+    NMT_sock_msg rx[NMT_SHM_SLOTS];
+    unsigned int count = 0;
+
+    ASSERT_EQ(OK, reader.NMT_get_result());
+    ASSERT_EQ(OK, writer.NMT_get_result());
+
+    for (unsigned int i = 0; i < NMT_SHM_SLOTS + 1; i++)
+    {
+        size_t length = snprintf(tx_pool[i], sizeof(tx_pool[i]), "msg%u", i);
+        tx[i] = {tx_pool[i], sizeof(tx_pool[i]), length, false};
+    }
+    for (unsigned int i = 0; i < NMT_SHM_SLOTS; i++)
+        rx[i] = {rx_pool[i], sizeof(rx_pool[i]), 0, false};
+
+    /* Idle reader - Nothing to read, nothing on the doorbell */
+    struct pollfd pfd = {reader.NMT_get_fd(), POLLIN, 0};
+    ASSERT_EQ(NOK, reader.NMT_read_batch(rx, 1, &count, false));
+    ASSERT_EQ(0, poll(&pfd, 1, 0));
+
+    /* Several laps around the ring */
+    for (unsigned int lap = 0; lap < 3; lap++)
+    {
+        ASSERT_EQ(OK, writer.NMT_write_batch(tx, 5));
+        ASSERT_EQ(1, poll(&pfd, 1, 1000));
+        ASSERT_EQ(OK, reader.NMT_read_batch(rx, NMT_SHM_SLOTS, &count, false));
+        ASSERT_EQ(5u, count);
+        ASSERT_STREQ("msg4", rx[4].buffer);
+        ASSERT_EQ(4u, rx[4].length);
+        ASSERT_NE(0, rx[4].rx_time.tv_sec);
+    }
+
+    /* A full ring drops the overflow */
+    ASSERT_EQ(NOK, writer.NMT_write_batch(tx, NMT_SHM_SLOTS + 1));
+    ASSERT_EQ(OK, reader.NMT_read_batch(rx, NMT_SHM_SLOTS, &count));
+    ASSERT_EQ(NMT_SHM_SLOTS, count);
+    ASSERT_STREQ("msg0", rx[0].buffer);
+}
+
+TEST(NMT_sock_local_Test, VerifyTransportOpen)
+{
+   /*!
+    *  @test Verify the transport named in RSXA procs is opened
+    */
+    ASSERT_NE(nullptr, dynamic_cast<NMT_sock_multicast *>(NMT_sock_open("", 5633, "239.255.0.33", SOCK_SERVER).get()));
+    ASSERT_NE(nullptr, dynamic_cast<NMT_sock_multicast *>(NMT_sock_open("udp", 5633, "239.255.0.33", SOCK_SERVER).get()));
+    ASSERT_NE(nullptr, dynamic_cast<NMT_sock_unix *>(NMT_sock_open("unix", 5633, "", SOCK_SERVER).get()));
+    ASSERT_NE(nullptr, dynamic_cast<NMT_sock_shm *>(NMT_sock_open("shm", 5633, "", SOCK_SERVER).get()));
+    ASSERT_EQ(nullptr, NMT_sock_open("tcp", 5633, "", SOCK_SERVER));
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    MyEnvironment* env = new MyEnvironment();
+    ::testing::AddGlobalTestEnvironment(env);
+    return RUN_ALL_TESTS();
+}
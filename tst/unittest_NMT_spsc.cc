@@ -0,0 +1,100 @@
+/**
+ *  @file      unittest_NMT_spsc.cc
+ *  @brief     Unittests for NMT_spsc.hpp
+ *  @details   Unittests for the lock-free single producer/single consumer queue
+ *  @author    Nitin Mohan
+ *  @date      April 22, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <gtest/gtest.h>
+#include <thread>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "NMT_spsc.hpp"
+
+/* ---- Start of Tests -------------*/
+using namespace testing;
+
+TEST(NMT_spsc_Test, VerifyReservePublish)
+{
+   /*!
+    *  @test Verify reserved slots stay invisible until published, the
+    *  queue holds exactly Depth items and wraps around
+    */
+    NMT_spsc_queue<int, 4> queue;
+
+    ASSERT_EQ(nullptr, queue.NMT_front());
+
+    for (unsigned int lap = 0; lap < 3; lap++)
+    {
+        for (unsigned int i = 0; i < 4; i++)
+        {
+            int *slot = queue.NMT_reserve(i);
+            ASSERT_NE(nullptr, slot);
+            *slot = lap * 10 + i;
+        }
+        ASSERT_EQ(nullptr, queue.NMT_reserve(4));
+        ASSERT_EQ(nullptr, queue.NMT_front());
+
+        queue.NMT_publish(4);
+        ASSERT_EQ(nullptr, queue.NMT_reserve(0));
+        ASSERT_FALSE(queue.NMT_push(99));
+
+        for (unsigned int i = 0; i < 4; i++)
+        {
+            ASSERT_NE(nullptr, queue.NMT_front());
+            ASSERT_EQ((int)(lap * 10 + i), *queue.NMT_front());
+            queue.NMT_pop();
+        }
+        ASSERT_EQ(nullptr, queue.NMT_front());
+    }
+
+    /* A freed slot can be pushed into again */
+    ASSERT_TRUE(queue.NMT_push(7));
+    ASSERT_EQ(7, *queue.NMT_front());
+}
+
+TEST(NMT_spsc_Test, VerifyThreads)
+{
+   /*!
+    *  @test Verify every item crosses between two threads once and in
+    *  order while the queue keeps filling up
+    */
+    static NMT_spsc_queue<uint64_t, 64> queue;
+    const uint64_t items = 200000;
+    uint64_t expected = 0;
+
+    std::thread producer([&]() {
+        for (uint64_t i = 0; i < items; i++)
+        {
+            while (!queue.NMT_push(i)) {std::this_thread::yield();}
+        }
+    });
+
+    while (expected < items)
+    {
+        uint64_t *item = queue.NMT_front();
+        if (!item)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        /* Out of order - Stop here, the producer still has to be joined */
+        if (*item != expected)
+            break;
+
+        queue.NMT_pop();
+        expected++;
+    }
+
+    while (queue.NMT_front()) {queue.NMT_pop();}
+    producer.join();
+    ASSERT_EQ(items, expected);
+}
@@ -130,5 +130,27 @@ class NMT_sock_Test(unittest.TestCase):
         print ("Message from first client socket=%s"%message_rx)
         self.assertEqual("", message_rx)
 
+    def test_GWTest_local_tx_rx(self):
+
+        ##
+         # @test Test the same host transports (unix and shm) carry a message
+         # @step 1. Create a reader and a writer on the same port
+         # @step 2. Writer sends a message
+         # @step 3. Reader recieves the message that was sent
+         #
+
+        message_tx = "This is a test message"
+
+        for transport in [NMT_sock.NMT_sock_unix, NMT_sock.NMT_sock_shm]:
+            client_object = transport(MULTICAST_PORT, sock_mode.SOCK_CLIENT, TIMEOUT)
+            self.assertEqual(client_object.NMT_get_result(), NMT_result.OK)
+
+            server_object = transport(MULTICAST_PORT, sock_mode.SOCK_SERVER, TIMEOUT)
+            self.assertEqual(server_object.NMT_write_socket(message_tx), NMT_result.OK)
+
+            result, message_rx = client_object.NMT_read_socket()
+            self.assertEqual(result, NMT_result.OK)
+            self.assertEqual(message_tx, message_rx)
+
 if __name__ == '__main__':
     unittest.main()
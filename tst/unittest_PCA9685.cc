@@ -11,6 +11,7 @@
 /                   System Imports                  /
 /--------------------------------------------------*/
 #include <gtest/gtest.h>
+#include <cstring>
 
 /*--------------------------------------------------/
 /                   Local Imports                   /
@@ -350,6 +351,109 @@ TEST_F(PCA9685_Test_Fixture, TestsetPWM_MaxMin)
     }
 }
 
+TEST_F(PCA9685_Test_Fixture, TestsetPWMBatchGW)
+{
+   /*!
+    *  @test Call PCA9685_setPWM_batch and
+    *  verify adjacent channels are written as one block
+    *  @step Set sim_mode = false and verify one write per run of channels
+    *  @step Set sim_mode = true and verify not hardware actions are taken
+    */
+
+    /* Channels 10 & 11 are adjacent, 13 is on its own */
+    PCA9685_pwm_update updates[] = {{CHANNEL_11, 50, 0},
+                                    {CHANNEL_10, 0, 0},
+                                    {CHANNEL_13, 25, 0}};
+    int run_1_len = 1 + (2 * 4);
+    int run_2_len = 1 + (1 * 4);
+
+   EXPECT_CALL(wpimock, wiringPiI2CSetup(_))
+           .Times(1)
+           .WillOnce(Return(1));
+    EXPECT_CALL(wpimock, wiringPiI2CWriteReg8(_, _, _))
+            .Times(AtLeast(1));
+    hw_settings.sim_mode = false;
+    ASSERT_EQ(OK, PCA9685_init(hw_settings));
+
+    /* One write per run of adjacent channels */
+    EXPECT_CALL(wpimock, wiringPiI2CWriteReg16(_, _, _))
+            .Times(0);
+    EXPECT_CALL(wpimock, PCA9685_i2c_write_block(1, _, AnyOf(run_1_len, run_2_len)))
+            .Times(2)
+            .WillRepeatedly(ReturnArg<2>());
+    ASSERT_EQ(OK, PCA9685_setPWM_batch(updates, 3));
+
+    /* Nothing is written in sim mode */
+    hw_settings.sim_mode = true;
+    EXPECT_CALL(wpimock, PCA9685_i2c_write_block(_, _, _))
+            .Times(0);
+    ASSERT_EQ(OK, PCA9685_init(hw_settings));
+    ASSERT_EQ(OK, PCA9685_setPWM_batch(updates, 3));
+}
+
+TEST_F(PCA9685_Test_Fixture, TestsetPWMBatchBW)
+{
+   /*!
+    *  @test Call PCA9685_setPWM_batch and
+    *  verify result = NOK on an invalid channel or failed write
+    */
+
+    PCA9685_pwm_update bad_channel[] = {{(PCA9685_PWM_CHANNEL)16, 50, 0}};
+    PCA9685_pwm_update good_channel[] = {{CHANNEL_0, 50, 0}};
+
+   EXPECT_CALL(wpimock, wiringPiI2CSetup(_))
+           .Times(1)
+           .WillOnce(Return(1));
+    EXPECT_CALL(wpimock, wiringPiI2CWriteReg8(_, _, _))
+            .Times(AtLeast(1));
+    hw_settings.sim_mode = false;
+    ASSERT_EQ(OK, PCA9685_init(hw_settings));
+
+    /* Invalid Channel */
+    EXPECT_CALL(wpimock, PCA9685_i2c_write_block(_, _, _))
+            .Times(0);
+    ASSERT_EQ(NOK, PCA9685_setPWM_batch(bad_channel, 1));
+
+    /* Short Write */
+    EXPECT_CALL(wpimock, PCA9685_i2c_write_block(1, _, _))
+            .Times(1)
+            .WillOnce(Return(-1));
+    ASSERT_EQ(NOK, PCA9685_setPWM_batch(good_channel, 1));
+}
+
+TEST_F(PCA9685_Test_Fixture, TestStopAll)
+{
+   /*!
+    *  @test Call PCA9685_stop_all and verify a single write
+    *  sets the full-off bit through the ALL_LED registers
+    */
+
+    unsigned char expected[] = {0xFA, 0x00, 0x00, 0x00, 0x10};
+
+   EXPECT_CALL(wpimock, wiringPiI2CSetup(_))
+           .Times(1)
+           .WillOnce(Return(1));
+    EXPECT_CALL(wpimock, wiringPiI2CWriteReg8(_, _, _))
+            .Times(AtLeast(1));
+    hw_settings.sim_mode = false;
+    ASSERT_EQ(OK, PCA9685_init(hw_settings));
+
+    EXPECT_CALL(wpimock, PCA9685_i2c_write_block(1, _, (int)sizeof(expected)))
+            .Times(1)
+            .WillOnce(Invoke([&](int, const unsigned char *buf, int len) {
+                EXPECT_EQ(0, memcmp(expected, buf, len));
+                return len;
+            }));
+    ASSERT_EQ(OK, PCA9685_stop_all());
+
+    /* Nothing is written in sim mode */
+    hw_settings.sim_mode = true;
+    EXPECT_CALL(wpimock, PCA9685_i2c_write_block(_, _, _))
+            .Times(0);
+    ASSERT_EQ(OK, PCA9685_init(hw_settings));
+    ASSERT_EQ(OK, PCA9685_stop_all());
+}
+
 TEST_F(PCA9685_Test_Fixture, TestPCA9685GetPWMGW)
 {
    /*!
@@ -0,0 +1,172 @@
+/**
+ *  @file      unittest_RMCT_init.cc
+ *  @brief     Unittests for RMCT_init.cpp
+ *  @details   Unittests for the RMCT hardware bring-up graph
+ *  @author    Nitin Mohan
+ *  @date      May 31, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <stdexcept>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "RMCT_init.hpp"
+#include "NMT_log.h"
+
+/* @class MyEnvironment
+ *  Environment Setup for Test */
+class MyEnvironment: public ::testing::Environment
+{
+public:
+  virtual ~MyEnvironment() = default;
+
+  virtual void SetUp() {NMT_log_init((char *)"/tmp/", false);}
+
+  virtual void TearDown() {NMT_log_finish();}
+};
+
+/* ---- Start of Tests -------------*/
+using namespace testing;
+using namespace std::chrono;
+
+TEST(RMCT_init_Test, VerifyParallelBringUp)
+{
+   /*!
+    *  @test Verify children start once their parent is up, and
+    *  independent children come up side by side
+    */
+    RMCT_init_graph graph;
+    std::atomic<bool> parent_up(false);
+    std::atomic<int> early(0);
+
+    auto child = [&]() {
+        if (!parent_up) {early++;}
+        std::this_thread::sleep_for(milliseconds(100));
+        return OK;
+    };
+
+    ASSERT_EQ(OK, graph.add("PARENT", [&]() {
+        std::this_thread::sleep_for(milliseconds(20));
+        parent_up = true;
+        return OK;
+    }));
+    ASSERT_EQ(OK, graph.add("CHILD1", child, {"PARENT"}));
+    ASSERT_EQ(OK, graph.add("CHILD2", child, {"PARENT"}));
+    ASSERT_EQ(OK, graph.add("CHILD3", child, {"PARENT"}));
+
+    ASSERT_EQ(OK, graph.run());
+    ASSERT_EQ(0, early);
+
+    /* Bounded by the slowest chain (120ms), not the sum (320ms) */
+    EXPECT_LT(graph.elapsed_ms(), 250.00);
+
+    ASSERT_EQ(4u, graph.report().size());
+    for (const RMCT_init_report &device : graph.report())
+    {
+        EXPECT_EQ(OK, device.result);
+        EXPECT_TRUE(device.ran);
+        EXPECT_GE(device.ready_ms, device.init_ms);
+    }
+
+    EXPECT_EQ("CHILD2", graph.report()[2].name);
+    EXPECT_GE(graph.report()[2].init_ms, 100.00);
+    EXPECT_GE(graph.report()[2].ready_ms, graph.report()[0].ready_ms + 100.00);
+}
+
+TEST(RMCT_init_Test, VerifySingleWorker)
+{
+   /*!
+    *  @test Verify one worker brings the devices up on the caller
+    *  in dependency order
+    */
+    RMCT_init_graph graph;
+    std::thread::id caller = std::this_thread::get_id();
+    std::vector<int> order;
+
+    for (int i = 0; i < 4; i++)
+    {
+        std::string name = "DEV" + std::to_string(i);
+        std::string after = "DEV" + std::to_string(i - 1);
+
+        auto init = [&, i]() {
+            EXPECT_EQ(caller, std::this_thread::get_id());
+            order.push_back(i);
+            return OK;
+        };
+
+        if (i == 0)
+            ASSERT_EQ(OK, graph.add(name, init));
+        else
+            ASSERT_EQ(OK, graph.add(name, init, {after}));
+    }
+
+    ASSERT_EQ(OK, graph.run(1));
+    ASSERT_EQ(std::vector<int>({0, 1, 2, 3}), order);
+}
+
+TEST(RMCT_init_Test, VerifyFailureSkipsDependents)
+{
+   /*!
+    *  @test Verify a failed or throwing device skips the devices
+    *  that need it, and the rest still come up
+    */
+    RMCT_init_graph graph;
+    std::atomic<int> ran(0);
+
+    ASSERT_EQ(OK, graph.add("BAD", [&]() {ran++; return NOK;}));
+    ASSERT_EQ(OK, graph.add("THROWS", [&]() -> NMT_result {ran++; throw std::runtime_error("no device");}));
+    ASSERT_EQ(OK, graph.add("GOOD", [&]() {ran++; return OK;}));
+    ASSERT_EQ(OK, graph.add("NEEDS_BAD", [&]() {ran++; return OK;}, {"BAD", "GOOD"}));
+    ASSERT_EQ(OK, graph.add("NEEDS_THROWS", [&]() {ran++; return OK;}, {"THROWS"}));
+    ASSERT_EQ(OK, graph.add("GRANDCHILD", [&]() {ran++; return OK;}, {"NEEDS_BAD"}));
+
+    ASSERT_EQ(NOK, graph.run());
+    ASSERT_EQ(3, ran);
+
+    const std::vector<RMCT_init_report> &report = graph.report();
+    EXPECT_EQ(NOK, report[0].result);
+    EXPECT_EQ(NOK, report[1].result);
+    EXPECT_TRUE(report[1].ran);
+    EXPECT_EQ(OK,  report[2].result);
+
+    for (size_t i = 3; i < report.size(); i++)
+    {
+        EXPECT_EQ(NOK, report[i].result);
+        EXPECT_FALSE(report[i].ran);
+    }
+}
+
+TEST(RMCT_init_Test, VerifyBadGraph)
+{
+   /*!
+    *  @test Verify a repeated name or an unknown dependency fails
+    *  the run before any device is touched
+    */
+    RMCT_init_graph graph;
+    int ran = 0;
+
+    ASSERT_EQ(OK,  graph.add("DEV", [&]() {ran++; return OK;}));
+    ASSERT_EQ(NOK, graph.add("DEV", [&]() {ran++; return OK;}));
+    ASSERT_EQ(NOK, graph.add("CHILD", [&]() {ran++; return OK;}, {"LATER"}));
+    ASSERT_EQ(OK,  graph.add("LATER", [&]() {ran++; return OK;}));
+
+    ASSERT_EQ(NOK, graph.run());
+    ASSERT_EQ(0, ran);
+    ASSERT_EQ(2u, graph.report().size());
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    MyEnvironment* env = new MyEnvironment();
+    ::testing::AddGlobalTestEnvironment(env);
+    return RUN_ALL_TESTS();
+}
@@ -10,6 +10,7 @@
 /*--------------------------------------------------/
 /                   System Imports                  /
 /--------------------------------------------------*/ #include <gtest/gtest.h>
+#include <thread>
 
 /*--------------------------------------------------/
 /                   Local Imports                   /
@@ -18,8 +19,13 @@
 #include "NMT_log.h"
 #include "LD27MG_stub.h"
 #include "PCA9685_stub.h"
+#include "RMCT_backends_mock.h"
 #include "RMCT_lib.hpp"
 
+/* @typedef MockController
+ *  Controller on the gmock policies */
+typedef RobotMotorControllerT<PwmBackendMock, ServoPolicyMock, DrivePolicyMock> MockController;
+
 /* @class MyEnvironment
  *  Environment Setup for Test */
 class MyEnvironment: public ::testing::Environment
@@ -41,43 +47,57 @@ class RMCT_lib_Test_Fixture : public ::testing::Test
        RSXA_hw cam_config;
        RSXA_hw left_motor_config;
        RSXA_hw right_motor_config;
+
+       struct RSXA_strtab *strings = RSXA_strtab_new(16, 256);
        double angle_sensitivity = 10.00;
 
     RMCT_lib_Test_Fixture()
     {
         /* PCA9685 Driver Config */
-        strcpy(pca9685_config.hw_name, "PCA9685_PWM_DRIVER");
+        pca9685_config = {0};
+        pca9685_config.strings = strings;
+        pca9685_config.hw_name = name("PCA9685_PWM_DRIVER");
         pca9685_config.hw_sim_mode = true;
 
         /* Settings for Left Drive Motor */
         left_motor_config = {0};
-        strcpy(left_motor_config.hw_name, "LEFT_DRV_MOTOR");
+        left_motor_config.strings = strings;
+        left_motor_config.hw_name = name("LEFT_DRV_MOTOR");
         left_motor_config.hw_sim_mode = true;
         left_motor_config.hw_interface = (RSXA_pins *)malloc(sizeof(RSXA_pins) * 2);
-        strcpy(left_motor_config.hw_interface[0].pin_name, "forward");
-        strcpy(left_motor_config.hw_interface[1].pin_name, "reverse");
+        left_motor_config.array_len_hw_int = 2;
+        left_motor_config.hw_interface[0].pin_name = name("forward");
+        left_motor_config.hw_interface[1].pin_name = name("reverse");
         left_motor_config.hw_interface[0].pin_no = 1;
         left_motor_config.hw_interface[1].pin_no = 2;
 
         /* Settings for Right Drive Motor */
         right_motor_config = {0};
-        strcpy(left_motor_config.hw_name, "RIGHT_DRV_MTR");
+        right_motor_config.strings = strings;
+        right_motor_config.hw_name = name("RIGHT_DRV_MTR");
         right_motor_config.hw_sim_mode = true;
         right_motor_config.hw_interface = (RSXA_pins *)malloc(sizeof(RSXA_pins) * 2);
-        strcpy(right_motor_config.hw_interface[0].pin_name, "forward");
-        strcpy(right_motor_config.hw_interface[1].pin_name, "reverse");
+        right_motor_config.array_len_hw_int = 2;
+        right_motor_config.hw_interface[0].pin_name = name("forward");
+        right_motor_config.hw_interface[1].pin_name = name("reverse");
         right_motor_config.hw_interface[0].pin_no = 1;
         right_motor_config.hw_interface[1].pin_no = 2;
 
        cam_config = {0};
-       strcpy(cam_config.hw_name, "CAMERA_MOTORS");
+       cam_config.strings = strings;
+       cam_config.hw_name = name("CAMERA_MOTORS");
        cam_config.hw_sim_mode = false;
        cam_config.hw_interface = (RSXA_pins *)malloc(sizeof(RSXA_pins) * 2);
-       strcpy(cam_config.hw_interface[0].pin_name, "CAM_HRZN_MTR");
-       strcpy(cam_config.hw_interface[1].pin_name, "CAM_VERT_MTR");
+       cam_config.array_len_hw_int = 2;
+       cam_config.hw_interface[0].pin_name = name("CAM_HRZN_MTR");
+       cam_config.hw_interface[1].pin_name = name("CAM_VERT_MTR");
        cam_config.hw_interface[0].pin_no = 1;
        cam_config.hw_interface[1].pin_no = 2;
     }
+
+    ~RMCT_lib_Test_Fixture() {RSXA_strtab_free(strings);}
+
+    RSXA_str name(const char *str) {return RSXA_intern(strings, str, strlen(str));}
 };
 
 /* ---- Start of Tests -------------*/
@@ -97,6 +117,11 @@ TEST_F(RMCT_lib_Test_Fixture, VerifyConstructorGW)
 
     /* Perform Action */
     RobotMotorController  obj(pca9685_config, cam_config, left_motor_config, right_motor_config);   
+
+    /* The PWM Driver, the Camera and both Drive Motors came up */
+    ASSERT_EQ(4u, obj.hw_init().report().size());
+    for (const RMCT_init_report &device : obj.hw_init().report())
+        EXPECT_EQ(OK, device.result) << device.name;
 }
 
 TEST_F(RMCT_lib_Test_Fixture, VerifyConstructorBW1)
@@ -112,6 +137,7 @@ TEST_F(RMCT_lib_Test_Fixture, VerifyConstructorBW1)
     EXPECT_CALL(pca9685mock, PCA9685_init(_)).Times(1)
         .WillOnce(Return(NOK));
     EXPECT_CALL(ld27mgmock, LD27MG_init(_)).Times(0);
+    EXPECT_CALL(pca9685mock, PCA9685_setPWM(_, _, _)).Times(0);
 
     /* Perform Action */
     try
@@ -358,8 +384,12 @@ TEST_F(RMCT_lib_Test_Fixture, VerifyMoveCameraGW8)
     /* Initialize */
     RobotMotorController obj(pca9685_config, cam_config, left_motor_config, right_motor_config);   
     
-    EXPECT_CALL(pwmstub, PCA9685_setPWM(_, _, _)).Times(2);
-    obj.process_motor_action("LEFT_DRV_MTR", "FORWARD", 0, 0);
+    /* Drive motors ramp - Nothing is written until the ramp ticks */
+    EXPECT_CALL(pwmstub, PCA9685_setPWM(_, _, _)).Times(0);
+    ASSERT_EQ(OK, obj.process_motor_action("LEFT_DRV_MTR", "FORWARD", 0, -1));
+
+    EXPECT_CALL(pwmstub, PCA9685_setPWM_batch(_, 1)).Times(1);
+    ASSERT_EQ(OK, obj.drive_ramp_tick());
 }
 
 TEST_F(RMCT_lib_Test_Fixture, VerifyMoveCameraGW9)
@@ -388,9 +418,341 @@ TEST_F(RMCT_lib_Test_Fixture, VerifyMoveCameraGW9)
     /* Initialize */
     RobotMotorController obj(pca9685_config, cam_config, left_motor_config, right_motor_config);   
     
-    EXPECT_CALL(pwmstub, PCA9685_setPWM(_, _, _)).Times(2);
-    obj.process_motor_action("RIGHT_DRV_MTR", "REVERSE", 0, 80);
+    /* Drive motors ramp - Nothing is written until the ramp ticks */
+    EXPECT_CALL(pwmstub, PCA9685_setPWM(_, _, _)).Times(0);
+    ASSERT_EQ(OK, obj.process_motor_action("RIGHT_DRV_MTR", "REVERSE", 0, 80));
+
+    EXPECT_CALL(pwmstub, PCA9685_setPWM_batch(_, 1)).Times(1);
+    ASSERT_EQ(OK, obj.drive_ramp_tick());
+}
+
+TEST_F(RMCT_lib_Test_Fixture, VerifyDriveRampResend)
+{
+   /*!
+    *  @test Verify drive_ramp_tick
+    *  A failed batch write is re-sent on the next tick, so the final
+    *  step to STOP is not lost
+    */
+
+    LD27MGMocker ld27mgmock;
+    PCA9685Mocker pwmstub;
+
+    left_motor_config.hw_sim_mode = false;
+    right_motor_config.hw_sim_mode = false;
+
+    EXPECT_CALL(ld27mgmock, LD27MG_init(_)).Times(1);
+    EXPECT_CALL(pwmstub, PCA9685_init(_)).Times(AtLeast(1));
+    EXPECT_CALL(pwmstub, PCA9685_setPWM(_, _, _)).Times(AtLeast(1));
+    RobotMotorController obj(pca9685_config, cam_config, left_motor_config, right_motor_config);
+
+    /* The first tick reaches 1% */
+    ASSERT_EQ(OK, obj.process_motor_action("LEFT_DRV_MTR", "FORWARD", 0, 1));
+    EXPECT_CALL(pwmstub, PCA9685_setPWM_batch(_, 1)).Times(1).WillOnce(Return(OK));
+    ASSERT_EQ(OK, obj.drive_ramp_tick());
+
+    /* Stopping - The write fails once and the next tick sends it again */
+    ASSERT_EQ(OK, obj.process_motor_action("LEFT_DRV_MTR", "STOP", 0, -1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_CALL(pwmstub, PCA9685_setPWM_batch(Pointee(Field(&PCA9685_pwm_update::duty_cycle, 0.00)), 1))
+        .Times(2).WillOnce(Return(NOK)).WillOnce(Return(OK));
+    ASSERT_EQ(NOK, obj.drive_ramp_tick());
+    ASSERT_EQ(OK, obj.drive_ramp_tick());
+
+    /* Written - Nothing left to send */
+    EXPECT_CALL(pwmstub, PCA9685_setPWM_batch(_, _)).Times(0);
+    ASSERT_EQ(OK, obj.drive_ramp_tick());
+}
+
+TEST_F(RMCT_lib_Test_Fixture, VerifyMockBackends)
+{
+   /*!
+    *  @test Verify RobotMotorControllerT with mock policies
+    *  Actions reach the policies without touching the C drivers
+    */
+    LD27MGMocker ld27mgmock;
+    PCA9685Mocker pwmstub;
+    double ret_angle = 10.00;
+
+    /* No C driver is called */
+    EXPECT_CALL(ld27mgmock, LD27MG_init(_)).Times(0);
+    EXPECT_CALL(pwmstub, PCA9685_init(_)).Times(0);
+    MockController obj(pca9685_config, cam_config, left_motor_config, right_motor_config);   
+
+    /* Camera moves go to the servo policy */
+    EXPECT_CALL(obj.servo_policy(), get_position(CAM_VERT_MTR, _)).Times(1)
+        .WillOnce(DoAll(SetArgPointee<1>(ret_angle), Return(OK)));
+    EXPECT_CALL(obj.servo_policy(), move_motor(CAM_VERT_MTR, ret_angle + angle_sensitivity)).Times(1);
+    ASSERT_EQ(OK, obj.process_motor_action("CAMERA", "UP", 0, 0));
+
+    /* Drive moves go to the drive policy with the default speed */
+    EXPECT_CALL(obj.drive_policy(), ramp_motor(DRV_MTR_RIGHT, REVERSE, 50)).Times(1);
+    ASSERT_EQ(OK, obj.process_motor_action("RIGHT_DRV_MTR", "REVERSE", 0, -1));
+
+    /* Ramp steps and the emergency stop are written through the PWM backend */
+    EXPECT_CALL(obj.drive_policy(), tick(_, _)).Times(1)
+        .WillOnce(DoAll(SetArgPointee<1>(2u), Return(OK)));
+    EXPECT_CALL(obj.pwm_backend(), set_pwm_batch(_, 2)).Times(1).WillOnce(Return(OK));
+    EXPECT_CALL(obj.drive_policy(), ack()).Times(1);
+    ASSERT_EQ(OK, obj.drive_ramp_tick());
+
+    EXPECT_CALL(obj.drive_policy(), halt()).Times(1);
+    EXPECT_CALL(obj.pwm_backend(), stop_all()).Times(1).WillOnce(Return(OK));
+    ASSERT_EQ(OK, obj.emergency_stop());
+}
+
+TEST_F(RMCT_lib_Test_Fixture, VerifySimBackends)
+{
+   /*!
+    *  @test Verify SimRobotMotorController
+    *  State is tracked in memory and no C driver is called
+    */
+    LD27MGMocker ld27mgmock;
+    PCA9685Mocker pwmstub;
+
+    EXPECT_CALL(ld27mgmock, LD27MG_move_motor(_, _)).Times(0);
+    EXPECT_CALL(pwmstub, PCA9685_setPWM(_, _, _)).Times(0);
+    SimRobotMotorController obj(pca9685_config, cam_config, left_motor_config, right_motor_config);   
+
+    ASSERT_EQ(OK, obj.process_motor_action("CAMERA", "LEFT", 0, 0));
+    EXPECT_DOUBLE_EQ(100.00, obj.servo_policy().angle[CAM_HRZN_MTR]);
+
+    ASSERT_EQ(OK, obj.process_motor_action("LEFT_DRV_MTR", "FORWARD", 0, 30));
+    EXPECT_EQ(FORWARD, obj.drive_policy().direction[DRV_MTR_LEFT]);
+    EXPECT_EQ(30, obj.drive_policy().speed[DRV_MTR_LEFT]);
+
+    /* A committed servo move reaches the PWM backend on its pin */
+    obj.begin_batch();
+    ASSERT_EQ(OK, obj.process_motor_action("CAM_VERT_MTR", "", 45.00, 0));
+    ASSERT_EQ(OK, obj.commit());
+    EXPECT_DOUBLE_EQ(45.00, obj.servo_policy().angle[CAM_VERT_MTR]);
+    EXPECT_NEAR(4.17, obj.pwm_backend().duty_cycle[2], 0.01);
+
+    ASSERT_EQ(OK, obj.emergency_stop());
+    EXPECT_DOUBLE_EQ(0.00, obj.pwm_backend().duty_cycle[2]);
+}
+
+TEST_F(RMCT_lib_Test_Fixture, VerifyActionResolvers)
+{
+   /*!
+    *  @test Verify the string to enum resolvers
+    *  Known names resolve, near misses and unknown names do not
+    */
+    MotorAction action;
+
+    EXPECT_EQ(RMCT_CAMERA, RMCT_motor_s2e("CAMERA", 6));
+    EXPECT_EQ(RMCT_RIGHT_DRV_MTR, RMCT_motor_s2e("RIGHT_DRV_MTR", 13));
+    EXPECT_EQ(MAX_RMCT_MOTORS, RMCT_motor_s2e("CAMERA", 5));
+    EXPECT_EQ(MAX_RMCT_MOTORS, RMCT_motor_s2e("camera", 6));
+    EXPECT_EQ(MAX_RMCT_MOTORS, RMCT_motor_s2e("", 0));
+
+    EXPECT_EQ(RMCT_UP, RMCT_direction_s2e("UP", 2));
+    EXPECT_EQ(RMCT_STOP, RMCT_direction_s2e("STOP", 4));
+    EXPECT_EQ(RMCT_NO_DIRECTION, RMCT_direction_s2e("CUSTOM", 6));
+    EXPECT_EQ(RMCT_NO_DIRECTION, RMCT_direction_s2e("", 0));
+
+    ASSERT_EQ(OK, RMCT_parse_motor_action("LEFT_DRV_MTR", 12, "REVERSE", 7, 0, 40, action));
+    EXPECT_EQ(RMCT_LEFT_DRV_MTR, action.motor);
+    EXPECT_EQ(RMCT_REVERSE, action.direction);
+    EXPECT_EQ(40, action.speed);
+    ASSERT_EQ(NOK, RMCT_parse_motor_action("WHEEL", 5, "FORWARD", 7, 0, 40, action));
+}
+
+TEST_F(RMCT_lib_Test_Fixture, VerifyActionDispatch)
+{
+   /*!
+    *  @test Verify dispatch of typed MotorActions
+    *  Directions that do not apply to the motor are rejected, and the
+    *  hardware free check agrees with the dispatch
+    */
+    LD27MGMocker ld27mgmock;
+    PCA9685Mocker pwmstub;
+    SimRobotMotorController obj(pca9685_config, cam_config, left_motor_config, right_motor_config);   
+
+    MotorAction servo = {RMCT_CAM_VERT_MTR, RMCT_NO_DIRECTION, 45.00, 0};
+    ASSERT_EQ(OK, obj.process_motor_action(servo));
+    EXPECT_DOUBLE_EQ(45.00, obj.servo_policy().angle[CAM_VERT_MTR]);
+
+    MotorAction drive = {RMCT_RIGHT_DRV_MTR, RMCT_STOP, 0, -1};
+    ASSERT_EQ(OK, obj.process_motor_action(drive));
+    EXPECT_EQ(STOP, obj.drive_policy().direction[DRV_MTR_RIGHT]);
+
+    MotorAction bad_drive = {RMCT_LEFT_DRV_MTR, RMCT_UP, 0, 10};
+    ASSERT_EQ(NOK, obj.process_motor_action(bad_drive));
+
+    MotorAction bad_camera = {RMCT_CAMERA, RMCT_FORWARD, 0, 0};
+    ASSERT_EQ(NOK, obj.process_motor_action(bad_camera));
+
+    MotorAction bad_motor = {MAX_RMCT_MOTORS, RMCT_UP, 0, 0};
+    ASSERT_EQ(NOK, obj.process_motor_action(bad_motor));
+    ASSERT_EQ(NOK, obj.process_motor_action("WHEEL", "FORWARD", 0, 0));
+
+    EXPECT_EQ(OK, RMCT_check_motor_action(servo));
+    EXPECT_EQ(OK, RMCT_check_motor_action(drive));
+    EXPECT_EQ(NOK, RMCT_check_motor_action(bad_drive));
+    EXPECT_EQ(NOK, RMCT_check_motor_action(bad_camera));
+    EXPECT_EQ(NOK, RMCT_check_motor_action(bad_motor));
+}
+
+TEST_F(RMCT_lib_Test_Fixture, VerifyBatchCommit)
+{
+   /*!
+    *  @test Verify a batch of actions is written once on commit
+    *  Camera steps accumulate on the staged angle and the last
+    *  action for a drive motor wins
+    */
+    LD27MGMocker ld27mgmock;
+    PCA9685Mocker pwmstub;
+    double ret_angle = 90.00;
+    MockController obj(pca9685_config, cam_config, left_motor_config, right_motor_config);   
+
+    /* Nothing is written while the batch is open */
+    EXPECT_CALL(obj.servo_policy(), get_position(CAM_VERT_MTR, _)).Times(1)
+        .WillOnce(DoAll(SetArgPointee<1>(ret_angle), Return(OK)));
+    EXPECT_CALL(obj.servo_policy(), move_motor(_, _)).Times(0);
+    EXPECT_CALL(obj.drive_policy(), ramp_motor(_, _, _)).Times(0);
+
+    obj.begin_batch();
+    ASSERT_EQ(OK, obj.process_motor_action("CAMERA", "UP", 0, 0));
+    ASSERT_EQ(OK, obj.process_motor_action("CAMERA", "UP", 0, 0));
+    ASSERT_EQ(OK, obj.process_motor_action("LEFT_DRV_MTR", "FORWARD", 0, 30));
+    ASSERT_EQ(OK, obj.process_motor_action("RIGHT_DRV_MTR", "FORWARD", 0, 30));
+    ASSERT_EQ(OK, obj.process_motor_action("LEFT_DRV_MTR", "REVERSE", 0, 60));
+
+    /* One servo update and both drive targets go out in one commit */
+    EXPECT_CALL(obj.servo_policy(), stage_move(CAM_VERT_MTR, ret_angle + (2 * angle_sensitivity), _))
+        .Times(1).WillOnce(Return(1));
+    EXPECT_CALL(obj.drive_policy(), commit(_, 2, _, _)).Times(1)
+        .WillOnce(Invoke([](const RMCT_drive_target *targets, unsigned int, 
+                            PCA9685_pwm_update *, unsigned int *update_count) {
+            EXPECT_EQ(DRV_MTR_LEFT, targets[0].motor);
+            EXPECT_EQ(REVERSE, targets[0].direction);
+            EXPECT_EQ(60, targets[0].speed);
+            EXPECT_EQ(DRV_MTR_RIGHT, targets[1].motor);
+            *update_count = 2;
+            return OK;
+        }));
+    EXPECT_CALL(obj.pwm_backend(), set_pwm_batch(_, 3)).Times(1).WillOnce(Return(OK));
+    ASSERT_EQ(OK, obj.commit());
+
+    /* Nothing left to commit */
+    ASSERT_EQ(OK, obj.commit());
+}
+
+TEST_F(RMCT_lib_Test_Fixture, VerifyBatchAbort)
+{
+   /*!
+    *  @test Verify an aborted batch writes nothing
+    */
+    LD27MGMocker ld27mgmock;
+    PCA9685Mocker pwmstub;
+    SimRobotMotorController obj(pca9685_config, cam_config, left_motor_config, right_motor_config);   
+
+    obj.begin_batch();
+    ASSERT_EQ(OK, obj.process_motor_action("CAM_HRZN_MTR", "", 30.00, 0));
+    ASSERT_EQ(OK, obj.process_motor_action("LEFT_DRV_MTR", "FORWARD", 0, 30));
+    obj.abort_batch();
+
+    EXPECT_DOUBLE_EQ(SERVO_HOME_ANGLE, obj.servo_policy().angle[CAM_HRZN_MTR]);
+    EXPECT_EQ(STOP, obj.drive_policy().direction[DRV_MTR_LEFT]);
+
+    /* Without a batch actions apply straight away */
+    ASSERT_EQ(OK, obj.process_motor_action("CAM_HRZN_MTR", "", 30.00, 0));
+    EXPECT_DOUBLE_EQ(30.00, obj.servo_policy().angle[CAM_HRZN_MTR]);
+}
+
+TEST_F(RMCT_lib_Test_Fixture, VerifyBatchRollback)
+{
+   /*!
+    *  @test Verify a rollback only drops what was staged after the
+    *  mark, and the rest of the batch still commits
+    */
+    LD27MGMocker ld27mgmock;
+    PCA9685Mocker pwmstub;
+    SimRobotMotorController obj(pca9685_config, cam_config, left_motor_config, right_motor_config);   
+
+    obj.begin_batch();
+    obj.mark_batch();
+    ASSERT_EQ(OK, obj.process_motor_action("CAM_HRZN_MTR", "", 30.00, 0));
+
+    obj.mark_batch();
+    ASSERT_EQ(OK, obj.process_motor_action("CAM_HRZN_MTR", "", 60.00, 0));
+    ASSERT_EQ(OK, obj.process_motor_action("LEFT_DRV_MTR", "FORWARD", 0, 30));
+    ASSERT_EQ(NOK, obj.process_motor_action("RIGHT_DRV_MTR", "UP", 0, 30));
+    obj.rollback_batch();
+
+    ASSERT_EQ(OK, obj.commit());
+    EXPECT_DOUBLE_EQ(30.00, obj.servo_policy().angle[CAM_HRZN_MTR]);
+    EXPECT_EQ(STOP, obj.drive_policy().direction[DRV_MTR_LEFT]);
 }
+
+TEST_F(RMCT_lib_Test_Fixture, VerifyEmergencyStop)
+{
+   /*!
+    *  @test Verify emergency_stop halts the drive policy
+    */
+    LD27MGMocker ld27mgmock;
+    PCA9685Mocker pwmstub;
+    SimRobotMotorController obj(pca9685_config, cam_config, left_motor_config, right_motor_config);   
+
+    ASSERT_EQ(OK, obj.process_motor_action("LEFT_DRV_MTR", "FORWARD", 0, 30));
+    ASSERT_EQ(OK, obj.process_motor_action("RIGHT_DRV_MTR", "REVERSE", 0, 30));
+    ASSERT_EQ(OK, obj.emergency_stop());
+
+    EXPECT_EQ(STOP, obj.drive_policy().direction[DRV_MTR_LEFT]);
+    EXPECT_EQ(STOP, obj.drive_policy().direction[DRV_MTR_RIGHT]);
+    EXPECT_EQ(0, obj.drive_policy().speed[DRV_MTR_LEFT]);
+}
+
+TEST_F(RMCT_lib_Test_Fixture, VerifyBatchSingleWrite)
+{
+   /*!
+    *  @test Verify a committed batch on the hardware stack is a
+    *  single PCA9685 batch holding the servo and drive channels
+    */
+    LD27MGMocker ld27mgmock;
+    PCA9685Mocker pwmstub;
+    PCA9685_pwm_update servo_update = {CHANNEL_1, 7.5, 0};
+
+    left_motor_config.hw_sim_mode = false;
+    right_motor_config.hw_sim_mode = false;
+    RobotMotorController obj(pca9685_config, cam_config, left_motor_config, right_motor_config);   
+
+    EXPECT_CALL(ld27mgmock, LD27MG_move_motor(_, _)).Times(0);
+    EXPECT_CALL(pwmstub, PCA9685_setPWM(_, _, _)).Times(0);
+
+    obj.begin_batch();
+    ASSERT_EQ(OK, obj.process_motor_action("CAM_HRZN_MTR", "", 45.00, 0));
+    ASSERT_EQ(OK, obj.process_motor_action("LEFT_DRV_MTR", "FORWARD", 0, 50));
+    ASSERT_EQ(OK, obj.process_motor_action("RIGHT_DRV_MTR", "FORWARD", 0, 50));
+
+    EXPECT_CALL(ld27mgmock, LD27MG_stage_move(CAM_HRZN_MTR, 45.00, _)).Times(1)
+        .WillOnce(DoAll(SetArgPointee<2>(servo_update), Return(1)));
+    EXPECT_CALL(pwmstub, PCA9685_setPWM_batch(_, 3)).Times(1);
+    ASSERT_EQ(OK, obj.commit());
+}
+
+TEST_F(RMCT_lib_Test_Fixture, VerifyReconfigure)
+{
+   /*!
+    *  @test Verify reconfigure only reaches the devices passed and
+    *  applies the others when one of them fails
+    */
+    LD27MGMocker ld27mgmock;
+    PCA9685Mocker pwmstub;
+    MockController obj(pca9685_config, cam_config, left_motor_config, right_motor_config);   
+
+    /* Only the left drive motor changed */
+    EXPECT_CALL(obj.servo_policy(), reconfigure(_)).Times(0);
+    EXPECT_CALL(obj.drive_policy(), reconfigure(DRV_MTR_LEFT, _)).Times(1).WillOnce(Return(OK));
+    EXPECT_CALL(obj.drive_policy(), reconfigure(DRV_MTR_RIGHT, _)).Times(0);
+    ASSERT_EQ(OK, obj.reconfigure(NULL, &left_motor_config, NULL));
+
+    /* The camera fails - The right drive motor is still applied */
+    EXPECT_CALL(obj.servo_policy(), reconfigure(_)).Times(1).WillOnce(Return(NOK));
+    EXPECT_CALL(obj.drive_policy(), reconfigure(DRV_MTR_RIGHT, _)).Times(1).WillOnce(Return(OK));
+    ASSERT_EQ(NOK, obj.reconfigure(&cam_config, NULL, &right_motor_config));
+}
+
 int main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
     MyEnvironment* env = new MyEnvironment(); 
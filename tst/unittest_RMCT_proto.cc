@@ -0,0 +1,339 @@
+/**
+ *  @file      unittest_RMCT_proto.cc
+ *  @brief     Unittests for RMCT_proto.cpp
+ *  @details   Unittests for the RMCT binary and JSON command protocols
+ *  @author    Nitin Mohan
+ *  @date      April 20, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <gtest/gtest.h>
+#include <string.h>
+#include <string>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "RMCT_proto.hpp"
+#include "NMT_log.h"
+
+/* @class MyEnvironment
+ *  Environment Setup for Test */
+class MyEnvironment: public ::testing::Environment
+{
+public:
+  virtual ~MyEnvironment() = default;
+
+  virtual void SetUp() {NMT_log_init((char *)"/tmp/", false);}
+
+  virtual void TearDown() {NMT_log_finish();}
+};
+
+/* ---- Start of Tests -------------*/
+using namespace testing;
+
+TEST(RMCT_proto_Test, VerifyRoundTrip)
+{
+   /*!
+    *  @test Verify actions survive encode/decode and the wire
+    *  layout is the documented little endian one
+    */
+    RMCT_proto_msg msg;
+    RMCT_proto_msg decoded;
+    char buffer[256];
+
+    msg.type   = RMCT_PROTO_ACTIONS;
+    msg.seq    = 0x01020304;
+    msg.client = 9;
+    msg.result = OK;
+    msg.count  = 2;
+    msg.actions[0] = {RMCT_CAM_HRZN_MTR, RMCT_NO_DIRECTION, 45.5, -1};
+    msg.actions[1] = {RMCT_LEFT_DRV_MTR, RMCT_FORWARD, -1, 80};
+
+    size_t length = RMCT_proto_encode(msg, buffer, sizeof(buffer));
+    ASSERT_EQ(sizeof(RMCT_proto_header) + 2 * sizeof(RMCT_proto_action), length);
+
+    /* Header - "NB", version, type, seq */
+    ASSERT_EQ('N', buffer[0]);
+    ASSERT_EQ('B', buffer[1]);
+    ASSERT_EQ(RMCT_PROTO_VERSION, buffer[2]);
+    ASSERT_EQ(RMCT_PROTO_ACTIONS, buffer[3]);
+    ASSERT_EQ(0x04, buffer[4]);
+    ASSERT_EQ(0x01, buffer[7]);
+
+    ASSERT_TRUE(RMCT_proto_is_binary(buffer, length));
+    ASSERT_FALSE(RMCT_proto_is_binary("[{\"type\":\"hw_action\"}]", 22));
+
+    ASSERT_EQ(OK, RMCT_proto_decode(buffer, length, decoded));
+    ASSERT_EQ(RMCT_PROTO_ACTIONS, decoded.type);
+    ASSERT_EQ(0x01020304u, decoded.seq);
+    ASSERT_EQ(9, decoded.client);
+    ASSERT_EQ(2u, decoded.count);
+    ASSERT_EQ(RMCT_CAM_HRZN_MTR, decoded.actions[0].motor);
+    ASSERT_EQ(RMCT_NO_DIRECTION, decoded.actions[0].direction);
+    ASSERT_DOUBLE_EQ(45.5, decoded.actions[0].angle);
+    ASSERT_EQ(-1, decoded.actions[0].speed);
+    ASSERT_EQ(RMCT_LEFT_DRV_MTR, decoded.actions[1].motor);
+    ASSERT_EQ(RMCT_FORWARD, decoded.actions[1].direction);
+    ASSERT_EQ(80, decoded.actions[1].speed);
+
+    /* Ack */
+    length = RMCT_proto_encode_ack(9, 7, NOK, buffer, sizeof(buffer));
+    ASSERT_EQ(sizeof(RMCT_proto_header), length);
+    ASSERT_EQ(OK, RMCT_proto_decode(buffer, length, decoded));
+    ASSERT_EQ(RMCT_PROTO_ACK, decoded.type);
+    ASSERT_EQ(7u, decoded.seq);
+    ASSERT_EQ(9, decoded.client);
+    ASSERT_EQ(NOK, decoded.result);
+
+    /* Does not fit */
+    ASSERT_EQ(0u, RMCT_proto_encode(msg, buffer, sizeof(RMCT_proto_header)));
+}
+
+TEST(RMCT_proto_Test, VerifyBoundsChecks)
+{
+   /*!
+    *  @test Verify malformed messages are rejected
+    */
+    RMCT_proto_msg msg;
+    RMCT_proto_msg decoded;
+    char buffer[256];
+
+    msg.type   = RMCT_PROTO_ACTIONS;
+    msg.seq    = 1;
+    msg.client = 0;
+    msg.result = OK;
+    msg.count  = 1;
+    msg.actions[0] = {RMCT_CAMERA, RMCT_UP, 0, 0};
+
+    size_t length = RMCT_proto_encode(msg, buffer, sizeof(buffer));
+    ASSERT_EQ(OK, RMCT_proto_decode(buffer, length, decoded));
+
+    /* Short, long and header only */
+    ASSERT_EQ(NOK, RMCT_proto_decode(buffer, length - 1, decoded));
+    ASSERT_EQ(NOK, RMCT_proto_decode(buffer, length + 1, decoded));
+    ASSERT_EQ(NOK, RMCT_proto_decode(buffer, sizeof(RMCT_proto_header) - 1, decoded));
+
+    /* Count beyond RMCT_PROTO_MAX_ACTIONS */
+    char bad[sizeof(buffer)];
+    memcpy(bad, buffer, length);
+    bad[8] = (char)0xff;
+    ASSERT_EQ(NOK, RMCT_proto_decode(bad, length, decoded));
+
+    /* Unknown motor, direction and type */
+    memcpy(bad, buffer, length);
+    bad[sizeof(RMCT_proto_header)] = MAX_RMCT_MOTORS;
+    ASSERT_EQ(NOK, RMCT_proto_decode(bad, length, decoded));
+
+    memcpy(bad, buffer, length);
+    bad[sizeof(RMCT_proto_header) + 1] = RMCT_NO_DIRECTION + 1;
+    ASSERT_EQ(NOK, RMCT_proto_decode(bad, length, decoded));
+
+    memcpy(bad, buffer, length);
+    bad[3] = MAX_RMCT_PROTO_TYPES;
+    ASSERT_EQ(NOK, RMCT_proto_decode(bad, length, decoded));
+
+    /* Newer versions are only accepted in a hello */
+    memcpy(bad, buffer, length);
+    bad[2] = RMCT_PROTO_VERSION + 1;
+    ASSERT_EQ(NOK, RMCT_proto_decode(bad, length, decoded));
+
+    msg.type  = RMCT_PROTO_HELLO;
+    msg.count = 0;
+    length = RMCT_proto_encode(msg, bad, sizeof(bad));
+    bad[2] = RMCT_PROTO_VERSION + 1;
+    ASSERT_EQ(OK, RMCT_proto_decode(bad, length, decoded));
+    ASSERT_EQ(RMCT_PROTO_VERSION + 1, decoded.version);
+}
+
+TEST(RMCT_proto_Test, VerifyAckBatch)
+{
+   /*!
+    *  @test Verify several results travel in one ack, which is only
+    *  accepted from RMCT_PROTO_ACK_BATCH_VERSION on
+    */
+    RMCT_proto_ack acks[3] = {{5, OK}, {6, NOK}, {7, OK}};
+    RMCT_proto_msg decoded;
+    char buffer[RMCT_PROTO_MAX_MSG];
+
+    size_t length = RMCT_proto_encode_ack_batch(4, acks, 3, buffer, sizeof(buffer));
+    ASSERT_EQ(sizeof(RMCT_proto_header) + 3 * sizeof(RMCT_proto_ack_record), length);
+
+    ASSERT_EQ(OK, RMCT_proto_decode(buffer, length, decoded));
+    ASSERT_EQ(RMCT_PROTO_ACK_BATCH, decoded.type);
+    ASSERT_EQ(4, decoded.client);
+    ASSERT_EQ(7u, decoded.seq);
+    ASSERT_EQ(NOK, decoded.result);
+    ASSERT_EQ(3u, decoded.count);
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        ASSERT_EQ(acks[i].seq, decoded.acks[i].seq);
+        ASSERT_EQ(acks[i].result, decoded.acks[i].result);
+    }
+
+    /* RMCT_proto_encode takes the same path */
+    char copy[RMCT_PROTO_MAX_MSG];
+    ASSERT_EQ(length, RMCT_proto_encode(decoded, copy, sizeof(copy)));
+    ASSERT_EQ(0, memcmp(buffer, copy, length));
+
+    /* Empty, too many and does not fit */
+    ASSERT_EQ(0u, RMCT_proto_encode_ack_batch(4, acks, 0, buffer, sizeof(buffer)));
+    ASSERT_EQ(0u, RMCT_proto_encode_ack_batch(4, acks, RMCT_PROTO_MAX_ACTIONS + 1, buffer, sizeof(buffer)));
+    ASSERT_EQ(0u, RMCT_proto_encode_ack_batch(4, acks, 3, buffer, length - 1));
+
+    /* A version 1 peer never sends one */
+    buffer[2] = RMCT_PROTO_ACK_BATCH_VERSION - 1;
+    ASSERT_EQ(NOK, RMCT_proto_decode(buffer, length, decoded));
+}
+
+TEST(RMCT_proto_Test, VerifySeqFilter)
+{
+   /*!
+    *  @test Verify duplicates and stale commands are dropped per
+    *  client, across the sequence number wrap
+    */
+    RMCT_seq_filter filter;
+
+    ASSERT_EQ(RMCT_SEQ_NEW, filter.check(1, 10));
+    ASSERT_EQ(RMCT_SEQ_DUPLICATE, filter.check(1, 10));
+    ASSERT_EQ(RMCT_SEQ_STALE, filter.check(1, 9));
+    ASSERT_EQ(RMCT_SEQ_NEW, filter.check(1, 12));
+    ASSERT_EQ(RMCT_SEQ_STALE, filter.check(1, 11));
+
+    /* Other clients have their own numbers */
+    ASSERT_EQ(RMCT_SEQ_NEW, filter.check(2, 1));
+
+    /* Unsequenced commands always pass */
+    ASSERT_EQ(RMCT_SEQ_NEW, filter.check(1, 0));
+    ASSERT_EQ(RMCT_SEQ_NEW, filter.check(1, 0));
+
+    /* Wraparound */
+    filter.reset(3, 0xfffffffe);
+    ASSERT_EQ(RMCT_SEQ_NEW, filter.check(3, 0xffffffff));
+    ASSERT_EQ(RMCT_SEQ_NEW, filter.check(3, 2));
+    ASSERT_EQ(RMCT_SEQ_STALE, filter.check(3, 0xffffffff));
+
+    /* A hello restarts the client */
+    filter.reset(1, 1);
+    ASSERT_EQ(RMCT_SEQ_NEW, filter.check(1, 2));
+
+    ASSERT_EQ(1u, filter.duplicates());
+    ASSERT_EQ(3u, filter.stale());
+}
+
+TEST(RMCT_proto_Test, VerifySeqFilterAssign)
+{
+   /*!
+    *  @test Verify client IDs handed out on hello are unique, never 0
+    *  and start at the hello's sequence number
+    */
+    RMCT_seq_filter filter;
+
+    ASSERT_EQ(1u, filter.assign(100));
+    ASSERT_EQ(2u, filter.assign(100));
+
+    /* Same hello sequence, separate numbering */
+    ASSERT_EQ(RMCT_SEQ_STALE, filter.check(1, 99));
+    ASSERT_EQ(RMCT_SEQ_NEW, filter.check(1, 101));
+    ASSERT_EQ(RMCT_SEQ_NEW, filter.check(2, 101));
+
+    /* Reused only after every other ID, and 0 is skipped */
+    for (unsigned int i = 3; i < RMCT_PROTO_MAX_CLIENTS; i++)
+        ASSERT_EQ(i, filter.assign(1));
+    ASSERT_EQ(1u, filter.assign(1));
+}
+
+TEST(RMCT_proto_Test, VerifyJsonParse)
+{
+   /*!
+    *  @test Verify the JSON fast path decodes the command schema
+    *  regardless of key order, whitespace and unknown keys
+    */
+    RMCT_proto_msg msg;
+    const char *cmd = " [ {\"type\" : \"hw_action\", \"motor\":\"CAM_VERT_MTR\", \"direction\":\"\","
+                      "\"angle\": 1.25e1, \"speed\": -1},\n"
+                      "  {\"speed\":80, \"extra\":{\"a\":[1,\"]}\",{}]}, \"angle\":-1,"
+                      "   \"direction\":\"REVERSE\", \"motor\":\"RIGHT_DRV_MTR\", \"type\":\"hw_action\"} ] ";
+
+    ASSERT_EQ(OK, RMCT_proto_parse_json(cmd, strlen(cmd), msg));
+    ASSERT_EQ(RMCT_PROTO_ACTIONS, msg.type);
+    ASSERT_EQ(2u, msg.count);
+    ASSERT_EQ(RMCT_CAM_VERT_MTR, msg.actions[0].motor);
+    ASSERT_EQ(RMCT_NO_DIRECTION, msg.actions[0].direction);
+    ASSERT_DOUBLE_EQ(12.5, msg.actions[0].angle);
+    ASSERT_EQ(-1, msg.actions[0].speed);
+    ASSERT_EQ(RMCT_RIGHT_DRV_MTR, msg.actions[1].motor);
+    ASSERT_EQ(RMCT_REVERSE, msg.actions[1].direction);
+    ASSERT_EQ(80, msg.actions[1].speed);
+
+    /* proc_action */
+    cmd = "[{\"type\":\"proc_action\",\"action\":\"exit\"}]";
+    ASSERT_EQ(OK, RMCT_proto_parse_json(cmd, strlen(cmd), msg));
+    ASSERT_EQ(RMCT_PROTO_EXIT, msg.type);
+    ASSERT_EQ(0u, msg.count);
+
+    cmd = "[{\"type\":\"proc_action\",\"action\":\"status\"}]";
+    ASSERT_EQ(OK, RMCT_proto_parse_json(cmd, strlen(cmd), msg));
+    ASSERT_EQ(RMCT_PROTO_ACTIONS, msg.type);
+
+    cmd = "[{\"type\":\"proc_action\",\"action\":\"latency\"}]";
+    ASSERT_EQ(OK, RMCT_proto_parse_json(cmd, strlen(cmd), msg));
+    ASSERT_EQ(RMCT_PROTO_LATENCY, msg.type);
+
+    cmd = "[{\"type\":\"proc_action\",\"action\":\"exit\"},{\"type\":\"proc_action\",\"action\":\"latency\"}]";
+    ASSERT_EQ(OK, RMCT_proto_parse_json(cmd, strlen(cmd), msg));
+    ASSERT_EQ(RMCT_PROTO_EXIT, msg.type);
+
+    /* Empty command and a trailing nul */
+    ASSERT_EQ(OK, RMCT_proto_parse_json("[]", 3, msg));
+    ASSERT_EQ(0u, msg.count);
+}
+
+TEST(RMCT_proto_Test, VerifyJsonRejects)
+{
+   /*!
+    *  @test Verify the JSON fast path rejects anything outside
+    *  the schema or the JSON grammar
+    */
+    RMCT_proto_msg msg;
+    const char *bad[] = {"",
+                         "{}",
+                         "[",
+                         "[{}]",
+                         "[{\"type\":\"hw_action\"}]",
+                         "[{\"type\":\"bogus\"}]",
+                         "[{\"type\":\"proc_action\",\"action\":1}]",
+                         "[{\"type\":\"hw_action\",\"motor\":\"NOPE\",\"direction\":\"UP\",\"angle\":0,\"speed\":0}]",
+                         "[{\"type\":\"hw_action\",\"motor\":\"CAMERA\",\"direction\":\"UP\",\"angle\":\"0\",\"speed\":0}]",
+                         "[{\"type\":\"hw_action\",\"motor\":\"CAMERA\",\"direction\":\"UP\",\"angle\":0x1,\"speed\":0}]",
+                         "[{\"type\":\"hw_action\",\"motor\":\"CAMERA\",\"direction\":\"UP\",\"angle\":0,\"speed\":1e99}]",
+                         "[{\"type\":\"hw_action\",\"motor\":\"CAMERA\",\"direction\":\"UP\",\"angle\":01,\"speed\":0}]",
+                         "[{\"type\":\"proc_action\",\"action\":\"exit\"}] x",
+                         "[{\"type\":\"proc_action\",\"action\":\"exit\"},]",
+                         "[{\"type\":\"proc_action\" \"action\":\"exit\"}]",
+                         "[{\"type\":\"proc_action\",\"action\":\"exit}]"};
+
+    for (const char *cmd : bad)
+        ASSERT_EQ(NOK, RMCT_proto_parse_json(cmd, strlen(cmd), msg)) << cmd;
+
+    /* Bounded by the length, not the nul */
+    const char *cmd = "[{\"type\":\"proc_action\",\"action\":\"exit\"}]";
+    ASSERT_EQ(NOK, RMCT_proto_parse_json(cmd, strlen(cmd) - 1, msg));
+
+    /* More actions than RMCT_PROTO_MAX_ACTIONS */
+    std::string many = "[";
+    for (unsigned int i = 0; i <= RMCT_PROTO_MAX_ACTIONS; i++)
+        many += std::string(i ? "," : "") + "{\"type\":\"hw_action\",\"motor\":\"CAMERA\",\"direction\":\"UP\",\"angle\":0,\"speed\":0}";
+    many += "]";
+    ASSERT_EQ(NOK, RMCT_proto_parse_json(many.c_str(), many.size(), msg));
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    MyEnvironment* env = new MyEnvironment();
+    ::testing::AddGlobalTestEnvironment(env);
+    return RUN_ALL_TESTS();
+}
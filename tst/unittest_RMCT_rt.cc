@@ -0,0 +1,106 @@
+/**
+ *  @file      unittest_RMCT_rt.cc
+ *  @brief     Unittests for RMCT_rt.cpp
+ *  @details   Unittests for the RMCT real-time control loop
+ *  @author    Nitin Mohan
+ *  @date      April 23, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <gtest/gtest.h>
+#include <thread>
+#include <chrono>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "RMCT_rt.hpp"
+#include "NMT_log.h"
+
+/* @class MyEnvironment
+ *  Environment Setup for Test */
+class MyEnvironment: public ::testing::Environment
+{
+public:
+  virtual ~MyEnvironment() = default;
+
+  virtual void SetUp() {NMT_log_init((char *)"/tmp/", false);}
+
+  virtual void TearDown() {NMT_log_finish();}
+};
+
+/* ---- Start of Tests -------------*/
+using namespace testing;
+using namespace std::chrono;
+
+TEST(RMCT_rt_Test, VerifyRate)
+{
+   /*!
+    *  @test Verify the loop ticks at its rate off absolute deadlines
+    *  and records the jitter of every tick
+    */
+    uint64_t ticks = 0;
+    uint64_t overruns = 0;
+    RMCT_latency_histogram jitter;
+    RMCT_rt_loop *loop_ref = NULL;
+    RMCT_rt_loop loop(500, 0, DEFAULT_RT_PRIORITY, [&]() {
+        if (++ticks == 50) {loop_ref->stop();}
+    });
+    loop_ref = &loop;
+
+    ASSERT_EQ(nanoseconds(2000000), loop.get_period());
+
+    /* The loop pins and reschedules the thread it runs on */
+    auto start = steady_clock::now();
+    NMT_result result = NOK;
+    std::thread worker([&]() {result = loop.run();});
+    worker.join();
+    auto elapsed = steady_clock::now() - start;
+
+    ASSERT_EQ(OK, result);
+    ASSERT_EQ(50u, ticks);
+    ASSERT_EQ(50u, loop.ticks());
+    ASSERT_GE(elapsed, milliseconds(100));
+
+    loop.stats(jitter, overruns);
+    ASSERT_EQ(50u, jitter.count());
+}
+
+TEST(RMCT_rt_Test, VerifyOverrun)
+{
+   /*!
+    *  @test Verify a tick that runs past the next deadline counts as
+    *  an overrun and the missed deadlines are skipped, not replayed
+    */
+    uint64_t ticks = 0;
+    uint64_t overruns = 0;
+    RMCT_latency_histogram jitter;
+    RMCT_rt_loop *loop_ref = NULL;
+    RMCT_rt_loop loop(1000, 0, DEFAULT_RT_PRIORITY, [&]() {
+        if (++ticks == 5) {std::this_thread::sleep_for(milliseconds(20));}
+        if (ticks == 10) {loop_ref->stop();}
+    });
+    loop_ref = &loop;
+
+    auto start = steady_clock::now();
+    std::thread worker([&]() {loop.run();});
+    worker.join();
+    auto elapsed = steady_clock::now() - start;
+
+    loop.stats(jitter, overruns);
+    ASSERT_GE(overruns, 1u);
+    ASSERT_EQ(10u, jitter.count());
+
+    /* Replaying the 20 missed deadlines would have ended the loop early */
+    ASSERT_GE(elapsed, milliseconds(28));
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    MyEnvironment* env = new MyEnvironment();
+    ::testing::AddGlobalTestEnvironment(env);
+    return RUN_ALL_TESTS();
+}
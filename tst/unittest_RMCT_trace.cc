@@ -0,0 +1,94 @@
+/**
+ *  @file      unittest_RMCT_trace.cc
+ *  @brief     Unittests for RMCT_trace.cpp
+ *  @details   Unittests for the RMCT command latency histograms
+ *  @author    Nitin Mohan
+ *  @date      April 21, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <gtest/gtest.h>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "RMCT_trace.hpp"
+
+/* ---- Start of Tests -------------*/
+using namespace testing;
+
+TEST(RMCT_trace_Test, VerifyHistogram)
+{
+   /*!
+    *  @test Verify latencies land in power of 2 buckets and the
+    *  percentiles are bounded by them
+    */
+    RMCT_latency_histogram histogram;
+
+    ASSERT_EQ(0u, histogram.percentile(50));
+
+    histogram.add(0);
+    histogram.add(1);
+    histogram.add(1000);
+    histogram.add(1023);
+    histogram.add(1024);
+    ASSERT_EQ(1u, histogram.bucket(0));
+    ASSERT_EQ(1u, histogram.bucket(1));
+    ASSERT_EQ(2u, histogram.bucket(10));
+    ASSERT_EQ(1u, histogram.bucket(11));
+
+    ASSERT_EQ(5u, histogram.count());
+    ASSERT_EQ(1024u, histogram.max());
+    ASSERT_EQ((0u + 1 + 1000 + 1023 + 1024) / 5, histogram.mean());
+    ASSERT_EQ(0u, histogram.percentile(10));
+    ASSERT_EQ(1023u, histogram.percentile(60));
+    ASSERT_EQ(1024u, histogram.percentile(100));
+
+    /* Anything too long for the buckets goes in the last one */
+    histogram.add(UINT64_MAX);
+    ASSERT_EQ(1u, histogram.bucket(RMCT_TRACE_BUCKETS - 1));
+
+    histogram.reset();
+    ASSERT_EQ(0u, histogram.count());
+    ASSERT_EQ(0u, histogram.bucket(10));
+}
+
+TEST(RMCT_trace_Test, VerifyStages)
+{
+   /*!
+    *  @test Verify each stage is measured from the previous stamped
+    *  one, skipped stages are left out and clock steps back are 0ns
+    */
+    RMCT_trace trace;
+    struct timespec stamps[MAX_RMCT_TRACE_STAGES] = {};
+
+    stamps[RMCT_STAGE_KERNEL]       = {10, 999999000};
+    stamps[RMCT_STAGE_RECV]         = {11, 1000};
+    stamps[RMCT_STAGE_PARSE]        = {11, 1500};
+    stamps[RMCT_STAGE_ACK_SEND]     = {11, 1400};
+    stamps[RMCT_STAGE_I2C_COMPLETE] = {11, 9000};
+    trace.record(stamps);
+
+    ASSERT_EQ(0u, trace.stage(RMCT_STAGE_KERNEL).count());
+    ASSERT_EQ(2000u, trace.stage(RMCT_STAGE_RECV).max());
+    ASSERT_EQ(500u, trace.stage(RMCT_STAGE_PARSE).max());
+    ASSERT_EQ(0u, trace.stage(RMCT_STAGE_ACK_SEND).max());
+    ASSERT_EQ(1u, trace.stage(RMCT_STAGE_ACK_SEND).count());
+    ASSERT_EQ(0u, trace.stage(RMCT_STAGE_DISPATCH).count());
+    ASSERT_EQ(0u, trace.stage(RMCT_STAGE_I2C_ISSUE).count());
+    ASSERT_EQ(7600u, trace.stage(RMCT_STAGE_I2C_COMPLETE).max());
+    ASSERT_EQ(10000u, trace.total().max());
+
+    /* Without a kernel stamp the command starts at the read */
+    stamps[RMCT_STAGE_KERNEL] = {0, 0};
+    trace.record(stamps);
+    ASSERT_EQ(1u, trace.stage(RMCT_STAGE_RECV).count());
+    ASSERT_EQ(2u, trace.total().count());
+
+    trace.reset();
+    ASSERT_EQ(0u, trace.total().count());
+    ASSERT_EQ(0u, trace.stage(RMCT_STAGE_PARSE).count());
+}
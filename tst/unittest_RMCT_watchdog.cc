@@ -0,0 +1,142 @@
+/**
+ *  @file      unittest_RMCT_watchdog.cc
+ *  @brief     Unittests for RMCT_watchdog.cpp
+ *  @details   Unittests for the RMCT deadman watchdog
+ *  @author    Nitin Mohan
+ *  @date      April 12, 2020
+ *  @copyright 2020 - NM Technologies
+ */
+
+/*--------------------------------------------------/
+/                   System Imports                  /
+/--------------------------------------------------*/
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+/*--------------------------------------------------/
+/                   Local Imports                   /
+/--------------------------------------------------*/
+#include "RMCT_watchdog.hpp"
+#include "NMT_log.h"
+
+/* @class MyEnvironment
+ *  Environment Setup for Test */
+class MyEnvironment: public ::testing::Environment
+{
+public:
+  virtual ~MyEnvironment() = default;
+
+  virtual void SetUp() {NMT_log_init((char *)"/tmp/", false);}
+
+  virtual void TearDown() {NMT_log_finish();}
+};
+
+/* ---- Start of Tests -------------*/
+using namespace testing;
+using namespace std::chrono;
+
+TEST(RMCT_watchdog_Test, VerifyDeadline)
+{
+   /*!
+    *  @test Verify the watchdog fires once per feed, and only
+    *  after the deadline has passed
+    */
+    int fired = 0;
+    RMCT_watchdog watchdog(milliseconds(100), [&]() {fired++;});
+
+    /* Not fed yet - Never fires */
+    ASSERT_FALSE(watchdog.check(steady_clock::now() + seconds(10)));
+
+    watchdog.feed();
+    auto fed = steady_clock::now();
+
+    ASSERT_FALSE(watchdog.check(fed + milliseconds(50)));
+    ASSERT_TRUE(watchdog.check(fed + milliseconds(150)));
+    ASSERT_EQ(1, fired);
+
+    /* Disarmed until the next feed */
+    ASSERT_FALSE(watchdog.check(fed + milliseconds(300)));
+    ASSERT_EQ(1, fired);
+
+    watchdog.feed();
+    ASSERT_TRUE(watchdog.check(steady_clock::now() + milliseconds(150)));
+    ASSERT_EQ(2, fired);
+    ASSERT_EQ(2, watchdog.expiries());
+}
+
+TEST(RMCT_watchdog_Test, VerifyThreadFires)
+{
+   /*!
+    *  @test Verify the watchdog thread fires on starvation
+    *  and stays quiet while it is fed
+    */
+    std::atomic<int> fired(0);
+    RMCT_watchdog watchdog(milliseconds(40), [&]() {fired++;});
+
+    ASSERT_EQ(OK, watchdog.start());
+
+    /* Fed well within the deadline */
+    for (int i = 0; i < 10; i++)
+    {
+        watchdog.feed();
+        std::this_thread::sleep_for(milliseconds(5));
+    }
+    ASSERT_EQ(0, fired);
+
+    /* Starved */
+    std::this_thread::sleep_for(milliseconds(200));
+    watchdog.stop();
+    ASSERT_EQ(1, fired);
+}
+
+TEST(RMCT_watchdog_Test, VerifyHeartbeat)
+{
+   /*!
+    *  @test Verify a held drive command survives well past the
+    *  deadline while the client heartbeat re-sends it
+    */
+    std::atomic<int> fired(0);
+    RMCT_watchdog watchdog(milliseconds(40), [&]() {fired++;});
+
+    ASSERT_EQ(OK, watchdog.start());
+
+    /* The command, then a heartbeat every 10ms for 5 deadlines */
+    watchdog.feed();
+    for (int i = 0; i < 20; i++)
+    {
+        std::this_thread::sleep_for(milliseconds(10));
+        watchdog.feed();
+    }
+    ASSERT_EQ(0, fired);
+
+    /* Heartbeat stops - The motors are stopped */
+    std::this_thread::sleep_for(milliseconds(200));
+    watchdog.stop();
+    ASSERT_EQ(1, fired);
+}
+
+TEST(RMCT_watchdog_Test, VerifyDisabled)
+{
+   /*!
+    *  @test Verify a deadline of 0 disables the watchdog
+    */
+    int fired = 0;
+    RMCT_watchdog watchdog(milliseconds(0), [&]() {fired++;});
+
+    ASSERT_FALSE(watchdog.enabled());
+    ASSERT_EQ(OK, watchdog.start());
+
+    watchdog.feed();
+    ASSERT_FALSE(watchdog.check(steady_clock::now() + seconds(10)));
+    watchdog.stop();
+    ASSERT_EQ(0, fired);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    MyEnvironment* env = new MyEnvironment();
+    ::testing::AddGlobalTestEnvironment(env);
+    return RUN_ALL_TESTS();
+}
@@ -19,12 +19,17 @@ import sys
 #                   Constants                       #
 #---------------------------------------------------#
 RS_PATH     = "/etc/NiBot/RSXA.json"
+RS_IMAGE    = "/etc/NiBot/RSXA.bin"
+RS_SHM      = "/NiBot_RSXA_test"
 
 #---------------------------------------------------#
 #                   Local Imports                   #
 #---------------------------------------------------#
 from lib_py.RSXA import RSXA
 from lib_py.RSXA import rsxa
+from lib_py.RSXA import RSXA_HW_SAME, RSXA_HW_SIM_MODE, RSXA_HW_PINS
+from lib_py.RSXA import rsxa_settings
+from lib_py.RSXA import rsxa_str, RSXA_STR_NONE
 from lib_py.NMT_stdlib_py import NMT_result
 import NMT_log_test
 
@@ -63,18 +68,21 @@ class NMT_RSXA_test(unittest.TestCase):
         self.assertEqual(result, NMT_result.OK)
 
         # Check log_dir
-        self.assertEqual(test_data["log_dir"], RSXA_Object.log_dir)
+        self.assertEqual(test_data["log_dir"], rsxa_str(RSXA_Object.strings, RSXA_Object.log_dir))
+
+        # Check transport defaults to multicast
+        self.assertEqual("udp", rsxa_str(RSXA_Object.strings, RSXA_Object.procs[0].transport))
 
         # Check hw structure 
         for i in range(0, len(test_data["hw"])):
             self.assertEqual(len(test_data["hw"]), RSXA_Object.array_len_hw)
-            self.assertEqual(test_data["hw"][i]["hw_name"], RSXA_Object.hw[i].hw_name)
+            self.assertEqual(test_data["hw"][i]["hw_name"], rsxa_str(RSXA_Object.strings, RSXA_Object.hw[i].hw_name))
             self.assertEqual(test_data["hw"][i]["hw_sim_mode"], RSXA_Object.hw[i].hw_sim_mode)
             for j in range(0, len(test_data["hw"][i]["hw_interface"])):
                 self.assertEqual(len(test_data["hw"][i]["hw_interface"]),
                                  RSXA_Object.hw[i].array_len_hw_int)
                 self.assertEqual(test_data["hw"][i]["hw_interface"][j]["pin_name"],
-                                 RSXA_Object.hw[i].hw_interface[j].pin_name)
+                                 rsxa_str(RSXA_Object.strings, RSXA_Object.hw[i].hw_interface[j].pin_name))
                 self.assertEqual(test_data["hw"][i]["hw_interface"][j]["pin_no"], 
                                  RSXA_Object.hw[i].hw_interface[j].pin_no)
 
@@ -306,7 +314,303 @@ class NMT_RSXA_test(unittest.TestCase):
         result = rsxa.RSXA_init(byref(RSXA_Object))
         self.assertEqual(result, NMT_result.NOK)
 
+    def test_RSXA_init_GW_2(self):
+        #Description - Verify a hw_name past the old 20 char limit is
+        #              kept whole
+
+        #Initialize Variables
+        RSXA_Object = RSXA()
+
+        # -- Prepare Test -- #
+        test_data = {"log_dir": "/test/test_file",
+                     "procs"  : [{"proc_name": "UnitTest", "server_ip": "224.1.1.1",
+                                  "server_p": 1000, "client_ip": "224.1.2.3", "client_p": 2000}],
+                     "hw": [{"hw_name": "UnitTest_HW1_Too_Long", "hw_sim_mode": False,
+                             "hw_interface":[{"pin_name": "p1", "pin_no": 1}]}]}
+
+        with open(RS_PATH, "w") as n_rsxa_file:
+            json.dump(test_data, n_rsxa_file)
+
+        result = rsxa.RSXA_init(byref(RSXA_Object))
+        self.assertEqual(result, NMT_result.OK)
+        self.assertEqual(test_data["hw"][0]["hw_name"],
+                         rsxa_str(RSXA_Object.strings, RSXA_Object.hw[0].hw_name))
+
+        rsxa.RSXA_free_mem(byref(RSXA_Object))
+
+    def test_RSXA_compile_GW(self):
+        #Description - Compile RSXA.json and confirm RSXA_init maps the
+        #              image with the same settings as the JSON
+
+        #Initialize Variables
+        RSXA_Object = RSXA()
+
+        # -- Prepare Test -- #
+        test_data = {"log_dir": "/test/test_file",
+                     "procs"  : [{"proc_name": "UnitTest", "server_ip": "224.1.1.1",
+                                  "server_p": 1000, "client_ip": "224.1.2.3", "client_p": 2000,
+                                  "transport": "shm"}],
+                     "hw": [{"hw_name": "UnitTest_HW1", "hw_sim_mode": False,
+                             "hw_interface":[{"pin_name": "p1", "pin_no": 1},
+                                             {"pin_name": "p2", "pin_no": 2}]},
+                            {"hw_name": "UnitTest_HW2", "hw_sim_mode": True,
+                             "hw_interface": []},
+                            {"hw_name": "UnitTest_HW3", "hw_sim_mode": True,
+                             "hw_interface": [{"pin_name": "p3", "pin_no": 3}]}]}
+
+        with open(RS_PATH, "w") as n_rsxa_file:
+            json.dump(test_data, n_rsxa_file)
+
+        result = rsxa.RSXA_compile(RS_PATH, RS_IMAGE)
+        self.assertEqual(result, NMT_result.OK)
+
+        result = rsxa.RSXA_init(byref(RSXA_Object))
+        self.assertEqual(result, NMT_result.OK)
+        self.assertTrue(RSXA_Object.image)
+
+        # Check the mapped settings
+        self.assertEqual(test_data["log_dir"], rsxa_str(RSXA_Object.strings, RSXA_Object.log_dir))
+        self.assertEqual("shm", rsxa_str(RSXA_Object.strings, RSXA_Object.procs[0].transport))
+        self.assertEqual(2000, RSXA_Object.procs[0].client_p)
+        self.assertEqual(len(test_data["hw"]), RSXA_Object.array_len_hw)
+        for i in range(0, len(test_data["hw"])):
+            self.assertEqual(test_data["hw"][i]["hw_name"], rsxa_str(RSXA_Object.strings, RSXA_Object.hw[i].hw_name))
+            self.assertEqual(test_data["hw"][i]["hw_sim_mode"], RSXA_Object.hw[i].hw_sim_mode)
+            self.assertEqual(len(test_data["hw"][i]["hw_interface"]),
+                             RSXA_Object.hw[i].array_len_hw_int)
+            for j in range(0, len(test_data["hw"][i]["hw_interface"])):
+                self.assertEqual(test_data["hw"][i]["hw_interface"][j]["pin_name"],
+                                 rsxa_str(RSXA_Object.strings, RSXA_Object.hw[i].hw_interface[j].pin_name))
+                self.assertEqual(test_data["hw"][i]["hw_interface"][j]["pin_no"],
+                                 RSXA_Object.hw[i].hw_interface[j].pin_no)
+
+        rsxa.RSXA_free_mem(byref(RSXA_Object))
+
+    def test_RSXA_compile_BW_1(self):
+        #Description - Verify the image is ignored once the JSON changes
+
+        #Initialize Variables
+        RSXA_Object = RSXA()
+
+        # -- Prepare Test -- #
+        test_data = {"log_dir": "/test/test_file",
+                     "procs"  : [{"proc_name": "UnitTest", "server_ip": "224.1.1.1",
+                                  "server_p": 1000, "client_ip": "224.1.2.3", "client_p": 2000}],
+                     "hw": [{"hw_name": "UnitTest_HW1", "hw_sim_mode": False,
+                             "hw_interface":[{"pin_name": "p1", "pin_no": 1}]}]}
+
+        with open(RS_PATH, "w") as n_rsxa_file:
+            json.dump(test_data, n_rsxa_file)
+
+        result = rsxa.RSXA_compile(RS_PATH, RS_IMAGE)
+        self.assertEqual(result, NMT_result.OK)
+
+        test_data["log_dir"] = "/test/test_file_2"
+        with open(RS_PATH, "w") as n_rsxa_file:
+            json.dump(test_data, n_rsxa_file)
+
+        result = rsxa.RSXA_init(byref(RSXA_Object))
+        self.assertEqual(result, NMT_result.OK)
+        self.assertFalse(RSXA_Object.image)
+        self.assertEqual(test_data["log_dir"], rsxa_str(RSXA_Object.strings, RSXA_Object.log_dir))
+
+    def test_RSXA_compile_BW_2(self):
+        #Description - Verify nothing is written for an invalid JSON
+
+        # -- Prepare Test -- #
+        test_data = {"log_dirs": "/test/test_file",
+                     "procs"  : [],
+                     "hw": []}
+
+        with open(RS_PATH, "w") as n_rsxa_file:
+            json.dump(test_data, n_rsxa_file)
+
+        os.system("rm -f %s"%RS_IMAGE)
+        result = rsxa.RSXA_compile(RS_PATH, RS_IMAGE)
+        self.assertEqual(result, NMT_result.NOK)
+        self.assertFalse(os.path.exists(RS_IMAGE))
+
+    def test_RSXA_find_GW(self):
+        #Description - Verify hw, procs and pins are found by name, and
+        #              the first entry wins when names repeat
+
+        #Initialize Variables
+        RSXA_Object = RSXA()
+
+        # -- Prepare Test -- #
+        test_data = {"log_dir": "/test/test_file",
+                     "procs"  : [{"proc_name": "UnitTest", "server_ip": "224.1.1.1",
+                                  "server_p": 1000, "client_ip": "224.1.2.3", "client_p": 2000},
+                                 {"proc_name": "UnitTest2", "server_ip": "224.1.1.2",
+                                  "server_p": 3000, "client_ip": "224.1.2.4", "client_p": 4000}],
+                     "hw": [{"hw_name": "HW%d"%i, "hw_sim_mode": True,
+                             "hw_interface":[{"pin_name": "p1", "pin_no": i},
+                                             {"pin_name": "p2", "pin_no": i + 100}]}
+                            for i in range(0, 50)] +
+                           [{"hw_name": "HW7", "hw_sim_mode": False, "hw_interface": []}]}
+
+        with open(RS_PATH, "w") as n_rsxa_file:
+            json.dump(test_data, n_rsxa_file)
+
+        result = rsxa.RSXA_init(byref(RSXA_Object))
+        self.assertEqual(result, NMT_result.OK)
+
+        for i in range(0, 50):
+            hw = rsxa.RSXA_find_hw(byref(RSXA_Object), "HW%d"%i)
+            self.assertEqual("HW%d"%i, rsxa_str(hw.contents.strings, hw.contents.hw_name))
+            self.assertEqual(i + 100, rsxa.RSXA_find_pin(hw, "p2").contents.pin_no)
+            self.assertFalse(rsxa.RSXA_find_pin(hw, "p3"))
+
+        self.assertTrue(rsxa.RSXA_find_hw(byref(RSXA_Object), "HW7").contents.hw_sim_mode)
+        self.assertFalse(rsxa.RSXA_find_hw(byref(RSXA_Object), "HW50"))
+        self.assertEqual(4000, rsxa.RSXA_find_proc(byref(RSXA_Object), "UnitTest2").contents.client_p)
+        self.assertFalse(rsxa.RSXA_find_proc(byref(RSXA_Object), "UnitTest3"))
+
+        rsxa.RSXA_free_mem(byref(RSXA_Object))
+
+    def test_RSXA_str_GW(self):
+        #Description - Verify names of any length are kept whole, equal
+        #              names share a handle and handles survive the image
+
+        #Initialize Variables
+        RSXA_Object = RSXA()
+
+        # -- Prepare Test -- #
+        long_name = "UnitTest_HW_" + "x" * 200
+        test_data = {"log_dir": "/test/" + "d" * 300,
+                     "procs"  : [{"proc_name": "UnitTest", "server_ip": "224.1.1.1",
+                                  "server_p": 1000, "client_ip": "224.1.1.1", "client_p": 2000}],
+                     "hw": [{"hw_name": long_name, "hw_sim_mode": False,
+                             "hw_interface":[{"pin_name": "p1", "pin_no": 1}]},
+                            {"hw_name": "UnitTest_HW2", "hw_sim_mode": True,
+                             "hw_interface":[{"pin_name": "p1", "pin_no": 2}]}]}
+
+        with open(RS_PATH, "w") as n_rsxa_file:
+            json.dump(test_data, n_rsxa_file)
+
+        for compiled in [False, True]:
+            if compiled:
+                self.assertEqual(rsxa.RSXA_compile(RS_PATH, RS_IMAGE), NMT_result.OK)
+
+            result = rsxa.RSXA_init(byref(RSXA_Object))
+            self.assertEqual(result, NMT_result.OK)
+            self.assertEqual(compiled, bool(RSXA_Object.image))
+
+            strings = RSXA_Object.strings
+            self.assertEqual(test_data["log_dir"], rsxa_str(strings, RSXA_Object.log_dir))
+            self.assertEqual(long_name, rsxa_str(strings, RSXA_Object.hw[0].hw_name))
+            self.assertEqual(RSXA_Object.procs[0].server_ip, RSXA_Object.procs[0].client_ip)
+            self.assertEqual(RSXA_Object.hw[0].hw_interface[0].pin_name,
+                             RSXA_Object.hw[1].hw_interface[0].pin_name)
+            self.assertEqual(RSXA_STR_NONE, rsxa.RSXA_str_find(strings, "p2", 2))
+
+            hw = rsxa.RSXA_find_hw(byref(RSXA_Object), long_name)
+            self.assertEqual(1, rsxa.RSXA_find_pin(hw, "p1").contents.pin_no)
+            self.assertFalse(rsxa.RSXA_find_hw(byref(RSXA_Object), long_name[:20]))
+
+            rsxa.RSXA_free_mem(byref(RSXA_Object))
+
+    def test_RSXA_diff_GW(self):
+        #Description - Verify an edit of RSXA.json is reported by the watch
+        #              and the diff finds the hw and procs that changed.
+        #              Reordering pins is no change.
+
+        #Initialize Variables
+        old_settings = RSXA()
+        new_settings = RSXA()
+
+        # -- Prepare Test -- #
+        test_data = {"log_dir": "/test/test_file",
+                     "procs"  : [{"proc_name": "UnitTest", "server_ip": "224.1.1.1",
+                                  "server_p": 1000, "client_ip": "224.1.2.3", "client_p": 2000}],
+                     "hw": [{"hw_name": "HW%d"%i, "hw_sim_mode": True,
+                             "hw_interface":[{"pin_name": "p1", "pin_no": 1},
+                                             {"pin_name": "p2", "pin_no": 2}]}
+                            for i in range(0, 4)]}
+
+        with open(RS_PATH, "w") as n_rsxa_file:
+            json.dump(test_data, n_rsxa_file)
+
+        self.assertEqual(rsxa.RSXA_init(byref(old_settings)), NMT_result.OK)
+        watch_fd = rsxa.RSXA_watch(RS_PATH)
+        self.assertTrue(watch_fd >= 0)
+        self.assertFalse(rsxa.RSXA_watch_changed(watch_fd, RS_PATH))
+
+        test_data["hw"][0]["hw_interface"].reverse()
+        test_data["hw"][1]["hw_sim_mode"] = False
+        test_data["hw"][2]["hw_interface"][1]["pin_no"] = 5
+        test_data["hw"][3]["hw_interface"].pop()
+        test_data["procs"][0]["client_p"] = 2001
+
+        with open(RS_PATH, "w") as n_rsxa_file:
+            json.dump(test_data, n_rsxa_file)
+
+        self.assertTrue(rsxa.RSXA_watch_changed(watch_fd, RS_PATH))
+        self.assertFalse(rsxa.RSXA_watch_changed(watch_fd, RS_PATH))
+        self.assertEqual(rsxa.RSXA_init(byref(new_settings)), NMT_result.OK)
+
+        changes = [rsxa.RSXA_diff_hw(rsxa.RSXA_find_hw(byref(old_settings), "HW%d"%i),
+                                     rsxa.RSXA_find_hw(byref(new_settings), "HW%d"%i)) for i in range(0, 4)]
+        self.assertEqual([RSXA_HW_SAME, RSXA_HW_SIM_MODE, RSXA_HW_PINS, RSXA_HW_PINS], changes)
+        self.assertTrue(rsxa.RSXA_diff_proc(rsxa.RSXA_find_proc(byref(old_settings), "UnitTest"),
+                                            rsxa.RSXA_find_proc(byref(new_settings), "UnitTest")))
+        self.assertFalse(rsxa.RSXA_diff_proc(rsxa.RSXA_find_proc(byref(old_settings), "UnitTest"),
+                                             rsxa.RSXA_find_proc(byref(old_settings), "UnitTest")))
+
+        os.close(watch_fd)
+        rsxa.RSXA_free_mem(byref(old_settings))
+        rsxa.RSXA_free_mem(byref(new_settings))
+
+    def test_RSXA_publish_GW(self):
+        #Description - Publish RSXA.json and confirm every republish bumps
+        #              the generation, and the segment is not read once
+        #              the JSON changes without a republish
+
+        # -- Prepare Test -- #
+        test_data = {"log_dir": "/test/test_file",
+                     "procs"  : [{"proc_name": "UnitTest", "server_ip": "224.1.1.1",
+                                  "server_p": 1000, "client_ip": "224.1.2.3", "client_p": 2000,
+                                  "transport": "shm"}],
+                     "hw": [{"hw_name": "UnitTest_HW1", "hw_sim_mode": False,
+                             "hw_interface":[{"pin_name": "p1", "pin_no": 1}]}]}
+
+        with open(RS_PATH, "w") as n_rsxa_file:
+            json.dump(test_data, n_rsxa_file)
+
+        self.assertEqual(0, rsxa.RSXA_shm_generation(RS_SHM))
+        self.assertEqual(rsxa.RSXA_publish(RS_PATH, RS_SHM), NMT_result.OK)
+        self.assertEqual(1, rsxa.RSXA_shm_generation(RS_SHM))
+        self.assertEqual(rsxa.RSXA_publish(RS_PATH, RS_SHM), NMT_result.OK)
+        self.assertEqual(2, rsxa.RSXA_shm_generation(RS_SHM))
+
+        # An invalid JSON leaves the published settings alone
+        with open(RS_PATH, "w") as n_rsxa_file:
+            n_rsxa_file.write("{")
+        self.assertEqual(rsxa.RSXA_publish(RS_PATH, RS_SHM), NMT_result.NOK)
+        self.assertEqual(2, rsxa.RSXA_shm_generation(RS_SHM))
+        os.system("rm -f /dev/shm%s"%RS_SHM)
+
+        # RSXA_init attaches to the default segment
+        with open(RS_PATH, "w") as n_rsxa_file:
+            json.dump(test_data, n_rsxa_file)
+        self.assertEqual(rsxa.RSXA_publish(RS_PATH, "/NiBot_RSXA"), NMT_result.OK)
+
+        settings = rsxa_settings()
+        self.assertTrue(settings["generation"] > 0)
+        del settings["generation"]
+        self.assertEqual(test_data, settings)
+
+        test_data["log_dir"] = "/test/test_file_2"
+        with open(RS_PATH, "w") as n_rsxa_file:
+            json.dump(test_data, n_rsxa_file)
+
+        settings = rsxa_settings()
+        self.assertEqual(0, settings["generation"])
+        self.assertEqual(test_data["log_dir"], settings["log_dir"])
+        os.system("rm -f /dev/shm/NiBot_RSXA")
+
     def tearDown(self):
+        os.system("rm -f %s"%RS_IMAGE)
         os.system("cp %s %s"%(self.backup_file, RS_PATH))
         os.system("rm -rf %s"%self.backup_file)
 